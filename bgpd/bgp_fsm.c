@@ -31,6 +31,7 @@
 #include "memory.h"
 #include "plist.h"
 #include "workqueue.h"
+#include "liveness.h"
 #include "queue.h"
 #include "filter.h"
 #include "command.h"
@@ -790,6 +791,26 @@ void bgp_update_delay_end(struct bgp *bgp)
 	 * mode.
 	 */
 	work_queue_unplug(bgp->process_queue);
+
+	bgp_update_delay_liveness();
+}
+
+/*
+ * watchfrr applies normal lag limits again once no instance is in
+ * update-delay any more.
+ */
+void bgp_update_delay_liveness(void)
+{
+	struct listnode *node;
+	struct bgp *bgp;
+
+	if (frr_liveness_get_phase() != FRR_LIVENESS_CONVERGING)
+		return;
+
+	for (ALL_LIST_ELEMENTS_RO(bm->bgp, node, bgp))
+		if (bgp_update_delay_active(bgp))
+			return;
+	frr_liveness_set_phase(FRR_LIVENESS_RUNNING);
 }
 
 /**
@@ -1061,6 +1082,8 @@ static void bgp_update_delay_begin(struct bgp *bgp)
 
 	quagga_timestamp(3, bgp->update_delay_begin_time,
 			 sizeof(bgp->update_delay_begin_time));
+
+	frr_liveness_set_phase(FRR_LIVENESS_CONVERGING);
 }
 
 static void bgp_update_delay_process_status_change(struct peer *peer)
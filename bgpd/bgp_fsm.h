@@ -133,6 +133,7 @@ extern int bgp_routeadv_timer(struct thread *);
 extern void bgp_fsm_change_status(struct peer *peer, int status);
 extern const char *const peer_down_str[];
 extern void bgp_update_delay_end(struct bgp *);
+extern void bgp_update_delay_liveness(void);
 extern void bgp_maxmed_update(struct bgp *);
 extern bool bgp_maxmed_onstartup_configured(struct bgp *);
 extern bool bgp_maxmed_onstartup_active(struct bgp *);
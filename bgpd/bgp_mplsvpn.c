@@ -495,8 +495,7 @@ leak_update(struct bgp *bgp, /* destination bgp instance */
 	    struct bgp_dest *bn, struct attr *new_attr, /* already interned */
 	    afi_t afi, safi_t safi, struct bgp_path_info *source_bpi,
 	    mpls_label_t *label, uint32_t num_labels, void *parent,
-	    struct bgp *bgp_orig, struct prefix *nexthop_orig,
-	    int nexthop_self_flag, int debug)
+	    struct bgp *bgp_orig, int nexthop_self_flag, int debug)
 {
 	const struct prefix *p = bgp_dest_get_prefix(bn);
 	struct bgp_path_info *bpi;
@@ -629,8 +628,6 @@ leak_update(struct bgp *bgp, /* destination bgp instance */
 		(struct bgp_dest *)((struct bgp_path_info *)parent)->net);
 	if (bgp_orig)
 		new->extra->bgp_orig = bgp_lock(bgp_orig);
-	if (nexthop_orig)
-		new->extra->nexthop_orig = *nexthop_orig;
 
 	/*
 	 * nexthop tracking for unicast routes
@@ -898,8 +895,8 @@ void vpn_leak_from_vrf_update(struct bgp *bgp_vpn,	    /* to */
 	struct bgp_path_info *new_info;
 
 	new_info = leak_update(bgp_vpn, bn, new_attr, afi, safi, path_vrf,
-			       &label, 1, path_vrf, bgp_vrf, NULL,
-			       nexthop_self_flag, debug);
+			       &label, 1, path_vrf, bgp_vrf, nexthop_self_flag,
+			       debug);
 
 	/*
 	 * Routes actually installed in the vpn RIB must also be
@@ -1081,7 +1078,6 @@ vpn_leak_to_vrf_update_onevrf(struct bgp *bgp_vrf,	    /* to */
 	struct bgp_dest *bn;
 	safi_t safi = SAFI_UNICAST;
 	const char *debugmsg;
-	struct prefix nexthop_orig;
 	mpls_label_t *pLabels = NULL;
 	uint32_t num_labels = 0;
 	int nexthop_self_flag = 1;
@@ -1135,27 +1131,19 @@ vpn_leak_to_vrf_update_onevrf(struct bgp *bgp_vrf,	    /* to */
 	}
 
 	/*
-	 * Nexthop: stash and clear
+	 * Nexthop: clear
 	 *
 	 * Nexthop is valid in context of VPN core, but not in destination vrf.
-	 * Stash it for later label resolution by vrf ingress path and then
-	 * overwrite with 0, i.e., "me", for the sake of vrf advertisement.
+	 * Overwrite it with 0, i.e., "me", for the sake of vrf advertisement.
 	 */
 	uint8_t nhfamily = NEXTHOP_FAMILY(path_vpn->attr->mp_nexthop_len);
 
-	memset(&nexthop_orig, 0, sizeof(nexthop_orig));
-	nexthop_orig.family = nhfamily;
-
 	switch (nhfamily) {
 	case AF_INET:
-		/* save */
-		nexthop_orig.u.prefix4 = path_vpn->attr->mp_nexthop_global_in;
-		nexthop_orig.prefixlen = 32;
-
 		if (CHECK_FLAG(bgp_vrf->af_flags[afi][safi],
 			       BGP_CONFIG_VRF_TO_VRF_IMPORT)) {
 			static_attr.nexthop.s_addr =
-				nexthop_orig.u.prefix4.s_addr;
+				path_vpn->attr->mp_nexthop_global_in.s_addr;
 
 			static_attr.mp_nexthop_global_in =
 				path_vpn->attr->mp_nexthop_global_in;
@@ -1165,13 +1153,10 @@ vpn_leak_to_vrf_update_onevrf(struct bgp *bgp_vrf,	    /* to */
 		static_attr.flag |= ATTR_FLAG_BIT(BGP_ATTR_NEXT_HOP);
 		break;
 	case AF_INET6:
-		/* save */
-		nexthop_orig.u.prefix6 = path_vpn->attr->mp_nexthop_global;
-		nexthop_orig.prefixlen = 128;
-
 		if (CHECK_FLAG(bgp_vrf->af_flags[afi][safi],
 			       BGP_CONFIG_VRF_TO_VRF_IMPORT)) {
-			static_attr.mp_nexthop_global = nexthop_orig.u.prefix6;
+			static_attr.mp_nexthop_global =
+				path_vpn->attr->mp_nexthop_global;
 		}
 		break;
 	}
@@ -1271,7 +1256,7 @@ vpn_leak_to_vrf_update_onevrf(struct bgp *bgp_vrf,	    /* to */
 
 	leak_update(bgp_vrf, bn, new_attr, afi, safi, path_vpn, pLabels,
 		    num_labels, path_vpn, /* parent */
-		    src_vrf, &nexthop_orig, nexthop_self_flag, debug);
+		    src_vrf, nexthop_self_flag, debug);
 }
 
 void vpn_leak_to_vrf_update(struct bgp *bgp_vpn,	    /* from */
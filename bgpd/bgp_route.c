@@ -8192,20 +8192,15 @@ static void route_vty_out_route(const struct prefix *p, struct vty *vty,
 				json_object *json, bool wide)
 {
 	int len = 0;
-	char buf[BUFSIZ];
-	char buf2[BUFSIZ];
 
 	if (p->family == AF_INET) {
 		if (!json) {
 			len = vty_out(vty, "%pFX", p);
 		} else {
-			json_object_string_add(json, "prefix",
-					       inet_ntop(p->family,
-							 &p->u.prefix, buf,
-							 BUFSIZ));
+			json_object_addr_add(json, "prefix", p->family,
+					     &p->u.prefix);
 			json_object_int_add(json, "prefixLen", p->prefixlen);
-			prefix2str(p, buf2, PREFIX_STRLEN);
-			json_object_string_add(json, "network", buf2);
+			json_object_prefix_add(json, "network", p);
 		}
 	} else if (p->family == AF_ETHERNET) {
 		len = vty_out(vty, "%pFX", p);
@@ -8223,13 +8218,10 @@ static void route_vty_out_route(const struct prefix *p, struct vty *vty,
 		if (!json)
 			len = vty_out(vty, "%pFX", p);
 		else {
-			json_object_string_add(json, "prefix",
-						inet_ntop(p->family,
-							&p->u.prefix, buf,
-							BUFSIZ));
+			json_object_addr_add(json, "prefix", p->family,
+					     &p->u.prefix);
 			json_object_int_add(json, "prefixLen", p->prefixlen);
-			prefix2str(p, buf2, PREFIX_STRLEN);
-			json_object_string_add(json, "network", buf2);
+			json_object_prefix_add(json, "network", p);
 		}
 	}
 
@@ -8601,14 +8593,10 @@ void route_vty_out(struct vty *vty, const struct prefix *p,
 		}
 	} else if (p->family == AF_INET && !BGP_ATTR_NEXTHOP_AFI_IP6(attr)) {
 		if (json_paths) {
-			char buf[BUFSIZ] = {0};
-
 			json_nexthop_global = json_object_new_object();
 
-			json_object_string_add(json_nexthop_global, "ip",
-					       inet_ntop(AF_INET,
-							 &attr->nexthop, buf,
-							 sizeof(buf)));
+			json_object_addr_add(json_nexthop_global, "ip", AF_INET,
+					     &attr->nexthop);
 
 			if (path->peer->hostname)
 				json_object_string_add(json_nexthop_global,
@@ -8637,14 +8625,11 @@ void route_vty_out(struct vty *vty, const struct prefix *p,
 
 	/* IPv6 Next Hop */
 	else if (p->family == AF_INET6 || BGP_ATTR_NEXTHOP_AFI_IP6(attr)) {
-		char buf[BUFSIZ];
-
 		if (json_paths) {
 			json_nexthop_global = json_object_new_object();
-			json_object_string_add(
-				json_nexthop_global, "ip",
-				inet_ntop(AF_INET6, &attr->mp_nexthop_global,
-					  buf, BUFSIZ));
+			json_object_addr_add(json_nexthop_global, "ip",
+					     AF_INET6,
+					     &attr->mp_nexthop_global);
 
 			if (path->peer->hostname)
 				json_object_string_add(json_nexthop_global,
@@ -8662,11 +8647,9 @@ void route_vty_out(struct vty *vty, const struct prefix *p,
 			     == BGP_ATTR_NHLEN_IPV6_GLOBAL_AND_LL)
 			    || (path->peer->conf_if)) {
 				json_nexthop_ll = json_object_new_object();
-				json_object_string_add(
-					json_nexthop_ll, "ip",
-					inet_ntop(AF_INET6,
-						  &attr->mp_nexthop_local, buf,
-						  BUFSIZ));
+				json_object_addr_add(json_nexthop_ll, "ip",
+						     AF_INET6,
+						     &attr->mp_nexthop_local);
 
 				if (path->peer->hostname)
 					json_object_string_add(
@@ -10506,11 +10489,32 @@ static int bgp_show_community(struct vty *vty, struct bgp *bgp,
 			      safi_t safi, uint8_t show_flags);
 
 
+/* State of a table walk run as a resumable vty command, see bgp_show() */
+struct bgp_show_walk {
+	struct bgp *bgp;
+	safi_t safi;
+	struct bgp_table *table;
+	enum bgp_show_type type;
+	uint8_t show_flags;
+	unsigned long json_header_depth;
+
+	/* next destination to display; nothing stays locked between slices */
+	bool paused;
+	struct prefix resume_p;
+	/* destinations added after the dump started are skipped */
+	uint32_t snapshot;
+	int header;
+	int first;
+	unsigned long output_count;
+	unsigned long total_count;
+};
+
 static int bgp_show_table(struct vty *vty, struct bgp *bgp, safi_t safi,
 			  struct bgp_table *table, enum bgp_show_type type,
 			  void *output_arg, char *rd, int is_last,
 			  unsigned long *output_cum, unsigned long *total_cum,
-			  unsigned long *json_header_depth, uint8_t show_flags)
+			  unsigned long *json_header_depth, uint8_t show_flags,
+			  struct bgp_show_walk *walk)
 {
 	struct bgp_path_info *pi;
 	struct bgp_dest *dest;
@@ -10525,6 +10529,19 @@ static int bgp_show_table(struct vty *vty, struct bgp *bgp, safi_t safi,
 	bool wide = CHECK_FLAG(show_flags, BGP_SHOW_OPT_WIDE);
 	bool all = CHECK_FLAG(show_flags, BGP_SHOW_OPT_AFI_ALL);
 
+	if (walk && walk->paused) {
+		/* pick up where the previous time slice stopped */
+		dest = bgp_node_lookup(table, &walk->resume_p);
+		if (!dest)
+			dest = bgp_table_get_next(table, &walk->resume_p);
+		walk->paused = false;
+		header = walk->header;
+		first = walk->first;
+		output_count = walk->output_count;
+		total_count = walk->total_count;
+		goto resume;
+	}
+
 	if (output_cum && *output_cum != 0)
 		header = 0;
 
@@ -10557,9 +10574,27 @@ static int bgp_show_table(struct vty *vty, struct bgp *bgp, safi_t safi,
 	}
 
 	/* Start processing of routes. */
-	for (dest = bgp_table_top(table); dest; dest = bgp_route_next(dest)) {
+	dest = bgp_table_top(table);
+resume:
+	for (; dest; dest = bgp_route_next(dest)) {
 		const struct prefix *dest_p = bgp_dest_get_prefix(dest);
 
+		if (walk && vty_resume_yield(vty)) {
+			prefix_copy(&walk->resume_p, dest_p);
+			bgp_dest_unlock_node(dest);
+			walk->paused = true;
+			walk->header = header;
+			walk->first = first;
+			walk->output_count = output_count;
+			walk->total_count = total_count;
+			return CMD_YIELD;
+		}
+
+		if (walk
+		    && !route_node_in_snapshot(bgp_dest_to_rnode(dest),
+					       walk->snapshot))
+			continue;
+
 		pi = bgp_dest_get_bgp_path_info(dest);
 		if (pi == NULL)
 			continue;
@@ -10881,7 +10916,7 @@ int bgp_show_table_rd(struct vty *vty, struct bgp *bgp, safi_t safi,
 			bgp_show_table(vty, bgp, safi, itable, type, output_arg,
 				       rd, next == NULL, &output_cum,
 				       &total_cum, &json_header_depth,
-				       show_flags);
+				       show_flags, NULL);
 			if (next == NULL)
 				show_msg = false;
 		}
@@ -10934,7 +10969,55 @@ static int bgp_show(struct vty *vty, struct bgp *bgp, afi_t afi, safi_t safi,
 		safi = SAFI_UNICAST;
 
 	return bgp_show_table(vty, bgp, safi, table, type, output_arg, NULL, 1,
-			      NULL, NULL, &json_header_depth, show_flags);
+			      NULL, NULL, &json_header_depth, show_flags, NULL);
+}
+
+static int bgp_show_resume(struct vty *vty, void *arg)
+{
+	struct bgp_show_walk *walk = arg;
+
+	return bgp_show_table(vty, walk->bgp, walk->safi, walk->table,
+			      walk->type, NULL, NULL, 1, NULL, NULL,
+			      &walk->json_header_depth, walk->show_flags, walk);
+}
+
+static void bgp_show_walk_free(void *arg)
+{
+	struct bgp_show_walk *walk = arg;
+
+	bgp_table_unlock(walk->table);
+	bgp_unlock(walk->bgp);
+	XFREE(MTYPE_TMP, walk);
+}
+
+/*
+ * Same as bgp_show(), for the plain table dumps that take no filter argument
+ * whose lifetime ends with the command: those may yield and finish later.
+ */
+static int bgp_show_yielding(struct vty *vty, struct bgp *bgp, afi_t afi,
+			     safi_t safi, enum bgp_show_type type,
+			     uint8_t show_flags)
+{
+	struct bgp_show_walk *walk;
+
+	if (bgp == NULL)
+		bgp = bgp_get_default();
+
+	if (bgp == NULL || safi == SAFI_MPLS_VPN
+	    || (safi == SAFI_FLOWSPEC && type == bgp_show_type_detail))
+		return bgp_show(vty, bgp, afi, safi, type, NULL, show_flags);
+
+	walk = XCALLOC(MTYPE_TMP, sizeof(*walk));
+	walk->bgp = bgp_lock(bgp);
+	walk->table = bgp->rib[afi][safi];
+	bgp_table_lock(walk->table);
+	walk->snapshot = route_table_snapshot(walk->table->route_table);
+	/* labeled-unicast routes live in the unicast table */
+	walk->safi = safi == SAFI_LABELED_UNICAST ? SAFI_UNICAST : safi;
+	walk->type = type;
+	walk->show_flags = show_flags;
+
+	return vty_resume_start(vty, bgp_show_resume, walk, bgp_show_walk_free);
 }
 
 static void bgp_show_all_instances_routes_vty(struct vty *vty, afi_t afi,
@@ -11923,8 +12006,8 @@ DEFPY (show_ip_bgp_json,
 						  exact_match, afi, safi,
 						  show_flags);
 		else
-			return bgp_show(vty, bgp, afi, safi, sh_type, NULL,
-					show_flags);
+			return bgp_show_yielding(vty, bgp, afi, safi, sh_type,
+						 show_flags);
 	} else {
 		/* show <ip> bgp ipv4 all: AFI_IP, show <ip> bgp ipv6 all:
 		 * AFI_IP6 */
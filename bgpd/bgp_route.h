@@ -191,12 +191,6 @@ struct bgp_path_info_extra {
 	 */
 	struct bgp *bgp_orig;
 
-	/*
-	 * Nexthop in context of original bgp instance. Needed
-	 * for label resolution of core mpls routes exported to a vrf.
-	 * Set nexthop_orig.family to 0 if not valid.
-	 */
-	struct prefix nexthop_orig;
 	/* presence of FS pbr firewall based entry */
 	struct list *bgp_fs_pbr;
 	/* presence of FS pbr iprule based entry */
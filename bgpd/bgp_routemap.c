@@ -365,7 +365,7 @@ route_match_script(void *rule, const struct prefix *prefix, void *object)
 	const char *scriptname = rule;
 	struct bgp_path_info *path = (struct bgp_path_info *)object;
 
-	struct frrscript *fs = frrscript_load(scriptname, NULL);
+	struct frrscript *fs = frrscript_get(scriptname);
 
 	if (!fs) {
 		zlog_err("Issue loading script rule; defaulting to no match");
@@ -443,7 +443,6 @@ route_match_script(void *rule, const struct prefix *prefix, void *object)
 	}
 
 	XFREE(MTYPE_TMP, lrm_status);
-	frrscript_unload(fs);
 
 	return status;
 }
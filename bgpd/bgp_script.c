@@ -142,9 +142,8 @@ static void lua_pushpeer(lua_State *L, const struct peer *peer)
 	lua_setfield(L, -2, "stats");
 }
 
-static void lua_pushattr(lua_State *L, const struct attr *attr)
+static void lua_updateattr(lua_State *L, const struct attr *attr)
 {
-	lua_newtable(L);
 	lua_pushinteger(L, attr->med);
 	lua_setfield(L, -2, "metric");
 	lua_pushinteger(L, attr->nh_ifindex);
@@ -155,6 +154,12 @@ static void lua_pushattr(lua_State *L, const struct attr *attr)
 	lua_setfield(L, -2, "localpref");
 }
 
+static void lua_pushattr(lua_State *L, const struct attr *attr)
+{
+	lua_newtable(L);
+	lua_updateattr(L, attr);
+}
+
 static void *lua_toattr(lua_State *L, int idx)
 {
 	struct attr *attr = XCALLOC(MTYPE_TMP, sizeof(struct attr));
@@ -181,7 +186,8 @@ struct frrscript_codec frrscript_codecs_bgpd[] = {
 	 .decoder = NULL},
 	{.typename = "attr",
 	 .encoder = (encoder_func)lua_pushattr,
-	 .decoder = lua_toattr},
+	 .decoder = lua_toattr,
+	 .update = (encoder_func)lua_updateattr},
 	{}};
 
 void bgp_script_init(void)
@@ -42,6 +42,8 @@
 #include "bgpd/bgp_fsm.h"
 #include "bgpd/bgp_mplsvpn_snmp.h"
 
+DEFINE_MTYPE_STATIC(BGPD, BGP_SNMP_PEERS, "BGP SNMP peer snapshot")
+
 /* BGP4-MIB described in RFC1657. */
 #define BGP4MIB 1,3,6,1,2,1,15
 
@@ -372,32 +374,116 @@ static struct peer *peer_lookup_addr_ipv4(struct in_addr *src)
 	return NULL;
 }
 
-static struct peer *bgp_peer_lookup_next(struct in_addr *src)
+/*
+ * bgpPeerTable walks ask for the peer following the previous one, once per
+ * column.  Answer these from a snapshot of the IPv4 peers sorted by address
+ * instead of going over all peers every time; it is rebuilt when older than
+ * a second, so peers added or removed show up in the next walk.  The
+ * snapshot holds a lock on each peer, so it is dropped on a timer once it
+ * is that old rather than pinning deleted peers until the next walk.
+ */
+#define PEER_SNAPSHOT_MAXAGE 1
+
+static struct {
+	struct peer **peers;
+	size_t count;
+	time_t built;
+	struct thread *t_expire;
+} peer_snapshot;
+
+static int peer_snapshot_cmp(const void *a, const void *b)
+{
+	const struct peer *pa = *(const struct peer * const *)a;
+	const struct peer *pb = *(const struct peer * const *)b;
+	uint32_t aa = ntohl(sockunion2ip(&pa->su));
+	uint32_t ab = ntohl(sockunion2ip(&pb->su));
+
+	return aa < ab ? -1 : (aa > ab);
+}
+
+static void peer_snapshot_flush(void)
+{
+	size_t i;
+
+	THREAD_OFF(peer_snapshot.t_expire);
+
+	for (i = 0; i < peer_snapshot.count; i++)
+		peer_unlock(peer_snapshot.peers[i]);
+
+	XFREE(MTYPE_BGP_SNMP_PEERS, peer_snapshot.peers);
+	peer_snapshot.count = 0;
+}
+
+static int peer_snapshot_expire(struct thread *thread)
+{
+	peer_snapshot_flush();
+	return 0;
+}
+
+static void peer_snapshot_update(void)
 {
 	struct bgp *bgp;
 	struct peer *peer;
-	struct peer *next_peer = NULL;
 	struct listnode *node;
 	struct listnode *bgpnode;
+	time_t now = monotime(NULL);
+	size_t count = 0;
+
+	if (peer_snapshot.peers && now - peer_snapshot.built
+					   < PEER_SNAPSHOT_MAXAGE)
+		return;
+
+	peer_snapshot_flush();
+
+	for (ALL_LIST_ELEMENTS_RO(bm->bgp, bgpnode, bgp))
+		count += listcount(bgp->peer);
+
+	peer_snapshot.peers = XCALLOC(MTYPE_BGP_SNMP_PEERS,
+				      (count ? count : 1) * sizeof(peer));
+	peer_snapshot.built = now;
 
 	for (ALL_LIST_ELEMENTS_RO(bm->bgp, bgpnode, bgp)) {
 		for (ALL_LIST_ELEMENTS_RO(bgp->peer, node, peer)) {
 			if (sockunion_family(&peer->su) != AF_INET)
 				continue;
-			if (ntohl(sockunion2ip(&peer->su)) <= ntohl(src->s_addr))
-				continue;
 
-			if (!next_peer
-			    || ntohl(sockunion2ip(&next_peer->su))
-				       > ntohl(sockunion2ip(&peer->su))) {
-				next_peer = peer;
-			}
+			peer_snapshot.peers[peer_snapshot.count++] =
+				peer_lock(peer);
 		}
 	}
 
-	if (next_peer) {
-		src->s_addr = sockunion2ip(&next_peer->su);
-		return next_peer;
+	qsort(peer_snapshot.peers, peer_snapshot.count, sizeof(peer),
+	      peer_snapshot_cmp);
+
+	thread_add_timer(bm->master, peer_snapshot_expire, NULL,
+			 PEER_SNAPSHOT_MAXAGE, &peer_snapshot.t_expire);
+}
+
+static struct peer *bgp_peer_lookup_next(struct in_addr *src)
+{
+	struct peer *peer;
+	size_t lo = 0, hi, mid;
+
+	peer_snapshot_update();
+
+	/* first peer with an address above src */
+	hi = peer_snapshot.count;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (ntohl(sockunion2ip(&peer_snapshot.peers[mid]->su))
+		    <= ntohl(src->s_addr))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	for (; lo < peer_snapshot.count; lo++) {
+		peer = peer_snapshot.peers[lo];
+		if (peer->status == Deleted)
+			continue;
+
+		src->s_addr = sockunion2ip(&peer->su);
+		return peer;
 	}
 
 	return NULL;
@@ -717,8 +803,13 @@ static struct bgp_path_info *bgp4PathAttrLookup(struct variable *v, oid name[],
 			else
 				addr->prefixlen = len * 8;
 
-			dest = bgp_node_get(bgp->rib[AFI_IP][SAFI_UNICAST],
-					    (struct prefix *)addr);
+			/* don't create the node just to start from it */
+			dest = bgp_node_lookup(bgp->rib[AFI_IP][SAFI_UNICAST],
+					       (struct prefix *)addr);
+			if (!dest)
+				dest = bgp_table_get_next(
+					bgp->rib[AFI_IP][SAFI_UNICAST],
+					(struct prefix *)addr);
 
 			offset++;
 			offsetlen--;
@@ -904,11 +995,18 @@ static int bgp_snmp_init(struct thread_master *tm)
 	return 0;
 }
 
+static int bgp_snmp_fini(void)
+{
+	peer_snapshot_flush();
+	return 0;
+}
+
 static int bgp_snmp_module_init(void)
 {
 	hook_register(peer_status_changed, bgpTrapEstablished);
 	hook_register(peer_backward_transition, bgpTrapBackwardTransition);
 	hook_register(frr_late_init, bgp_snmp_init);
+	hook_register(frr_early_fini, bgp_snmp_fini);
 	return 0;
 }
 
@@ -37,6 +37,7 @@
 #include "queue.h"
 #include "filter.h"
 #include "frrstr.h"
+#include "snapshot.h"
 
 #include "bgpd/bgpd.h"
 #include "bgpd/bgp_attr_evpn.h"
@@ -19056,6 +19057,13 @@ void bgp_vty_init(void)
 	install_element(BGP_IPV6_NODE, &af_no_route_map_vpn_imexport_cmd);
 	install_element(BGP_IPV4_NODE, &af_no_import_vrf_route_map_cmd);
 	install_element(BGP_IPV6_NODE, &af_no_import_vrf_route_map_cmd);
+
+	/* polled by monitoring, answered by --query-thread */
+	snapshot_register("show bgp summary", 1000);
+	snapshot_register("show bgp summary json", 1000);
+	snapshot_register("show bgp neighbors json", 1000);
+	snapshot_register("show bgp ipv4 unicast", 5000);
+	snapshot_register("show bgp ipv6 unicast", 5000);
 }
 
 #include "memory.h"
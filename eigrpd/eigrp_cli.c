@@ -845,6 +845,7 @@ static struct cmd_node eigrp_node = {
 	.parent_node = CONFIG_NODE,
 	.prompt = "%s(config-router)# ",
 	.config_write = eigrp_config_write,
+	.config_nb = true,
 };
 
 static int eigrp_config_write(struct vty *vty)
@@ -239,17 +239,12 @@ void show_ip_eigrp_topology_header(struct vty *vty, struct eigrp *eigrp)
 void show_ip_eigrp_prefix_descriptor(struct vty *vty,
 				     struct eigrp_prefix_descriptor *tn)
 {
-	struct list *successors = eigrp_topology_get_successor(tn);
-
 	vty_out(vty, "%-3c", (tn->state > 0) ? 'A' : 'P');
 
 	vty_out(vty, "%pFX, ", tn->destination);
-	vty_out(vty, "%u successors, ", (successors) ? successors->count : 0);
+	vty_out(vty, "%u successors, ", eigrp_topology_successor_count(tn));
 	vty_out(vty, "FD is %u, serno: %" PRIu64 " \n", tn->fdistance,
 		tn->serno);
-
-	if (successors)
-		list_delete(&successors);
 }
 
 void show_ip_eigrp_route_descriptor(struct vty *vty, struct eigrp *eigrp,
@@ -437,12 +437,11 @@ int eigrp_fsm_event_nq_fcn(struct eigrp_fsm_action_message *msg)
 {
 	struct eigrp *eigrp = msg->eigrp;
 	struct eigrp_prefix_descriptor *prefix = msg->prefix;
-	struct list *successors = eigrp_topology_get_successor(prefix);
-	struct eigrp_route_descriptor *ne;
+	struct eigrp_route_descriptor *ne =
+		eigrp_topology_get_first_successor(prefix);
 
-	assert(successors); // If this is NULL we have shit the bed, fun huh?
+	assert(ne); // If this is NULL we have shit the bed, fun huh?
 
-	ne = listnode_head(successors);
 	prefix->state = EIGRP_FSM_STATE_ACTIVE_1;
 	prefix->rdistance = prefix->distance = prefix->fdistance = ne->distance;
 	prefix->reported_metric = ne->total_metric;
@@ -455,8 +454,6 @@ int eigrp_fsm_event_nq_fcn(struct eigrp_fsm_action_message *msg)
 					 // neighbors left
 	}
 
-	list_delete(&successors);
-
 	return 1;
 }
 
@@ -464,12 +461,11 @@ int eigrp_fsm_event_q_fcn(struct eigrp_fsm_action_message *msg)
 {
 	struct eigrp *eigrp = msg->eigrp;
 	struct eigrp_prefix_descriptor *prefix = msg->prefix;
-	struct list *successors = eigrp_topology_get_successor(prefix);
-	struct eigrp_route_descriptor *ne;
+	struct eigrp_route_descriptor *ne =
+		eigrp_topology_get_first_successor(prefix);
 
-	assert(successors); // If this is NULL somebody poked us in the eye.
+	assert(ne); // If this is NULL somebody poked us in the eye.
 
-	ne = listnode_head(successors);
 	prefix->state = EIGRP_FSM_STATE_ACTIVE_3;
 	prefix->rdistance = prefix->distance = prefix->fdistance = ne->distance;
 	prefix->reported_metric = ne->total_metric;
@@ -481,8 +477,6 @@ int eigrp_fsm_event_q_fcn(struct eigrp_fsm_action_message *msg)
 					 // neighbors left
 	}
 
-	list_delete(&successors);
-
 	return 1;
 }
 
@@ -524,13 +518,11 @@ int eigrp_fsm_event_lr(struct eigrp_fsm_action_message *msg)
 	prefix->reported_metric = ne->total_metric;
 
 	if (prefix->state == EIGRP_FSM_STATE_ACTIVE_3) {
-		struct list *successors = eigrp_topology_get_successor(prefix);
+		ne = eigrp_topology_get_first_successor(prefix);
 
-		assert(successors); // It's like Napolean and Waterloo
+		assert(ne); // It's like Napolean and Waterloo
 
-		ne = listnode_head(successors);
 		eigrp_send_reply(ne->adv_router, prefix);
-		list_delete(&successors);
 	}
 
 	prefix->state = EIGRP_FSM_STATE_PASSIVE;
@@ -546,12 +538,11 @@ int eigrp_fsm_event_lr(struct eigrp_fsm_action_message *msg)
 
 int eigrp_fsm_event_dinc(struct eigrp_fsm_action_message *msg)
 {
-	struct list *successors = eigrp_topology_get_successor(msg->prefix);
-	struct eigrp_route_descriptor *ne;
+	struct eigrp_route_descriptor *ne =
+		eigrp_topology_get_first_successor(msg->prefix);
 
-	assert(successors); // Trump and his big hands
+	assert(ne); // Trump and his big hands
 
-	ne = listnode_head(successors);
 	msg->prefix->state = msg->prefix->state == EIGRP_FSM_STATE_ACTIVE_1
 				     ? EIGRP_FSM_STATE_ACTIVE_0
 				     : EIGRP_FSM_STATE_ACTIVE_2;
@@ -560,8 +551,6 @@ int eigrp_fsm_event_dinc(struct eigrp_fsm_action_message *msg)
 		(*(NSM[msg->prefix->state][eigrp_get_fsm_event(msg)].func))(
 			msg);
 
-
-	list_delete(&successors);
 	return 1;
 }
 
@@ -578,14 +567,11 @@ int eigrp_fsm_event_lr_fcs(struct eigrp_fsm_action_message *msg)
 				    ? prefix->distance
 				    : prefix->fdistance;
 	if (prefix->state == EIGRP_FSM_STATE_ACTIVE_2) {
-		struct list *successors = eigrp_topology_get_successor(prefix);
+		ne = eigrp_topology_get_first_successor(prefix);
 
-		assert(successors); // Having a spoon and all you need is a
-				    // knife
-		ne = listnode_head(successors);
-		eigrp_send_reply(ne->adv_router, prefix);
+		assert(ne); // Having a spoon and all you need is a knife
 
-		list_delete(&successors);
+		eigrp_send_reply(ne->adv_router, prefix);
 	}
 	prefix->req_action |= EIGRP_FSM_NEED_UPDATE;
 	listnode_add(eigrp->topology_changes_internalIPV4, prefix);
@@ -601,16 +587,15 @@ int eigrp_fsm_event_lr_fcn(struct eigrp_fsm_action_message *msg)
 {
 	struct eigrp *eigrp = msg->eigrp;
 	struct eigrp_prefix_descriptor *prefix = msg->prefix;
-	struct eigrp_route_descriptor *best_successor;
-	struct list *successors = eigrp_topology_get_successor(prefix);
+	struct eigrp_route_descriptor *best_successor =
+		eigrp_topology_get_first_successor(prefix);
 
-	assert(successors); // Routing without a stack
+	assert(best_successor); // Routing without a stack
 
 	prefix->state = prefix->state == EIGRP_FSM_STATE_ACTIVE_0
 				? EIGRP_FSM_STATE_ACTIVE_1
 				: EIGRP_FSM_STATE_ACTIVE_3;
 
-	best_successor = listnode_head(successors);
 	prefix->rdistance = prefix->distance = best_successor->distance;
 	prefix->reported_metric = best_successor->total_metric;
 
@@ -622,22 +607,18 @@ int eigrp_fsm_event_lr_fcn(struct eigrp_fsm_action_message *msg)
 					 // neighbors left
 	}
 
-	list_delete(&successors);
-
 	return 1;
 }
 
 int eigrp_fsm_event_qact(struct eigrp_fsm_action_message *msg)
 {
-	struct list *successors = eigrp_topology_get_successor(msg->prefix);
-	struct eigrp_route_descriptor *ne;
+	struct eigrp_route_descriptor *ne =
+		eigrp_topology_get_first_successor(msg->prefix);
 
-	assert(successors); // Cats and no Dogs
+	assert(ne); // Cats and no Dogs
 
-	ne = listnode_head(successors);
 	msg->prefix->state = EIGRP_FSM_STATE_ACTIVE_2;
 	msg->prefix->distance = ne->distance;
 
-	list_delete(&successors);
 	return 1;
 }
@@ -128,7 +128,7 @@ void eigrp_query_receive(struct eigrp *eigrp, struct ip *iph,
 				struct eigrp_fsm_action_message msg;
 				struct eigrp_route_descriptor *entry =
 					eigrp_route_descriptor_lookup(
-						dest->entries, nbr);
+						eigrp, dest, nbr);
 				msg.packet_type = EIGRP_OPC_QUERY;
 				msg.eigrp = eigrp;
 				msg.data_type = EIGRP_INT;
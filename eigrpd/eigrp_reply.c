@@ -179,7 +179,7 @@ void eigrp_reply_receive(struct eigrp *eigrp, struct ip *iph,
 
 		struct eigrp_fsm_action_message msg;
 		struct eigrp_route_descriptor *entry =
-			eigrp_route_descriptor_lookup(dest->entries, nbr);
+			eigrp_route_descriptor_lookup(eigrp, dest, nbr);
 
 		if (eigrp_update_prefix_apply(eigrp, ei, EIGRP_FILTER_IN,
 					      &dest_addr)) {
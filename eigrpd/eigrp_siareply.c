@@ -96,7 +96,7 @@ void eigrp_siareply_receive(struct eigrp *eigrp, struct ip *iph,
 				struct eigrp_fsm_action_message msg;
 				struct eigrp_route_descriptor *entry =
 					eigrp_route_descriptor_lookup(
-						dest->entries, nbr);
+						eigrp, dest, nbr);
 				msg.packet_type = EIGRP_OPC_SIAQUERY;
 				msg.eigrp = eigrp;
 				msg.data_type = EIGRP_INT;
@@ -33,10 +33,13 @@
 #define _ZEBRA_EIGRP_STRUCTS_H_
 
 #include "filter.h"
+#include "typesafe.h"
 
 #include "eigrpd/eigrp_const.h"
 #include "eigrpd/eigrp_macros.h"
 
+PREDECL_HASH(eigrp_rd_hash)
+
 struct eigrp_metrics {
 	uint32_t delay;
 	uint32_t bandwidth;
@@ -94,6 +97,9 @@ struct eigrp {
 
 	struct route_table *topology_table;
 
+	/* Route descriptors indexed by (prefix, advertising neighbor) */
+	struct eigrp_rd_hash_head rd_hash;
+
 	uint64_t serno; /* Global serial number counter for topology entry
 			   changes*/
 	uint64_t serno_last_update; /* Highest serial number of information send
@@ -484,6 +490,8 @@ struct eigrp_route_descriptor {
 	uint8_t flags;			   // used for marking successor and FS
 
 	struct eigrp_interface *ei; // pointer for case of connected entry
+
+	struct eigrp_rd_hash_item rd_hash_item;
 };
 
 //---------------------------------------------------------------------------------------------------------------------------------------------
@@ -38,6 +38,7 @@
 #include "linklist.h"
 #include "vty.h"
 #include "lib_errors.h"
+#include "jhash.h"
 
 #include "eigrpd/eigrp_types.h"
 #include "eigrpd/eigrp_structs.h"
@@ -57,6 +58,39 @@
 static int eigrp_route_descriptor_cmp(struct eigrp_route_descriptor *rd1,
 				      struct eigrp_route_descriptor *rd2);
 
+/*
+ * Route descriptors are looked up by (prefix, advertising neighbor) on
+ * every received update, query and reply.  Keep them in a hash so that
+ * this does not require walking the per-prefix entries list.
+ */
+static int eigrp_rd_hash_cmp(const struct eigrp_route_descriptor *rd1,
+			     const struct eigrp_route_descriptor *rd2)
+{
+	if (rd1->prefix != rd2->prefix)
+		return numcmp((uintptr_t)rd1->prefix, (uintptr_t)rd2->prefix);
+
+	return numcmp((uintptr_t)rd1->adv_router, (uintptr_t)rd2->adv_router);
+}
+
+static uint32_t eigrp_rd_hash_key(const struct eigrp_route_descriptor *rd)
+{
+	return jhash_2words((uint32_t)(uintptr_t)rd->prefix,
+			    (uint32_t)(uintptr_t)rd->adv_router, 0xe16a7d0c);
+}
+
+DECLARE_HASH(eigrp_rd_hash, struct eigrp_route_descriptor, rd_hash_item,
+	     eigrp_rd_hash_cmp, eigrp_rd_hash_key)
+
+/*
+ * Make sure a route descriptor present in a prefix entries list is also
+ * present in the lookup index.  Adding an item twice is a no-op.
+ */
+static void eigrp_route_descriptor_index(struct eigrp *eigrp,
+					 struct eigrp_route_descriptor *entry)
+{
+	eigrp_rd_hash_add(&eigrp->rd_hash, entry);
+}
+
 /*
  * Returns linkedlist used as topology table
  * cmp - assigned function for comparing topology nodes
@@ -68,6 +102,18 @@ struct route_table *eigrp_topology_new(void)
 	return route_table_init();
 }
 
+void eigrp_topology_index_init(struct eigrp *eigrp)
+{
+	eigrp_rd_hash_init(&eigrp->rd_hash);
+}
+
+void eigrp_topology_index_fini(struct eigrp *eigrp)
+{
+	while (eigrp_rd_hash_pop(&eigrp->rd_hash))
+		;
+	eigrp_rd_hash_fini(&eigrp->rd_hash);
+}
+
 /*
  * Returns new created toplogy node
  * cmp - assigned function for comparing topology entry
@@ -159,6 +205,7 @@ void eigrp_route_descriptor_add(struct eigrp *eigrp,
 	if (listnode_lookup(node->entries, entry) == NULL) {
 		listnode_add_sort(node->entries, entry);
 		entry->prefix = node;
+		eigrp_route_descriptor_index(eigrp, entry);
 
 		eigrp_zebra_route_add(eigrp, node->destination,
 				      l, node->fdistance);
@@ -213,6 +260,7 @@ void eigrp_route_descriptor_delete(struct eigrp *eigrp,
 {
 	if (listnode_lookup(node->entries, entry) != NULL) {
 		listnode_delete(node->entries, entry);
+		eigrp_rd_hash_del(&eigrp->rd_hash, entry);
 		eigrp_zebra_route_delete(eigrp, node->destination);
 		XFREE(MTYPE_EIGRP_ROUTE_DESCRIPTOR, entry);
 	}
@@ -290,40 +338,76 @@ struct list *
 eigrp_topology_get_successor_max(struct eigrp_prefix_descriptor *table_node,
 				 unsigned int maxpaths)
 {
-	struct list *successors = eigrp_topology_get_successor(table_node);
+	struct list *successors = NULL;
+	struct eigrp_route_descriptor *data;
+	struct listnode *node;
 
-	if (successors && successors->count > maxpaths) {
-		do {
-			struct listnode *node = listtail(successors);
+	for (ALL_LIST_ELEMENTS_RO(table_node->entries, node, data)) {
+		if (!(data->flags & EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG))
+			continue;
 
-			list_delete_node(successors, node);
+		if (successors && successors->count >= maxpaths)
+			break;
 
-		} while (successors->count > maxpaths);
+		if (!successors)
+			successors = list_new();
+		listnode_add(successors, data);
 	}
 
 	return successors;
 }
 
+/*
+ * Returns the best successor of the prefix without building a list.
+ * The entries list is kept sorted by distance, so this is the first
+ * entry flagged as successor.
+ */
 struct eigrp_route_descriptor *
-eigrp_route_descriptor_lookup(struct list *entries, struct eigrp_neighbor *nbr)
+eigrp_topology_get_first_successor(struct eigrp_prefix_descriptor *table_node)
 {
 	struct eigrp_route_descriptor *data;
-	struct listnode *node, *nnode;
-	for (ALL_LIST_ELEMENTS(entries, node, nnode, data)) {
-		if (data->adv_router == nbr) {
+	struct listnode *node;
+
+	for (ALL_LIST_ELEMENTS_RO(table_node->entries, node, data)) {
+		if (data->flags & EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG)
 			return data;
-		}
 	}
 
 	return NULL;
 }
 
+unsigned int
+eigrp_topology_successor_count(struct eigrp_prefix_descriptor *table_node)
+{
+	struct eigrp_route_descriptor *data;
+	struct listnode *node;
+	unsigned int count = 0;
+
+	for (ALL_LIST_ELEMENTS_RO(table_node->entries, node, data)) {
+		if (data->flags & EIGRP_ROUTE_DESCRIPTOR_SUCCESSOR_FLAG)
+			count++;
+	}
+
+	return count;
+}
+
+struct eigrp_route_descriptor *
+eigrp_route_descriptor_lookup(struct eigrp *eigrp,
+			      struct eigrp_prefix_descriptor *pe,
+			      struct eigrp_neighbor *nbr)
+{
+	struct eigrp_route_descriptor ref;
+
+	ref.prefix = pe;
+	ref.adv_router = nbr;
+
+	return eigrp_rd_hash_find(&eigrp->rd_hash, &ref);
+}
+
 /* Lookup all prefixes from specified neighbor */
 struct list *eigrp_neighbor_prefixes_lookup(struct eigrp *eigrp,
 					    struct eigrp_neighbor *nbr)
 {
-	struct listnode *node2, *node22;
-	struct eigrp_route_descriptor *entry;
 	struct eigrp_prefix_descriptor *pe;
 	struct route_node *rn;
 
@@ -335,13 +419,9 @@ struct list *eigrp_neighbor_prefixes_lookup(struct eigrp *eigrp,
 		if (!rn->info)
 			continue;
 		pe = rn->info;
-		/* iterate over all neighbor entry in prefix */
-		for (ALL_LIST_ELEMENTS(pe->entries, node2, node22, entry)) {
-			/* if entry is from specified neighbor, add to list */
-			if (entry->adv_router == nbr) {
-				listnode_add(prefixes, pe);
-			}
-		}
+		/* if prefix has an entry from specified neighbor, add to list */
+		if (eigrp_route_descriptor_lookup(eigrp, pe, nbr))
+			listnode_add(prefixes, pe);
 	}
 
 	/* return list of prefixes from specified neighbor */
@@ -411,6 +491,7 @@ distance_done:
 	 */
 	listnode_delete(prefix->entries, entry);
 	listnode_add_sort(prefix->entries, entry);
+	eigrp_route_descriptor_index(eigrp, entry);
 
 	return change;
 }
@@ -491,33 +572,31 @@ void eigrp_update_routing_table(struct eigrp *eigrp,
 void eigrp_topology_neighbor_down(struct eigrp *eigrp,
 				  struct eigrp_neighbor *nbr)
 {
-	struct listnode *node2, *node22;
 	struct eigrp_prefix_descriptor *pe;
 	struct eigrp_route_descriptor *entry;
 	struct route_node *rn;
 
 	for (rn = route_top(eigrp->topology_table); rn; rn = route_next(rn)) {
+		struct eigrp_fsm_action_message msg;
+
 		pe = rn->info;
 
 		if (!pe)
 			continue;
 
-		for (ALL_LIST_ELEMENTS(pe->entries, node2, node22, entry)) {
-			struct eigrp_fsm_action_message msg;
-
-			if (entry->adv_router != nbr)
-				continue;
-
-			memset(&msg, 0, sizeof(msg));
-			msg.metrics.delay = EIGRP_MAX_METRIC;
-			msg.packet_type = EIGRP_OPC_UPDATE;
-			msg.eigrp = eigrp;
-			msg.data_type = EIGRP_INT;
-			msg.adv_router = nbr;
-			msg.entry = entry;
-			msg.prefix = pe;
-			eigrp_fsm_event(&msg);
-		}
+		entry = eigrp_route_descriptor_lookup(eigrp, pe, nbr);
+		if (!entry)
+			continue;
+
+		memset(&msg, 0, sizeof(msg));
+		msg.metrics.delay = EIGRP_MAX_METRIC;
+		msg.packet_type = EIGRP_OPC_UPDATE;
+		msg.eigrp = eigrp;
+		msg.data_type = EIGRP_INT;
+		msg.adv_router = nbr;
+		msg.entry = entry;
+		msg.prefix = pe;
+		eigrp_fsm_event(&msg);
 	}
 
 	eigrp_query_send_all(eigrp);
@@ -34,6 +34,8 @@
 
 /* EIGRP Topology table related functions. */
 extern struct route_table *eigrp_topology_new(void);
+extern void eigrp_topology_index_init(struct eigrp *eigrp);
+extern void eigrp_topology_index_fini(struct eigrp *eigrp);
 extern void eigrp_topology_init(struct route_table *table);
 extern struct eigrp_prefix_descriptor *eigrp_prefix_descriptor_new(void);
 extern struct eigrp_route_descriptor *eigrp_route_descriptor_new(void);
@@ -59,7 +61,12 @@ extern struct list *
 eigrp_topology_get_successor_max(struct eigrp_prefix_descriptor *pe,
 				 unsigned int maxpaths);
 extern struct eigrp_route_descriptor *
-eigrp_route_descriptor_lookup(struct list *entries,
+eigrp_topology_get_first_successor(struct eigrp_prefix_descriptor *pe);
+extern unsigned int
+eigrp_topology_successor_count(struct eigrp_prefix_descriptor *pe);
+extern struct eigrp_route_descriptor *
+eigrp_route_descriptor_lookup(struct eigrp *eigrp,
+			      struct eigrp_prefix_descriptor *pe,
 			      struct eigrp_neighbor *neigh);
 extern struct list *eigrp_neighbor_prefixes_lookup(struct eigrp *eigrp,
 						   struct eigrp_neighbor *n);
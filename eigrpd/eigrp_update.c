@@ -152,7 +152,8 @@ static void eigrp_update_receive_GR_ask(struct eigrp *eigrp,
 		fsm_msg.metrics.delay = EIGRP_MAX_METRIC;
 
 		struct eigrp_route_descriptor *entry =
-			eigrp_route_descriptor_lookup(prefix->entries, nbr);
+			eigrp_route_descriptor_lookup(eigrp, prefix,
+						      nbr);
 
 		fsm_msg.packet_type = EIGRP_OPC_UPDATE;
 		fsm_msg.eigrp = eigrp;
@@ -322,7 +323,7 @@ void eigrp_update_receive(struct eigrp *eigrp, struct ip *iph,
 				struct eigrp_fsm_action_message msg;
 				struct eigrp_route_descriptor *entry =
 					eigrp_route_descriptor_lookup(
-						dest->entries, nbr);
+						eigrp, dest, nbr);
 
 				msg.packet_type = EIGRP_OPC_UPDATE;
 				msg.eigrp = eigrp;
@@ -842,7 +843,8 @@ static void eigrp_update_send_GR_part(struct eigrp_neighbor *nbr)
 			struct eigrp_fsm_action_message fsm_msg;
 
 			struct eigrp_route_descriptor *entry =
-				eigrp_route_descriptor_lookup(pe->entries, nbr);
+				eigrp_route_descriptor_lookup(eigrp, pe,
+							      nbr);
 
 			fsm_msg.packet_type = EIGRP_OPC_UPDATE;
 			fsm_msg.eigrp = eigrp;
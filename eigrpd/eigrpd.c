@@ -173,6 +173,7 @@ static struct eigrp *eigrp_new(uint16_t as, vrf_id_t vrf_id)
 	eigrp->oi_write_q = list_new();
 
 	eigrp->topology_table = route_table_init();
+	eigrp_topology_index_init(eigrp);
 
 	eigrp->neighbor_self = eigrp_nbr_new(NULL);
 	eigrp->neighbor_self->src.s_addr = INADDR_ANY;
@@ -280,6 +281,7 @@ void eigrp_finish_final(struct eigrp *eigrp)
 	list_delete(&eigrp->oi_write_q);
 
 	eigrp_topology_free(eigrp, eigrp->topology_table);
+	eigrp_topology_index_fini(eigrp);
 
 	eigrp_nbr_delete(eigrp->neighbor_self);
 
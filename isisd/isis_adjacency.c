@@ -31,6 +31,7 @@
 #include "thread.h"
 #include "if.h"
 #include "stream.h"
+#include "hello_thread.h"
 
 #include "isisd/isis_constants.h"
 #include "isisd/isis_common.h"
@@ -157,7 +158,7 @@ void isis_delete_adj(void *arg)
 	/* Remove self from snmp list without walking the list*/
 	list_delete_node(adj->circuit->snmp_adj_list, adj->snmp_list_node);
 
-	thread_cancel(&adj->t_expire);
+	hello_hold_free(&adj->hold);
 	if (adj->adj_state != ISIS_ADJ_DOWN)
 		adj->adj_state = ISIS_ADJ_DOWN;
 
@@ -435,21 +436,25 @@ const char *isis_adj_yang_state(enum isis_adj_state state)
 	}
 }
 
-int isis_adj_expire(struct thread *thread)
+static void isis_adj_expire(void *arg)
 {
-	struct isis_adjacency *adj;
-
-	/*
-	 * Get the adjacency
-	 */
-	adj = THREAD_ARG(thread);
-	assert(adj);
-	adj->t_expire = NULL;
+	struct isis_adjacency *adj = arg;
 
 	/* trigger the adj expire event */
 	isis_adj_state_change(&adj, ISIS_ADJ_DOWN, "holding time expired");
+}
 
-	return 0;
+/*
+ * (Re)start the holding timer.  It runs on the hello pthread, so that it
+ * doesn't expire just because IIHs are stuck behind a long task on the main
+ * pthread.
+ */
+void isis_adj_hold_refresh(struct isis_adjacency *adj)
+{
+	if (!adj->hold)
+		adj->hold = hello_hold_new(isis_adj_expire, adj);
+
+	hello_hold_refresh(adj->hold, adj->hold_time * 1000);
 }
 
 /*
@@ -99,7 +99,7 @@ struct isis_adjacency {
 	enum isis_threeway_state threeway_state;
 	uint32_t ext_circuit_id;
 	int flaps;		      /* number of adjacency flaps  */
-	struct thread *t_expire;      /* expire after hold_time  */
+	struct hello_hold *hold;      /* expire after hold_time  */
 	struct isis_circuit *circuit; /* back pointer */
 	uint16_t *mt_set;      /* Topologies this adjacency is valid for */
 	unsigned int mt_count; /* Number of entries in mt_set */
@@ -135,7 +135,7 @@ void isis_adj_state_change(struct isis_adjacency **adj,
 			   enum isis_adj_state state, const char *reason);
 void isis_adj_print(struct isis_adjacency *adj);
 const char *isis_adj_yang_state(enum isis_adj_state state);
-int isis_adj_expire(struct thread *thread);
+void isis_adj_hold_refresh(struct isis_adjacency *adj);
 void isis_adj_print_vty(struct isis_adjacency *adj, struct vty *vty,
 			char detail);
 void isis_adj_build_neigh_list(struct list *adjdb, struct list *list);
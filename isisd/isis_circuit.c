@@ -903,6 +903,8 @@ void isis_circuit_down(struct isis_circuit *circuit)
 	circuit->snmp_adj_idx_gen = 0;
 
 	/* Cancel all active threads */
+	send_hello_stop(circuit, IS_LEVEL_1);
+	send_hello_stop(circuit, IS_LEVEL_2);
 	thread_cancel(&circuit->t_send_csnp[0]);
 	thread_cancel(&circuit->t_send_csnp[1]);
 	thread_cancel(&circuit->t_send_psnp[0]);
@@ -35,6 +35,7 @@
 DECLARE_HOOK(isis_if_new_hook, (struct interface *ifp), (ifp));
 
 struct isis_lsp;
+struct hello_tx;
 
 struct password {
 	struct password *next;
@@ -101,6 +102,10 @@ struct isis_circuit {
 	struct stream *rcv_stream; /* Stream for receiving */
 	int (*tx)(struct isis_circuit *circuit, int level);
 	struct stream *snd_stream; /* Stream for sending */
+	/* hand the IIH in snd_stream to the hello pthread, if supported */
+	int (*tx_hello)(struct isis_circuit *circuit, int level,
+			struct hello_tx *tx, bool send_now);
+	struct hello_tx *hello_tx[ISIS_LEVELS]; /* periodic IIHs */
 	int idx;		   /* idx in S[RM|SN] flags */
 #define CIRCUIT_T_UNKNOWN    0
 #define CIRCUIT_T_BROADCAST  1
@@ -64,6 +64,8 @@
 #define MIN_LSP_LIFETIME              350
 #define MAX_LSP_LIFETIME              65535
 #define DEFAULT_LSP_LIFETIME          1200
+/* RFC 4444: refresh LSPs at least this long before they expire */
+#define LSP_REFRESH_MARGIN            300
 
 #define MIN_MAX_LSP_GEN_INTERVAL      1
 #define MAX_MAX_LSP_GEN_INTERVAL      65235
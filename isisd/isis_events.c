@@ -114,6 +114,7 @@ static void circuit_resign_level(struct isis_circuit *circuit, int level)
 
 	if (circuit->circ_type == CIRCUIT_T_BROADCAST) {
 		thread_cancel(&circuit->u.bc.t_send_lan_hello[idx]);
+		send_hello_stop(circuit, level);
 		thread_cancel(&circuit->u.bc.t_run_dr[idx]);
 		thread_cancel(&circuit->u.bc.t_refresh_pseudo_lsp[idx]);
 		circuit->lsp_regenerate_pending[idx] = 0;
@@ -33,6 +33,7 @@
 #include "prefix.h"
 #include "command.h"
 #include "hash.h"
+#include "jhash.h"
 #include "if.h"
 #include "checksum.h"
 #include "md5.h"
@@ -90,6 +91,56 @@ void lsp_db_fini(struct lspdb_head *head)
 	lspdb_fini(head);
 }
 
+/*
+ * Fragment each redistributed prefix was last put in, so that a change to
+ * one prefix only affects the fragment carrying it.
+ */
+#define LSP_FRAG_NONE 0xffff
+
+struct lsp_frag_map_entry {
+	struct lspfragmap_item item;
+
+	struct prefix p;
+	struct prefix_ipv6 src_p; /* zero unless source-specific */
+
+	uint16_t frag;
+	/* only valid while building */
+	bool seen;
+	struct route_node *rn;
+};
+
+static int lspfragmap_cmp(const struct lsp_frag_map_entry *a,
+			  const struct lsp_frag_map_entry *b)
+{
+	int ret = prefix_cmp(&a->p, &b->p);
+
+	if (ret)
+		return ret;
+	return memcmp(&a->src_p, &b->src_p, sizeof(a->src_p));
+}
+
+static uint32_t lspfragmap_hash(const struct lsp_frag_map_entry *e)
+{
+	return jhash(&e->src_p, sizeof(e->src_p), prefix_hash_key(&e->p));
+}
+
+DECLARE_HASH(lspfragmap, struct lsp_frag_map_entry, item, lspfragmap_cmp,
+	     lspfragmap_hash)
+
+void lsp_frag_map_init(struct lspfragmap_head *head)
+{
+	lspfragmap_init(head);
+}
+
+void lsp_frag_map_fini(struct lspfragmap_head *head)
+{
+	struct lsp_frag_map_entry *e;
+
+	while ((e = lspfragmap_pop(head)))
+		XFREE(MTYPE_ISIS_LSP_FRAG_MAP, e);
+	lspfragmap_fini(head);
+}
+
 struct isis_lsp *lsp_search(struct lspdb_head *head, const uint8_t *id)
 {
 	struct isis_lsp searchfor;
@@ -253,21 +304,12 @@ int lsp_compare(char *areatag, struct isis_lsp *lsp, uint32_t seqno,
 	return LSP_OLDER;
 }
 
-static void put_lsp_hdr(struct isis_lsp *lsp, size_t *len_pointer, bool keep)
+static void lsp_put_hdr(struct isis_lsp *lsp, struct stream *stream,
+			size_t *len_pointer)
 {
 	uint8_t pdu_type =
 		(lsp->level == IS_LEVEL_1) ? L1_LINK_STATE : L2_LINK_STATE;
 	struct isis_lsp_hdr *hdr = &lsp->hdr;
-	struct stream *stream = lsp->pdu;
-	size_t orig_getp = 0, orig_endp = 0;
-
-	if (keep) {
-		orig_getp = stream_get_getp(lsp->pdu);
-		orig_endp = stream_get_endp(lsp->pdu);
-	}
-
-	stream_set_getp(lsp->pdu, 0);
-	stream_set_endp(lsp->pdu, 0);
 
 	fill_fixed_hdr(pdu_type, stream);
 
@@ -279,6 +321,21 @@ static void put_lsp_hdr(struct isis_lsp *lsp, size_t *len_pointer, bool keep)
 	stream_putl(stream, hdr->seqno);
 	stream_putw(stream, hdr->checksum);
 	stream_putc(stream, hdr->lsp_bits);
+}
+
+static void put_lsp_hdr(struct isis_lsp *lsp, size_t *len_pointer, bool keep)
+{
+	size_t orig_getp = 0, orig_endp = 0;
+
+	if (keep) {
+		orig_getp = stream_get_getp(lsp->pdu);
+		orig_endp = stream_get_endp(lsp->pdu);
+	}
+
+	stream_set_getp(lsp->pdu, 0);
+	stream_set_endp(lsp->pdu, 0);
+
+	lsp_put_hdr(lsp, lsp->pdu, len_pointer);
 
 	if (keep) {
 		stream_set_endp(lsp->pdu, orig_endp);
@@ -286,29 +343,87 @@ static void put_lsp_hdr(struct isis_lsp *lsp, size_t *len_pointer, bool keep)
 	}
 }
 
-static void lsp_add_auth(struct isis_lsp *lsp)
+static void lsp_add_auth(struct isis_lsp *lsp, struct isis_tlvs *tlvs)
 {
 	struct isis_passwd *passwd;
 	passwd = (lsp->level == IS_LEVEL_1) ? &lsp->area->area_passwd
 					    : &lsp->area->domain_passwd;
-	isis_tlvs_add_auth(lsp->tlvs, passwd);
+	isis_tlvs_add_auth(tlvs, passwd);
+}
+
+/* Pack tlvs behind lsp's header, returns nonzero if they don't fit */
+static int lsp_pack_into(struct isis_lsp *lsp, struct isis_tlvs *tlvs,
+			 struct stream *stream)
+{
+	size_t len_pointer;
+	int ret;
+
+	lsp_add_auth(lsp, tlvs);
+
+	stream_reset(stream);
+	lsp_put_hdr(lsp, stream, &len_pointer);
+	ret = isis_pack_tlvs(tlvs, stream, len_pointer, false, true);
+	fletcher_checksum(STREAM_DATA(stream) + 12,
+			  stream_get_endp(stream) - 12, 12);
+
+	return ret;
 }
 
-static void lsp_pack_pdu(struct isis_lsp *lsp)
+/* TLV area of the LSP's PDU, empty if there is none */
+static void lsp_tlvs_data(struct isis_lsp *lsp, struct isis_tlvs_view *view)
+{
+	size_t hdr_len = ISIS_FIXED_HDR_LEN + ISIS_LSP_HDR_LEN;
+	size_t len;
+
+	len = lsp->pdu ? MIN(lsp->hdr.pdu_len, stream_get_endp(lsp->pdu)) : 0;
+	if (len < hdr_len) {
+		view->data = NULL;
+		view->len = 0;
+		return;
+	}
+
+	view->data = STREAM_DATA(lsp->pdu) + hdr_len;
+	view->len = len - hdr_len;
+}
+
+/*
+ * Called whenever a new PDU is stored, so SPF doesn't have to validate the
+ * TLVs again each time it walks the LSP.
+ */
+static void lsp_tlvs_view_check(struct isis_lsp *lsp)
+{
+	struct isis_tlvs_view view;
+
+	lsp_tlvs_data(lsp, &view);
+	lsp->tlvs_invalid = !!isis_tlvs_view_init(&view, view.data, view.len);
+}
+
+/*
+ * In-place view of the TLVs in the LSP's PDU.  The PDU was validated by
+ * isis_tlvs_view_init() when it was stored; fails if that check did.
+ */
+int lsp_tlvs_view(struct isis_lsp *lsp, struct isis_tlvs_view *view)
+{
+	if (lsp->tlvs_invalid) {
+		view->data = NULL;
+		view->len = 0;
+		return 1;
+	}
+
+	lsp_tlvs_data(lsp, view);
+	return 0;
+}
+
+void lsp_pack_pdu(struct isis_lsp *lsp)
 {
 	if (!lsp->tlvs)
 		lsp->tlvs = isis_alloc_tlvs();
 
-	lsp_add_auth(lsp);
-
-	size_t len_pointer;
-	put_lsp_hdr(lsp, &len_pointer, false);
-	isis_pack_tlvs(lsp->tlvs, lsp->pdu, len_pointer, false, true);
+	lsp_pack_into(lsp, lsp->tlvs, lsp->pdu);
 
 	lsp->hdr.pdu_len = stream_get_endp(lsp->pdu);
-	lsp->hdr.checksum =
-		ntohs(fletcher_checksum(STREAM_DATA(lsp->pdu) + 12,
-					stream_get_endp(lsp->pdu) - 12, 12));
+	lsp->hdr.checksum = ntohs(stream_getw_from(lsp->pdu, 24));
+	lsp_tlvs_view_check(lsp);
 }
 
 void lsp_inc_seqno(struct isis_lsp *lsp, uint32_t seqno)
@@ -330,6 +445,7 @@ void lsp_inc_seqno(struct isis_lsp *lsp, uint32_t seqno)
 #endif /* ifndef FABRICD */
 
 	lsp->hdr.seqno = newseq;
+	lsp->changed = false;
 
 	lsp_pack_pdu(lsp);
 	isis_spf_schedule(lsp->area, lsp->level);
@@ -522,6 +638,7 @@ static void lsp_update_data(struct isis_lsp *lsp, struct isis_lsp_hdr *hdr,
 	lsp->pdu = stream_dup(stream);
 
 	memcpy(&lsp->hdr, hdr, sizeof(lsp->hdr));
+	lsp_tlvs_view_check(lsp);
 	lsp->area = area;
 	lsp->level = level;
 	lsp->age_out = ZERO_AGE_LIFETIME;
@@ -805,7 +922,8 @@ static uint16_t lsp_rem_lifetime(struct isis_area *area, int level)
 	/* N.B. this calucation is acceptable since rem_lifetime is in
 	 * [332,65535] at
 	 * this point */
-	if (area->lsp_gen_interval[level - 1] > (rem_lifetime - 300))
+	if (area->lsp_gen_interval[level - 1]
+	    > (rem_lifetime - LSP_REFRESH_MARGIN))
 		rem_lifetime = area->max_lsp_lifetime[level - 1];
 
 	return rem_lifetime;
@@ -824,8 +942,8 @@ static uint16_t lsp_refresh_time(struct isis_lsp *lsp, uint16_t rem_lifetime)
 	/* RFC 4444 : make sure the refresh time is at least less than 300
 	 * of the remaining lifetime and more than gen interval */
 	if (refresh_time <= area->lsp_gen_interval[level - 1]
-	    || refresh_time > (rem_lifetime - 300))
-		refresh_time = rem_lifetime - 300;
+	    || refresh_time > (rem_lifetime - LSP_REFRESH_MARGIN))
+		refresh_time = rem_lifetime - LSP_REFRESH_MARGIN;
 
 	/* In cornercases, refresh_time might be <= lsp_gen_interval, however
 	 * we accept this violation to satisfy refresh_time <= rem_lifetime -
@@ -834,85 +952,244 @@ static uint16_t lsp_refresh_time(struct isis_lsp *lsp, uint16_t rem_lifetime)
 	return refresh_time;
 }
 
-static void lsp_build_ext_reach_ipv4(struct isis_lsp *lsp,
-				     struct isis_area *area)
+static void lsp_build_ext_reach_ipv4(struct isis_area *area,
+				     struct route_node *rn,
+				     struct isis_tlvs *tlvs)
 {
-	struct route_table *er_table = get_ext_reach(area, AF_INET, lsp->level);
-	if (!er_table)
-		return;
+	struct prefix_ipv4 *ipv4 = (struct prefix_ipv4 *)&rn->p;
+	struct isis_ext_info *info = rn->info;
 
-	for (struct route_node *rn = route_top(er_table); rn;
-	     rn = route_next(rn)) {
-		if (!rn->info)
-			continue;
+	uint32_t metric = info->metric;
+	if (metric > MAX_WIDE_PATH_METRIC)
+		metric = MAX_WIDE_PATH_METRIC;
+	if (area->oldmetric && metric > 0x3f)
+		metric = 0x3f;
 
-		struct prefix_ipv4 *ipv4 = (struct prefix_ipv4 *)&rn->p;
-		struct isis_ext_info *info = rn->info;
+	if (area->oldmetric)
+		isis_tlvs_add_oldstyle_ip_reach(tlvs, ipv4, metric);
+	if (area->newmetric) {
+		struct sr_prefix_cfg *pcfg = NULL;
 
-		uint32_t metric = info->metric;
-		if (metric > MAX_WIDE_PATH_METRIC)
-			metric = MAX_WIDE_PATH_METRIC;
-		if (area->oldmetric && metric > 0x3f)
-			metric = 0x3f;
+		if (area->srdb.enabled)
+			pcfg = isis_sr_cfg_prefix_find(area, ipv4);
 
-		if (area->oldmetric)
-			isis_tlvs_add_oldstyle_ip_reach(lsp->tlvs, ipv4,
-							metric);
-		if (area->newmetric) {
-			struct sr_prefix_cfg *pcfg = NULL;
+		isis_tlvs_add_extended_ip_reach(tlvs, ipv4, metric, true,
+						pcfg);
+	}
+}
 
-			if (area->srdb.enabled)
-				pcfg = isis_sr_cfg_prefix_find(area, ipv4);
+static void lsp_build_ext_reach_ipv6(struct isis_area *area,
+				     struct route_node *rn,
+				     struct isis_tlvs *tlvs)
+{
+	struct isis_ext_info *info = rn->info;
+	struct prefix_ipv6 *p, *src_p;
 
-			isis_tlvs_add_extended_ip_reach(lsp->tlvs, ipv4, metric,
-							true, pcfg);
-		}
+	srcdest_rnode_prefixes(rn, (const struct prefix **)&p,
+			       (const struct prefix **)&src_p);
+
+	uint32_t metric = info->metric;
+	if (info->metric > MAX_WIDE_PATH_METRIC)
+		metric = MAX_WIDE_PATH_METRIC;
+
+	if (!src_p || !src_p->prefixlen) {
+		struct sr_prefix_cfg *pcfg = NULL;
+
+		if (area->srdb.enabled)
+			pcfg = isis_sr_cfg_prefix_find(area, p);
+
+		isis_tlvs_add_ipv6_reach(tlvs, isis_area_ipv6_topology(area),
+					 p, metric, true, pcfg);
+	} else if (isis_area_ipv6_dstsrc_enabled(area)) {
+		isis_tlvs_add_ipv6_dstsrc_reach(tlvs, ISIS_MT_IPV6_DSTSRC, p,
+						src_p, metric);
 	}
 }
 
-static void lsp_build_ext_reach_ipv6(struct isis_lsp *lsp,
-				     struct isis_area *area)
+static void lsp_build_ext_reach_entry(struct isis_area *area,
+				      struct lsp_frag_map_entry *e,
+				      struct isis_tlvs *tlvs)
 {
-	struct route_table *er_table =
-		get_ext_reach(area, AF_INET6, lsp->level);
-	if (!er_table)
-		return;
+	if (e->p.family == AF_INET)
+		lsp_build_ext_reach_ipv4(area, e->rn, tlvs);
+	else
+		lsp_build_ext_reach_ipv6(area, e->rn, tlvs);
+}
+
+/* Packed size of tlvs, false if they don't fit into stream */
+static bool lsp_tlvs_fit(struct isis_tlvs *tlvs, struct stream *stream,
+			 size_t *size)
+{
+	stream_reset(stream);
+	if (isis_pack_tlvs(tlvs, stream, (size_t)-1, false, true))
+		return false;
+
+	*size = stream_get_endp(stream);
+	return true;
+}
+
+/*
+ * Add our redistributed prefixes to frags, which start out as copies of the
+ * rest of the LSP's contents in base[0..nb_base-1].  Prefixes stay in the
+ * fragment they were put in last time, unless it overflows; only new prefixes
+ * and those evicted from an overflowing fragment are placed again, into the
+ * first fragment with enough room.  So a prefix change only modifies the
+ * fragment carrying that prefix, and others pack to the same PDU as before.
+ */
+static void lsp_build_ext_reach(struct isis_lsp *lsp, struct isis_area *area,
+				struct isis_tlvs **frags,
+				struct isis_tlvs **base, size_t nb_base,
+				size_t tlv_space)
+{
+	static const int families[] = {AF_INET, AF_INET6};
+	struct lspfragmap_head *map = &area->lsp_frag_map[lsp->level - 1];
+	struct lsp_frag_map_entry *e, lookup;
+	struct list *entries = list_new();
+	struct stream *stream = stream_new(tlv_space);
+	struct listnode *node;
+	size_t used[256] = {};
+	bool touched[256] = {};
+	bool fragment_overflow = false;
+	size_t size;
+
+	/* Put every known prefix back into its fragment */
+	for (size_t i = 0; i < array_size(families); i++) {
+		struct route_table *er_table =
+			get_ext_reach(area, families[i], lsp->level);
+		if (!er_table)
+			continue;
 
-	for (struct route_node *rn = route_top(er_table); rn;
-	     rn = srcdest_route_next(rn)) {
-		if (!rn->info)
+		for (struct route_node *rn = route_top(er_table); rn;
+		     rn = srcdest_route_next(rn)) {
+			const struct prefix *p, *src_p;
+
+			if (!rn->info)
+				continue;
+
+			srcdest_rnode_prefixes(rn, &p, &src_p);
+			memset(&lookup, 0, sizeof(lookup));
+			prefix_copy(&lookup.p, p);
+			if (src_p && src_p->prefixlen)
+				prefix_copy(&lookup.src_p, src_p);
+
+			e = lspfragmap_find(map, &lookup);
+			if (!e) {
+				e = XCALLOC(MTYPE_ISIS_LSP_FRAG_MAP,
+					    sizeof(*e));
+				e->p = lookup.p;
+				e->src_p = lookup.src_p;
+				e->frag = LSP_FRAG_NONE;
+				lspfragmap_add(map, e);
+			}
+			e->seen = true;
+			e->rn = rn;
+			listnode_add(entries, e);
+
+			if (e->frag == LSP_FRAG_NONE)
+				continue;
+			if (!frags[e->frag])
+				frags[e->frag] = isis_alloc_tlvs();
+			lsp_build_ext_reach_entry(area, e, frags[e->frag]);
+		}
+	}
+
+	/*
+	 * Fragments that no longer fit (prefixes got bigger, the rest of the
+	 * LSP grew, MTU shrank) give up all of their redistributed prefixes.
+	 */
+	for (size_t f = 0; f < 256; f++) {
+		if (!frags[f] || lsp_tlvs_fit(frags[f], stream, &used[f]))
+			continue;
+
+		isis_free_tlvs(frags[f]);
+		frags[f] = NULL;
+		used[f] = 0;
+		if (f < nb_base) {
+			frags[f] = isis_copy_tlvs(base[f]);
+			lsp_tlvs_fit(frags[f], stream, &used[f]);
+		}
+		for (ALL_LIST_ELEMENTS_RO(entries, node, e)) {
+			if (e->frag == f)
+				e->frag = LSP_FRAG_NONE;
+		}
+	}
+
+	/* Place new and evicted prefixes */
+	for (ALL_LIST_ELEMENTS_RO(entries, node, e)) {
+		struct isis_tlvs *tlvs;
+		size_t f;
+
+		if (e->frag != LSP_FRAG_NONE)
 			continue;
-		struct isis_ext_info *info = rn->info;
-		struct prefix_ipv6 *p, *src_p;
 
-		srcdest_rnode_prefixes(rn, (const struct prefix **)&p,
-				       (const struct prefix **)&src_p);
+		/*
+		 * A prefix on its own, TLV headers included, is an upper
+		 * bound for what it adds to a fragment.
+		 */
+		tlvs = isis_alloc_tlvs();
+		lsp_build_ext_reach_entry(area, e, tlvs);
+		if (!lsp_tlvs_fit(tlvs, stream, &size))
+			size = tlv_space + 1;
+		isis_free_tlvs(tlvs);
+		if (!size)
+			continue;
 
-		uint32_t metric = info->metric;
-		if (info->metric > MAX_WIDE_PATH_METRIC)
-			metric = MAX_WIDE_PATH_METRIC;
+		for (f = 0; f < 256; f++) {
+			if (frags[f] && used[f] + size <= tlv_space)
+				break;
+		}
+		if (f == 256) {
+			for (f = 0; f < 256; f++) {
+				if (!frags[f])
+					break;
+			}
+		}
+		if (f == 256 || size > tlv_space) {
+			if (!fragment_overflow) {
+				fragment_overflow = true;
+				zlog_warn(
+					"ISIS (%s): Too much information for 256 fragments",
+					area->area_tag);
+			}
+			continue;
+		}
 
-		if (!src_p || !src_p->prefixlen) {
-			struct sr_prefix_cfg *pcfg = NULL;
+		if (!frags[f])
+			frags[f] = isis_alloc_tlvs();
+		used[f] += size;
+		touched[f] = true;
+		e->frag = f;
+	}
 
-			if (area->srdb.enabled)
-				pcfg = isis_sr_cfg_prefix_find(area, p);
+	/*
+	 * Build the fragments that got new prefixes once more, so their
+	 * contents are in table order and pack the same way next time.
+	 */
+	for (size_t f = 0; f < 256; f++) {
+		if (!touched[f])
+			continue;
+		isis_free_tlvs(frags[f]);
+		frags[f] = (f < nb_base) ? isis_copy_tlvs(base[f])
+					  : isis_alloc_tlvs();
+	}
+	for (ALL_LIST_ELEMENTS_RO(entries, node, e)) {
+		if (e->frag != LSP_FRAG_NONE && touched[e->frag])
+			lsp_build_ext_reach_entry(area, e, frags[e->frag]);
+	}
 
-			isis_tlvs_add_ipv6_reach(lsp->tlvs,
-						 isis_area_ipv6_topology(area),
-						 p, metric, true, pcfg);
-		} else if (isis_area_ipv6_dstsrc_enabled(area)) {
-			isis_tlvs_add_ipv6_dstsrc_reach(lsp->tlvs,
-							ISIS_MT_IPV6_DSTSRC,
-							p, src_p, metric);
+	/* Forget prefixes that are gone */
+	frr_each_safe (lspfragmap, map, e) {
+		if (e->seen) {
+			e->seen = false;
+			e->rn = NULL;
+			continue;
 		}
+		lspfragmap_del(map, e);
+		XFREE(MTYPE_ISIS_LSP_FRAG_MAP, e);
 	}
-}
 
-static void lsp_build_ext_reach(struct isis_lsp *lsp, struct isis_area *area)
-{
-	lsp_build_ext_reach_ipv4(lsp, area);
-	lsp_build_ext_reach_ipv6(lsp, area);
+	stream_free(stream);
+	list_delete(&entries);
 }
 
 static struct isis_lsp *lsp_next_frag(uint8_t frag_num, struct isis_lsp *lsp0,
@@ -926,7 +1203,6 @@ static struct isis_lsp *lsp_next_frag(uint8_t frag_num, struct isis_lsp *lsp0,
 
 	lsp = lsp_search(&area->lspdb[level - 1], frag_id);
 	if (lsp) {
-		lsp_clear_data(lsp);
 		if (!lsp->lspu.zero_lsp)
 			lsp_link_fragment(lsp, lsp0);
 		return lsp;
@@ -941,19 +1217,48 @@ static struct isis_lsp *lsp_next_frag(uint8_t frag_num, struct isis_lsp *lsp0,
 	return lsp;
 }
 
+/*
+ * Give lsp the contents tlvs, unless they'd pack to the same PDU as before.
+ * Sets lsp->changed accordingly.
+ */
+static void lsp_set_tlvs(struct isis_lsp *lsp, struct isis_tlvs *tlvs,
+			 struct stream *stream)
+{
+	size_t len;
+
+	lsp_adjust_stream(lsp);
+
+	lsp->changed = true;
+	if (lsp->tlvs && !lsp_pack_into(lsp, tlvs, stream)) {
+		len = stream_get_endp(stream);
+
+		/* everything but the remaining lifetime */
+		if (len == stream_get_endp(lsp->pdu)
+		    && !memcmp(STREAM_DATA(stream), STREAM_DATA(lsp->pdu), 10)
+		    && !memcmp(STREAM_DATA(stream) + 12,
+			       STREAM_DATA(lsp->pdu) + 12, len - 12))
+			lsp->changed = false;
+	}
+
+	if (lsp->changed) {
+		lsp_clear_data(lsp);
+		lsp->tlvs = tlvs;
+	} else {
+		isis_free_tlvs(tlvs);
+	}
+}
+
 /*
  * Builds the LSP data part. This func creates a new frag whenever
- * area->lsp_frag_threshold is exceeded.
+ * area->lsp_frag_threshold is exceeded. Fragments whose contents didn't
+ * change keep their data and PDU, the others are marked as changed.
  */
 static void lsp_build(struct isis_lsp *lsp, struct isis_area *area)
 {
 	int level = lsp->level;
 	struct listnode *node;
 	struct isis_lsp *frag;
-
-	lsp_clear_data(lsp);
-	for (ALL_LIST_ELEMENTS_RO(lsp->lspu.frags, node, frag))
-		lsp_clear_data(frag);
+	struct isis_tlvs *old_tlvs = lsp->tlvs;
 
 	lsp->tlvs = isis_alloc_tlvs();
 	lsp_debug("ISIS (%s): Constructing local system LSP for level %d",
@@ -962,7 +1267,7 @@ static void lsp_build(struct isis_lsp *lsp, struct isis_area *area)
 	lsp->hdr.lsp_bits = lsp_bits_generate(level, area->overload_bit,
 					      area->attached_bit_send, area);
 
-	lsp_add_auth(lsp);
+	lsp_add_auth(lsp, lsp->tlvs);
 
 	isis_tlvs_add_area_addresses(lsp->tlvs, area->area_addrs);
 
@@ -1245,15 +1550,15 @@ static void lsp_build(struct isis_lsp *lsp, struct isis_area *area)
 		}
 	}
 
-	lsp_build_ext_reach(lsp, area);
-
 	struct isis_tlvs *tlvs = lsp->tlvs;
-	lsp->tlvs = NULL;
+	lsp->tlvs = old_tlvs;
 
 	lsp_adjust_stream(lsp);
-	lsp_pack_pdu(lsp);
-	size_t tlv_space = STREAM_WRITEABLE(lsp->pdu) - LLC_LEN;
-	lsp_clear_data(lsp);
+	struct stream *stream = stream_new(STREAM_SIZE(lsp->pdu));
+	struct isis_tlvs *empty = isis_alloc_tlvs();
+	lsp_pack_into(lsp, empty, stream);
+	isis_free_tlvs(empty);
+	size_t tlv_space = STREAM_WRITEABLE(stream) - LLC_LEN;
 
 	struct list *fragments = isis_fragment_tlvs(tlvs, tlv_space);
 	if (!fragments) {
@@ -1261,33 +1566,51 @@ static void lsp_build(struct isis_lsp *lsp, struct isis_area *area)
 		log_multiline(LOG_WARNING, "    ", "%s",
 			      isis_format_tlvs(tlvs));
 		isis_free_tlvs(tlvs);
+		stream_free(stream);
 		return;
 	}
 	isis_free_tlvs(tlvs);
 
+	struct isis_tlvs *base[256] = {}, *frags[256] = {};
+	size_t nb_base = 0;
 	bool fragment_overflow = false;
-	frag = lsp;
 	for (ALL_LIST_ELEMENTS_RO(fragments, node, tlvs)) {
-		if (node != listhead(fragments)) {
-			if (LSP_FRAGMENT(frag->hdr.lsp_id) == 255) {
-				if (!fragment_overflow) {
-					fragment_overflow = true;
-					zlog_warn(
-						"ISIS (%s): Too much information for 256 fragments",
-						area->area_tag);
-				}
-				isis_free_tlvs(tlvs);
-				continue;
+		if (nb_base == array_size(base)) {
+			if (!fragment_overflow) {
+				fragment_overflow = true;
+				zlog_warn(
+					"ISIS (%s): Too much information for 256 fragments",
+					area->area_tag);
 			}
-
-			frag = lsp_next_frag(LSP_FRAGMENT(frag->hdr.lsp_id) + 1,
-					     lsp, area, level);
-			lsp_adjust_stream(frag);
+			isis_free_tlvs(tlvs);
+			continue;
 		}
-		frag->tlvs = tlvs;
+		base[nb_base] = tlvs;
+		frags[nb_base] = isis_copy_tlvs(tlvs);
+		nb_base++;
 	}
-
 	list_delete(&fragments);
+
+	lsp_build_ext_reach(lsp, area, frags, base, nb_base, tlv_space);
+
+	for (ALL_LIST_ELEMENTS_RO(lsp->lspu.frags, node, frag)) {
+		if (!frags[LSP_FRAGMENT(frag->hdr.lsp_id)])
+			lsp_clear_data(frag);
+	}
+
+	if (!frags[0])
+		frags[0] = isis_alloc_tlvs();
+	for (size_t i = 0; i < array_size(frags); i++) {
+		isis_free_tlvs(base[i]);
+		if (!frags[i])
+			continue;
+
+		frag = i ? lsp_next_frag(i, lsp, area, level) : lsp;
+		frag->hdr.lsp_bits = lsp->hdr.lsp_bits;
+		lsp_set_tlvs(frag, frags[i], stream);
+	}
+
+	stream_free(stream);
 	lsp_debug("ISIS (%s): LSP construction is complete. Serializing...",
 		  area->area_tag);
 	return;
@@ -1365,7 +1688,32 @@ int lsp_generate(struct isis_area *area, int level)
 }
 
 /*
- * Search own LSPs, update holding time and flood
+ * Reoriginate a fragment of our own LSP if its contents changed, or if it
+ * would need a refresh before half of the refresh interval has passed
+ * anyway.  Returns the number of seconds until it needs to be refreshed.
+ */
+static uint16_t lsp_regenerate_frag(struct isis_lsp *lsp, uint16_t rem_lifetime,
+				    uint16_t refresh_time, unsigned int *count)
+{
+	if (!lsp->changed
+	    && lsp->hdr.rem_lifetime >= LSP_REFRESH_MARGIN + refresh_time / 2)
+		return lsp->hdr.rem_lifetime - LSP_REFRESH_MARGIN;
+
+	/* Set the lifetime values of all the fragments to the same value,
+	 * so that no fragment expires before the lsp is refreshed.
+	 */
+	lsp->hdr.rem_lifetime = rem_lifetime;
+	lsp->age_out = ZERO_AGE_LIFETIME;
+	lsp->last_generated = time(NULL);
+	lsp_inc_seqno(lsp, 0);
+	lsp_flood(lsp, NULL);
+	(*count)++;
+
+	return refresh_time;
+}
+
+/*
+ * Search own LSPs, update holding time and flood the fragments that changed
  */
 static int lsp_regenerate(struct isis_area *area, int level)
 {
@@ -1373,7 +1721,8 @@ static int lsp_regenerate(struct isis_area *area, int level)
 	struct isis_lsp *lsp, *frag;
 	struct listnode *node;
 	uint8_t lspid[ISIS_SYS_ID_LEN + 2];
-	uint16_t rem_lifetime, refresh_time;
+	uint16_t rem_lifetime, refresh_time, next_refresh;
+	unsigned int count = 0;
 
 	if ((area == NULL) || (area->is_type & level) != level)
 		return ISIS_ERROR;
@@ -1391,46 +1740,40 @@ static int lsp_regenerate(struct isis_area *area, int level)
 		return ISIS_ERROR;
 	}
 
-	lsp_clear_data(lsp);
 	lsp_build(lsp, area);
 	rem_lifetime = lsp_rem_lifetime(area, level);
-	lsp->hdr.rem_lifetime = rem_lifetime;
-	lsp->last_generated = time(NULL);
-	lsp_flood(lsp, NULL);
+	refresh_time = lsp_refresh_time(lsp, rem_lifetime);
 	area->lsp_gen_count[level - 1]++;
+
+	next_refresh = lsp_regenerate_frag(lsp, rem_lifetime, refresh_time,
+					   &count);
 	for (ALL_LIST_ELEMENTS_RO(lsp->lspu.frags, node, frag)) {
 		if (!frag->tlvs) {
-			/* Updating and flooding should only affect fragments
-			 * carrying data
+			/* Purge should only be applied when the fragment has
+			 * non-zero remaining lifetime.
 			 */
+			if (frag->hdr.rem_lifetime)
+				lsp_purge(frag, level, NULL);
 			continue;
 		}
 
-		frag->hdr.lsp_bits =
-			lsp_bits_generate(level, area->overload_bit,
-					  area->attached_bit_send, area);
-		/* Set the lifetime values of all the fragments to the same
-		 * value,
-		 * so that no fragment expires before the lsp is refreshed.
-		 */
-		frag->hdr.rem_lifetime = rem_lifetime;
-		frag->age_out = ZERO_AGE_LIFETIME;
-		lsp_flood(frag, NULL);
+		next_refresh = MIN(next_refresh,
+				   lsp_regenerate_frag(frag, rem_lifetime,
+						       refresh_time, &count));
 	}
-	lsp_seqno_update(lsp);
 
-	refresh_time = lsp_refresh_time(lsp, rem_lifetime);
 	thread_add_timer(master, lsp_refresh,
-			 &area->lsp_refresh_arg[level - 1], refresh_time,
-			 &area->t_lsp_refresh[level - 1]);
+			 &area->lsp_refresh_arg[level - 1],
+			 MAX(next_refresh, 1), &area->t_lsp_refresh[level - 1]);
 	area->lsp_regenerate_pending[level - 1] = 0;
 
 	if (IS_DEBUG_UPDATE_PACKETS) {
 		zlog_debug(
-			"ISIS-Upd (%s): Refreshed our L%d LSP %s, len %hu, seq 0x%08x, cksum 0x%04hx, lifetime %hus refresh %hus",
+			"ISIS-Upd (%s): Refreshed our L%d LSP %s, len %hu, seq 0x%08x, cksum 0x%04hx, lifetime %hus refresh %hus, %u of %u fragments reoriginated",
 			area->area_tag, level, rawlspid_print(lsp->hdr.lsp_id),
 			lsp->hdr.pdu_len, lsp->hdr.seqno, lsp->hdr.checksum,
-			lsp->hdr.rem_lifetime, refresh_time);
+			lsp->hdr.rem_lifetime, next_refresh, count,
+			lsp->lspu.frags ? listcount(lsp->lspu.frags) + 1 : 1);
 	}
 	sched_debug(
 		"ISIS (%s): Rebuilt L%d LSP. Set triggered regenerate to non-pending.",
@@ -28,6 +28,7 @@
 #include "isisd/isis_pdu.h"
 
 PREDECL_RBTREE_UNIQ(lspdb)
+PREDECL_HASH(lspfragmap)
 
 struct isis;
 /* Structure for isis_lsp, this structure will only support the fixed
@@ -53,6 +54,10 @@ struct isis_lsp {
 	int age_out;
 	struct isis_area *area;
 	struct isis_tlvs *tlvs;
+	/* own LSP: contents differ from the last one originated */
+	bool changed;
+	/* PDU failed isis_tlvs_view_init() when it was stored */
+	bool tlvs_invalid;
 
 	time_t flooding_time;
 	struct list *flooding_neighbors[TX_LSP_CIRCUIT_SCOPED + 1];
@@ -65,6 +70,8 @@ DECLARE_RBTREE_UNIQ(lspdb, struct isis_lsp, dbe, lspdb_compare)
 
 void lsp_db_init(struct lspdb_head *head);
 void lsp_db_fini(struct lspdb_head *head);
+void lsp_frag_map_init(struct lspfragmap_head *head);
+void lsp_frag_map_fini(struct lspfragmap_head *head);
 int lsp_tick(struct thread *thread);
 
 int lsp_generate(struct isis_area *area, int level);
@@ -116,6 +123,7 @@ void lsp_update(struct isis_lsp *lsp, struct isis_lsp_hdr *hdr,
 		struct isis_tlvs *tlvs, struct stream *stream,
 		struct isis_area *area, int level, bool confusion);
 void lsp_inc_seqno(struct isis_lsp *lsp, uint32_t seqno);
+void lsp_pack_pdu(struct isis_lsp *lsp);
 void lspid_print(uint8_t *lsp_id, char *dest, size_t dest_len, char dynhost,
 		 char frag, struct isis *isis);
 void lsp_print(struct isis_lsp *lsp, struct vty *vty, char dynhost,
@@ -142,6 +150,13 @@ typedef int (*lsp_is_reach_iter_cb)(const uint8_t *id, uint32_t metric,
 				    struct isis_ext_subtlvs *subtlvs,
 				    void *arg);
 
+/*
+ * In-place view of the TLVs in the LSP's PDU, see isis_tlvs_view_init().
+ * The PDU is validated once when it is stored; the view is only valid until
+ * the PDU changes.
+ */
+struct isis_tlvs_view;
+int lsp_tlvs_view(struct isis_lsp *lsp, struct isis_tlvs_view *view);
 int isis_lsp_iterate_ip_reach(struct isis_lsp *lsp, int family, uint16_t mtid,
 			      lsp_ip_reach_iter_cb cb, void *arg);
 int isis_lsp_iterate_is_reach(struct isis_lsp *lsp, uint16_t mtid,
@@ -40,6 +40,7 @@
 #include "qobj.h"
 #include "libfrr.h"
 #include "routemap.h"
+#include "hello_thread.h"
 
 #include "isisd/isis_constants.h"
 #include "isisd/isis_common.h"
@@ -273,6 +274,8 @@ int main(int argc, char **argv, char **envp)
 	fabricd_init();
 
 	frr_config_fork();
+	/* after forking, since pthreads don't survive it */
+	hello_thread_start(master);
 	frr_run(master);
 
 	/* Not reached. */
@@ -44,6 +44,7 @@ DEFINE_MTYPE(ISISD, ISIS_DICT, "ISIS dictionary")
 DEFINE_MTYPE(ISISD, ISIS_DICT_NODE, "ISIS dictionary node")
 DEFINE_MTYPE(ISISD, ISIS_EXT_ROUTE, "ISIS redistributed route")
 DEFINE_MTYPE(ISISD, ISIS_EXT_INFO, "ISIS redistributed route info")
+DEFINE_MTYPE(ISISD, ISIS_LSP_FRAG_MAP, "ISIS LSP fragment map")
 DEFINE_MTYPE(ISISD, ISIS_MPLS_TE, "ISIS MPLS_TE parameters")
 DEFINE_MTYPE(ISISD, ISIS_ACL_NAME, "ISIS access-list name")
 DEFINE_MTYPE(ISISD, ISIS_PLIST_NAME, "ISIS prefix-list name")
@@ -43,6 +43,7 @@ DECLARE_MTYPE(ISIS_DICT)
 DECLARE_MTYPE(ISIS_DICT_NODE)
 DECLARE_MTYPE(ISIS_EXT_ROUTE)
 DECLARE_MTYPE(ISIS_EXT_INFO)
+DECLARE_MTYPE(ISIS_LSP_FRAG_MAP)
 DECLARE_MTYPE(ISIS_MPLS_TE)
 DECLARE_MTYPE(ISIS_ACL_NAME)
 DECLARE_MTYPE(ISIS_PLIST_NAME)
@@ -33,5 +33,9 @@ int isis_recv_pdu_bcast(struct isis_circuit *circuit, uint8_t *ssnpa);
 int isis_recv_pdu_p2p(struct isis_circuit *circuit, uint8_t *ssnpa);
 int isis_send_pdu_bcast(struct isis_circuit *circuit, int level);
 int isis_send_pdu_p2p(struct isis_circuit *circuit, int level);
+int isis_tx_hello_bcast(struct isis_circuit *circuit, int level,
+			struct hello_tx *tx, bool send_now);
+int isis_tx_hello_p2p(struct isis_circuit *circuit, int level,
+		      struct hello_tx *tx, bool send_now);
 
 #endif /* _ZEBRA_ISIS_NETWORK_H */
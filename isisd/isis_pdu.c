@@ -35,6 +35,7 @@
 #include "checksum.h"
 #include "md5.h"
 #include "lib_errors.h"
+#include "hello_thread.h"
 
 #include "isisd/isis_constants.h"
 #include "isisd/isis_common.h"
@@ -205,9 +206,7 @@ static int process_p2p_hello(struct iih_info *iih)
 				      adj);
 
 	/* lets take care of the expiry */
-	thread_cancel(&adj->t_expire);
-	thread_add_timer(master, isis_adj_expire, adj, (long)adj->hold_time,
-			 &adj->t_expire);
+	isis_adj_hold_refresh(adj);
 
 	/* While fabricds initial sync is in progress, ignore hellos from other
 	 * interfaces than the one we are performing the initial sync on. */
@@ -497,9 +496,7 @@ static int process_lan_hello(struct iih_info *iih)
 				      adj);
 
 	/* lets take care of the expiry */
-	thread_cancel(&adj->t_expire);
-	thread_add_timer(master, isis_adj_expire, adj, (long)adj->hold_time,
-			 &adj->t_expire);
+	isis_adj_hold_refresh(adj);
 
 	/*
 	 * If the snpa for this circuit is found from LAN Neighbours TLV
@@ -1885,13 +1882,10 @@ static void put_hello_hdr(struct isis_circuit *circuit, int level,
 	}
 }
 
-int send_hello(struct isis_circuit *circuit, int level)
+/* Build the IIH in snd_stream */
+static int put_hello(struct isis_circuit *circuit, int level)
 {
 	size_t len_pointer;
-	int retval;
-
-	if (circuit->is_passive)
-		return ISIS_OK;
 
 	if (circuit->interface->mtu == 0) {
 		zlog_warn("circuit has zero MTU");
@@ -1997,6 +1991,13 @@ int send_hello(struct isis_circuit *circuit, int level)
 	}
 
 	isis_free_tlvs(tlvs);
+	return ISIS_OK;
+}
+
+/* Send the IIH put_hello() left in snd_stream */
+static int send_hello_built(struct isis_circuit *circuit, int level)
+{
+	int retval;
 
 	pdu_counter_count(circuit->area->pdu_tx_counters,
 			  hello_pdu_type(circuit, level));
@@ -2010,6 +2011,108 @@ int send_hello(struct isis_circuit *circuit, int level)
 	return retval;
 }
 
+int send_hello(struct isis_circuit *circuit, int level)
+{
+	int retval;
+
+	if (circuit->is_passive)
+		return ISIS_OK;
+
+	retval = put_hello(circuit, level);
+	if (retval != ISIS_OK)
+		return retval;
+
+	return send_hello_built(circuit, level);
+}
+
+static long hello_interval_msec(struct isis_circuit *circuit, int level)
+{
+	if (circuit->circ_type == CIRCUIT_T_P2P)
+		return 1000 * circuit->hello_interval[1];
+	return 1000 * circuit->hello_interval[level - 1];
+}
+
+static void send_hello_count(struct isis_circuit *circuit, int level)
+{
+	uint32_t sent = hello_tx_collect(circuit->hello_tx[level - 1]);
+
+	while (sent--)
+		pdu_counter_count(circuit->area->pdu_tx_counters,
+				  hello_pdu_type(circuit, level));
+}
+
+void send_hello_stop(struct isis_circuit *circuit, int level)
+{
+	if (!circuit->hello_tx[level - 1])
+		return;
+
+	send_hello_count(circuit, level);
+	hello_tx_free(&circuit->hello_tx[level - 1]);
+}
+
+static void send_hello_refresh(void *arg);
+
+/*
+ * Where the circuit supports it, periodic IIHs are sent by the hello pthread
+ * so that they keep going while the main pthread is busy.  The IIH is
+ * rebuilt shortly before each transmission by send_hello_refresh().
+ * Returns false if the caller has to schedule IIHs itself; with send_now,
+ * this one has been sent already then, with the result in *retval.
+ */
+static bool send_hello_tx(struct isis_circuit *circuit, int level,
+			  bool send_now, int *retval)
+{
+	struct hello_tx **txp = &circuit->hello_tx[level - 1];
+
+	*retval = ISIS_OK;
+	if (circuit->is_passive) {
+		send_hello_stop(circuit, level);
+		return false;
+	}
+
+	*retval = put_hello(circuit, level);
+	if (*retval != ISIS_OK) {
+		send_hello_stop(circuit, level);
+		return false;
+	}
+
+	if (circuit->tx_hello) {
+		if (!*txp)
+			*txp = hello_tx_new(send_hello_refresh,
+					    &circuit->level_arg[level - 1]);
+		hello_tx_set_interval(*txp, hello_interval_msec(circuit, level),
+				      IIH_JITTER);
+
+		if (circuit->tx_hello(circuit, level, *txp, send_now)
+		    == ISIS_OK) {
+			send_hello_count(circuit, level);
+			return true;
+		}
+	}
+
+	/* the IIH is still in snd_stream, don't build it again */
+	send_hello_stop(circuit, level);
+	if (send_now)
+		*retval = send_hello_built(circuit, level);
+	return false;
+}
+
+static void send_hello_refresh(void *arg)
+{
+	struct isis_circuit_arg *carg = arg;
+	struct isis_circuit *circuit = carg->circuit;
+	int level = carg->level;
+	int retval;
+
+	if (circuit->circ_type == CIRCUIT_T_BROADCAST
+	    && circuit->u.bc.run_dr_elect[level - 1])
+		isis_dr_elect(circuit, level);
+
+	if (!send_hello_tx(circuit, level, false, &retval))
+		send_hello_sched(circuit, level,
+				 hello_interval_msec(circuit, level));
+}
+
 static int send_hello_cb(struct thread *thread)
 {
 	struct isis_circuit_arg *arg = THREAD_ARG(thread);
@@ -2017,12 +2120,14 @@ static int send_hello_cb(struct thread *thread)
 
 	struct isis_circuit *circuit = arg->circuit;
 	int level = arg->level;
+	int rv;
 
 	assert(circuit);
 
 	if (circuit->circ_type == CIRCUIT_T_P2P) {
 		circuit->u.p2p.t_send_p2p_hello = NULL;
-		send_hello(circuit, 1);
+		if (send_hello_tx(circuit, ISIS_LEVEL1, true, &rv))
+			return ISIS_OK;
 		send_hello_sched(circuit, ISIS_LEVEL1,
 				 1000 * circuit->hello_interval[1]);
 		return ISIS_OK;
@@ -2044,7 +2149,8 @@ static int send_hello_cb(struct thread *thread)
 	if (circuit->u.bc.run_dr_elect[level - 1])
 		isis_dr_elect(circuit, level);
 
-	int rv = send_hello(circuit, level);
+	if (send_hello_tx(circuit, level, true, &rv))
+		return ISIS_OK;
 
 	/* set next timer thread */
 	send_hello_sched(circuit, level, 1000 * circuit->hello_interval[level - 1]);
@@ -2055,6 +2161,16 @@ static void _send_hello_sched(struct isis_circuit *circuit,
 			      struct thread **threadp,
 			      int level, long delay)
 {
+	struct hello_tx *tx = circuit->hello_tx[level - 1];
+	long remain;
+
+	/* the hello pthread sends one soon enough anyway */
+	if (tx) {
+		remain = hello_tx_remain_msec(tx);
+		if (remain >= 0 && remain < delay)
+			return;
+	}
+
 	if (*threadp) {
 		if (thread_timer_remain_msec(*threadp) < (unsigned long)delay)
 			return;
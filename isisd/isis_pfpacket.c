@@ -28,11 +28,13 @@
 #include <linux/filter.h>
 
 #include "log.h"
+#include "memory.h"
 #include "network.h"
 #include "stream.h"
 #include "if.h"
 #include "lib_errors.h"
 #include "vrf.h"
+#include "hello_thread.h"
 
 #include "isisd/isis_constants.h"
 #include "isisd/isis_common.h"
@@ -206,9 +208,11 @@ int isis_sock_init(struct isis_circuit *circuit)
 	/* Assign Rx and Tx callbacks are based on real if type */
 		if (if_is_broadcast(circuit->interface)) {
 			circuit->tx = isis_send_pdu_bcast;
+			circuit->tx_hello = isis_tx_hello_bcast;
 			circuit->rx = isis_recv_pdu_bcast;
 		} else if (if_is_pointopoint(circuit->interface)) {
 			circuit->tx = isis_send_pdu_p2p;
+			circuit->tx_hello = isis_tx_hello_p2p;
 			circuit->rx = isis_recv_pdu_p2p;
 		} else {
 			zlog_warn("isis_sock_init(): unknown circuit type");
@@ -342,6 +346,25 @@ int isis_recv_pdu_p2p(struct isis_circuit *circuit, uint8_t *ssnpa)
 	return ISIS_OK;
 }
 
+static void isis_bcast_dst(struct isis_circuit *circuit, int level,
+			   struct sockaddr_ll *sa)
+{
+	memset(sa, 0, sizeof(struct sockaddr_ll));
+	sa->sll_family = AF_PACKET;
+
+	size_t frame_size = stream_get_endp(circuit->snd_stream) + LLC_LEN;
+	sa->sll_protocol = htons(isis_ethertype(frame_size));
+	sa->sll_ifindex = circuit->interface->ifindex;
+	sa->sll_halen = ETH_ALEN;
+	/* RFC5309 section 4.1 recommends ALL_ISS */
+	if (circuit->circ_type == CIRCUIT_T_P2P)
+		memcpy(&sa->sll_addr, ALL_ISS, ETH_ALEN);
+	else if (level == 1)
+		memcpy(&sa->sll_addr, ALL_L1_ISS, ETH_ALEN);
+	else
+		memcpy(&sa->sll_addr, ALL_L2_ISS, ETH_ALEN);
+}
+
 int isis_send_pdu_bcast(struct isis_circuit *circuit, int level)
 {
 	struct msghdr msg;
@@ -354,20 +377,7 @@ int isis_send_pdu_bcast(struct isis_circuit *circuit, int level)
 	struct sockaddr_ll sa;
 
 	stream_set_getp(circuit->snd_stream, 0);
-	memset(&sa, 0, sizeof(struct sockaddr_ll));
-	sa.sll_family = AF_PACKET;
-
-	size_t frame_size = stream_get_endp(circuit->snd_stream) + LLC_LEN;
-	sa.sll_protocol = htons(isis_ethertype(frame_size));
-	sa.sll_ifindex = circuit->interface->ifindex;
-	sa.sll_halen = ETH_ALEN;
-	/* RFC5309 section 4.1 recommends ALL_ISS */
-	if (circuit->circ_type == CIRCUIT_T_P2P)
-		memcpy(&sa.sll_addr, ALL_ISS, ETH_ALEN);
-	else if (level == 1)
-		memcpy(&sa.sll_addr, ALL_L1_ISS, ETH_ALEN);
-	else
-		memcpy(&sa.sll_addr, ALL_L2_ISS, ETH_ALEN);
+	isis_bcast_dst(circuit, level, &sa);
 
 	/* on a broadcast circuit */
 	/* first we put the LLC in */
@@ -395,24 +405,55 @@ int isis_send_pdu_bcast(struct isis_circuit *circuit, int level)
 	return ISIS_OK;
 }
 
-int isis_send_pdu_p2p(struct isis_circuit *circuit, int level)
+/*
+ * Same framing as isis_send_pdu_bcast(), but the IIH is handed to the hello
+ * pthread, which keeps resending it.
+ */
+int isis_tx_hello_bcast(struct isis_circuit *circuit, int level,
+			struct hello_tx *tx, bool send_now)
 {
 	struct sockaddr_ll sa;
-	ssize_t rv;
+	size_t len = stream_get_endp(circuit->snd_stream);
+	uint8_t *buf;
 
-	stream_set_getp(circuit->snd_stream, 0);
-	memset(&sa, 0, sizeof(struct sockaddr_ll));
-	sa.sll_family = AF_PACKET;
-	sa.sll_ifindex = circuit->interface->ifindex;
-	sa.sll_halen = ETH_ALEN;
+	isis_bcast_dst(circuit, level, &sa);
+
+	buf = XMALLOC(MTYPE_TMP, LLC_LEN + len);
+	buf[0] = 0xFE;
+	buf[1] = 0xFE;
+	buf[2] = 0x03;
+	memcpy(buf + LLC_LEN, STREAM_DATA(circuit->snd_stream), len);
+
+	hello_tx_update(tx, circuit->fd, (struct sockaddr *)&sa, sizeof(sa), 0,
+			buf, LLC_LEN + len, send_now);
+	XFREE(MTYPE_TMP, buf);
+	return ISIS_OK;
+}
+
+static void isis_p2p_dst(struct isis_circuit *circuit, int level,
+			 struct sockaddr_ll *sa)
+{
+	memset(sa, 0, sizeof(struct sockaddr_ll));
+	sa->sll_family = AF_PACKET;
+	sa->sll_ifindex = circuit->interface->ifindex;
+	sa->sll_halen = ETH_ALEN;
 	if (level == 1)
-		memcpy(&sa.sll_addr, ALL_L1_ISS, ETH_ALEN);
+		memcpy(&sa->sll_addr, ALL_L1_ISS, ETH_ALEN);
 	else
-		memcpy(&sa.sll_addr, ALL_L2_ISS, ETH_ALEN);
-
+		memcpy(&sa->sll_addr, ALL_L2_ISS, ETH_ALEN);
 
 	/* lets try correcting the protocol */
-	sa.sll_protocol = htons(0x00FE);
+	sa->sll_protocol = htons(0x00FE);
+}
+
+int isis_send_pdu_p2p(struct isis_circuit *circuit, int level)
+{
+	struct sockaddr_ll sa;
+	ssize_t rv;
+
+	stream_set_getp(circuit->snd_stream, 0);
+	isis_p2p_dst(circuit, level, &sa);
+
 	rv = sendto(circuit->fd, circuit->snd_stream->data,
 		    stream_get_endp(circuit->snd_stream), 0,
 		    (struct sockaddr *)&sa, sizeof(struct sockaddr_ll));
@@ -426,4 +467,16 @@ int isis_send_pdu_p2p(struct isis_circuit *circuit, int level)
 	return ISIS_OK;
 }
 
+int isis_tx_hello_p2p(struct isis_circuit *circuit, int level,
+		      struct hello_tx *tx, bool send_now)
+{
+	struct sockaddr_ll sa;
+
+	isis_p2p_dst(circuit, level, &sa);
+	hello_tx_update(tx, circuit->fd, (struct sockaddr *)&sa, sizeof(sa), 0,
+			STREAM_DATA(circuit->snd_stream),
+			stream_get_endp(circuit->snd_stream), send_now);
+	return ISIS_OK;
+}
+
 #endif /* ISIS_METHOD == ISIS_METHOD_PFPACKET */
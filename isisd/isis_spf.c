@@ -787,6 +787,11 @@ static int isis_spf_process_lsp(struct isis_spftree *spftree,
 	struct isis_mt_router_info *mt_router_info = NULL;
 	struct prefix_pair ip_info;
 	bool has_valid_psid;
+	struct isis_tlvs_view view;
+	struct isis_reach_iter it;
+	struct isis_reach_view r;
+	struct isis_prefix_sid psid;
+	struct prefix_ipv6 src_p;
 
 	if (isis_lfa_excise_node_check(spftree, lsp->hdr.lsp_id)) {
 		if (IS_DEBUG_LFA)
@@ -827,69 +832,64 @@ lspfragloop:
 		   print_sys_hostname(lsp->hdr.lsp_id));
 #endif /* EXTREME_DEBUG */
 
+	/* Walk reachability in place, without going through lsp->tlvs */
+	if (lsp_tlvs_view(lsp, &view)) {
+		zlog_warn("ISIS-SPF: cannot parse reachability of LSP %s",
+			  rawlspid_print(lsp->hdr.lsp_id));
+		goto end;
+	}
+
 	if (no_overload) {
 		if ((pseudo_lsp || spftree->mtid == ISIS_MT_IPV4_UNICAST)
-		    && spftree->area->oldmetric) {
-			struct isis_oldstyle_reach *r;
-			for (r = (struct isis_oldstyle_reach *)
-					 lsp->tlvs->oldstyle_reach.head;
-			     r; r = r->next) {
-				if (fabricd)
-					continue;
-
+		    && spftree->area->oldmetric && !fabricd) {
+			isis_reach_iter_init(&it, &view, ISIS_REACH_OLDSTYLE_IS,
+					     ISIS_MT_IPV4_UNICAST);
+			while (isis_reach_iter_next(&it, &r)) {
 				/* C.2.6 a) */
 				/* Two way connectivity */
-				if (!LSP_PSEUDO_ID(r->id)
-				    && !memcmp(r->id, root_sysid,
+				if (!LSP_PSEUDO_ID(r.id)
+				    && !memcmp(r.id, root_sysid,
 					       ISIS_SYS_ID_LEN))
 					continue;
 				if (!pseudo_lsp
-				    && !memcmp(r->id, null_sysid,
+				    && !memcmp(r.id, null_sysid,
 					       ISIS_SYS_ID_LEN))
 					continue;
-				dist = cost + r->metric;
+				dist = cost + r.metric;
 				process_N(spftree,
-					  LSP_PSEUDO_ID(r->id)
+					  LSP_PSEUDO_ID(r.id)
 						  ? VTYPE_PSEUDO_IS
 						  : VTYPE_NONPSEUDO_IS,
-					  (void *)r->id, dist, depth + 1, NULL,
+					  (void *)r.id, dist, depth + 1, NULL,
 					  parent);
 			}
 		}
 
 		if (spftree->area->newmetric) {
-			struct isis_item_list *te_neighs = NULL;
-			if (pseudo_lsp || spftree->mtid == ISIS_MT_IPV4_UNICAST)
-				te_neighs = &lsp->tlvs->extended_reach;
-			else
-				te_neighs = isis_lookup_mt_items(
-					&lsp->tlvs->mt_reach, spftree->mtid);
-
-			struct isis_extended_reach *er;
-			for (er = te_neighs ? (struct isis_extended_reach *)
-						      te_neighs->head
-					    : NULL;
-			     er; er = er->next) {
+			isis_reach_iter_init(&it, &view, ISIS_REACH_EXTENDED_IS,
+					     pseudo_lsp ? ISIS_MT_IPV4_UNICAST
+							: spftree->mtid);
+			while (isis_reach_iter_next(&it, &r)) {
 				/* C.2.6 a) */
 				/* Two way connectivity */
-				if (!LSP_PSEUDO_ID(er->id)
-				    && !memcmp(er->id, root_sysid,
+				if (!LSP_PSEUDO_ID(r.id)
+				    && !memcmp(r.id, root_sysid,
 					       ISIS_SYS_ID_LEN))
 					continue;
 				if (!pseudo_lsp
-				    && !memcmp(er->id, null_sysid,
+				    && !memcmp(r.id, null_sysid,
 					       ISIS_SYS_ID_LEN))
 					continue;
 				dist = cost
 				       + (CHECK_FLAG(spftree->flags,
 						     F_SPFTREE_HOPCOUNT_METRIC)
 						  ? 1
-						  : er->metric);
+						  : r.metric);
 				process_N(spftree,
-					  LSP_PSEUDO_ID(er->id)
+					  LSP_PSEUDO_ID(r.id)
 						  ? VTYPE_PSEUDO_TE_IS
 						  : VTYPE_NONPSEUDO_TE_IS,
-					  (void *)er->id, dist, depth + 1, NULL,
+					  (void *)r.id, dist, depth + 1, NULL,
 					  parent);
 			}
 		}
@@ -898,24 +898,22 @@ lspfragloop:
 	if (!fabricd && !pseudo_lsp && spftree->family == AF_INET
 	    && spftree->mtid == ISIS_MT_IPV4_UNICAST
 	    && spftree->area->oldmetric) {
-		struct isis_item_list *reachs[] = {
-			&lsp->tlvs->oldstyle_ip_reach,
-			&lsp->tlvs->oldstyle_ip_reach_ext};
+		static const enum isis_reach_kind kinds[] = {
+			ISIS_REACH_OLDSTYLE_IP, ISIS_REACH_OLDSTYLE_IP_EXT};
 
-		for (unsigned int i = 0; i < array_size(reachs); i++) {
+		for (unsigned int i = 0; i < array_size(kinds); i++) {
 			vtype = i ? VTYPE_IPREACH_EXTERNAL
 				  : VTYPE_IPREACH_INTERNAL;
 
 			memset(&ip_info, 0, sizeof(ip_info));
 			ip_info.dest.family = AF_INET;
 
-			struct isis_oldstyle_ip_reach *r;
-			for (r = (struct isis_oldstyle_ip_reach *)reachs[i]
-					 ->head;
-			     r; r = r->next) {
-				dist = cost + r->metric;
-				ip_info.dest.u.prefix4 = r->prefix.prefix;
-				ip_info.dest.prefixlen = r->prefix.prefixlen;
+			isis_reach_iter_init(&it, &view, kinds[i],
+					     ISIS_MT_IPV4_UNICAST);
+			while (isis_reach_iter_next(&it, &r)) {
+				dist = cost + r.metric;
+				ip_info.dest.u.prefix4 = r.prefix.u.prefix4;
+				ip_info.dest.prefixlen = r.prefix.prefixlen;
 				process_N(spftree, vtype, &ip_info,
 					  dist, depth + 1, NULL, parent);
 			}
@@ -927,121 +925,64 @@ lspfragloop:
 		goto end;
 
 	if (!pseudo_lsp && spftree->family == AF_INET) {
-		struct isis_item_list *ipv4_reachs;
-		if (spftree->mtid == ISIS_MT_IPV4_UNICAST)
-			ipv4_reachs = &lsp->tlvs->extended_ip_reach;
-		else
-			ipv4_reachs = isis_lookup_mt_items(
-				&lsp->tlvs->mt_ip_reach, spftree->mtid);
-
 		memset(&ip_info, 0, sizeof(ip_info));
 		ip_info.dest.family = AF_INET;
 
-		struct isis_extended_ip_reach *r;
-		for (r = ipv4_reachs
-				 ? (struct isis_extended_ip_reach *)
-					   ipv4_reachs->head
-				 : NULL;
-		     r; r = r->next) {
-			dist = cost + r->metric;
-			ip_info.dest.u.prefix4 = r->prefix.prefix;
-			ip_info.dest.prefixlen = r->prefix.prefixlen;
-
-			/* Parse list of Prefix-SID subTLVs */
-			has_valid_psid = false;
-			if (r->subtlvs) {
-				for (struct isis_item *i =
-					     r->subtlvs->prefix_sids.head;
-				     i; i = i->next) {
-					struct isis_prefix_sid *psid =
-						(struct isis_prefix_sid *)i;
-
-					if (psid->algorithm != SR_ALGORITHM_SPF)
-						continue;
-
-					has_valid_psid = true;
-					process_N(spftree, VTYPE_IPREACH_TE,
-						  &ip_info, dist, depth + 1,
-						  psid, parent);
-					/*
-					 * Stop the Prefix-SID iteration since
-					 * we only support the SPF algorithm for
-					 * now.
-					 */
-					break;
-				}
-			}
-			if (!has_valid_psid)
-				process_N(spftree, VTYPE_IPREACH_TE, &ip_info,
-					  dist, depth + 1, NULL, parent);
+		isis_reach_iter_init(&it, &view, ISIS_REACH_EXTENDED_IP,
+				     spftree->mtid);
+		while (isis_reach_iter_next(&it, &r)) {
+			dist = cost + r.metric;
+			ip_info.dest.u.prefix4 = r.prefix.u.prefix4;
+			ip_info.dest.prefixlen = r.prefix.prefixlen;
+
+			/*
+			 * Only the SPF algorithm is supported for now, so
+			 * that's the only Prefix-SID we're interested in.
+			 */
+			has_valid_psid = isis_reach_view_prefix_sid(
+				&r, SR_ALGORITHM_SPF, &psid);
+			process_N(spftree, VTYPE_IPREACH_TE, &ip_info, dist,
+				  depth + 1, has_valid_psid ? &psid : NULL,
+				  parent);
 		}
 	}
 
 	if (!pseudo_lsp && spftree->family == AF_INET6) {
-		struct isis_item_list *ipv6_reachs;
-		if (spftree->mtid == ISIS_MT_IPV4_UNICAST)
-			ipv6_reachs = &lsp->tlvs->ipv6_reach;
-		else
-			ipv6_reachs = isis_lookup_mt_items(
-				&lsp->tlvs->mt_ipv6_reach, spftree->mtid);
-
-		struct isis_ipv6_reach *r;
-		for (r = ipv6_reachs
-				 ? (struct isis_ipv6_reach *)ipv6_reachs->head
-				 : NULL;
-		     r; r = r->next) {
-			dist = cost + r->metric;
-			vtype = r->external ? VTYPE_IP6REACH_EXTERNAL
-					    : VTYPE_IP6REACH_INTERNAL;
+		isis_reach_iter_init(&it, &view, ISIS_REACH_IPV6,
+				     spftree->mtid);
+		while (isis_reach_iter_next(&it, &r)) {
+			dist = cost + r.metric;
+			vtype = r.external ? VTYPE_IP6REACH_EXTERNAL
+					   : VTYPE_IP6REACH_INTERNAL;
 			memset(&ip_info, 0, sizeof(ip_info));
 			ip_info.dest.family = AF_INET6;
-			ip_info.dest.u.prefix6 = r->prefix.prefix;
-			ip_info.dest.prefixlen = r->prefix.prefixlen;
+			ip_info.dest.u.prefix6 = r.prefix.u.prefix6;
+			ip_info.dest.prefixlen = r.prefix.prefixlen;
 
-			if (r->subtlvs
-			    && r->subtlvs->source_prefix
-			    && r->subtlvs->source_prefix->prefixlen) {
+			if (isis_reach_view_source_prefix(&r, &src_p)
+			    && src_p.prefixlen) {
 				if (spftree->tree_id != SPFTREE_DSTSRC) {
 					char buff[VID2STR_BUFFER];
 					zlog_warn("Ignoring dest-src route %s in non dest-src topology",
 						srcdest2str(
 							&ip_info.dest,
-							r->subtlvs->source_prefix,
+							&src_p,
 							buff, sizeof(buff)
 						)
 					);
 					continue;
 				}
-				ip_info.src = *r->subtlvs->source_prefix;
+				ip_info.src = src_p;
 			}
 
-			/* Parse list of Prefix-SID subTLVs */
-			has_valid_psid = false;
-			if (r->subtlvs) {
-				for (struct isis_item *i =
-					     r->subtlvs->prefix_sids.head;
-				     i; i = i->next) {
-					struct isis_prefix_sid *psid =
-						(struct isis_prefix_sid *)i;
-
-					if (psid->algorithm != SR_ALGORITHM_SPF)
-						continue;
-
-					has_valid_psid = true;
-					process_N(spftree, vtype, &ip_info,
-						  dist, depth + 1, psid,
-						  parent);
-					/*
-					 * Stop the Prefix-SID iteration since
-					 * we only support the SPF algorithm for
-					 * now.
-					 */
-					break;
-				}
-			}
-			if (!has_valid_psid)
-				process_N(spftree, vtype, &ip_info, dist,
-					  depth + 1, NULL, parent);
+			/*
+			 * Only the SPF algorithm is supported for now, so
+			 * that's the only Prefix-SID we're interested in.
+			 */
+			has_valid_psid = isis_reach_view_prefix_sid(
+				&r, SR_ALGORITHM_SPF, &psid);
+			process_N(spftree, vtype, &ip_info, dist, depth + 1,
+				  has_valid_psid ? &psid : NULL, parent);
 		}
 	}
 
@@ -4099,6 +4099,411 @@ int isis_unpack_tlvs(size_t avail_len, struct stream *stream,
 	return rv;
 }
 
+/*
+ * In-place access to reachability TLVs: validated like isis_unpack_tlvs()
+ * would, then decoded item by item straight from the packed TLVs.
+ */
+
+static bool view_reach_kind(uint8_t tlv_type, enum isis_reach_kind *kind)
+{
+	switch (tlv_type) {
+	case ISIS_TLV_OLDSTYLE_REACH:
+		*kind = ISIS_REACH_OLDSTYLE_IS;
+		return true;
+	case ISIS_TLV_EXTENDED_REACH:
+	case ISIS_TLV_MT_REACH:
+		*kind = ISIS_REACH_EXTENDED_IS;
+		return true;
+	case ISIS_TLV_OLDSTYLE_IP_REACH:
+		*kind = ISIS_REACH_OLDSTYLE_IP;
+		return true;
+	case ISIS_TLV_OLDSTYLE_IP_REACH_EXT:
+		*kind = ISIS_REACH_OLDSTYLE_IP_EXT;
+		return true;
+	case ISIS_TLV_EXTENDED_IP_REACH:
+	case ISIS_TLV_MT_IP_REACH:
+		*kind = ISIS_REACH_EXTENDED_IP;
+		return true;
+	case ISIS_TLV_IPV6_REACH:
+	case ISIS_TLV_MT_IPV6_REACH:
+		*kind = ISIS_REACH_IPV6;
+		return true;
+	}
+
+	return false;
+}
+
+static uint32_t view_get3(const uint8_t *v)
+{
+	return ((uint32_t)v[0] << 16) | ((uint32_t)v[1] << 8) | v[2];
+}
+
+static uint32_t view_getl(const uint8_t *v)
+{
+	return ((uint32_t)v[0] << 24) | view_get3(v + 1);
+}
+
+/* Same checks as unpack_item_prefix_sid() */
+static bool view_prefix_sid(const uint8_t *v, uint8_t len,
+			    struct isis_prefix_sid *sid)
+{
+	uint8_t flags, expected_size;
+	uint32_t value;
+
+	if (len < 5)
+		return false;
+
+	flags = v[0];
+	if (!!(flags & ISIS_PREFIX_SID_VALUE)
+	    != !!(flags & ISIS_PREFIX_SID_LOCAL))
+		return false;
+
+	expected_size = (flags & ISIS_PREFIX_SID_VALUE)
+				? ISIS_SUBTLV_PREFIX_SID_SIZE
+				: ISIS_SUBTLV_PREFIX_SID_SIZE + 1;
+	if (len != expected_size)
+		return false;
+
+	if (flags & ISIS_PREFIX_SID_VALUE) {
+		value = view_get3(v + 2);
+		if (!IS_MPLS_UNRESERVED_LABEL(value))
+			return false;
+	} else {
+		value = view_getl(v + 2);
+	}
+
+	if (sid) {
+		memset(sid, 0, sizeof(*sid));
+		sid->flags = flags;
+		sid->algorithm = v[1];
+		sid->value = value;
+	}
+	return true;
+}
+
+/* Same checks as unpack_subtlv_ipv6_source_prefix() */
+static bool view_source_prefix(const uint8_t *v, uint8_t len,
+			       struct prefix_ipv6 *p)
+{
+	if (len < 1 || v[0] > 128 || len != 1 + PSIZE(v[0]))
+		return false;
+
+	if (p) {
+		memset(p, 0, sizeof(*p));
+		p->family = AF_INET6;
+		p->prefixlen = v[0];
+		memcpy(&p->prefix, v + 1, PSIZE(v[0]));
+	}
+	return true;
+}
+
+static bool view_subtlvs_valid(enum isis_reach_kind kind, const uint8_t *v,
+			       size_t len)
+{
+	size_t pos = 0;
+
+	while (pos < len) {
+		uint8_t type, tlv_len;
+
+		if (len - pos < 2)
+			return false;
+		type = v[pos];
+		tlv_len = v[pos + 1];
+		if (len - pos - 2 < tlv_len)
+			return false;
+		pos += 2;
+
+		if (type == ISIS_SUBTLV_PREFIX_SID && tlv_len
+		    && !view_prefix_sid(v + pos, tlv_len, NULL))
+			return false;
+		if (type == ISIS_SUBTLV_IPV6_SOURCE_PREFIX
+		    && kind == ISIS_REACH_IPV6
+		    && !view_source_prefix(v + pos, tlv_len, NULL))
+			return false;
+
+		pos += tlv_len;
+	}
+
+	return true;
+}
+
+/*
+ * Decode one item of the given kind from v into r (if given), with the same
+ * checks as the unpack_item_*() functions; with validate, sub-TLVs of IP
+ * reachability are checked too.  Returns the item's size, 0 if invalid.
+ */
+static size_t view_reach_item(enum isis_reach_kind kind, const uint8_t *v,
+			      size_t len, struct isis_reach_view *r,
+			      bool validate)
+{
+	struct isis_reach_view dummy;
+	size_t consume;
+	uint8_t control, plen, subtlv_len;
+	struct in_addr mask;
+
+	if (!r)
+		r = &dummy;
+	memset(r, 0, sizeof(*r));
+	r->kind = kind;
+
+	switch (kind) {
+	case ISIS_REACH_OLDSTYLE_IS:
+		if (len < 11)
+			return 0;
+		r->metric = v[0] & 0x3f;
+		r->id = v + 4;
+		return 11;
+
+	case ISIS_REACH_EXTENDED_IS:
+		if (len < 11)
+			return 0;
+		r->id = v;
+		r->metric = view_get3(v + 7);
+		subtlv_len = v[10];
+		if (len < (size_t)11 + subtlv_len)
+			return 0;
+		if (subtlv_len) {
+			r->subtlvs = v + 11;
+			r->subtlvs_len = subtlv_len;
+		}
+		return 11 + subtlv_len;
+
+	case ISIS_REACH_OLDSTYLE_IP:
+	case ISIS_REACH_OLDSTYLE_IP_EXT:
+		if (len < 12)
+			return 0;
+		r->metric = v[0] & 0x7f;
+		r->external = (kind == ISIS_REACH_OLDSTYLE_IP_EXT);
+		r->prefix.family = AF_INET;
+		memcpy(&r->prefix.u.prefix4, v + 4, 4);
+		memcpy(&mask, v + 8, 4);
+		r->prefix.prefixlen = ip_masklen(mask);
+		return 12;
+
+	case ISIS_REACH_EXTENDED_IP:
+		if (len < 5)
+			return 0;
+		r->metric = view_getl(v);
+		control = v[4];
+		r->down = (control & ISIS_EXTENDED_IP_REACH_DOWN);
+		plen = control & 0x3f;
+		if (plen > 32)
+			return 0;
+		consume = 5 + PSIZE(plen);
+		if (len < consume)
+			return 0;
+		r->prefix.family = AF_INET;
+		r->prefix.prefixlen = plen;
+		memcpy(&r->prefix.u.prefix4, v + 5, PSIZE(plen));
+		apply_mask_ipv4((struct prefix_ipv4 *)&r->prefix);
+		if (!(control & ISIS_EXTENDED_IP_REACH_SUBTLV))
+			return consume;
+		break;
+
+	case ISIS_REACH_IPV6:
+		if (len < 6)
+			return 0;
+		r->metric = view_getl(v);
+		control = v[4];
+		r->down = (control & ISIS_IPV6_REACH_DOWN);
+		r->external = (control & ISIS_IPV6_REACH_EXTERNAL);
+		plen = v[5];
+		if (plen > 128)
+			return 0;
+		consume = 6 + PSIZE(plen);
+		if (len < consume)
+			return 0;
+		r->prefix.family = AF_INET6;
+		r->prefix.prefixlen = plen;
+		memcpy(&r->prefix.u.prefix6, v + 6, PSIZE(plen));
+		apply_mask_ipv6((struct prefix_ipv6 *)&r->prefix);
+		if (!(control & ISIS_IPV6_REACH_SUBTLV))
+			return consume;
+		break;
+
+	default:
+		return 0;
+	}
+
+	/* IP reachability with sub-TLVs */
+	if (len < consume + 1)
+		return 0;
+	subtlv_len = v[consume];
+	consume += 1;
+	if (len < consume + subtlv_len)
+		return 0;
+	if (validate && !view_subtlvs_valid(kind, v + consume, subtlv_len))
+		return 0;
+	if (subtlv_len) {
+		r->subtlvs = v + consume;
+		r->subtlvs_len = subtlv_len;
+	}
+
+	return consume + subtlv_len;
+}
+
+/* Same framing as unpack_tlv_with_items() */
+static bool view_tlv_valid(uint8_t tlv_type, const uint8_t *v, uint8_t len)
+{
+	enum isis_reach_kind kind;
+	size_t pos = 0, consume;
+
+	if (!view_reach_kind(tlv_type, &kind))
+		return true;
+
+	if (IS_COMPAT_MT_TLV(tlv_type)) {
+		if (len < 2)
+			return false;
+		pos += 2;
+	}
+	if (tlv_type == ISIS_TLV_OLDSTYLE_REACH) {
+		if (len - pos < 1)
+			return false;
+		pos += 1;
+	}
+
+	while (pos < len) {
+		consume = view_reach_item(kind, v + pos, len - pos, NULL, true);
+		if (!consume)
+			return false;
+		pos += consume;
+	}
+
+	return true;
+}
+
+int isis_tlvs_view_init(struct isis_tlvs_view *view, const uint8_t *data,
+			size_t len)
+{
+	size_t pos = 0;
+
+	view->data = NULL;
+	view->len = 0;
+
+	while (pos < len) {
+		uint8_t tlv_len;
+
+		if (len - pos < 2)
+			return 1;
+		tlv_len = data[pos + 1];
+		if (len - pos - 2 < tlv_len)
+			return 1;
+		if (!view_tlv_valid(data[pos], data + pos + 2, tlv_len))
+			return 1;
+		pos += 2 + tlv_len;
+	}
+
+	view->data = data;
+	view->len = len;
+	return 0;
+}
+
+void isis_reach_iter_init(struct isis_reach_iter *it,
+			  const struct isis_tlvs_view *view,
+			  enum isis_reach_kind kind, uint16_t mtid)
+{
+	memset(it, 0, sizeof(*it));
+	it->view = view;
+	it->kind = kind;
+	it->mtid = mtid;
+}
+
+bool isis_reach_iter_next(struct isis_reach_iter *it, struct isis_reach_view *r)
+{
+	const uint8_t *data = it->view->data;
+	size_t consume;
+
+	while (it->pos >= it->end) {
+		size_t start = it->next_tlv + 2;
+		enum isis_reach_kind kind;
+		uint8_t tlv_type;
+
+		if (it->next_tlv >= it->view->len)
+			return false;
+
+		tlv_type = data[it->next_tlv];
+		it->next_tlv = start + data[it->next_tlv + 1];
+		if (!view_reach_kind(tlv_type, &kind) || kind != it->kind)
+			continue;
+
+		/* MT TLVs for mtid 0 go with the standard ones, as unpacked */
+		if (IS_COMPAT_MT_TLV(tlv_type)) {
+			if ((((data[start] << 8) | data[start + 1])
+			     & ISIS_MT_MASK)
+			    != it->mtid)
+				continue;
+			start += 2;
+		} else if (it->mtid != ISIS_MT_IPV4_UNICAST) {
+			continue;
+		}
+		if (tlv_type == ISIS_TLV_OLDSTYLE_REACH)
+			start += 1;
+
+		it->pos = start;
+		it->end = it->next_tlv;
+	}
+
+	consume = view_reach_item(it->kind, data + it->pos, it->end - it->pos,
+				  r, false);
+	if (!consume) {
+		/* can't happen on a validated view */
+		it->pos = it->end;
+		it->next_tlv = it->view->len;
+		return false;
+	}
+	it->pos += consume;
+	return true;
+}
+
+bool isis_reach_view_prefix_sid(const struct isis_reach_view *r,
+				uint8_t algorithm, struct isis_prefix_sid *sid)
+{
+	size_t pos = 0;
+
+	if (r->kind != ISIS_REACH_EXTENDED_IP && r->kind != ISIS_REACH_IPV6)
+		return false;
+
+	while (pos + 2 <= r->subtlvs_len) {
+		uint8_t type = r->subtlvs[pos];
+		uint8_t len = r->subtlvs[pos + 1];
+
+		pos += 2;
+		if (pos + len > r->subtlvs_len)
+			return false;
+		if (type == ISIS_SUBTLV_PREFIX_SID && len
+		    && view_prefix_sid(r->subtlvs + pos, len, sid)
+		    && sid->algorithm == algorithm)
+			return true;
+		pos += len;
+	}
+
+	return false;
+}
+
+bool isis_reach_view_source_prefix(const struct isis_reach_view *r,
+				   struct prefix_ipv6 *p)
+{
+	size_t pos = 0;
+
+	if (r->kind != ISIS_REACH_IPV6)
+		return false;
+
+	/* only the first one counts, as in the unpacker */
+	while (pos + 2 <= r->subtlvs_len) {
+		uint8_t type = r->subtlvs[pos];
+		uint8_t len = r->subtlvs[pos + 1];
+
+		pos += 2;
+		if (pos + len > r->subtlvs_len)
+			return false;
+		if (type == ISIS_SUBTLV_IPV6_SOURCE_PREFIX)
+			return view_source_prefix(r->subtlvs + pos, len, p);
+		pos += len;
+	}
+
+	return false;
+}
+
 #define TLV_OPS(_name_, _desc_)                                                \
 	static const struct tlv_ops tlv_##_name_##_ops = {                     \
 		.name = _desc_, .unpack = unpack_tlv_##_name_,                 \
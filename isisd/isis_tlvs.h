@@ -548,6 +548,72 @@ const char *isis_format_tlvs(struct isis_tlvs *tlvs);
 struct isis_tlvs *isis_copy_tlvs(struct isis_tlvs *tlvs);
 struct list *isis_fragment_tlvs(struct isis_tlvs *tlvs, size_t size);
 
+/*
+ * Read-only access to the reachability TLVs of a packed LSP, without
+ * unpacking it into struct isis_tlvs.  isis_tlvs_view_init() checks the TLV
+ * framing, and everything isis_unpack_tlvs() checks for reachability TLVs
+ * and their IP sub-TLVs, so any data it unpacks is accepted.  The iterators
+ * then decode one item at a time from the buffer, which must stay around;
+ * sub-TLVs are only decoded when asked for.
+ */
+struct isis_tlvs_view {
+	const uint8_t *data;
+	size_t len;
+};
+
+enum isis_reach_kind {
+	ISIS_REACH_OLDSTYLE_IS,	    /* TLV 2 */
+	ISIS_REACH_EXTENDED_IS,	    /* TLV 22, 222 */
+	ISIS_REACH_OLDSTYLE_IP,	    /* TLV 128 */
+	ISIS_REACH_OLDSTYLE_IP_EXT, /* TLV 130 */
+	ISIS_REACH_EXTENDED_IP,	    /* TLV 135, 235 */
+	ISIS_REACH_IPV6,	    /* TLV 236, 237 */
+};
+
+struct isis_reach_view {
+	enum isis_reach_kind kind;
+	uint32_t metric;
+
+	/* IS reachability, points into the view */
+	const uint8_t *id;
+
+	/* IP reachability */
+	struct prefix prefix;
+	bool down;
+	bool external;
+
+	const uint8_t *subtlvs;
+	uint8_t subtlvs_len;
+};
+
+struct isis_reach_iter {
+	const struct isis_tlvs_view *view;
+	enum isis_reach_kind kind;
+	uint16_t mtid;
+
+	size_t next_tlv;
+	size_t pos, end;
+};
+
+int isis_tlvs_view_init(struct isis_tlvs_view *view, const uint8_t *data,
+			size_t len);
+/*
+ * Walks the items isis_unpack_tlvs() would put into the list for kind and
+ * mtid, in the same order.  Oldstyle kinds only exist for the IPv4 unicast
+ * topology.
+ */
+void isis_reach_iter_init(struct isis_reach_iter *it,
+			  const struct isis_tlvs_view *view,
+			  enum isis_reach_kind kind, uint16_t mtid);
+bool isis_reach_iter_next(struct isis_reach_iter *it,
+			  struct isis_reach_view *r);
+/* First Prefix-SID sub-TLV for algorithm */
+bool isis_reach_view_prefix_sid(const struct isis_reach_view *r,
+				uint8_t algorithm, struct isis_prefix_sid *sid);
+/* IPv6 Source Prefix sub-TLV */
+bool isis_reach_view_source_prefix(const struct isis_reach_view *r,
+				   struct prefix_ipv6 *p);
+
 #define ISIS_EXTENDED_IP_REACH_DOWN 0x80
 #define ISIS_EXTENDED_IP_REACH_SUBTLV 0x40
 
@@ -274,6 +274,8 @@ struct isis_area *isis_area_create(const char *area_tag, const char *vrf_name)
 		lsp_db_init(&area->lspdb[0]);
 	if (area->is_type & IS_LEVEL_2)
 		lsp_db_init(&area->lspdb[1]);
+	lsp_frag_map_init(&area->lsp_frag_map[0]);
+	lsp_frag_map_init(&area->lsp_frag_map[1]);
 
 	spftree_area_init(area);
 
@@ -473,6 +475,8 @@ void isis_area_destroy(struct isis_area *area)
 
 	lsp_db_fini(&area->lspdb[0]);
 	lsp_db_fini(&area->lspdb[1]);
+	lsp_frag_map_fini(&area->lsp_frag_map[0]);
+	lsp_frag_map_fini(&area->lsp_frag_map[1]);
 
 	/* invalidate and verify to delete all routes from zebra */
 	isis_area_invalidate_routes(area, area->is_type);
@@ -2474,6 +2478,8 @@ static void area_resign_level(struct isis_area *area, int level)
 	isis_area_verify_routes(area);
 
 	lsp_db_fini(&area->lspdb[level - 1]);
+	lsp_frag_map_fini(&area->lsp_frag_map[level - 1]);
+	lsp_frag_map_init(&area->lsp_frag_map[level - 1]);
 
 	for (int tree = SPFTREE_IPV4; tree < SPFTREE_COUNT; tree++) {
 		if (area->spftree[tree][level - 1]) {
@@ -2968,6 +2974,7 @@ struct cmd_node router_node = {
 	.parent_node = CONFIG_NODE,
 	.prompt = "%s(config-router)# ",
 	.config_write = isis_config_write,
+	.config_nb = true,
 };
 #endif /* ifdef FABRICD */
 
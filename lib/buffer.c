@@ -26,6 +26,7 @@
 #include "log.h"
 #include "network.h"
 #include "lib_errors.h"
+#include "printfrr.h"
 
 #include <stddef.h>
 
@@ -38,8 +39,11 @@ struct buffer {
 	struct buffer_data *head;
 	struct buffer_data *tail;
 
-	/* Size of each buffer_data chunk. */
+	/* Size of the first buffer_data chunk. */
 	size_t size;
+
+	/* Size of the next chunk; grows while data keeps piling up. */
+	size_t next_size;
 };
 
 /* Data container. */
@@ -52,8 +56,11 @@ struct buffer_data {
 	/* Pointer to data not yet flushed. */
 	size_t sp;
 
+	/* Allocated size of data[]. */
+	size_t size;
+
 	/* Actual data stream (variable length). */
-	unsigned char data[]; /* real dimension is buffer->size */
+	unsigned char data[];
 };
 
 /* It should always be true that: 0 <= sp <= cp <= size */
@@ -62,6 +69,10 @@ struct buffer_data {
    next page boundery. */
 #define BUFFER_SIZE_DEFAULT		4096
 
+/* Chunks double in size, up to this limit, as long as the buffer is not
+   drained; large outputs then take few allocations and few iovecs. */
+#define BUFFER_SIZE_MAX			65536
+
 #define BUFFER_DATA_FREE(D) XFREE(MTYPE_BUFFER_DATA, (D))
 
 /* Make new buffer. */
@@ -127,14 +138,22 @@ void buffer_reset(struct buffer *b)
 	b->head = b->tail = NULL;
 }
 
-/* Add buffer_data to the end of buffer. */
-static struct buffer_data *buffer_add(struct buffer *b)
+/* Add buffer_data of at least min_size bytes to the end of buffer. */
+static struct buffer_data *buffer_add_size(struct buffer *b, size_t min_size)
 {
 	struct buffer_data *d;
+	size_t size;
+
+	if (!b->head || b->next_size < b->size)
+		b->next_size = b->size;
+	size = MAX(b->next_size, min_size);
+	if (b->next_size < BUFFER_SIZE_MAX)
+		b->next_size = MIN(b->next_size * 2,
+				   MAX(b->size, (size_t)BUFFER_SIZE_MAX));
 
-	d = XMALLOC(MTYPE_BUFFER_DATA,
-		    offsetof(struct buffer_data, data) + b->size);
+	d = XMALLOC(MTYPE_BUFFER_DATA, offsetof(struct buffer_data, data) + size);
 	d->cp = d->sp = 0;
+	d->size = size;
 	d->next = NULL;
 
 	if (b->tail)
@@ -146,6 +165,12 @@ static struct buffer_data *buffer_add(struct buffer *b)
 	return d;
 }
 
+/* Add buffer_data to the end of buffer. */
+static struct buffer_data *buffer_add(struct buffer *b)
+{
+	return buffer_add_size(b, 0);
+}
+
 /* Write data to buffer. */
 void buffer_put(struct buffer *b, const void *p, size_t size)
 {
@@ -157,11 +182,12 @@ void buffer_put(struct buffer *b, const void *p, size_t size)
 		size_t chunk;
 
 		/* If there is no data buffer add it. */
-		if (data == NULL || data->cp == b->size)
+		if (data == NULL || data->cp == data->size)
 			data = buffer_add(b);
 
-		chunk = ((size <= (b->size - data->cp)) ? size
-							: (b->size - data->cp));
+		chunk = ((size <= (data->size - data->cp))
+				 ? size
+				 : (data->size - data->cp));
 		memcpy((data->data + data->cp), ptr, chunk);
 		size -= chunk;
 		ptr += chunk;
@@ -195,11 +221,11 @@ void buffer_put_crlf(struct buffer *b, const void *origp, size_t origsize)
 		size_t avail, chunk;
 
 		/* If there is no data buffer add it. */
-		if (data == NULL || data->cp == b->size)
+		if (data == NULL || data->cp == data->size)
 			data = buffer_add(b);
 
 		size = (lf ? lf : end) - p;
-		avail = b->size - data->cp;
+		avail = data->size - data->cp;
 
 		chunk = (size <= avail) ? size : avail;
 		memcpy(data->data + data->cp, p, chunk);
@@ -209,10 +235,10 @@ void buffer_put_crlf(struct buffer *b, const void *origp, size_t origsize)
 
 		if (lf && size <= avail) {
 			/* we just copied up to (including) a '\n' */
-			if (data->cp == b->size)
+			if (data->cp == data->size)
 				data = buffer_add(b);
 			data->data[data->cp++] = '\r';
-			if (data->cp == b->size)
+			if (data->cp == data->size)
 				data = buffer_add(b);
 			data->data[data->cp++] = '\n';
 
@@ -222,6 +248,53 @@ void buffer_put_crlf(struct buffer *b, const void *origp, size_t origsize)
 	}
 }
 
+/* Format straight into the tail chunk.  If the output does not fit in the
+   room left there, it is formatted again into a fresh chunk large enough to
+   hold all of it, so it is never split or copied. */
+ssize_t buffer_vprintf(struct buffer *b, const char *fmt, va_list ap)
+{
+	struct buffer_data *data = b->tail;
+	struct fbuf fb;
+	va_list aq;
+	ssize_t len;
+
+	if (data == NULL || data->cp == data->size)
+		data = buffer_add(b);
+
+	fb.buf = fb.pos = (char *)data->data + data->cp;
+	fb.len = data->size - data->cp;
+
+	va_copy(aq, ap);
+	len = vbprintfrr(&fb, fmt, aq);
+	va_end(aq);
+
+	if (len <= 0)
+		return len;
+
+	if ((size_t)len > data->size - data->cp) {
+		data = buffer_add_size(b, len);
+
+		fb.buf = fb.pos = (char *)data->data;
+		fb.len = data->size;
+		len = vbprintfrr(&fb, fmt, ap);
+	}
+
+	data->cp += len;
+	return len;
+}
+
+ssize_t buffer_printf(struct buffer *b, const char *fmt, ...)
+{
+	va_list ap;
+	ssize_t len;
+
+	va_start(ap, fmt);
+	len = buffer_vprintf(b, fmt, ap);
+	va_end(ap);
+
+	return len;
+}
+
 /* Keep flushing data to the fd until the buffer is empty or an error is
    encountered or the operation would block. */
 buffer_status_t buffer_flush_all(struct buffer *b, int fd)
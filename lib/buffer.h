@@ -46,6 +46,12 @@ extern void buffer_putc(struct buffer *, uint8_t);
 extern void buffer_putstr(struct buffer *, const char *);
 /* Add given data, inline-expanding \n to \r\n */
 extern void buffer_put_crlf(struct buffer *b, const void *p, size_t size);
+/* Format text with printfrr directly into the buffer, without an
+   intermediate copy.  Returns the number of bytes added. */
+extern ssize_t buffer_vprintf(struct buffer *b, const char *fmt, va_list ap)
+	PRINTFRR(2, 0);
+extern ssize_t buffer_printf(struct buffer *b, const char *fmt, ...)
+	PRINTFRR(2, 3);
 
 /* Combine all accumulated (and unflushed) data inside the buffer into a
    single NUL-terminated string allocated using XMALLOC(MTYPE_TMP).  Note
@@ -48,6 +48,8 @@
 #include "lib_errors.h"
 #include "northbound_cli.h"
 #include "network.h"
+#include "sha256.h"
+#include "printfrr.h"
 
 #include "frrscript.h"
 
@@ -1027,7 +1029,8 @@ int cmd_execute_command(vector vline, struct vty *vty,
 		return saved_ret;
 
 	if (ret != CMD_SUCCESS && ret != CMD_WARNING
-	    && ret != CMD_NOT_MY_INSTANCE && ret != CMD_WARNING_CONFIG_FAILED) {
+	    && ret != CMD_NOT_MY_INSTANCE && ret != CMD_WARNING_CONFIG_FAILED
+	    && ret != CMD_YIELD) {
 		/* This assumes all nodes above CONFIG_NODE are childs of
 		 * CONFIG_NODE */
 		while (vty->node > CONFIG_NODE) {
@@ -1041,7 +1044,8 @@ int cmd_execute_command(vector vline, struct vty *vty,
 						       vty, cmd);
 			if (ret == CMD_SUCCESS || ret == CMD_WARNING
 			    || ret == CMD_NOT_MY_INSTANCE
-			    || ret == CMD_WARNING_CONFIG_FAILED)
+			    || ret == CMD_WARNING_CONFIG_FAILED
+			    || ret == CMD_YIELD)
 				return ret;
 		}
 		/* no command succeeded, reset the vty to the original node */
@@ -1531,7 +1535,8 @@ DEFUN_HIDDEN(show_cli_graph,
 	return CMD_SUCCESS;
 }
 
-static int vty_write_config(struct vty *vty)
+/* skip_nb: leave out nodes whose configuration is all northbound */
+static int vty_write_config_nodes(struct vty *vty, bool skip_nb)
 {
 	size_t i;
 	struct cmd_node *node;
@@ -1554,6 +1559,8 @@ static int vty_write_config(struct vty *vty)
 
 	for (i = 0; i < vector_active(cmdvec); i++)
 		if ((node = vector_slot(cmdvec, i)) && node->config_write) {
+			if (skip_nb && node->config_nb)
+				continue;
 			if ((*node->config_write)(vty))
 				vty_out(vty, "!\n");
 		}
@@ -1565,6 +1572,107 @@ static int vty_write_config(struct vty *vty)
 	return CMD_SUCCESS;
 }
 
+static int vty_write_config(struct vty *vty)
+{
+	return vty_write_config_nodes(vty, false);
+}
+
+void config_file_digest(FILE *fp, uint8_t digest[32])
+{
+	SHA256_CTX ctx;
+	char buf[16384];
+	size_t n;
+
+	SHA256_Init(&ctx);
+	while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+		SHA256_Update(&ctx, buf, n);
+	SHA256_Final(digest, &ctx);
+}
+
+/*
+ * Write <config_file>.lyb for the text configuration just saved to
+ * config_file.  Failure is not fatal: on startup the text configuration is
+ * read whenever the binary one is missing or doesn't match.
+ */
+static void file_write_config_lyb(struct vty *vty, const char *config_file)
+{
+	char *lyb_file, *lyb_file_tmp;
+	struct conf_lyb_hdr hdr = {};
+	struct vty *file_vty;
+	char *lyb = NULL;
+	int lyb_len = 0;
+	FILE *fp;
+	int fd;
+
+	lyb_file = asprintfrr(MTYPE_TMP, "%s%s", config_file, CONF_LYB_EXT);
+	lyb_file_tmp = asprintfrr(MTYPE_TMP, "%s.XXXXXX", lyb_file);
+
+	fp = fopen(config_file, "r");
+	if (!fp) {
+		vty_out(vty, "Can't read back configuration file %s.\n",
+			config_file);
+		goto out_unlink;
+	}
+	config_file_digest(fp, hdr.text_sha256);
+	fclose(fp);
+
+	if (running_config->dnode) {
+		if (lyd_print_mem(&lyb, running_config->dnode, LYD_LYB,
+				  LYP_WITHSIBLINGS)
+		    != 0) {
+			vty_out(vty, "Can't encode binary configuration.\n");
+			goto out_unlink;
+		}
+		lyb_len = lyd_lyb_data_length(lyb);
+		if (lyb_len < 0) {
+			vty_out(vty, "Can't encode binary configuration.\n");
+			goto out_unlink;
+		}
+	}
+
+	memcpy(hdr.magic, CONF_LYB_MAGIC, sizeof(hdr.magic));
+	hdr.lyb_len = htonl(lyb_len);
+
+	fd = mkstemp(lyb_file_tmp);
+	if (fd < 0) {
+		vty_out(vty, "Can't open binary configuration file %s.\n",
+			lyb_file_tmp);
+		goto out_unlink;
+	}
+	if (fchmod(fd, CONFIGFILE_MASK) != 0
+	    || write(fd, &hdr, sizeof(hdr)) != sizeof(hdr)
+	    || write(fd, lyb, lyb_len) != lyb_len) {
+		vty_out(vty, "Can't write binary configuration file %s: %s.\n",
+			lyb_file_tmp, safe_strerror(errno));
+		close(fd);
+		unlink(lyb_file_tmp);
+		goto out_unlink;
+	}
+
+	/* The rest is plain text, read as usual on startup. */
+	file_vty = vty_new();
+	file_vty->wfd = fd;
+	file_vty->type = VTY_FILE;
+	vty_write_config_nodes(file_vty, true);
+	vty_close(file_vty);
+
+	if (rename(lyb_file_tmp, lyb_file) != 0) {
+		vty_out(vty, "Can't save binary configuration file %s.\n",
+			lyb_file);
+		unlink(lyb_file_tmp);
+		goto out_unlink;
+	}
+	goto out;
+
+out_unlink:
+	/* don't leave an older one around, even if it would be rejected */
+	unlink(lyb_file);
+out:
+	free(lyb);
+	XFREE(MTYPE_TMP, lyb_file_tmp);
+	XFREE(MTYPE_TMP, lyb_file);
+}
+
 static int file_write_config(struct vty *vty)
 {
 	int fd, dirfd;
@@ -1664,6 +1772,9 @@ static int file_write_config(struct vty *vty)
 	vty_out(vty, "Configuration saved to %s\n", config_file);
 	ret = CMD_SUCCESS;
 
+	if (host.binary_config)
+		file_write_config_lyb(vty, config_file);
+
 finished:
 	if (ret != CMD_SUCCESS)
 		unlink(config_file_tmp);
@@ -74,6 +74,11 @@ struct host {
 	int advanced;
 	int encrypt;
 
+	/* Keep a binary (LYB) copy of the northbound configuration next to
+	 * the configuration file, and prefer it on startup.
+	 */
+	bool binary_config;
+
 	/* Banner configuration. */
 	char *motd;
 	char *motdfile;
@@ -192,6 +197,11 @@ struct cmd_node {
 	/* Node's configuration write function */
 	int (*config_write)(struct vty *);
 
+	/* config_write output comes entirely from the northbound running
+	 * configuration; see host.binary_config.
+	 */
+	bool config_nb;
+
 	/* called when leaving the node on a VTY session.
 	 * return 1 if normal exit processing should happen, 0 to suppress
 	 */
@@ -223,6 +233,7 @@ struct cmd_node {
 #define CMD_SUSPEND             12
 #define CMD_WARNING_CONFIG_FAILED 13
 #define CMD_NOT_MY_INSTANCE	14
+#define CMD_YIELD               15
 
 /* Argc max counts. */
 #define CMD_ARGC_MAX   256
@@ -435,6 +446,7 @@ struct cmd_node {
 
 #define CMD_VNI_RANGE "(1-16777215)"
 #define CONF_BACKUP_EXT ".sav"
+#define CONF_LYB_EXT ".lyb"
 #define MPLS_LDP_SYNC_STR "Enable MPLS LDP-SYNC\n"
 #define NO_MPLS_LDP_SYNC_STR "Disable MPLS LDP-SYNC\n"
 #define MPLS_LDP_SYNC_HOLDDOWN_STR                                             \
@@ -589,6 +601,28 @@ extern void host_config_set(const char *);
 
 extern void print_version(const char *);
 
+/*
+ * Binary configuration file (<config>.lyb), written along with the text
+ * configuration when host.binary_config is set:
+ *
+ *   struct conf_lyb_hdr
+ *   LYB encoded northbound running configuration (lyb_len bytes)
+ *   text configuration of all nodes without config_nb, up to EOF
+ *
+ * text_sha256 is the digest of the text configuration file saved at the
+ * same time.  The binary file is only used if it still matches.
+ */
+#define CONF_LYB_MAGIC "FRRLYB01"
+
+struct conf_lyb_hdr {
+	char magic[8];
+	uint8_t text_sha256[32];
+	/* network byte order */
+	uint32_t lyb_len;
+};
+
+extern void config_file_digest(FILE *fp, uint8_t digest[32]);
+
 extern int cmd_banner_motd_file(const char *);
 extern void cmd_banner_motd_line(const char *line);
 
@@ -819,6 +819,7 @@ static struct cmd_node access_node = {
 	.node = ACCESS_NODE,
 	.prompt = "",
 	.config_write = config_write_access,
+	.config_nb = true,
 };
 
 static int config_write_access(struct vty *vty)
@@ -59,10 +59,15 @@ int frrlua_table_get_integer(lua_State *L, const char *key)
  */
 
 void lua_pushprefix(lua_State *L, const struct prefix *prefix)
+{
+	lua_newtable(L);
+	lua_updateprefix(L, prefix);
+}
+
+void lua_updateprefix(lua_State *L, const struct prefix *prefix)
 {
 	char buffer[PREFIX_STRLEN];
 
-	lua_newtable(L);
 	lua_pushstring(L, prefix2str(prefix, buffer, PREFIX_STRLEN));
 	lua_setfield(L, -2, "network");
 	lua_pushinteger(L, prefix->prefixlen);
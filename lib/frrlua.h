@@ -50,6 +50,12 @@ static inline void lua_pushstring_wrapper(lua_State *L, const char *str)
  */
 void lua_pushprefix(lua_State *L, const struct prefix *prefix);
 
+/*
+ * Sets the fields of the prefix table on top of the stack, as pushed by
+ * lua_pushprefix(), to another prefix.
+ */
+void lua_updateprefix(lua_State *L, const struct prefix *prefix);
+
 /*
  * Converts the Lua value at idx to a prefix.
  *
@@ -21,6 +21,7 @@
 #ifdef HAVE_SCRIPTING
 
 #include <stdarg.h>
+#include <pthread.h>
 #include <lua.h>
 
 #include "frrscript.h"
@@ -28,6 +29,9 @@
 #include "memory.h"
 #include "hash.h"
 #include "log.h"
+#include "typesafe.h"
+#include "monotime.h"
+#include "frratomic.h"
 
 
 DEFINE_MTYPE_STATIC(LIB, SCRIPT, "Scripting");
@@ -43,7 +47,8 @@ struct frrscript_codec frrscript_codecs_lib[] = {
 	 .decoder = lua_tostringp},
 	{.typename = "prefix",
 	 .encoder = (encoder_func)lua_pushprefix,
-	 .decoder = lua_toprefix},
+	 .decoder = lua_toprefix,
+	 .update = (encoder_func)lua_updateprefix},
 	{.typename = "interface",
 	 .encoder = (encoder_func)lua_pushinterface,
 	 .decoder = lua_tointerface},
@@ -90,6 +95,7 @@ static void *codec_alloc(void *arg)
 	e->typename = XSTRDUP(MTYPE_SCRIPT, tmp->typename);
 	e->encoder = tmp->encoder;
 	e->decoder = tmp->decoder;
+	e->update = tmp->update;
 
 	return e;
 }
@@ -118,11 +124,24 @@ int frrscript_call(struct frrscript *fs, struct frrscript_env *env)
 
 		struct frrscript_codec *codec = hash_lookup(codec_hash, &c);
 		assert(codec && "No encoder for type");
+
+		/* Reuse the table from the previous call, if any */
+		if (codec->update) {
+			lua_getglobal(fs->L, bindname);
+			if (lua_istable(fs->L, -1)) {
+				codec->update(fs->L, arg);
+				lua_pop(fs->L, 1);
+				continue;
+			}
+			lua_pop(fs->L, 1);
+		}
+
 		codec->encoder(fs->L, arg);
 
 		lua_setglobal(fs->L, bindname);
 	}
 
+	lua_rawgeti(fs->L, LUA_REGISTRYINDEX, fs->chunk);
 	int ret = lua_pcall(fs->L, 0, 0, 0);
 
 	switch (ret) {
@@ -205,6 +224,7 @@ struct frrscript *frrscript_load(const char *name,
 	struct frrscript *fs = XCALLOC(MTYPE_SCRIPT, sizeof(struct frrscript));
 
 	fs->name = XSTRDUP(MTYPE_SCRIPT, name);
+	fs->chunk = LUA_NOREF;
 	fs->L = luaL_newstate();
 	frrlua_export_logging(fs->L);
 
@@ -242,6 +262,9 @@ struct frrscript *frrscript_load(const char *name,
 	if (ret != LUA_OK)
 		goto fail;
 
+	/* Keep the compiled chunk around, so it can be called repeatedly */
+	fs->chunk = luaL_ref(fs->L, LUA_REGISTRYINDEX);
+
 	if (load_cb && (*load_cb)(fs) != 0)
 		goto fail;
 
@@ -258,11 +281,125 @@ void frrscript_unload(struct frrscript *fs)
 	XFREE(MTYPE_SCRIPT, fs);
 }
 
+/* Per-pthread cache of loaded scripts, see frrscript_get() */
+
+#define SCRIPT_RECHECK_MSEC 1000
+
+PREDECL_DLIST(script_cache);
+
+struct script_cache_entry {
+	struct script_cache_item item;
+
+	struct frrscript *fs;
+
+	/* Script file and reload generation fs was loaded from */
+	struct stat st;
+	uint32_t generation;
+
+	/* Last time the file was checked for changes */
+	struct timeval checked;
+};
+
+DECLARE_DLIST(script_cache, struct script_cache_entry, item);
+
+static pthread_key_t script_cache_key;
+static _Atomic uint32_t script_generation;
+
+static void script_cache_free(void *arg)
+{
+	struct script_cache_head *head = arg;
+	struct script_cache_entry *entry;
+
+	while ((entry = script_cache_pop(head))) {
+		frrscript_unload(entry->fs);
+		XFREE(MTYPE_SCRIPT, entry);
+	}
+	script_cache_fini(head);
+	XFREE(MTYPE_SCRIPT, head);
+}
+
+static bool script_file_same(const struct stat *a, const struct stat *b)
+{
+	return a->st_dev == b->st_dev && a->st_ino == b->st_ino
+	       && a->st_size == b->st_size && a->st_mtime == b->st_mtime;
+}
+
+struct frrscript *frrscript_get(const char *name)
+{
+	struct script_cache_head *head;
+	struct script_cache_entry *entry;
+	struct frrscript *fs;
+	struct stat st = {};
+	char fname[MAXPATHLEN * 2];
+	uint32_t generation = atomic_load_explicit(&script_generation,
+						   memory_order_relaxed);
+
+	head = pthread_getspecific(script_cache_key);
+	if (!head) {
+		head = XCALLOC(MTYPE_SCRIPT, sizeof(*head));
+		script_cache_init(head);
+		pthread_setspecific(script_cache_key, head);
+	}
+
+	frr_each (script_cache, head, entry)
+		if (strmatch(entry->fs->name, name))
+			break;
+
+	if (entry && entry->generation == generation
+	    && monotime_since(&entry->checked, NULL)
+		       < SCRIPT_RECHECK_MSEC * 1000)
+		return entry->fs;
+
+	snprintf(fname, sizeof(fname), "%s/%s.lua", scriptdir, name);
+	(void)stat(fname, &st);
+
+	if (entry) {
+		monotime(&entry->checked);
+		if (entry->generation == generation
+		    && script_file_same(&entry->st, &st))
+			return entry->fs;
+
+		/* don't retry until the next change */
+		entry->generation = generation;
+		entry->st = st;
+
+		fs = frrscript_load(name, NULL);
+		if (!fs) {
+			zlog_warn("Keeping previous version of script '%s'",
+				  name);
+			return entry->fs;
+		}
+		frrscript_unload(entry->fs);
+		entry->fs = fs;
+		return fs;
+	}
+
+	fs = frrscript_load(name, NULL);
+	if (!fs)
+		return NULL;
+
+	entry = XCALLOC(MTYPE_SCRIPT, sizeof(*entry));
+	entry->fs = fs;
+	entry->st = st;
+	entry->generation = generation;
+	monotime(&entry->checked);
+	script_cache_add_tail(head, entry);
+
+	return fs;
+}
+
+void frrscript_reload_all(void)
+{
+	atomic_fetch_add_explicit(&script_generation, 1, memory_order_relaxed);
+}
+
 void frrscript_init(const char *sd)
 {
 	codec_hash = hash_create(codec_hash_key, codec_hash_cmp,
 				 "Lua type encoders");
 
+	pthread_key_create(&script_cache_key, script_cache_free);
+
 	strlcpy(scriptdir, sd, sizeof(scriptdir));
 
 	/* Register core library types */
@@ -37,6 +37,13 @@ struct frrscript_codec {
 	const char *typename;
 	encoder_func encoder;
 	decoder_func decoder;
+
+	/*
+	 * Optional. Refreshes the table on top of the stack, previously
+	 * pushed by encoder, with a new value. Used when a script is called
+	 * again, so arguments don't need a new table on every call.
+	 */
+	encoder_func update;
 };
 
 struct frrscript {
@@ -45,6 +52,9 @@ struct frrscript {
 
 	/* Lua state */
 	struct lua_State *L;
+
+	/* Registry reference to the compiled script */
+	int chunk;
 };
 
 struct frrscript_env {
@@ -69,6 +79,29 @@ struct frrscript *frrscript_load(const char *name,
  */
 void frrscript_unload(struct frrscript *fs);
 
+/*
+ * Get a loaded and compiled instance of a script, for repeated calls from
+ * the calling pthread. Each pthread keeps its own instances, so no locking
+ * is involved.
+ *
+ * A script is loaded on first use and kept until its file changes (checked
+ * at most once a second) or frrscript_reload_all() is called. If the new
+ * version fails to load, the old one stays in use. Since instances are
+ * reused, global variables set by a script persist between calls.
+ *
+ * The returned script must not be unloaded, and is valid until the next
+ * frrscript_get() for the same name on this pthread.
+ *
+ * Returns:
+ *    The script, or NULL if it can't be loaded.
+ */
+struct frrscript *frrscript_get(const char *name);
+
+/*
+ * Reload all scripts on their next use, on all pthreads.
+ */
+void frrscript_reload_all(void);
+
 /*
  * Register a Lua codec for a type.
  *
@@ -98,10 +131,11 @@ void frrscript_init(const char *scriptdir);
 
 
 /*
- * Call script.
+ * Call script. A script can be called any number of times.
  *
  * fs
- *    The script to call; this is obtained from frrscript_load().
+ *    The script to call; this is obtained from frrscript_load() or
+ *    frrscript_get().
  *
  * env
  *    The script's environment. Specify this as an array of frrscript_env.
@@ -0,0 +1,499 @@
+/*
+ * Hello transmission and hold timers on a separate pthread.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <zebra.h>
+
+#include "hello_thread.h"
+#include "frr_pthread.h"
+#include "frratomic.h"
+#include "log.h"
+#include "memory.h"
+#include "monotime.h"
+#include "network.h"
+#include "typesafe.h"
+
+DEFINE_MTYPE_STATIC(LIB, HELLO_TX, "Hello transmitter")
+DEFINE_MTYPE_STATIC(LIB, HELLO_TX_PKT, "Hello packet")
+DEFINE_MTYPE_STATIC(LIB, HELLO_HOLD, "Hello hold timer")
+
+/* transmissions due within this much of each other are done together */
+#define HELLO_TX_TOLERANCE_USEC 20000
+/* refresh callbacks run this long before the transmission, at most */
+#define HELLO_REFRESH_LEAD_MSEC 200
+/* nothing to do; wake up once in a while anyway */
+#define HELLO_IDLE_USEC 1000000
+
+PREDECL_DLIST(hello_txs)
+
+struct hello_tx {
+	struct hello_txs_item item;
+
+	void (*refresh)(void *arg);
+	void *arg;
+
+	/* protected by hello_mtx */
+	int fd;
+	uint32_t interval_msec;
+	unsigned int jitter_pct;
+	struct sockaddr_storage dst;
+	socklen_t dstlen;
+	ifindex_t ifindex;
+	uint8_t *pkt;
+	size_t len;
+	int64_t next;
+	bool failing;
+
+	_Atomic uint32_t sent;
+
+	/* runs on the main pthread, scheduled by the hello pthread */
+	struct thread *t_refresh;
+};
+
+DECLARE_DLIST(hello_txs, struct hello_tx, item)
+
+PREDECL_DLIST(hello_holds)
+
+struct hello_hold {
+	struct hello_holds_item item;
+
+	void (*expire)(void *arg);
+	void *arg;
+
+	/* written by the main pthread only; 0 = not running */
+	_Atomic int64_t deadline;
+	/* protected by hello_mtx; t_expire is pending */
+	bool posted;
+
+	struct thread *t_expire;
+};
+
+DECLARE_DLIST(hello_holds, struct hello_hold, item)
+
+static pthread_mutex_t hello_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t hello_cond;
+static struct hello_txs_head txs = INIT_DLIST(txs);
+static struct hello_holds_head holds = INIT_DLIST(holds);
+
+static struct frr_pthread *hello_pth;
+static struct thread_master *hello_main;
+
+static int64_t hello_now(void)
+{
+	struct timeval tv;
+
+	monotime(&tv);
+	return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+/* Requires: hello_mtx */
+static void hello_wake(void)
+{
+	if (hello_pth)
+		pthread_cond_signal(&hello_cond);
+}
+
+/* Requires: hello_mtx */
+static int64_t hello_tx_interval(struct hello_tx *tx)
+{
+	int64_t usec = (int64_t)tx->interval_msec * 1000;
+
+	if (tx->jitter_pct)
+		usec -= usec * (frr_weak_random() % (tx->jitter_pct + 1)) / 100;
+	return usec;
+}
+
+/* Requires: hello_mtx */
+static void hello_tx_send(struct hello_tx *tx)
+{
+	struct msghdr msg = {};
+	struct iovec iov;
+#if defined(GNU_LINUX) && defined(IP_PKTINFO)
+	union {
+		struct cmsghdr align;
+		char buf[CMSG_SPACE(sizeof(struct in_pktinfo))];
+	} cmsgbuf = {};
+#endif
+
+	iov.iov_base = tx->pkt;
+	iov.iov_len = tx->len;
+	msg.msg_name = &tx->dst;
+	msg.msg_namelen = tx->dstlen;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+
+#if defined(GNU_LINUX) && defined(IP_PKTINFO)
+	if (tx->dst.ss_family == AF_INET && tx->ifindex) {
+		struct cmsghdr *cm;
+		struct in_pktinfo *pi;
+
+		msg.msg_control = cmsgbuf.buf;
+		msg.msg_controllen = sizeof(cmsgbuf.buf);
+		cm = CMSG_FIRSTHDR(&msg);
+		cm->cmsg_level = IPPROTO_IP;
+		cm->cmsg_type = IP_PKTINFO;
+		cm->cmsg_len = CMSG_LEN(sizeof(*pi));
+		pi = (struct in_pktinfo *)CMSG_DATA(cm);
+		pi->ipi_ifindex = tx->ifindex;
+	}
+#endif
+
+	if (sendmsg(tx->fd, &msg, 0) < 0) {
+		/* once per streak of failures, interfaces do go down */
+		if (!tx->failing)
+			zlog_warn("%s: hello on fd %d, ifindex %d failed: %s",
+				  __func__, tx->fd, tx->ifindex,
+				  safe_strerror(errno));
+		tx->failing = true;
+		return;
+	}
+	tx->failing = false;
+	atomic_fetch_add_explicit(&tx->sent, 1, memory_order_relaxed);
+}
+
+static int hello_tx_refresh(struct thread *t)
+{
+	struct hello_tx *tx = THREAD_ARG(t);
+
+	tx->refresh(tx->arg);
+	return 0;
+}
+
+/* Requires: hello_mtx; on the hello pthread */
+static void hello_tx_process(struct hello_tx *tx, int64_t now, int64_t *wake)
+{
+	long delay;
+
+	if (!tx->pkt || !tx->interval_msec)
+		return;
+
+	if (tx->next > now + HELLO_TX_TOLERANCE_USEC) {
+		*wake = MIN(*wake, tx->next);
+		return;
+	}
+
+	hello_tx_send(tx);
+	tx->next = now + hello_tx_interval(tx);
+	*wake = MIN(*wake, tx->next);
+
+	delay = (tx->next - now) / 1000;
+	delay -= MIN(delay / 4, HELLO_REFRESH_LEAD_MSEC);
+	thread_add_timer_msec(hello_main, hello_tx_refresh, tx, delay,
+			      &tx->t_refresh);
+}
+
+static int hello_hold_confirm(struct thread *t)
+{
+	struct hello_hold *hold = THREAD_ARG(t);
+	int64_t deadline;
+
+	deadline = atomic_load_explicit(&hold->deadline, memory_order_relaxed);
+	if (deadline && deadline <= hello_now()) {
+		atomic_store_explicit(&hold->deadline, 0, memory_order_relaxed);
+		frr_with_mutex(&hello_mtx) {
+			hold->posted = false;
+		}
+		hold->expire(hold->arg);
+		return 0;
+	}
+
+	frr_with_mutex(&hello_mtx) {
+		hold->posted = false;
+	}
+	return 0;
+}
+
+/*
+ * Posted by the hello pthread, this runs before whatever I/O the main
+ * pthread picks up next.  Check again after that, a hello refreshing the
+ * hold timer may be among it.
+ */
+static int hello_hold_check(struct thread *t)
+{
+	struct hello_hold *hold = THREAD_ARG(t);
+
+	thread_add_event(hello_main, hello_hold_confirm, hold, 0,
+			 &hold->t_expire);
+	return 0;
+}
+
+/* Requires: hello_mtx; on the hello pthread */
+static void hello_hold_process(struct hello_hold *hold, int64_t now,
+			       int64_t *wake)
+{
+	int64_t deadline;
+
+	deadline = atomic_load_explicit(&hold->deadline, memory_order_relaxed);
+	if (!deadline || hold->posted)
+		return;
+
+	if (deadline > now) {
+		*wake = MIN(*wake, deadline);
+		return;
+	}
+
+	hold->posted = true;
+	thread_add_event(hello_main, hello_hold_check, hold, 0,
+			 &hold->t_expire);
+}
+
+static void *hello_thread_run(void *arg)
+{
+	struct frr_pthread *fpt = arg;
+	struct hello_tx *tx;
+	struct hello_hold *hold;
+	struct timespec ts;
+	int64_t now, wake;
+
+	fpt->master->owner = pthread_self();
+
+	/* not using the frr_pthread event loop, see bgp_keepalives_start() */
+	frr_pthread_set_name(fpt);
+
+	pthread_mutex_lock(&hello_mtx);
+	frr_pthread_notify_running(fpt);
+
+	while (atomic_load_explicit(&fpt->running, memory_order_relaxed)) {
+		now = hello_now();
+		wake = now + HELLO_IDLE_USEC;
+
+		frr_each (hello_txs, &txs, tx)
+			hello_tx_process(tx, now, &wake);
+		frr_each (hello_holds, &holds, hold)
+			hello_hold_process(hold, now, &wake);
+
+		ts.tv_sec = wake / 1000000;
+		ts.tv_nsec = (wake % 1000000) * 1000;
+		pthread_cond_timedwait(&hello_cond, &hello_mtx, &ts);
+	}
+
+	pthread_mutex_unlock(&hello_mtx);
+	return NULL;
+}
+
+static int hello_thread_stop(struct frr_pthread *fpt, void **result)
+{
+	assert(fpt->running);
+
+	frr_with_mutex(&hello_mtx) {
+		atomic_store_explicit(&fpt->running, false,
+				      memory_order_relaxed);
+		pthread_cond_signal(&hello_cond);
+	}
+	pthread_join(fpt->thread, result);
+
+	frr_with_mutex(&hello_mtx) {
+		hello_pth = NULL;
+	}
+	return 0;
+}
+
+/* Stopped (and freed) by frr_fini(), along with all other pthreads */
+void hello_thread_start(struct thread_master *master)
+{
+	struct frr_pthread_attr attr = {
+		.start = hello_thread_run,
+		.stop = hello_thread_stop,
+	};
+	pthread_condattr_t condattr;
+
+	assert(!hello_pth);
+
+	/* timestamps are monotime() */
+	pthread_condattr_init(&condattr);
+	pthread_condattr_setclock(&condattr, CLOCK_MONOTONIC);
+	pthread_cond_init(&hello_cond, &condattr);
+	pthread_condattr_destroy(&condattr);
+
+	hello_main = master;
+	hello_pth = frr_pthread_new(&attr, "Hello thread", "hello");
+	frr_pthread_run(hello_pth, NULL);
+	frr_pthread_wait_running(hello_pth);
+}
+
+struct hello_tx *hello_tx_new(void (*refresh)(void *arg), void *arg)
+{
+	struct hello_tx *tx;
+
+	tx = XCALLOC(MTYPE_HELLO_TX, sizeof(*tx));
+	tx->fd = -1;
+	tx->refresh = refresh;
+	tx->arg = arg;
+
+	frr_with_mutex(&hello_mtx) {
+		hello_txs_add_tail(&txs, tx);
+	}
+	return tx;
+}
+
+void hello_tx_free(struct hello_tx **txp)
+{
+	struct hello_tx *tx = *txp;
+
+	if (!tx)
+		return;
+
+	frr_with_mutex(&hello_mtx) {
+		hello_txs_del(&txs, tx);
+	}
+	/* the hello pthread doesn't know about tx anymore */
+	THREAD_OFF(tx->t_refresh);
+
+	XFREE(MTYPE_HELLO_TX_PKT, tx->pkt);
+	XFREE(MTYPE_HELLO_TX, tx);
+	*txp = NULL;
+}
+
+void hello_tx_set_interval(struct hello_tx *tx, uint32_t interval_msec,
+			   unsigned int jitter_pct)
+{
+	int64_t next;
+
+	frr_with_mutex(&hello_mtx) {
+		if (tx->interval_msec == interval_msec
+		    && tx->jitter_pct == jitter_pct)
+			break;
+
+		tx->interval_msec = interval_msec;
+		tx->jitter_pct = MIN(jitter_pct, 100);
+		if (!interval_msec)
+			break;
+
+		next = hello_now() + hello_tx_interval(tx);
+		if (!tx->next || next < tx->next) {
+			tx->next = next;
+			hello_wake();
+		}
+	}
+	if (!interval_msec)
+		THREAD_OFF(tx->t_refresh);
+}
+
+void hello_tx_update(struct hello_tx *tx, int fd, const struct sockaddr *dst,
+		     socklen_t dstlen, ifindex_t ifindex, const void *data,
+		     size_t len, bool send_now)
+{
+	assert(dstlen <= sizeof(tx->dst));
+
+	frr_with_mutex(&hello_mtx) {
+		if (len != tx->len) {
+			XFREE(MTYPE_HELLO_TX_PKT, tx->pkt);
+			tx->pkt = XMALLOC(MTYPE_HELLO_TX_PKT, len);
+			tx->len = len;
+		}
+		memcpy(tx->pkt, data, len);
+		tx->fd = fd;
+		memcpy(&tx->dst, dst, dstlen);
+		tx->dstlen = dstlen;
+		tx->ifindex = ifindex;
+
+		if (!send_now)
+			break;
+
+		hello_tx_send(tx);
+		if (tx->interval_msec) {
+			tx->next = hello_now() + hello_tx_interval(tx);
+			hello_wake();
+		}
+	}
+}
+
+long hello_tx_remain_msec(struct hello_tx *tx)
+{
+	long remain = -1;
+	int64_t now;
+
+	frr_with_mutex(&hello_mtx) {
+		if (!tx->pkt || !tx->interval_msec || !tx->next)
+			break;
+		now = hello_now();
+		remain = tx->next > now ? (tx->next - now) / 1000 : 0;
+	}
+	return remain;
+}
+
+uint32_t hello_tx_collect(struct hello_tx *tx)
+{
+	return atomic_exchange_explicit(&tx->sent, 0, memory_order_relaxed);
+}
+
+struct hello_hold *hello_hold_new(void (*expire)(void *arg), void *arg)
+{
+	struct hello_hold *hold;
+
+	hold = XCALLOC(MTYPE_HELLO_HOLD, sizeof(*hold));
+	hold->expire = expire;
+	hold->arg = arg;
+
+	frr_with_mutex(&hello_mtx) {
+		hello_holds_add_tail(&holds, hold);
+	}
+	return hold;
+}
+
+void hello_hold_free(struct hello_hold **holdp)
+{
+	struct hello_hold *hold = *holdp;
+
+	if (!hold)
+		return;
+
+	frr_with_mutex(&hello_mtx) {
+		hello_holds_del(&holds, hold);
+	}
+	THREAD_OFF(hold->t_expire);
+
+	XFREE(MTYPE_HELLO_HOLD, hold);
+	*holdp = NULL;
+}
+
+void hello_hold_refresh(struct hello_hold *hold, uint32_t hold_msec)
+{
+	int64_t deadline = hello_now() + (int64_t)hold_msec * 1000;
+	int64_t prev;
+
+	prev = atomic_exchange_explicit(&hold->deadline, deadline,
+					memory_order_relaxed);
+
+	/* the hello pthread may be sleeping past the new deadline */
+	if (!prev || deadline < prev) {
+		frr_with_mutex(&hello_mtx) {
+			hello_wake();
+		}
+	}
+}
+
+void hello_hold_stop(struct hello_hold *hold)
+{
+	atomic_store_explicit(&hold->deadline, 0, memory_order_relaxed);
+	THREAD_OFF(hold->t_expire);
+	frr_with_mutex(&hello_mtx) {
+		hold->posted = false;
+	}
+}
+
+long hello_hold_remain_msec(const struct hello_hold *hold)
+{
+	int64_t deadline, now;
+
+	deadline = atomic_load_explicit(&hold->deadline, memory_order_relaxed);
+	if (!deadline)
+		return -1;
+
+	now = hello_now();
+	return deadline > now ? (deadline - now) / 1000 : 0;
+}
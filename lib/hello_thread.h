@@ -0,0 +1,98 @@
+/*
+ * Hello transmission and hold timers on a separate pthread.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef _FRR_HELLO_THREAD_H
+#define _FRR_HELLO_THREAD_H
+
+#include "thread.h"
+#include "if.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Keeps adjacencies of link state protocols up while the main pthread is
+ * busy with long tasks (SPF, LSDB refresh, ...), modelled on bgpd's
+ * keepalives pthread.
+ *
+ * hello_tx: the main pthread builds a hello packet and hands a copy to the
+ * hello pthread, which sends it every interval.  Since packet contents can
+ * only change on the main pthread, a busy main pthread just means the
+ * packet is resent as is.  Shortly before every transmission the refresh
+ * callback is scheduled on the main pthread so it can rebuild the packet;
+ * if the main pthread doesn't get to it in time, the previous one is sent.
+ *
+ * hello_hold: the main pthread refreshes the hold timer when it receives a
+ * hello (which is just an atomic store) and the hello pthread notices when
+ * it expires.  The expiry callback then runs on the main pthread, but only
+ * after input that was already pending at that point has been processed,
+ * so a hello stuck behind a long task doesn't cause a spurious expiry.
+ *
+ * All functions except hello_thread_start() are safe to call before it or
+ * after the pthread has stopped; nothing is sent or expired then.
+ */
+struct hello_tx;
+struct hello_hold;
+
+extern void hello_thread_start(struct thread_master *master);
+
+/* refresh() is called on the main pthread, see above */
+extern struct hello_tx *hello_tx_new(void (*refresh)(void *arg), void *arg);
+extern void hello_tx_free(struct hello_tx **txp);
+
+/*
+ * interval_msec == 0 stops transmission.  jitter_pct randomly shortens
+ * each interval by up to that many percent.
+ */
+extern void hello_tx_set_interval(struct hello_tx *tx, uint32_t interval_msec,
+				  unsigned int jitter_pct);
+
+/*
+ * Replace the packet sent to dst through fd.  On Linux, AF_INET packets
+ * are sent with an IP_PKTINFO control message for ifindex (if nonzero), so
+ * they go out the right interface without changing multicast socket
+ * options.  With send_now, the packet is sent immediately and the interval
+ * restarts.
+ */
+extern void hello_tx_update(struct hello_tx *tx, int fd,
+			    const struct sockaddr *dst, socklen_t dstlen,
+			    ifindex_t ifindex, const void *data, size_t len,
+			    bool send_now);
+
+/* milliseconds until the next transmission, or -1 if none is scheduled */
+extern long hello_tx_remain_msec(struct hello_tx *tx);
+
+/* Number of packets sent since the previous call */
+extern uint32_t hello_tx_collect(struct hello_tx *tx);
+
+extern struct hello_hold *hello_hold_new(void (*expire)(void *arg),
+					 void *arg);
+extern void hello_hold_free(struct hello_hold **holdp);
+
+/* (re)start the hold timer */
+extern void hello_hold_refresh(struct hello_hold *hold, uint32_t hold_msec);
+extern void hello_hold_stop(struct hello_hold *hold);
+/* milliseconds until expiry, or -1 if not running */
+extern long hello_hold_remain_msec(const struct hello_hold *hold);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FRR_HELLO_THREAD_H */
@@ -44,6 +44,7 @@ DEFINE_MTYPE_STATIC(LIB, CONNECTED, "Connected")
 DEFINE_MTYPE_STATIC(LIB, NBR_CONNECTED, "Neighbor Connected")
 DEFINE_MTYPE(LIB, CONNECTED_LABEL, "Connected interface label")
 DEFINE_MTYPE_STATIC(LIB, IF_LINK_PARAMS, "Informational Link Parameters")
+DEFINE_MTYPE_STATIC(LIB, IF_ADDR_INDEX, "Interface address index")
 
 static struct interface *if_lookup_by_ifindex(ifindex_t ifindex,
 					      vrf_id_t vrf_id);
@@ -55,6 +56,53 @@ RB_GENERATE(if_index_head, interface, index_entry, if_cmp_index_func);
 
 DEFINE_QOBJ_TYPE(interface)
 
+/*
+ * All interfaces with a valid ifindex, ordered by (ifindex, vrf_id) so
+ * if_lookup_by_index_all_vrf() finds the same interface walking the
+ * VRFs by id would, without walking them.
+ */
+static int if_index_all_cmp(const struct interface *ifp1,
+			    const struct interface *ifp2)
+{
+	if (ifp1->ifindex != ifp2->ifindex)
+		return numcmp(ifp1->ifindex, ifp2->ifindex);
+
+	return numcmp(ifp1->vrf_id, ifp2->vrf_id);
+}
+
+DECLARE_RBTREE_UNIQ(if_index_all, struct interface, index_all_entry,
+		    if_index_all_cmp);
+
+static struct if_index_all_head if_index_all_head = INIT_RBTREE_UNIQ(
+	if_index_all_head);
+
+/*
+ * Per-VRF index of interface addresses: host address -> connected for
+ * exact lookups and connected prefix -> connected for longest prefix
+ * lookups.  Route node info is a list, since several interfaces may
+ * carry the same address.
+ */
+struct if_addr_index {
+	struct route_table *addr[AFI_MAX];
+	struct route_table *net[AFI_MAX];
+};
+
+/* Add/remove ifp to/from the ifindex indexes of vrf and of all VRFs */
+static int if_index_add(struct vrf *vrf, struct interface *ifp)
+{
+	if (IFINDEX_RB_INSERT(vrf, ifp))
+		return -1;
+
+	if_index_all_add(&if_index_all_head, ifp);
+	return 0;
+}
+
+static void if_index_del(struct vrf *vrf, struct interface *ifp)
+{
+	if (IFINDEX_RB_REMOVE(vrf, ifp))
+		if_index_all_del(&if_index_all_head, ifp);
+}
+
 DEFINE_HOOK(if_add, (struct interface * ifp), (ifp))
 DEFINE_KOOH(if_del, (struct interface * ifp), (ifp))
 
@@ -235,6 +283,8 @@ struct interface *if_create_ifindex(ifindex_t ifindex, vrf_id_t vrf_id)
 void if_update_to_new_vrf(struct interface *ifp, vrf_id_t vrf_id)
 {
 	struct vrf *old_vrf, *vrf;
+	struct listnode *node;
+	struct connected *ifc;
 
 	/* remove interface from old master vrf list */
 	old_vrf = vrf_lookup_by_id(ifp->vrf_id);
@@ -243,7 +293,7 @@ void if_update_to_new_vrf(struct interface *ifp, vrf_id_t vrf_id)
 			IFNAME_RB_REMOVE(old_vrf, ifp);
 
 		if (ifp->ifindex != IFINDEX_INTERNAL)
-			IFINDEX_RB_REMOVE(old_vrf, ifp);
+			if_index_del(old_vrf, ifp);
 	}
 
 	ifp->vrf_id = vrf_id;
@@ -253,7 +303,10 @@ void if_update_to_new_vrf(struct interface *ifp, vrf_id_t vrf_id)
 		IFNAME_RB_INSERT(vrf, ifp);
 
 	if (ifp->ifindex != IFINDEX_INTERNAL)
-		IFINDEX_RB_INSERT(vrf, ifp);
+		if_index_add(vrf, ifp);
+
+	for (ALL_LIST_ELEMENTS_RO(ifp->connected, node, ifc))
+		connected_index_update(ifc);
 
 	/*
 	 * HACK: Change the interface VRF in the running configuration directly,
@@ -308,7 +361,7 @@ void if_delete(struct interface **ifp)
 
 	IFNAME_RB_REMOVE(vrf, ptr);
 	if (ptr->ifindex != IFINDEX_INTERNAL)
-		IFINDEX_RB_REMOVE(vrf, ptr);
+		if_index_del(vrf, ptr);
 
 	if_delete_retain(ptr);
 
@@ -447,17 +500,17 @@ struct interface *if_lookup_by_name_all_vrf(const char *name)
 
 struct interface *if_lookup_by_index_all_vrf(ifindex_t ifindex)
 {
-	struct vrf *vrf;
+	struct interface ref;
 	struct interface *ifp;
 
 	if (ifindex == IFINDEX_INTERNAL)
 		return NULL;
 
-	RB_FOREACH (vrf, vrf_id_head, &vrfs_by_id) {
-		ifp = if_lookup_by_ifindex(ifindex, vrf->vrf_id);
-		if (ifp)
-			return ifp;
-	}
+	ref.ifindex = ifindex;
+	ref.vrf_id = 0;
+	ifp = if_index_all_find_gteq(&if_index_all_head, &ref);
+	if (ifp && ifp->ifindex == ifindex && ifp->vrf_id != VRF_UNKNOWN)
+		return ifp;
 
 	return NULL;
 }
@@ -467,31 +520,37 @@ struct interface *if_lookup_exact_address(const void *src, int family,
 					  vrf_id_t vrf_id)
 {
 	struct vrf *vrf = vrf_lookup_by_id(vrf_id);
-	struct listnode *cnode;
-	struct interface *ifp;
-	struct prefix *p;
+	struct route_table *table;
+	struct route_node *rn;
+	struct prefix p = {};
 	struct connected *c;
 
-	FOR_ALL_INTERFACES (vrf, ifp) {
-		for (ALL_LIST_ELEMENTS_RO(ifp->connected, cnode, c)) {
-			p = c->address;
-
-			if (p && (p->family == family)) {
-				if (family == AF_INET) {
-					if (IPV4_ADDR_SAME(
-						    &p->u.prefix4,
-						    (struct in_addr *)src))
-						return ifp;
-				} else if (family == AF_INET6) {
-					if (IPV6_ADDR_SAME(
-						    &p->u.prefix6,
-						    (struct in6_addr *)src))
-						return ifp;
-				}
-			}
-		}
-	}
-	return NULL;
+	if (!vrf || !vrf->addr_index)
+		return NULL;
+
+	if (family == AF_INET) {
+		p.family = AF_INET;
+		p.prefixlen = IPV4_MAX_BITLEN;
+		p.u.prefix4 = *(struct in_addr *)src;
+	} else if (family == AF_INET6) {
+		p.family = AF_INET6;
+		p.prefixlen = IPV6_MAX_BITLEN;
+		p.u.prefix6 = *(struct in6_addr *)src;
+	} else
+		return NULL;
+
+	table = vrf->addr_index->addr[family2afi(family)];
+	if (!table)
+		return NULL;
+
+	rn = route_node_lookup(table, &p);
+	if (!rn)
+		return NULL;
+
+	c = listnode_head((struct list *)rn->info);
+	route_unlock_node(rn);
+
+	return c ? c->ifp : NULL;
 }
 
 /* Lookup interface by IP address. */
@@ -502,7 +561,7 @@ struct connected *if_lookup_address(const void *matchaddr, int family,
 	struct prefix addr;
 	int bestlen = 0;
 	struct listnode *cnode;
-	struct interface *ifp;
+	struct route_node *rn, *node;
 	struct connected *c;
 	struct connected *match;
 
@@ -518,16 +577,32 @@ struct connected *if_lookup_address(const void *matchaddr, int family,
 
 	match = NULL;
 
-	FOR_ALL_INTERFACES (vrf, ifp) {
-		for (ALL_LIST_ELEMENTS_RO(ifp->connected, cnode, c)) {
-			if (c->address && (c->address->family == AF_INET)
-			    && prefix_match(CONNECTED_PREFIX(c), &addr)
+	/* Only IPv4 addresses are matched, as has always been the case */
+	if (family != AF_INET || !vrf || !vrf->addr_index
+	    || !vrf->addr_index->net[AFI_IP])
+		return NULL;
+
+	rn = route_node_match(vrf->addr_index->net[AFI_IP], &addr);
+	if (!rn)
+		return NULL;
+
+	/*
+	 * The longest covering network may only hold addresses with a shorter
+	 * prefixlen than a less specific one (peer addresses); walk up.
+	 */
+	for (node = rn; node; node = node->parent) {
+		if (!node->info)
+			continue;
+		for (ALL_LIST_ELEMENTS_RO((struct list *)node->info, cnode, c)) {
+			if (prefix_match(CONNECTED_PREFIX(c), &addr)
 			    && (c->address->prefixlen > bestlen)) {
 				bestlen = c->address->prefixlen;
 				match = c;
 			}
 		}
 	}
+	route_unlock_node(rn);
+
 	return match;
 }
 
@@ -653,7 +728,7 @@ int if_set_index(struct interface *ifp, ifindex_t ifindex)
 		return -1;
 
 	if (ifp->ifindex != IFINDEX_INTERNAL)
-		IFINDEX_RB_REMOVE(vrf, ifp);
+		if_index_del(vrf, ifp);
 
 	ifp->ifindex = ifindex;
 
@@ -663,7 +738,7 @@ int if_set_index(struct interface *ifp, ifindex_t ifindex)
 		 * already an interface with the desired ifindex at the top of
 		 * the function. Nevertheless.
 		 */
-		if (IFINDEX_RB_INSERT(vrf, ifp))
+		if (if_index_add(vrf, ifp))
 			return -1;
 	}
 
@@ -836,6 +911,122 @@ void if_dump_all(void)
 			if_dump(ifp);
 }
 
+/* Address or prefix index of the VRF for afi, created on first use. */
+static struct route_table *if_addr_index_table(struct vrf *vrf, afi_t afi,
+					       bool net)
+{
+	struct route_table **table;
+
+	if (!vrf->addr_index)
+		vrf->addr_index =
+			XCALLOC(MTYPE_IF_ADDR_INDEX, sizeof(*vrf->addr_index));
+
+	table = net ? &vrf->addr_index->net[afi] : &vrf->addr_index->addr[afi];
+	if (!*table)
+		*table = route_table_init();
+
+	return *table;
+}
+
+static void if_addr_index_free(struct vrf *vrf)
+{
+	afi_t afi;
+
+	if (!vrf->addr_index)
+		return;
+
+	for (afi = AFI_IP; afi < AFI_MAX; afi++) {
+		if (vrf->addr_index->addr[afi])
+			route_table_finish(vrf->addr_index->addr[afi]);
+		if (vrf->addr_index->net[afi])
+			route_table_finish(vrf->addr_index->net[afi]);
+	}
+	XFREE(MTYPE_IF_ADDR_INDEX, vrf->addr_index);
+}
+
+static struct route_node *if_addr_index_link(struct route_table *table,
+					     const struct prefix *p,
+					     struct connected *ifc)
+{
+	struct route_node *rn;
+
+	rn = route_node_get(table, p);
+	if (rn->info)
+		route_unlock_node(rn);
+	else
+		rn->info = list_new();
+
+	listnode_add(rn->info, ifc);
+	return rn;
+}
+
+static void if_addr_index_unlink(struct route_node **rnp,
+				 struct connected *ifc)
+{
+	struct route_node *rn = *rnp;
+	struct list *list;
+
+	if (!rn)
+		return;
+
+	list = rn->info;
+	listnode_delete(list, ifc);
+	if (!listcount(list)) {
+		list_delete(&list);
+		rn->info = NULL;
+		route_unlock_node(rn);
+	}
+	*rnp = NULL;
+}
+
+static void connected_index_del(struct connected *ifc)
+{
+	if_addr_index_unlink(&ifc->addr_rn, ifc);
+	if_addr_index_unlink(&ifc->net_rn, ifc);
+}
+
+static void connected_index_add(struct connected *ifc)
+{
+	const struct prefix *np;
+	struct prefix p;
+	struct vrf *vrf;
+	afi_t afi;
+
+	if (!ifc->address || (ifc->address->family != AF_INET
+			      && ifc->address->family != AF_INET6))
+		return;
+
+	vrf = vrf_lookup_by_id(ifc->ifp->vrf_id);
+	if (!vrf)
+		return;
+
+	afi = family2afi(ifc->address->family);
+
+	prefix_copy(&p, ifc->address);
+	p.prefixlen = prefix_blen(&p) * 8;
+	ifc->addr_rn = if_addr_index_link(if_addr_index_table(vrf, afi, false),
+					  &p, ifc);
+
+	np = CONNECTED_PREFIX(ifc);
+	if (!np || np->family != ifc->address->family)
+		return;
+
+	prefix_copy(&p, np);
+	apply_mask(&p);
+	ifc->net_rn = if_addr_index_link(if_addr_index_table(vrf, afi, true),
+					 &p, ifc);
+}
+
+/*
+ * Reindex a connected address whose flags, destination or interface VRF
+ * changed after it was added to its interface.
+ */
+void connected_index_update(struct connected *ifc)
+{
+	connected_index_del(ifc);
+	connected_index_add(ifc);
+}
+
 /* Allocate connected structure. */
 struct connected *connected_new(void)
 {
@@ -853,6 +1044,8 @@ void connected_free(struct connected **connected)
 {
 	struct connected *ptr = *connected;
 
+	connected_index_del(ptr);
+
 	prefix_free(&ptr->address);
 	prefix_free(&ptr->destination);
 
@@ -988,6 +1181,7 @@ struct connected *connected_delete_by_prefix(struct interface *ifp,
 
 		if (connected_same_prefix(ifc->address, p)) {
 			listnode_delete(ifp->connected, ifc);
+			connected_index_del(ifc);
 			return ifc;
 		}
 	}
@@ -1036,10 +1230,17 @@ struct connected *connected_add_by_prefix(struct interface *ifp,
 	}
 
 	/* Add connected address to the interface. */
-	listnode_add(ifp->connected, ifc);
+	connected_add(ifp, ifc);
 	return ifc;
 }
 
+/* Add connected address to the interface and to the VRF address index. */
+void connected_add(struct interface *ifp, struct connected *ifc)
+{
+	listnode_add(ifp->connected, ifc);
+	connected_index_add(ifc);
+}
+
 struct connected *connected_get_linklocal(struct interface *ifp)
 {
 	struct listnode *n;
@@ -1066,6 +1267,8 @@ void if_terminate(struct vrf *vrf)
 		}
 		if_delete(&ifp);
 	}
+
+	if_addr_index_free(vrf);
 }
 
 const char *if_link_type_str(enum zebra_link_type llt)
@@ -26,6 +26,7 @@
 #include "memory.h"
 #include "qobj.h"
 #include "hook.h"
+#include "typesafe.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -203,9 +204,14 @@ struct if_link_params {
 #define HAS_LINK_PARAMS(ifp)  ((ifp)->link_params != NULL)
 
 /* Interface structure */
+PREDECL_RBTREE_UNIQ(if_index_all);
+
 struct interface {
 	RB_ENTRY(interface) name_entry, index_entry;
 
+	/* Entry in the (ifindex, vrf_id) index across all VRFs */
+	struct if_index_all_item index_all_entry;
+
 	/* Interface name.  This should probably never be changed after the
 	   interface is created, because the configuration info for this
 	   interface
@@ -433,6 +439,10 @@ struct connected {
 	 * "struct interface"
 	 */
 	uint32_t metric;
+
+	/* Entries in the per-VRF address index, see connected_add() */
+	struct route_node *addr_rn;
+	struct route_node *net_rn;
 };
 
 /* Nbr Connected address structure. */
@@ -575,6 +585,7 @@ extern ifindex_t ifname2ifindex(const char *ifname, vrf_id_t vrf_id);
 extern struct connected *connected_new(void);
 extern void connected_free(struct connected **connected);
 extern void connected_add(struct interface *, struct connected *);
+extern void connected_index_update(struct connected *ifc);
 extern struct connected *
 connected_add_by_prefix(struct interface *, struct prefix *, struct prefix *);
 extern struct connected *connected_delete_by_prefix(struct interface *,
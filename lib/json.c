@@ -21,6 +21,7 @@
 #include <zebra.h>
 
 #include "command.h"
+#include "prefix.h"
 #include "lib/json.h"
 
 /*
@@ -75,6 +76,24 @@ void json_object_boolean_add(struct json_object *obj, const char *key, bool val)
 	json_object_object_add(obj, key, json_object_new_boolean(val));
 }
 
+void json_object_addr_add(struct json_object *obj, const char *key, int af,
+			  const void *addr)
+{
+	char buf[INET6_ADDRSTRLEN];
+	size_t len = frr_inet_ntop_fast(af, addr, buf);
+
+	json_object_object_add(obj, key, json_object_new_string_len(buf, len));
+}
+
+void json_object_prefix_add(struct json_object *obj, const char *key,
+			    const struct prefix *p)
+{
+	char buf[PREFIX_STRLEN];
+	size_t len = prefix2str_fast(p, buf);
+
+	json_object_object_add(obj, key, json_object_new_string_len(buf, len));
+}
+
 struct json_object *json_object_lock(struct json_object *obj)
 {
 	return json_object_get(obj);
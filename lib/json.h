@@ -59,6 +59,13 @@ extern struct json_object *json_object_lock(struct json_object *obj);
 extern void json_object_free(struct json_object *obj);
 extern void json_array_string_add(json_object *json, const char *str);
 
+/* address / prefix as string, for large dumps (avoids printf & strlen) */
+struct prefix;
+extern void json_object_addr_add(struct json_object *obj, const char *key,
+				 int af, const void *addr);
+extern void json_object_prefix_add(struct json_object *obj, const char *key,
+				   const struct prefix *p);
+
 #define JSON_STR "JavaScript Object Notation\n"
 
 /* NOTE: json-c lib has following commit 316da85 which
@@ -42,6 +42,7 @@
 #include "vector.h"
 #include "vty.h"
 #include "command.h"
+#include "frrscript.h"
 
 #if defined(HAVE_MALLINFO2) || defined(HAVE_MALLINFO)
 static int show_memory_mallinfo(struct vty *vty)
@@ -280,6 +281,18 @@ static const struct cmd_variable_handler default_var_handlers[] = {
 	{.completions = NULL},
 };
 
+#ifdef HAVE_SCRIPTING
+DEFUN (clear_scripts,
+       clear_scripts_cmd,
+       "clear scripts",
+       CLEAR_STR
+       "Reload all scripts on next use\n")
+{
+	frrscript_reload_all();
+	return CMD_SUCCESS;
+}
+#endif /* HAVE_SCRIPTING */
+
 void lib_cmd_init(void)
 {
 	cmd_variable_handler_register(default_var_handlers);
@@ -292,6 +305,10 @@ void lib_cmd_init(void)
 
 	install_element(CONFIG_NODE, &start_config_cmd);
 	install_element(CONFIG_NODE, &end_config_cmd);
+
+#ifdef HAVE_SCRIPTING
+	install_element(ENABLE_NODE, &clear_scripts_cmd);
+#endif
 }
 
 /* Stats querying from users */
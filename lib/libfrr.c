@@ -44,6 +44,8 @@
 #include "frr_pthread.h"
 #include "defaults.h"
 #include "frrscript.h"
+#include "snapshot.h"
+#include "liveness.h"
 
 DEFINE_HOOK(frr_late_init, (struct thread_master * tm), (tm))
 DEFINE_HOOK(frr_very_late_init, (struct thread_master * tm), (tm))
@@ -104,6 +106,8 @@ static void opt_extend(const struct optspec *os)
 #define OPTION_LOGGING   1007
 #define OPTION_LIMIT_FDS 1008
 #define OPTION_SCRIPTDIR 1009
+#define OPTION_QUERY     1010
+#define OPTION_BINCONF   1011
 
 static const struct option lo_always[] = {
 	{"help", no_argument, NULL, 'h'},
@@ -120,6 +124,7 @@ static const struct option lo_always[] = {
 	{"tcli", no_argument, NULL, OPTION_TCLI},
 	{"command-log-always", no_argument, NULL, OPTION_LOGGING},
 	{"limit-fds", required_argument, NULL, OPTION_LIMIT_FDS},
+	{"query-thread", no_argument, NULL, OPTION_QUERY},
 	{NULL}};
 static const struct optspec os_always = {
 	"hvdM:F:N:",
@@ -135,7 +140,9 @@ static const struct optspec os_always = {
 	"      --log          Set Logging to stdout, syslog, or file:<name>\n"
 	"      --log-level    Set Logging Level to use, debug, info, warn, etc\n"
 	"      --tcli         Use transaction-based CLI\n"
-	"      --limit-fds    Limit number of fds supported\n",
+	"      --limit-fds    Limit number of fds supported\n"
+	"      --query-thread\n"
+	"                     Answer read-only queries from a separate thread\n",
 	lo_always};
 
 
@@ -147,6 +154,7 @@ static const struct option lo_cfg_pid_dry[] = {
 #endif
 	{"dryrun", no_argument, NULL, 'C'},
 	{"terminal", no_argument, NULL, 't'},
+	{"binary-config", no_argument, NULL, OPTION_BINCONF},
 	{NULL}};
 static const struct optspec os_cfg_pid_dry = {
 	"f:i:Ct",
@@ -157,7 +165,9 @@ static const struct optspec os_cfg_pid_dry = {
 #endif
 	"  -C, --dryrun       Check configuration for validity and exit\n"
 	"  -t, --terminal     Open terminal session on stdio\n"
-	"  -d -t              Daemonize after terminal session ends\n",
+	"  -d -t              Daemonize after terminal session ends\n"
+	"      --binary-config\n"
+	"                     Also save/load configuration in binary form\n",
 	lo_cfg_pid_dry};
 
 
@@ -594,6 +604,14 @@ static int frr_opt(int opt)
 	case OPTION_LIMIT_FDS:
 		di->limit_fds = strtoul(optarg, &err, 0);
 		break;
+	case OPTION_QUERY:
+		di->query_thread = true;
+		break;
+	case OPTION_BINCONF:
+		if (di->flags & FRR_NO_CFG_PID_DRY)
+			return 1;
+		di->binary_config = true;
+		break;
 	default:
 		return 1;
 	}
@@ -751,6 +769,7 @@ struct thread_master *frr_init(void)
 
 	vty_init(master, di->log_always);
 	lib_cmd_init();
+	host.binary_config = di->binary_config;
 
 	frr_pthread_init();
 #ifdef HAVE_SCRIPTING
@@ -966,6 +985,10 @@ static int frr_config_read_in(struct thread *t)
 
 	hook_call(frr_very_late_init, master);
 
+	/* daemons may have moved on to FRR_LIVENESS_CONVERGING meanwhile */
+	if (frr_liveness_get_phase() == FRR_LIVENESS_STARTUP)
+		frr_liveness_set_phase(FRR_LIVENESS_RUNNING);
+
 	return 0;
 }
 
@@ -1018,6 +1041,24 @@ static void frr_vty_serv(void)
 	vty_serv_sock(di->vty_addr, di->vty_port, di->vty_path);
 }
 
+static void frr_query_serv(struct thread_master *master)
+{
+	char path[256];
+	const char *dir;
+
+	if (!di->query_thread)
+		return;
+
+	dir = di->vty_sock_path ? di->vty_sock_path : frr_vtydir;
+	if (di->instance)
+		snprintf(path, sizeof(path), "%s/%s-%d.query", dir, di->name,
+			 di->instance);
+	else
+		snprintf(path, sizeof(path), "%s/%s.query", dir, di->name);
+
+	snapshot_start(master, path);
+}
+
 static void frr_check_detach(void)
 {
 	if (nodetach_term || nodetach_daemon)
@@ -1103,11 +1144,28 @@ void frr_detach(void)
 	frr_check_detach();
 }
 
+static void frr_liveness_serv(struct thread_master *master)
+{
+	char path[256];
+	const char *dir;
+
+	dir = di->vty_sock_path ? di->vty_sock_path : frr_vtydir;
+	if (di->instance)
+		snprintf(path, sizeof(path), "%s/%s-%d.live", dir, di->name,
+			 di->instance);
+	else
+		snprintf(path, sizeof(path), "%s/%s.live", dir, di->name);
+
+	frr_liveness_start(master, path);
+}
+
 void frr_run(struct thread_master *master)
 {
 	char instanceinfo[64] = "";
 
+	frr_liveness_serv(master);
 	frr_vty_serv();
+	frr_query_serv(master);
 
 	if (di->instance)
 		snprintf(instanceinfo, sizeof(instanceinfo), "instance %u ",
@@ -1162,6 +1220,8 @@ void frr_fini(void)
 
 	hook_call(frr_fini);
 
+	snapshot_stop();
+	frr_liveness_stop();
 	vty_terminate();
 	cmd_terminate();
 	nb_terminate();
@@ -104,6 +104,12 @@ struct frr_daemon_info {
 
 	bool log_always;
 
+	/* Serve registered show commands from a separate pthread */
+	bool query_thread;
+
+	/* Keep <config_file>.lyb along with the text configuration */
+	bool binary_config;
+
 	/* Optional upper limit on the number of fds used in select/poll */
 	uint32_t limit_fds;
 };
@@ -0,0 +1,178 @@
+/*
+ * Event loop liveness, published to watchfrr through shared memory.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <zebra.h>
+#include <sys/mman.h>
+
+#include "liveness.h"
+#include "lib_errors.h"
+#include "memory.h"
+#include "thread.h"
+
+const char *const frr_liveness_phase_names[] = {
+	[FRR_LIVENESS_STARTUP] = "startup",
+	[FRR_LIVENESS_CONVERGING] = "converging",
+	[FRR_LIVENESS_RUNNING] = "running",
+};
+
+static struct frr_liveness *liveness;
+static struct thread_master *liveness_master;
+static struct thread *t_liveness_tick;
+static char *liveness_path;
+
+/*
+ * Nothing to do here; the point is that poll() returns, and thus the event
+ * loop updates the page, at least once per tick even when the daemon is idle.
+ */
+static int frr_liveness_tick(struct thread *t)
+{
+	thread_add_timer_msec(liveness_master, frr_liveness_tick, NULL,
+			      FRR_LIVENESS_TICK_MSEC, &t_liveness_tick);
+	return 0;
+}
+
+void frr_liveness_start(struct thread_master *master, const char *path)
+{
+	struct frr_liveness *live;
+	struct timeval now;
+	char tmppath[MAXPATHLEN];
+	int fd;
+
+	/*
+	 * watchfrr may still have the previous instance's file mapped; build
+	 * the new one next to it and rename it in place so that mapping stays
+	 * valid (and stale) until watchfrr notices the restart.
+	 */
+	snprintf(tmppath, sizeof(tmppath), "%s.tmp", path);
+	unlink(tmppath);
+
+	fd = open(tmppath, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		flog_err_sys(EC_LIB_SYSTEM_CALL, "%s: cannot create %s: %s",
+			     __func__, tmppath, safe_strerror(errno));
+		return;
+	}
+	if (ftruncate(fd, sizeof(*live)) < 0) {
+		flog_err_sys(EC_LIB_SYSTEM_CALL, "%s: cannot size %s: %s",
+			     __func__, tmppath, safe_strerror(errno));
+		goto out_unlink;
+	}
+	live = mmap(NULL, sizeof(*live), PROT_READ | PROT_WRITE, MAP_SHARED,
+		    fd, 0);
+	if (live == MAP_FAILED) {
+		flog_err_sys(EC_LIB_SYSTEM_CALL, "%s: cannot map %s: %s",
+			     __func__, tmppath, safe_strerror(errno));
+		goto out_unlink;
+	}
+
+	monotime(&now);
+	live->version = FRR_LIVENESS_VERSION;
+	live->pid = getpid();
+	atomic_store_explicit(&live->phase, FRR_LIVENESS_STARTUP,
+			      memory_order_relaxed);
+	frr_liveness_wake(live, &now);
+	/* magic goes last, the page is only valid once it's set */
+	atomic_thread_fence(memory_order_release);
+	live->magic = FRR_LIVENESS_MAGIC;
+
+	if (rename(tmppath, path) < 0) {
+		flog_err_sys(EC_LIB_SYSTEM_CALL, "%s: cannot rename %s: %s",
+			     __func__, tmppath, safe_strerror(errno));
+		munmap(live, sizeof(*live));
+		goto out_unlink;
+	}
+	close(fd);
+
+	liveness = live;
+	liveness_master = master;
+	liveness_path = XSTRDUP(MTYPE_TMP, path);
+	master->liveness = live;
+
+	thread_add_timer_msec(master, frr_liveness_tick, NULL,
+			      FRR_LIVENESS_TICK_MSEC, &t_liveness_tick);
+	return;
+
+out_unlink:
+	close(fd);
+	unlink(tmppath);
+}
+
+void frr_liveness_stop(void)
+{
+	if (!liveness)
+		return;
+
+	THREAD_OFF(t_liveness_tick);
+	if (liveness_master)
+		liveness_master->liveness = NULL;
+
+	unlink(liveness_path);
+	XFREE(MTYPE_TMP, liveness_path);
+	munmap(liveness, sizeof(*liveness));
+	liveness = NULL;
+	liveness_master = NULL;
+}
+
+void frr_liveness_set_phase(enum frr_liveness_phase phase)
+{
+	if (!liveness)
+		return;
+
+	atomic_store_explicit(&liveness->phase, phase, memory_order_relaxed);
+}
+
+enum frr_liveness_phase frr_liveness_get_phase(void)
+{
+	if (!liveness)
+		return FRR_LIVENESS_RUNNING;
+
+	return atomic_load_explicit(&liveness->phase, memory_order_relaxed);
+}
+
+struct frr_liveness *frr_liveness_map(const char *path)
+{
+	struct frr_liveness *live;
+	struct stat st;
+	int fd;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return NULL;
+
+	if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(*live)) {
+		close(fd);
+		return NULL;
+	}
+
+	live = mmap(NULL, sizeof(*live), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (live == MAP_FAILED)
+		return NULL;
+
+	if (frr_liveness_lag(live) < 0) {
+		munmap(live, sizeof(*live));
+		return NULL;
+	}
+	return live;
+}
+
+void frr_liveness_unmap(struct frr_liveness *live)
+{
+	if (live)
+		munmap(live, sizeof(*live));
+}
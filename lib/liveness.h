@@ -0,0 +1,116 @@
+/*
+ * Event loop liveness, published to watchfrr through shared memory.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef _FRR_LIVENESS_H
+#define _FRR_LIVENESS_H
+
+#include "frratomic.h"
+#include "monotime.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Each daemon maps <vtydir>/<daemon>[-<instance>].live and its main event
+ * loop stores there when it last got control back, i.e. between two tasks
+ * or when poll() returned.  A timer wakes the loop at least every
+ * FRR_LIVENESS_TICK_MSEC, so in a healthy daemon that time is never much
+ * older than the tick; when it is, a single task has been running for that
+ * long (or the process is stopped).  watchfrr reads this instead of sending
+ * echo commands, which a busy daemon could only answer after working
+ * through its whole backlog.
+ *
+ * Daemons also tell whether they are still starting up or converging, so
+ * watchfrr can allow for longer tasks in those phases.
+ */
+
+#define FRR_LIVENESS_MAGIC	0x4c525246 /* "FRRL" */
+#define FRR_LIVENESS_VERSION	1
+#define FRR_LIVENESS_TICK_MSEC	1000
+
+enum frr_liveness_phase {
+	/* reading configuration */
+	FRR_LIVENESS_STARTUP = 0,
+	/* initial route exchange, e.g. BGP update-delay */
+	FRR_LIVENESS_CONVERGING,
+	FRR_LIVENESS_RUNNING,
+};
+
+struct frr_liveness {
+	uint32_t magic;
+	uint32_t version;
+	int32_t pid;
+	_Atomic uint32_t phase;
+	/* number of times the event loop got control back */
+	_Atomic uint64_t heartbeat;
+	/* monotime (microseconds) when that last happened */
+	_Atomic int64_t last_wake;
+};
+
+static inline int64_t frr_liveness_now(void)
+{
+	struct timeval tv;
+
+	monotime(&tv);
+	return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+/* Called by the event loop between tasks and after poll() */
+static inline void frr_liveness_wake(struct frr_liveness *live,
+				     const struct timeval *now)
+{
+	atomic_store_explicit(&live->last_wake,
+			      (int64_t)now->tv_sec * 1000000 + now->tv_usec,
+			      memory_order_relaxed);
+	atomic_fetch_add_explicit(&live->heartbeat, 1, memory_order_relaxed);
+}
+
+/*
+ * Time (microseconds) since the event loop last got control back, or -1 if
+ * the page is not valid.
+ */
+static inline int64_t frr_liveness_lag(const struct frr_liveness *live)
+{
+	if (live->magic != FRR_LIVENESS_MAGIC
+	    || live->version != FRR_LIVENESS_VERSION)
+		return -1;
+
+	return frr_liveness_now()
+	       - atomic_load_explicit(&live->last_wake, memory_order_relaxed);
+}
+
+extern const char *const frr_liveness_phase_names[];
+
+/* Daemon side; path is created (atomically replacing any old file) */
+struct thread_master;
+extern void frr_liveness_start(struct thread_master *master,
+			       const char *path);
+extern void frr_liveness_stop(void);
+extern void frr_liveness_set_phase(enum frr_liveness_phase phase);
+extern enum frr_liveness_phase frr_liveness_get_phase(void);
+
+/* watchfrr side; returns NULL if the file doesn't exist or is invalid */
+extern struct frr_liveness *frr_liveness_map(const char *path);
+extern void frr_liveness_unmap(struct frr_liveness *live);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FRR_LIVENESS_H */
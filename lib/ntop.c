@@ -30,36 +30,55 @@
 
 #include "compiler.h"
 
+/* "0".."255" left-aligned in 3 bytes plus length, so that each octet is
+ * a single fixed-size 4-byte copy instead of a divide & branch cascade.
+ */
+struct dec_octet {
+	char str[3];
+	uint8_t len;
+};
+
+#define DEC_D0(n) ('0' + ((n) >= 100 ? (n) / 100 : (n) >= 10 ? (n) / 10 : (n)))
+#define DEC_D1(n)                                                              \
+	((n) >= 100 ? '0' + (n) / 10 % 10 : (n) >= 10 ? '0' + (n) % 10 : 0)
+#define DEC_D2(n) ((n) >= 100 ? '0' + (n) % 10 : 0)
+#define DEC_LEN(n) ((n) >= 100 ? 3 : (n) >= 10 ? 2 : 1)
+
+#define DEC1(n) { { DEC_D0(n), DEC_D1(n), DEC_D2(n) }, DEC_LEN(n) }
+#define DEC4(n) DEC1(n), DEC1(n + 1), DEC1(n + 2), DEC1(n + 3)
+#define DEC16(n) DEC4(n), DEC4(n + 4), DEC4(n + 8), DEC4(n + 12)
+#define DEC64(n) DEC16(n), DEC16(n + 16), DEC16(n + 32), DEC16(n + 48)
+
+static const struct dec_octet dec_octets[256] = {
+	DEC64(0), DEC64(64), DEC64(128), DEC64(192),
+};
+
+/* two lowercase hex digits per byte */
+#define HEX_D(d) ((d) < 10 ? '0' + (d) : 'a' + (d) - 10)
+#define HEX1(n) { HEX_D((n) >> 4), HEX_D((n) & 0xf) }
+#define HEX4(n) HEX1(n), HEX1(n + 1), HEX1(n + 2), HEX1(n + 3)
+#define HEX16(n) HEX4(n), HEX4(n + 4), HEX4(n + 8), HEX4(n + 12)
+#define HEX64(n) HEX16(n), HEX16(n + 16), HEX16(n + 32), HEX16(n + 48)
+
+static const char hex_pairs[256][2] = {
+	HEX64(0), HEX64(64), HEX64(128), HEX64(192),
+};
+
 #define pos (*posx)
 
-static inline void putbyte(uint8_t bytex, char **posx)
+/* both of these write 4 bytes but only advance by the actual length; the
+ * excess is overwritten by whatever comes next (at least the final NUL.)
+ * Callers need to provide NTOP_SLACK bytes of room beyond the result.
+ */
+#define NTOP_SLACK 3
+
+static inline void putbyte(uint8_t byte, char **posx)
 	__attribute__((always_inline)) OPTIMIZE;
 
-static inline void putbyte(uint8_t bytex, char **posx)
+static inline void putbyte(uint8_t byte, char **posx)
 {
-	bool zero = false;
-	int byte = bytex, tmp, a, b;
-
-	if ((tmp = byte - 200) >= 0) {
-		*pos++ = '2';
-		zero = true;
-		byte = tmp;
-	} else if ((tmp = byte - 100) >= 0) {
-		*pos++ = '1';
-		zero = true;
-		byte = tmp;
-	}
-
-	/* make sure the compiler knows the value range of "byte" */
-	assume(byte < 100 && byte >= 0);
-
-	b = byte % 10;
-	a = byte / 10;
-	if (a || zero) {
-		*pos++ = '0' + a;
-		*pos++ = '0' + b;
-	} else
-		*pos++ = '0' + b;
+	memcpy(pos, &dec_octets[byte], 4);
+	pos += dec_octets[byte].len;
 }
 
 static inline void puthex(uint16_t word, char **posx)
@@ -67,33 +86,27 @@ static inline void puthex(uint16_t word, char **posx)
 
 static inline void puthex(uint16_t word, char **posx)
 {
-	const char *digits = "0123456789abcdef";
-	if (word >= 0x1000)
-		*pos++ = digits[(word >> 12) & 0xf];
-	if (word >= 0x100)
-		*pos++ = digits[(word >> 8) & 0xf];
-	if (word >= 0x10)
-		*pos++ = digits[(word >> 4) & 0xf];
-	*pos++ = digits[word & 0xf];
+	char tmp[8] = {};
+	size_t len = 1 + (word >= 0x10) + (word >= 0x100) + (word >= 0x1000);
+
+	memcpy(tmp, hex_pairs[word >> 8], 2);
+	memcpy(tmp + 2, hex_pairs[word & 0xff], 2);
+	memcpy(pos, tmp + 4 - len, 4);
+	pos += len;
 }
 
 #undef pos
 
-const char *frr_inet_ntop(int af, const void * restrict src,
-			  char * restrict dst, socklen_t size)
-	__attribute__((flatten)) OPTIMIZE;
+/* returns string length (without NUL), or 0 for unknown af */
+static inline size_t ntop_core(int af, const uint8_t *b, char *o)
+	__attribute__((always_inline)) OPTIMIZE;
 
-const char *frr_inet_ntop(int af, const void * restrict src,
-			  char * restrict dst, socklen_t size)
+static inline size_t ntop_core(int af, const uint8_t *b, char *o)
 {
-	const uint8_t *b = src;
-	/* 8 * "abcd:" for IPv6
-	 * note: the IPv4-embedded IPv6 syntax is only used for ::A.B.C.D,
-	 * which isn't longer than 40 chars either.  even with ::ffff:A.B.C.D
-	 * it's shorter.
-	 */
-	char buf[8 * 5], *o = buf;
-	size_t best = 0, bestlen = 0, curlen = 0, i;
+	char *start = o;
+	uint16_t words[8];
+	unsigned int zeroes = 0, mask, run = 0;
+	size_t best = 0, bestlen = 0, i;
 
 	switch (af) {
 	case AF_INET:
@@ -105,24 +118,28 @@ inet4:
 		putbyte(b[2], &o);
 		*o++ = '.';
 		putbyte(b[3], &o);
-		*o++ = '\0';
+		*o = '\0';
 		break;
 	case AF_INET6:
+		/* bit i set = word i is zero; written without branches so the
+		 * compiler can turn this into vector compares
+		 */
 		for (i = 0; i < 8; i++) {
-			if (b[i * 2] || b[i * 2 + 1]) {
-				if (curlen && curlen > bestlen) {
-					best = i - curlen;
-					bestlen = curlen;
-				}
-				curlen = 0;
-				continue;
-			}
-			curlen++;
+			words[i] = (b[i * 2] << 8) | b[i * 2 + 1];
+			zeroes |= (unsigned int)(words[i] == 0) << i;
 		}
-		if (curlen && curlen > bestlen) {
-			best = i - curlen;
-			bestlen = curlen;
+
+		/* each step keeps bits that start a run of zero words at least
+		 * one longer; the last non-empty mask holds the starts of the
+		 * longest runs, and the first of those is the one to compress
+		 */
+		for (mask = zeroes; mask; mask &= mask >> 1) {
+			run = mask;
+			bestlen++;
 		}
+		if (run)
+			best = __builtin_ctz(run);
+
 		/* do we want ::ffff:A.B.C.D? */
 		if (best == 0 && bestlen == 6) {
 			*o++ = ':';
@@ -138,23 +155,43 @@ inet4:
 				if (i == 0)
 					*o++ = ':';
 				*o++ = ':';
+				i += bestlen - 1;
 				continue;
 			}
-			if (i > best && i < best + bestlen) {
-				continue;
-			}
-			puthex((b[i * 2] << 8) | b[i * 2 + 1], &o);
+			puthex(words[i], &o);
 
 			if (i < 7)
 				*o++ = ':';
 		}
-		*o++ = '\0';
+		*o = '\0';
 		break;
 	default:
-		return NULL;
+		return 0;
 	}
 
-	i = o - buf;
+	return o - start;
+}
+
+const char *frr_inet_ntop(int af, const void * restrict src,
+			  char * restrict dst, socklen_t size)
+	__attribute__((flatten)) OPTIMIZE;
+
+const char *frr_inet_ntop(int af, const void * restrict src,
+			  char * restrict dst, socklen_t size)
+{
+	/* 8 * "abcd:" for IPv6
+	 * note: the IPv4-embedded IPv6 syntax is only used for ::A.B.C.D,
+	 * which isn't longer than 40 chars either.  even with ::ffff:A.B.C.D
+	 * it's shorter.
+	 */
+	char buf[8 * 5 + NTOP_SLACK];
+	size_t i;
+
+	i = ntop_core(af, src, buf);
+	if (!i)
+		return NULL;
+
+	i++;
 	if (i > size)
 		return NULL;
 	/* compiler might inline memcpy if it knows the length is short,
@@ -165,6 +202,18 @@ inet4:
 	return dst;
 }
 
+size_t frr_inet_ntop_fast(int af, const void *src, char *dst)
+	__attribute__((flatten)) OPTIMIZE;
+
+size_t frr_inet_ntop_fast(int af, const void *src, char *dst)
+{
+	size_t len = ntop_core(af, src, dst);
+
+	if (!len)
+		dst[0] = '\0';
+	return len;
+}
+
 #if !defined(INET_NTOP_NO_OVERRIDE) && !defined(__APPLE__)
 /* we want to override libc inet_ntop, but make sure it shows up in backtraces
  * as frr_inet_ntop (to avoid confusion while debugging)
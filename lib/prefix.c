@@ -1019,10 +1019,9 @@ static const char *prefixevpn2str(const struct prefix_evpn *p, char *str,
 	return str;
 }
 
-const char *prefix2str(union prefixconstptr pu, char *str, int size)
+size_t prefix2str_fast(union prefixconstptr pu, char *buf)
 {
 	const struct prefix *p = pu.p;
-	char buf[PREFIX2STR_BUFFER];
 	int byte, tmp, a, b;
 	bool z = false;
 	size_t l;
@@ -1030,8 +1029,7 @@ const char *prefix2str(union prefixconstptr pu, char *str, int size)
 	switch (p->family) {
 	case AF_INET:
 	case AF_INET6:
-		inet_ntop(p->family, &p->u.prefix, buf, sizeof(buf));
-		l = strlen(buf);
+		l = frr_inet_ntop_fast(p->family, &p->u.prefix, buf);
 		buf[l++] = '/';
 		byte = p->prefixlen;
 		if ((tmp = p->prefixlen - 100) >= 0) {
@@ -1045,6 +1043,22 @@ const char *prefix2str(union prefixconstptr pu, char *str, int size)
 			buf[l++] = '0' + a;
 		buf[l++] = '0' + b;
 		buf[l] = '\0';
+		return l;
+	default:
+		prefix2str(p, buf, PREFIX_STRLEN);
+		return strlen(buf);
+	}
+}
+
+const char *prefix2str(union prefixconstptr pu, char *str, int size)
+{
+	const struct prefix *p = pu.p;
+	char buf[PREFIX2STR_BUFFER];
+
+	switch (p->family) {
+	case AF_INET:
+	case AF_INET6:
+		prefix2str_fast(p, buf);
 		strlcpy(str, buf, size);
 		break;
 
@@ -1392,7 +1406,9 @@ printfrr_ext_autoreg_p("I4", printfrr_i4)
 static ssize_t printfrr_i4(char *buf, size_t bsz, const char *fmt,
 			   int prec, const void *ptr)
 {
-	if (ptr)
+	if (ptr && bsz >= INET6_ADDRSTRLEN)
+		frr_inet_ntop_fast(AF_INET, ptr, buf);
+	else if (ptr)
 		inet_ntop(AF_INET, ptr, buf, bsz);
 	else
 		strlcpy(buf, "NULL", bsz);
@@ -1404,7 +1420,9 @@ printfrr_ext_autoreg_p("I6", printfrr_i6)
 static ssize_t printfrr_i6(char *buf, size_t bsz, const char *fmt,
 			   int prec, const void *ptr)
 {
-	if (ptr)
+	if (ptr && bsz >= INET6_ADDRSTRLEN)
+		frr_inet_ntop_fast(AF_INET6, ptr, buf);
+	else if (ptr)
 		inet_ntop(AF_INET6, ptr, buf, bsz);
 	else
 		strlcpy(buf, "NULL", bsz);
@@ -1416,7 +1434,9 @@ printfrr_ext_autoreg_p("FX", printfrr_pfx)
 static ssize_t printfrr_pfx(char *buf, size_t bsz, const char *fmt,
 			    int prec, const void *ptr)
 {
-	if (ptr)
+	if (ptr && bsz >= PREFIX_STRLEN)
+		prefix2str_fast(ptr, buf);
+	else if (ptr)
 		prefix2str(ptr, buf, bsz);
 	else
 		strlcpy(buf, "NULL", bsz);
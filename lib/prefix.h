@@ -339,6 +339,28 @@ union prefixconstptr {
 	prefixtype(prefixconstptr, const struct prefix_rd,   rd)
 } __attribute__((transparent_union));
 
+/* Compact storage for IPv4/IPv6 prefixes in structures that exist once per
+ * route (struct prefix is 48 bytes due to the EVPN/flowspec union.)  These
+ * are not for API use;  convert with prefix_key_set() / prefix_key_get().
+ */
+struct prefix_key4 {
+	uint8_t prefixlen;
+	uint8_t addr[4];
+} __attribute__((packed));
+
+struct prefix_key6 {
+	uint8_t prefixlen;
+	uint8_t addr[16];
+} __attribute__((packed));
+
+struct prefix_key {
+	uint8_t family;
+	union {
+		struct prefix_key4 v4;
+		struct prefix_key6 v6;
+	} u;
+} __attribute__((packed));
+
 #ifndef INET_ADDRSTRLEN
 #define INET_ADDRSTRLEN 16
 #endif /* INET_ADDRSTRLEN */
@@ -446,6 +468,13 @@ extern void prefix_mcast_inet4_dump(const char *onfail, struct in_addr addr,
 				char *buf, int buf_size);
 extern const char *prefix_sg2str(const struct prefix_sg *sg, char *str);
 extern const char *prefix2str(union prefixconstptr, char *, int);
+
+/* Formatters for bulk output (show/JSON dumps) that skip the printfrr and
+ * size checking overhead.  buf must have room for INET6_ADDRSTRLEN or
+ * PREFIX_STRLEN bytes respectively; the string length is returned.
+ */
+extern size_t frr_inet_ntop_fast(int af, const void *src, char *buf);
+extern size_t prefix2str_fast(union prefixconstptr pu, char *buf);
 extern int evpn_type5_prefix_match(const struct prefix *evpn_pfx,
 				   const struct prefix *match_pfx);
 extern int prefix_match(const struct prefix *, const struct prefix *);
@@ -582,6 +611,74 @@ static inline int is_default_host_route(const struct prefix *p)
 	return 0;
 }
 
+/* family 0 (and false returned) if p is not IPv4/IPv6 */
+static inline bool prefix_key_set(struct prefix_key *k, union prefixconstptr pu)
+{
+	const struct prefix *p = pu.p;
+
+	switch (p->family) {
+	case AF_INET:
+		k->family = AF_INET;
+		k->u.v4.prefixlen = p->prefixlen;
+		memcpy(k->u.v4.addr, &p->u.prefix4, sizeof(k->u.v4.addr));
+		return true;
+	case AF_INET6:
+		k->family = AF_INET6;
+		k->u.v6.prefixlen = p->prefixlen;
+		memcpy(k->u.v6.addr, &p->u.prefix6, sizeof(k->u.v6.addr));
+		return true;
+	}
+	memset(k, 0, sizeof(*k));
+	return false;
+}
+
+/* zero address & length, keeping the family */
+static inline void prefix_key_reset(struct prefix_key *k)
+{
+	uint8_t family = k->family;
+
+	memset(k, 0, sizeof(*k));
+	k->family = family;
+}
+
+static inline void prefix_key_get(const struct prefix_key *k, union prefixptr pu)
+{
+	struct prefix *p = pu.p;
+
+	memset(p, 0, sizeof(*p));
+	p->family = k->family;
+	switch (k->family) {
+	case AF_INET:
+		p->prefixlen = k->u.v4.prefixlen;
+		memcpy(&p->u.prefix4, k->u.v4.addr, sizeof(k->u.v4.addr));
+		break;
+	case AF_INET6:
+		p->prefixlen = k->u.v6.prefixlen;
+		memcpy(&p->u.prefix6, k->u.v6.addr, sizeof(k->u.v6.addr));
+		break;
+	}
+}
+
+static inline bool prefix_key_same(const struct prefix_key *k,
+				   union prefixconstptr pu)
+{
+	const struct prefix *p = pu.p;
+
+	if (k->family != p->family)
+		return false;
+	switch (k->family) {
+	case AF_INET:
+		return k->u.v4.prefixlen == p->prefixlen
+		       && !memcmp(k->u.v4.addr, &p->u.prefix4,
+				  sizeof(k->u.v4.addr));
+	case AF_INET6:
+		return k->u.v6.prefixlen == p->prefixlen
+		       && !memcmp(k->u.v6.addr, &p->u.prefix6,
+				  sizeof(k->u.v6.addr));
+	}
+	return true;
+}
+
 #ifdef _FRR_ATTRIBUTE_PRINTFRR
 #pragma FRR printfrr_ext "%pEA"  (struct ethaddr *)
 
@@ -1023,6 +1023,7 @@ static struct cmd_node rmap_node = {
 	.parent_node = CONFIG_NODE,
 	.prompt = "%s(config-route-map)# ",
 	.config_write = route_map_config_write,
+	.config_nb = true,
 };
 
 static void rmap_autocomplete(vector comps, struct cmd_token *token)
@@ -0,0 +1,387 @@
+/*
+ * Read-only query snapshots served from a separate pthread.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <zebra.h>
+#include <sys/un.h>
+
+#include "snapshot.h"
+#include "buffer.h"
+#include "command.h"
+#include "frr_pthread.h"
+#include "frratomic.h"
+#include "frrcu.h"
+#include "lib_errors.h"
+#include "memory.h"
+#include "network.h"
+#include "privs.h"
+#include "typesafe.h"
+#include "vty.h"
+
+DEFINE_MTYPE_STATIC(LIB, SNAPSHOT, "Query snapshot")
+DEFINE_MTYPE_STATIC(LIB, SNAPSHOT_PROVIDER, "Query snapshot provider")
+DEFINE_MTYPE_STATIC(LIB, SNAPSHOT_CONN, "Query snapshot connection")
+
+/* Published output of one command; freed through RCU once replaced */
+struct snapshot {
+	struct rcu_head rcu_head;
+	int status;
+	size_t len;
+	char text[];
+};
+
+PREDECL_DLIST(snapshot_providers)
+
+struct snapshot_provider {
+	struct snapshot_providers_item item;
+
+	char *cmd;
+	unsigned int refresh_msec;
+
+	/* read by the query pthread, replaced by the main pthread */
+	struct snapshot *_Atomic current;
+	/* set by the query pthread when current was asked for */
+	atomic_bool wanted;
+
+	/* main pthread only */
+	struct timeval rendered;
+	struct thread *t_refresh;
+};
+
+DECLARE_DLIST(snapshot_providers, struct snapshot_provider, item)
+
+/* only modified before the query pthread starts or after it stopped */
+static struct snapshot_providers_head providers =
+	INIT_DLIST(providers);
+
+PREDECL_DLIST(snapshot_conns)
+
+struct snapshot_conn {
+	struct snapshot_conns_item item;
+	int fd;
+	struct buffer *obuf;
+	size_t len;
+	char buf[VTY_BUFSIZ];
+	struct thread *t_read;
+	struct thread *t_write;
+};
+
+DECLARE_DLIST(snapshot_conns, struct snapshot_conn, item)
+
+/* query pthread only, until it stopped */
+static struct snapshot_conns_head conns = INIT_DLIST(conns);
+
+static struct thread_master *snapshot_main;
+static struct frr_pthread *snapshot_pth;
+static int snapshot_sock = -1;
+static struct thread *t_snapshot_accept;
+
+void snapshot_register(const char *cmd, unsigned int refresh_msec)
+{
+	struct snapshot_provider *p;
+
+	assert(!snapshot_pth);
+
+	p = XCALLOC(MTYPE_SNAPSHOT_PROVIDER, sizeof(*p));
+	p->cmd = XSTRDUP(MTYPE_SNAPSHOT_PROVIDER, cmd);
+	p->refresh_msec = refresh_msec;
+	snapshot_providers_add_tail(&providers, p);
+}
+
+/* Main pthread: run the command and capture its output */
+static struct snapshot *snapshot_render(struct snapshot_provider *p)
+{
+	struct snapshot *s;
+	struct vty *vty;
+	char *text;
+	int status;
+
+	vty = vty_new();
+	vty->type = VTY_FILE;
+	vty->node = ENABLE_NODE;
+
+	status = cmd_execute(vty, p->cmd, NULL, 0);
+	text = buffer_getstr(vty->obuf);
+	buffer_reset(vty->obuf);
+	vty_close(vty);
+
+	s = XMALLOC(MTYPE_SNAPSHOT, sizeof(*s) + strlen(text) + 1);
+	s->status = status;
+	s->len = strlen(text);
+	memcpy(s->text, text, s->len + 1);
+	XFREE(MTYPE_TMP, text);
+
+	return s;
+}
+
+static int snapshot_refresh(struct thread *thread)
+{
+	struct snapshot_provider *p = THREAD_ARG(thread);
+	struct snapshot *old;
+	int64_t age_msec;
+
+	if (timerisset(&p->rendered)) {
+		age_msec = monotime_since(&p->rendered, NULL) / 1000;
+		if (age_msec < p->refresh_msec) {
+			thread_add_timer_msec(snapshot_main, snapshot_refresh,
+					      p, p->refresh_msec - age_msec,
+					      &p->t_refresh);
+			return 0;
+		}
+	}
+
+	atomic_store_explicit(&p->wanted, false, memory_order_relaxed);
+
+	old = atomic_exchange_explicit(&p->current, snapshot_render(p),
+				       memory_order_acq_rel);
+	monotime(&p->rendered);
+
+	if (old)
+		rcu_free(MTYPE_SNAPSHOT, old, rcu_head);
+	return 0;
+}
+
+/* Query pthread ---------------------------------------------------------- */
+
+static void snapshot_conn_close(struct snapshot_conn *conn)
+{
+	THREAD_OFF(conn->t_read);
+	THREAD_OFF(conn->t_write);
+	snapshot_conns_del(&conns, conn);
+	buffer_free(conn->obuf);
+	close(conn->fd);
+	XFREE(MTYPE_SNAPSHOT_CONN, conn);
+}
+
+static int snapshot_conn_write(struct thread *thread);
+
+/* Returns -1 if the connection was closed */
+static int snapshot_conn_flush(struct snapshot_conn *conn)
+{
+	switch (buffer_flush_available(conn->obuf, conn->fd)) {
+	case BUFFER_PENDING:
+		thread_add_write(snapshot_pth->master, snapshot_conn_write,
+				 conn, conn->fd, &conn->t_write);
+		break;
+	case BUFFER_ERROR:
+		snapshot_conn_close(conn);
+		return -1;
+	case BUFFER_EMPTY:
+		break;
+	}
+	return 0;
+}
+
+static int snapshot_conn_write(struct thread *thread)
+{
+	snapshot_conn_flush(THREAD_ARG(thread));
+	return 0;
+}
+
+static void snapshot_answer(struct snapshot_conn *conn, const char *cmd)
+{
+	struct snapshot_provider *p;
+	struct snapshot *s;
+	uint8_t header[4] = {0, 0, 0, 0};
+	const char *text;
+
+	frr_each (snapshot_providers, &providers, p)
+		if (strmatch(p->cmd, cmd))
+			break;
+
+	if (!p) {
+		text = "% Command not available on the query socket\n";
+		buffer_put(conn->obuf, text, strlen(text));
+		header[3] = CMD_ERR_NO_MATCH;
+		buffer_put(conn->obuf, header, 4);
+		return;
+	}
+
+	/* ask the main pthread for a fresh copy, once */
+	if (!atomic_exchange_explicit(&p->wanted, true, memory_order_relaxed))
+		thread_add_event(snapshot_main, snapshot_refresh, p, 0, NULL);
+
+	/* tasks run under the RCU read lock, s stays valid until we return */
+	s = atomic_load_explicit(&p->current, memory_order_acquire);
+	if (!s) {
+		text = "% No output available yet, try again shortly\n";
+		buffer_put(conn->obuf, text, strlen(text));
+		header[3] = CMD_WARNING;
+	} else {
+		buffer_put(conn->obuf, s->text, s->len);
+		header[3] = s->status;
+	}
+	buffer_put(conn->obuf, header, 4);
+}
+
+static int snapshot_conn_read(struct thread *thread)
+{
+	struct snapshot_conn *conn = THREAD_ARG(thread);
+	ssize_t nbytes;
+	char *end;
+
+	nbytes = read(conn->fd, conn->buf + conn->len,
+		      sizeof(conn->buf) - conn->len - 1);
+	if (nbytes <= 0) {
+		if (nbytes < 0 && ERRNO_IO_RETRY(errno)) {
+			thread_add_read(snapshot_pth->master,
+					snapshot_conn_read, conn, conn->fd,
+					&conn->t_read);
+			return 0;
+		}
+		snapshot_conn_close(conn);
+		return 0;
+	}
+	conn->len += nbytes;
+	conn->buf[conn->len] = '\0';
+
+	/* answer every complete (NUL-terminated) command */
+	while ((end = memchr(conn->buf, '\0', conn->len))) {
+		snapshot_answer(conn, conn->buf);
+		conn->len -= end + 1 - conn->buf;
+		memmove(conn->buf, end + 1, conn->len);
+		conn->buf[conn->len] = '\0';
+	}
+
+	if (conn->len == sizeof(conn->buf) - 1) {
+		snapshot_conn_close(conn);
+		return 0;
+	}
+
+	if (snapshot_conn_flush(conn) < 0)
+		return 0;
+
+	thread_add_read(snapshot_pth->master, snapshot_conn_read, conn,
+			conn->fd, &conn->t_read);
+	return 0;
+}
+
+static int snapshot_accept(struct thread *thread)
+{
+	struct snapshot_conn *conn;
+	int sock;
+
+	thread_add_read(snapshot_pth->master, snapshot_accept, NULL,
+			snapshot_sock, &t_snapshot_accept);
+
+	sock = accept(snapshot_sock, NULL, NULL);
+	if (sock < 0) {
+		flog_err_sys(EC_LIB_SOCKET, "%s: accept failed: %s", __func__,
+			     safe_strerror(errno));
+		return 0;
+	}
+	set_nonblocking(sock);
+	set_cloexec(sock);
+
+	conn = XCALLOC(MTYPE_SNAPSHOT_CONN, sizeof(*conn));
+	conn->fd = sock;
+	conn->obuf = buffer_new(0);
+	snapshot_conns_add_tail(&conns, conn);
+	thread_add_read(snapshot_pth->master, snapshot_conn_read, conn, sock,
+			&conn->t_read);
+	return 0;
+}
+
+static int snapshot_serv_un(const char *path)
+{
+	struct sockaddr_un serv;
+	struct zprivs_ids_t ids;
+	mode_t old_mask;
+	int sock;
+
+	unlink(path);
+
+	sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (sock < 0) {
+		flog_err_sys(EC_LIB_SOCKET,
+			     "Cannot create unix stream socket: %s",
+			     safe_strerror(errno));
+		return -1;
+	}
+
+	memset(&serv, 0, sizeof(serv));
+	serv.sun_family = AF_UNIX;
+	strlcpy(serv.sun_path, path, sizeof(serv.sun_path));
+	set_cloexec(sock);
+
+	old_mask = umask(0007);
+	if (bind(sock, (struct sockaddr *)&serv, sizeof(serv)) < 0
+	    || listen(sock, 5) < 0) {
+		flog_err_sys(EC_LIB_SOCKET, "Cannot listen on %s: %s", path,
+			     safe_strerror(errno));
+		umask(old_mask);
+		close(sock);
+		return -1;
+	}
+	umask(old_mask);
+
+	zprivs_get_ids(&ids);
+	if ((int)ids.gid_vty > 0 && chown(path, -1, ids.gid_vty))
+		flog_err_sys(EC_LIB_SYSTEM_CALL, "%s: could not chown %s: %s",
+			     __func__, path, safe_strerror(errno));
+
+	return sock;
+}
+
+void snapshot_start(struct thread_master *master, const char *path)
+{
+	if (snapshot_providers_count(&providers) == 0)
+		return;
+
+	snapshot_sock = snapshot_serv_un(path);
+	if (snapshot_sock < 0)
+		return;
+
+	snapshot_main = master;
+	snapshot_pth = frr_pthread_new(NULL, "Query snapshot thread",
+				       "snapshot");
+	frr_pthread_run(snapshot_pth, NULL);
+	frr_pthread_wait_running(snapshot_pth);
+
+	thread_add_read(snapshot_pth->master, snapshot_accept, NULL,
+			snapshot_sock, &t_snapshot_accept);
+}
+
+void snapshot_stop(void)
+{
+	struct snapshot_provider *p;
+	struct snapshot_conn *conn;
+	struct snapshot *s;
+
+	if (snapshot_pth) {
+		frr_pthread_stop(snapshot_pth, NULL);
+		/* pending tasks go away with the pthread's thread_master */
+		while ((conn = snapshot_conns_pop(&conns))) {
+			buffer_free(conn->obuf);
+			close(conn->fd);
+			XFREE(MTYPE_SNAPSHOT_CONN, conn);
+		}
+		frr_pthread_destroy(snapshot_pth);
+		snapshot_pth = NULL;
+		close(snapshot_sock);
+		snapshot_sock = -1;
+	}
+
+	while ((p = snapshot_providers_pop(&providers))) {
+		THREAD_OFF(p->t_refresh);
+		s = atomic_load_explicit(&p->current, memory_order_relaxed);
+		if (s)
+			rcu_free(MTYPE_SNAPSHOT, s, rcu_head);
+		XFREE(MTYPE_SNAPSHOT_PROVIDER, p->cmd);
+		XFREE(MTYPE_SNAPSHOT_PROVIDER, p);
+	}
+}
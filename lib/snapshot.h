@@ -0,0 +1,52 @@
+/*
+ * Read-only query snapshots served from a separate pthread.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef _FRR_SNAPSHOT_H
+#define _FRR_SNAPSHOT_H
+
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Daemons register show commands that monitoring tools poll heavily.  When
+ * started with --query-thread, a separate pthread answers these commands on
+ * the <daemon>.query unix socket, using the same framing as the vtysh socket
+ * (NUL-terminated command in; output followed by "\0\0\0<status>" out).
+ *
+ * Answers come from the last published output of the command, an RCU
+ * protected copy.  The main pthread renders it again at most once per
+ * refresh interval, and only if it was queried in the meantime, so the
+ * query rate never adds work on the main pthread.  Output can thus be up to
+ * one refresh interval (plus render time) old; the very first query of a
+ * command gets a warning asking to retry.
+ *
+ * Commands must be registered before frr_run().
+ */
+extern void snapshot_register(const char *cmd, unsigned int refresh_msec);
+
+extern void snapshot_start(struct thread_master *master, const char *path);
+extern void snapshot_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FRR_SNAPSHOT_H */
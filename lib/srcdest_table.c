@@ -289,6 +289,10 @@ const char *srcdest2str(const struct prefix *dst_p,
 {
 	char dst_buf[PREFIX_STRLEN], src_buf[PREFIX_STRLEN];
 
+	/* common case, no need to go through snprintf */
+	if (!src_p || !src_p->prefixlen)
+		return prefix2str(dst_p, str, size);
+
 	snprintf(str, size, "%s%s%s",
 		 prefix2str(dst_p, dst_buf, sizeof(dst_buf)),
 		 (src_p && src_p->prefixlen) ? " from " : "",
@@ -27,6 +27,7 @@
 #include "table.h"
 #include "memory.h"
 #include "sockunion.h"
+#include "jhash.h"
 #include "libfrr_trace.h"
 
 DEFINE_MTYPE_STATIC(LIB, ROUTE_TABLE, "Route table")
@@ -40,8 +41,25 @@ static int route_table_hash_cmp(const struct route_node *a,
 	return prefix_cmp(&a->p, &b->p);
 }
 
+/* node prefixes are always masked, so IPv4/IPv6 can be hashed directly from
+ * the address words rather than through prefix_hash_key()'s zeroed copy
+ */
+static uint32_t route_table_hash_key(const struct route_node *rn)
+{
+	const struct prefix *p = &rn->p;
+
+	switch (p->family) {
+	case AF_INET:
+		return jhash_2words(p->u.prefix4.s_addr, p->prefixlen,
+				    0x55aa5a5a);
+	case AF_INET6:
+		return jhash2(p->u.val32, 4, 0x55aa5a5a ^ p->prefixlen);
+	}
+	return prefix_hash_key(p);
+}
+
 DECLARE_HASH(rn_hash_node, struct route_node, nodehash, route_table_hash_cmp,
-	     prefix_hash_key)
+	     route_table_hash_key)
 /*
  * route_table_init_with_delegate
  */
@@ -64,7 +82,11 @@ void route_table_finish(struct route_table *rt)
 /* Allocate new route node. */
 static struct route_node *route_node_new(struct route_table *table)
 {
-	return table->delegate->create_node(table->delegate, table);
+	struct route_node *node;
+
+	node = table->delegate->create_node(table->delegate, table);
+	node->snap_version = table->snap_version;
+	return node;
 }
 
 /* Allocate new route node with prefix set. */
@@ -303,8 +325,12 @@ struct route_node *route_node_get(struct route_table *table,
 	node = table->top;
 	while (node && node->p.prefixlen <= prefixlen
 	       && prefix_match(&node->p, p)) {
-		if (node->p.prefixlen == prefixlen)
+		if (node->p.prefixlen == prefixlen) {
+			/* stub node becoming a route, new for snapshots */
+			if (!node->info)
+				node->snap_version = table->snap_version;
 			return route_lock_node(node);
+		}
 
 		match = node;
 		node = node->link[prefix_bit(prefix, node->p.prefixlen)];
@@ -74,6 +74,9 @@ struct route_table {
 
 	unsigned long count;
 
+	/* see route_table_snapshot() */
+	uint32_t snap_version;
+
 	/*
 	 * User data.
 	 */
@@ -130,6 +133,8 @@ struct route_table {
                                                                                \
 	/* Lock of this radix */                                               \
 	unsigned int table_rdonly(lock);                                       \
+	/* table->snap_version when created / when it became a route */        \
+	uint32_t table_rdonly(snap_version);                                   \
                                                                                \
 	struct rn_hash_node_item nodehash;                                     \
 	/* Each node of route. */                                              \
@@ -316,6 +321,29 @@ static inline struct route_node *route_table_iter_next(route_table_iter_t *iter)
 	return node;
 }
 
+/*
+ * Snapshot versions.
+ *
+ * route_table_snapshot() is O(1) and returns a version number.  Nodes that
+ * are created afterwards (or that were stubs and are handed out again by
+ * route_node_get()) carry a newer version.  So a walker that pauses and
+ * resumes by prefix (e.g. route_table_iter_pause()) can skip whatever was
+ * added since it started, and still hold no locks between time slices.
+ * Removed nodes simply disappear from the walk.  The info pointers are
+ * owned by the daemons and are not versioned, so they are read as of the
+ * time each node is visited.
+ */
+static inline uint32_t route_table_snapshot(struct route_table *table)
+{
+	return table->snap_version++;
+}
+
+static inline bool route_node_in_snapshot(const struct route_node *node,
+					  uint32_t snapshot)
+{
+	return (int32_t)(node->snap_version - snapshot) <= 0;
+}
+
 /*
  * route_table_iter_is_done
  *
@@ -37,6 +37,7 @@
 #include "lib_errors.h"
 #include "libfrr_trace.h"
 #include "libfrr.h"
+#include "liveness.h"
 
 DEFINE_MTYPE_STATIC(LIB, THREAD, "Thread")
 DEFINE_MTYPE_STATIC(LIB, THREAD_MASTER, "Thread master")
@@ -1615,6 +1616,11 @@ struct thread *thread_fetch(struct thread_master *m, struct thread *fetch)
 	bool eintr_p = false;
 	int num = 0;
 
+	if (m->liveness) {
+		monotime(&now);
+		frr_liveness_wake(m->liveness, &now);
+	}
+
 	do {
 		/* Handle signals if any */
 		if (m->handle_signals)
@@ -1711,6 +1717,8 @@ struct thread *thread_fetch(struct thread_master *m, struct thread *fetch)
 
 		/* Post timers to ready queue. */
 		monotime(&now);
+		if (m->liveness)
+			frr_liveness_wake(m->liveness, &now);
 		thread_process_timers(m, &now);
 
 		/* Post I/O to ready queue. */
@@ -93,6 +93,9 @@ struct thread_master {
 
 	bool ready_run_loop;
 	RUSAGE_T last_getrusage;
+
+	/* shared page read by watchfrr, main thread_master only */
+	struct frr_liveness *liveness;
 };
 
 /* Thread itself. */
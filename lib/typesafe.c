@@ -28,6 +28,7 @@
 DEFINE_MTYPE_STATIC(LIB, TYPEDHASH_BUCKET, "Typed-hash bucket")
 DEFINE_MTYPE_STATIC(LIB, SKIPLIST_OFLOW, "Skiplist overflow")
 DEFINE_MTYPE_STATIC(LIB, HEAP_ARRAY, "Typed-heap array")
+DEFINE_MTYPE_STATIC(LIB, FLATHASH_TABLE, "Typed-flathash table")
 
 #if 0
 static void hash_consistency_check(struct thash_head *head)
@@ -156,6 +157,109 @@ void typesafe_hash_shrink(struct thash_head *head)
 	hash_consistency_check(head);
 }
 
+/* flat hash */
+
+/* keep at least 1/8 of the slots empty, so lookups always terminate */
+#define FLATHASH_MAXLOAD(tabsize) ((tabsize) - (tabsize) / 8)
+
+static uint32_t flathash_find_free(const struct tflathash_head *head,
+				   uint32_t hashval)
+{
+	uint32_t gmask = head->tabsize / FLATHASH_GROUP - 1;
+	uint32_t grp = FLATHASH_H1(hashval) & gmask, step = 0, match;
+
+	while (1) {
+		/* both empty and deleted have the top bit set */
+		match = ~flathash_match_full(head->ctrl + grp * FLATHASH_GROUP)
+			& 0xffff;
+		if (match)
+			return grp * FLATHASH_GROUP + __builtin_ctz(match);
+		grp = (grp + ++step) & gmask;
+	}
+}
+
+static void flathash_resize(struct tflathash_head *head, uint32_t newsize)
+{
+	uint8_t *oldctrl = head->ctrl;
+	struct tflathash_item **oldslots = head->slots;
+	uint32_t oldsize = head->tabsize, i, slot;
+
+	head->ctrl = XMALLOC(MTYPE_FLATHASH_TABLE, newsize);
+	memset(head->ctrl, FLATHASH_EMPTY, newsize);
+	head->slots = XCALLOC(MTYPE_FLATHASH_TABLE,
+			      sizeof(head->slots[0]) * newsize);
+	head->tabsize = newsize;
+	head->growth_left = FLATHASH_MAXLOAD(newsize) - head->count;
+
+	for (i = 0; i < oldsize; i++) {
+		if (oldctrl[i] & 0x80)
+			continue;
+
+		slot = flathash_find_free(head, oldslots[i]->hashval);
+		head->ctrl[slot] = FLATHASH_H2(oldslots[i]->hashval);
+		head->slots[slot] = oldslots[i];
+		oldslots[i]->slot = slot;
+	}
+
+	XFREE(MTYPE_FLATHASH_TABLE, oldctrl);
+	XFREE(MTYPE_FLATHASH_TABLE, oldslots);
+}
+
+void typesafe_flathash_insert(struct tflathash_head *head,
+			      struct tflathash_item *item)
+{
+	uint32_t slot;
+
+	if (!head->growth_left) {
+		/* mostly tombstones => rebuild at the same size */
+		if (!head->tabsize)
+			flathash_resize(head, FLATHASH_GROUP);
+		else if (head->count < FLATHASH_MAXLOAD(head->tabsize) / 2)
+			flathash_resize(head, head->tabsize);
+		else
+			flathash_resize(head, head->tabsize * 2);
+	}
+
+	slot = flathash_find_free(head, item->hashval);
+	if (head->ctrl[slot] == FLATHASH_EMPTY)
+		head->growth_left--;
+	head->ctrl[slot] = FLATHASH_H2(item->hashval);
+	head->slots[slot] = item;
+	item->slot = slot;
+	head->count++;
+}
+
+void typesafe_flathash_remove(struct tflathash_head *head, uint32_t slot)
+{
+	uint32_t grp = slot & ~(FLATHASH_GROUP - 1);
+
+	head->slots[slot] = NULL;
+	head->count--;
+
+	if (!head->count) {
+		typesafe_flathash_fini(head);
+		return;
+	}
+
+	/* a group that still has an empty slot never had lookups continue
+	 * past it, so the slot can become empty again.  Otherwise it must
+	 * stay marked to keep probe sequences intact.
+	 */
+	if (flathash_match(head->ctrl + grp, FLATHASH_EMPTY)) {
+		head->ctrl[slot] = FLATHASH_EMPTY;
+		head->growth_left++;
+	} else
+		head->ctrl[slot] = FLATHASH_DELETED;
+}
+
+void typesafe_flathash_fini(struct tflathash_head *head)
+{
+	XFREE(MTYPE_FLATHASH_TABLE, head->ctrl);
+	XFREE(MTYPE_FLATHASH_TABLE, head->slots);
+	head->tabsize = 0;
+	head->growth_left = 0;
+}
+
 /* skiplist */
 
 static inline struct sskip_item *sl_level_get(const struct sskip_item *item,
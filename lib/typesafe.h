@@ -23,6 +23,12 @@
 #include <assert.h>
 #include "compiler.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -736,6 +742,218 @@ macro_pure size_t prefix ## _count(const struct prefix##_head *h)              \
 }                                                                              \
 /* ... */
 
+/* open addressing hash ("flat" hash), unsorted
+ *
+ * Same API as DECLARE_HASH, but the table holds item pointers directly, with
+ * one control byte per slot (7 bits of the hash value, or empty/deleted).
+ * Slots are probed in groups of 16, comparing all 16 control bytes at once,
+ * so a lookup usually touches the control bytes, one slot and the item it
+ * points to, rather than one item per chain entry.  Items are not moved when
+ * the table grows, so pointers to them stay valid.
+ *
+ * The table doesn't shrink while it has items in it (it is released when
+ * the last one is removed), so deleting items during frr_each_safe is fine.
+ * Adding items during iteration is not.
+ */
+
+/* don't use these structs directly */
+struct tflathash_item {
+	uint32_t hashval;
+	uint32_t slot;
+};
+
+struct tflathash_head {
+	uint8_t *ctrl;
+	struct tflathash_item **slots;
+	uint32_t count;
+	uint32_t tabsize;
+	uint32_t growth_left;
+};
+
+#define FLATHASH_GROUP		16
+#define FLATHASH_EMPTY		0x80
+#define FLATHASH_DELETED	0xfe
+#define FLATHASH_H1(val)	((val) >> 7)
+#define FLATHASH_H2(val)	((uint8_t)((val) & 0x7f))
+
+/* bit i set if ctrl[i] == byte */
+macro_inline uint32_t flathash_match(const uint8_t *ctrl, uint8_t byte)
+{
+#if defined(__SSE2__)
+	__m128i grp = _mm_loadu_si128((const __m128i *)ctrl);
+
+	return (uint32_t)_mm_movemask_epi8(
+		_mm_cmpeq_epi8(grp, _mm_set1_epi8((char)byte)));
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	static const uint8_t bits[16] = {
+		1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128,
+	};
+	uint8x16_t eq = vandq_u8(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(byte)),
+				 vld1q_u8(bits));
+
+	return vaddv_u8(vget_low_u8(eq)) |
+	       ((uint32_t)vaddv_u8(vget_high_u8(eq)) << 8);
+#else
+	uint32_t i, ret = 0;
+
+	for (i = 0; i < FLATHASH_GROUP; i++)
+		ret |= (uint32_t)(ctrl[i] == byte) << i;
+	return ret;
+#endif
+}
+
+/* bit i set if slot i holds an item */
+macro_inline uint32_t flathash_match_full(const uint8_t *ctrl)
+{
+#if defined(__SSE2__)
+	__m128i grp = _mm_loadu_si128((const __m128i *)ctrl);
+
+	return ~(uint32_t)_mm_movemask_epi8(grp) & 0xffff;
+#else
+	uint32_t i, ret = 0;
+
+	for (i = 0; i < FLATHASH_GROUP; i++)
+		ret |= (uint32_t)!(ctrl[i] & 0x80) << i;
+	return ret;
+#endif
+}
+
+macro_pure const struct tflathash_item *
+typesafe_flathash_next(const struct tflathash_head *head, uint32_t slot)
+{
+	uint32_t grp, mask;
+
+	if (slot >= head->tabsize)
+		return NULL;
+
+	grp = slot & ~(FLATHASH_GROUP - 1);
+	mask = flathash_match_full(head->ctrl + grp) >> (slot - grp);
+	if (mask)
+		return head->slots[slot + __builtin_ctz(mask)];
+
+	for (grp += FLATHASH_GROUP; grp < head->tabsize;
+	     grp += FLATHASH_GROUP) {
+		mask = flathash_match_full(head->ctrl + grp);
+		if (mask)
+			return head->slots[grp + __builtin_ctz(mask)];
+	}
+	return NULL;
+}
+
+extern void typesafe_flathash_insert(struct tflathash_head *head,
+				     struct tflathash_item *item);
+extern void typesafe_flathash_remove(struct tflathash_head *head,
+				     uint32_t slot);
+extern void typesafe_flathash_fini(struct tflathash_head *head);
+
+/* use as:
+ *
+ * PREDECL_FLATHASH(namelist)
+ * struct name {
+ *   struct namelist_item nlitem;
+ * }
+ * DECLARE_FLATHASH(namelist, struct name, nlitem, cmpfunc, hashfunc)
+ */
+#define PREDECL_FLATHASH(prefix)                                               \
+struct prefix ## _head { struct tflathash_head fh; };                          \
+struct prefix ## _item { struct tflathash_item fi; };
+
+#define INIT_FLATHASH(var)	{ }
+
+#define DECLARE_FLATHASH(prefix, type, field, cmpfn, hashfn)                   \
+                                                                               \
+macro_inline void prefix ## _init(struct prefix##_head *h)                     \
+{                                                                              \
+	memset(h, 0, sizeof(*h));                                              \
+}                                                                              \
+macro_inline void prefix ## _fini(struct prefix##_head *h)                     \
+{                                                                              \
+	assert(h->fh.count == 0);                                              \
+	typesafe_flathash_fini(&h->fh);                                        \
+}                                                                              \
+macro_inline const type *_ ## prefix ## _find_hval(                            \
+		const struct prefix##_head *h, const type *item, uint32_t hval) \
+{                                                                              \
+	if (!h->fh.tabsize)                                                    \
+		return NULL;                                                   \
+	uint32_t gmask = h->fh.tabsize / FLATHASH_GROUP - 1;                   \
+	uint32_t grp = FLATHASH_H1(hval) & gmask, step = 0, match;             \
+	const uint8_t *ctrl;                                                   \
+	const struct tflathash_item *fi;                                       \
+	while (1) {                                                            \
+		ctrl = h->fh.ctrl + grp * FLATHASH_GROUP;                      \
+		match = flathash_match(ctrl, FLATHASH_H2(hval));               \
+		while (match) {                                                \
+			fi = h->fh.slots[grp * FLATHASH_GROUP                  \
+					 + __builtin_ctz(match)];              \
+			if (fi->hashval == hval                                \
+			    && !cmpfn(container_of(fi, type, field.fi), item)) \
+				return container_of(fi, type, field.fi);       \
+			match &= match - 1;                                    \
+		}                                                              \
+		if (flathash_match(ctrl, FLATHASH_EMPTY))                      \
+			return NULL;                                           \
+		grp = (grp + ++step) & gmask;                                  \
+	}                                                                      \
+}                                                                              \
+macro_inline type *prefix ## _add(struct prefix##_head *h, type *item)         \
+{                                                                              \
+	uint32_t hval = hashfn(item);                                          \
+	const type *prev = _ ## prefix ## _find_hval(h, item, hval);           \
+	if (prev)                                                              \
+		return (type *)prev;                                           \
+	item->field.fi.hashval = hval;                                         \
+	typesafe_flathash_insert(&h->fh, &item->field.fi);                     \
+	return NULL;                                                           \
+}                                                                              \
+macro_inline const type *prefix ## _const_find(const struct prefix##_head *h,  \
+					       const type *item)               \
+{                                                                              \
+	return _ ## prefix ## _find_hval(h, item, hashfn(item));               \
+}                                                                              \
+TYPESAFE_FIND(prefix, type)                                                    \
+macro_inline type *prefix ## _del(struct prefix##_head *h, type *item)         \
+{                                                                              \
+	uint32_t slot = item->field.fi.slot;                                   \
+	if (slot >= h->fh.tabsize || h->fh.slots[slot] != &item->field.fi)     \
+		return NULL;                                                   \
+	typesafe_flathash_remove(&h->fh, slot);                                \
+	return item;                                                           \
+}                                                                              \
+macro_inline type *prefix ## _pop(struct prefix##_head *h)                     \
+{                                                                              \
+	struct tflathash_item *fi;                                             \
+	fi = (struct tflathash_item *)typesafe_flathash_next(&h->fh, 0);       \
+	if (!fi)                                                               \
+		return NULL;                                                   \
+	typesafe_flathash_remove(&h->fh, fi->slot);                            \
+	return container_of(fi, type, field.fi);                               \
+}                                                                              \
+macro_pure const type *prefix ## _const_first(const struct prefix##_head *h)   \
+{                                                                              \
+	const struct tflathash_item *fi = typesafe_flathash_next(&h->fh, 0);   \
+	return fi ? container_of(fi, type, field.fi) : NULL;                   \
+}                                                                              \
+macro_pure const type *prefix ## _const_next(const struct prefix##_head *h,    \
+					     const type *item)                 \
+{                                                                              \
+	const struct tflathash_item *fi;                                       \
+	fi = typesafe_flathash_next(&h->fh, item->field.fi.slot + 1);          \
+	return fi ? container_of(fi, type, field.fi) : NULL;                   \
+}                                                                              \
+TYPESAFE_FIRST_NEXT(prefix, type)                                              \
+macro_pure type *prefix ## _next_safe(struct prefix##_head *h, type *item)     \
+{                                                                              \
+	if (!item)                                                             \
+		return NULL;                                                   \
+	return prefix ## _next(h, item);                                       \
+}                                                                              \
+macro_pure size_t prefix ## _count(const struct prefix##_head *h)              \
+{                                                                              \
+	return h->fh.count;                                                    \
+}                                                                              \
+/* ... */
+
 /* skiplist, sorted.
  * can be used as priority queue with add / pop
  */
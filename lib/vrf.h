@@ -86,6 +86,9 @@ struct vrf {
 	struct if_name_head ifaces_by_name;
 	struct if_index_head ifaces_by_index;
 
+	/* Interface addresses, see if_lookup_address() */
+	struct if_addr_index *addr_index;
+
 	/* User data */
 	void *info;
 
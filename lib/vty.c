@@ -69,7 +69,8 @@ enum event {
 #ifdef VTYSH
 	VTYSH_SERV,
 	VTYSH_READ,
-	VTYSH_WRITE
+	VTYSH_WRITE,
+	VTYSH_RESUME
 #endif /* VTYSH */
 };
 
@@ -165,6 +166,16 @@ int vty_out(struct vty *vty, const char *format, ...)
 		vty_out(vty, "%s", vty->frame);
 	}
 
+	/* Unfiltered output that needs no crlf expansion is formatted
+	 * straight into the output buffer. */
+	if (!vty->filter
+	    && (vty->type == VTY_SHELL_SERV || vty->type == VTY_FILE)) {
+		va_start(args, format);
+		len = buffer_vprintf(vty->obuf, format, args);
+		va_end(args);
+		return len;
+	}
+
 	va_start(args, format);
 	p = vasnprintfrr(MTYPE_VTY_OUT_BUF, buf, sizeof(buf), format, args);
 	va_end(args);
@@ -2056,15 +2067,85 @@ static int vtysh_flush(struct vty *vty)
 	return 0;
 }
 
-static int vtysh_read(struct thread *thread)
+/*
+ * Run the commands in buf.  If one of them yields, the rest of buf is kept
+ * on the vty and run by vty_resume_process() once that command completes.
+ * Returns -1 if the vty was closed.
+ */
+static int vtysh_execute_input(struct vty *vty, const unsigned char *buf,
+			       size_t nbytes)
 {
 	int ret;
+	const unsigned char *p;
+	uint8_t header[4] = {0, 0, 0, 0};
+
+	if (vty->length + nbytes >= VTY_BUFSIZ) {
+		/* Clear command line buffer. */
+		vty->cp = vty->length = 0;
+		vty_clear_buf(vty);
+		vty_out(vty, "%% Command is too long.\n");
+		return 0;
+	}
+
+	for (p = buf; p < buf + nbytes; p++) {
+		vty->buf[vty->length++] = *p;
+		if (*p == '\0') {
+			/* Pass this line to parser. */
+			ret = vty_execute(vty);
+/* Note that vty_execute clears the command buffer and resets
+   vty->length to 0. */
+
+/* Return result. */
+#ifdef VTYSH_DEBUG
+			printf("result: %d\n", ret);
+			printf("vtysh node: %d\n", vty->node);
+#endif /* VTYSH_DEBUG */
+
+			/* hack for asynchronous "write integrated"
+			 * - other commands in "buf" will be ditched
+			 * - input during pending config-write is
+			 * "unsupported" */
+			if (ret == CMD_SUSPEND)
+				break;
+
+			/* resumable command: stream what it printed so
+			 * far, the result follows when it completes */
+			if (ret == CMD_YIELD) {
+				p++;
+				if (p < buf + nbytes) {
+					vty->resume_input_len = buf + nbytes - p;
+					vty->resume_input = XMALLOC(
+						MTYPE_VTY, vty->resume_input_len);
+					memcpy(vty->resume_input, p,
+					       vty->resume_input_len);
+				}
+
+				if (!vty->t_write && (vtysh_flush(vty) < 0))
+					return -1;
+				break;
+			}
+
+			/* warning: watchfrr hardcodes this result write
+			 */
+			header[3] = ret;
+			buffer_put(vty->obuf, header, 4);
+
+			if (!vty->t_write && (vtysh_flush(vty) < 0))
+				/* Try to flush results; exit if a write
+				 * error occurs. */
+				return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int vtysh_read(struct thread *thread)
+{
 	int sock;
 	int nbytes;
 	struct vty *vty;
 	unsigned char buf[VTY_READ_BUFSIZ];
-	unsigned char *p;
-	uint8_t header[4] = {0, 0, 0, 0};
 
 	sock = THREAD_FD(thread);
 	vty = THREAD_ARG(thread);
@@ -2095,49 +2176,12 @@ static int vtysh_read(struct thread *thread)
 	printf("line: %.*s\n", nbytes, buf);
 #endif /* VTYSH_DEBUG */
 
-	if (vty->length + nbytes >= VTY_BUFSIZ) {
-		/* Clear command line buffer. */
-		vty->cp = vty->length = 0;
-		vty_clear_buf(vty);
-		vty_out(vty, "%% Command is too long.\n");
-	} else {
-		for (p = buf; p < buf + nbytes; p++) {
-			vty->buf[vty->length++] = *p;
-			if (*p == '\0') {
-				/* Pass this line to parser. */
-				ret = vty_execute(vty);
-/* Note that vty_execute clears the command buffer and resets
-   vty->length to 0. */
-
-/* Return result. */
-#ifdef VTYSH_DEBUG
-				printf("result: %d\n", ret);
-				printf("vtysh node: %d\n", vty->node);
-#endif /* VTYSH_DEBUG */
-
-				/* hack for asynchronous "write integrated"
-				 * - other commands in "buf" will be ditched
-				 * - input during pending config-write is
-				 * "unsupported" */
-				if (ret == CMD_SUSPEND)
-					break;
-
-				/* warning: watchfrr hardcodes this result write
-				 */
-				header[3] = ret;
-				buffer_put(vty->obuf, header, 4);
-
-				if (!vty->t_write && (vtysh_flush(vty) < 0))
-					/* Try to flush results; exit if a write
-					 * error occurs. */
-					return 0;
-			}
-		}
-	}
+	if (vtysh_execute_input(vty, buf, nbytes) < 0)
+		return 0;
 
 	if (vty->status == VTY_CLOSE)
 		vty_close(vty);
-	else
+	else if (!vty->resume_fn)
 		vty_event(VTYSH_READ, vty);
 
 	return 0;
@@ -2153,6 +2197,115 @@ static int vtysh_write(struct thread *thread)
 
 #endif /* VTYSH */
 
+/* Time slice for one run of a resumable command */
+#define VTY_RESUME_SLICE_USEC 20000
+/* Delay before retrying while the client has not drained earlier output */
+#define VTY_RESUME_BACKOFF_MSEC 10
+
+static void vty_resume_clear(struct vty *vty)
+{
+	THREAD_OFF(vty->t_resume);
+	if (vty->resume_free)
+		vty->resume_free(vty->resume_arg);
+	vty->resume_fn = NULL;
+	vty->resume_arg = NULL;
+	vty->resume_free = NULL;
+}
+
+bool vty_resume_yield(struct vty *vty)
+{
+	if (!vty->resume_fn)
+		return false;
+
+	return monotime_since(&vty->resume_slice, NULL)
+	       >= VTY_RESUME_SLICE_USEC;
+}
+
+#ifdef VTYSH
+static int vty_resume_process(struct thread *thread)
+{
+	struct vty *vty = THREAD_ARG(thread);
+	uint8_t header[4] = {0, 0, 0, 0};
+	unsigned char *input;
+	size_t len;
+	int ret;
+
+	/* don't produce more output than the client is reading */
+	if (vty->t_write) {
+		vty_event(VTYSH_RESUME, vty);
+		return 0;
+	}
+
+	monotime(&vty->resume_slice);
+	ret = vty->resume_fn(vty, vty->resume_arg);
+
+	if (ret == CMD_YIELD) {
+		if (vtysh_flush(vty) < 0)
+			return 0;
+		vty_event(VTYSH_RESUME, vty);
+		return 0;
+	}
+
+	vty_resume_clear(vty);
+
+	header[3] = ret;
+	buffer_put(vty->obuf, header, 4);
+	if (!vty->t_write && (vtysh_flush(vty) < 0))
+		return 0;
+
+	/* run the commands that were read along with this one */
+	input = vty->resume_input;
+	len = vty->resume_input_len;
+	if (input) {
+		vty->resume_input = NULL;
+		vty->resume_input_len = 0;
+		ret = vtysh_execute_input(vty, input, len);
+		XFREE(MTYPE_VTY, input);
+		if (ret < 0)
+			return 0;
+	}
+
+	if (vty->status == VTY_CLOSE)
+		vty_close(vty);
+	else if (!vty->resume_fn)
+		vty_event(VTYSH_READ, vty);
+	return 0;
+}
+#endif /* VTYSH */
+
+int vty_resume_start(struct vty *vty, int (*fn)(struct vty *vty, void *arg),
+		     void *arg, void (*arg_free)(void *arg))
+{
+	int ret;
+
+#ifdef VTYSH
+	if (vty->type == VTY_SHELL_SERV && !vty->filter && !vty->resume_fn) {
+		vty->resume_fn = fn;
+		vty->resume_arg = arg;
+		vty->resume_free = arg_free;
+		monotime(&vty->resume_slice);
+
+		ret = fn(vty, arg);
+		if (ret != CMD_YIELD) {
+			vty_resume_clear(vty);
+			return ret;
+		}
+
+		vty_event(VTYSH_RESUME, vty);
+		return CMD_YIELD;
+	}
+#endif /* VTYSH */
+
+	/* vty_resume_yield() is false here, fn runs in a single pass */
+	do {
+		ret = fn(vty, arg);
+	} while (ret == CMD_YIELD);
+
+	if (arg_free)
+		arg_free(arg);
+	return ret;
+}
+
 /* Determine address family to bind. */
 void vty_serv_sock(const char *addr, unsigned short port, const char *path)
 {
@@ -2188,6 +2341,7 @@ void vty_close(struct vty *vty)
 	THREAD_OFF(vty->t_read);
 	THREAD_OFF(vty->t_write);
 	THREAD_OFF(vty->t_timeout);
+	vty_resume_clear(vty);
 
 	/* Flush buffer. */
 	buffer_flush_all(vty->obuf, vty->wfd);
@@ -2221,6 +2375,7 @@ void vty_close(struct vty *vty)
 		was_stdio = true;
 
 	XFREE(MTYPE_VTY, vty->buf);
+	XFREE(MTYPE_VTY, vty->resume_input);
 
 	if (vty->error) {
 		vty->error->del = vty_error_delete;
@@ -2254,8 +2409,12 @@ static int vty_timeout(struct thread *thread)
 	return 0;
 }
 
-/* Read up configuration file from file_name. */
-static void vty_read_file(struct nb_config *config, FILE *confp)
+/*
+ * Read up configuration file from file_name.  Without a shared candidate
+ * (config), the private one starts out as preload if given.
+ */
+static void vty_read_file(struct nb_config *config, struct nb_config *preload,
+			  FILE *confp)
 {
 	int ret;
 	struct vty *vty;
@@ -2279,7 +2438,7 @@ static void vty_read_file(struct nb_config *config, FILE *confp)
 		vty->candidate_config = config;
 	else {
 		vty->private_config = true;
-		vty->candidate_config = nb_config_new(NULL);
+		vty->candidate_config = preload ? preload : nb_config_new(NULL);
 	}
 
 	/* Execute configuration file */
@@ -2348,6 +2507,85 @@ static void vty_read_file(struct nb_config *config, FILE *confp)
 	vty_close(vty);
 }
 
+/*
+ * Read <fullpath>.lyb (see struct conf_lyb_hdr) instead of the text
+ * configuration in confp, if both were saved together.  The northbound
+ * configuration is loaded as a whole, and only the remaining text goes
+ * through the command parser; everything is committed at once, as for a
+ * text configuration.  Returns false if the binary file can't be used, in
+ * which case confp is left at its start.
+ */
+static bool vty_read_config_lyb(const char *fullpath, FILE *confp)
+{
+	struct conf_lyb_hdr hdr;
+	uint8_t digest[32];
+	struct lyd_node *dnode = NULL;
+	struct stat st;
+	char *lyb_file;
+	char *buf = NULL;
+	size_t size, lyb_len;
+	FILE *fp, *restp;
+	bool ret = false;
+
+	lyb_file = asprintfrr(MTYPE_TMP, "%s%s", fullpath, CONF_LYB_EXT);
+	fp = fopen(lyb_file, "r");
+	if (!fp)
+		goto out;
+
+	if (fstat(fileno(fp), &st) < 0 || st.st_size < (off_t)sizeof(hdr))
+		goto out_invalid;
+	size = st.st_size;
+	buf = XMALLOC(MTYPE_TMP, size);
+	if (fread(buf, 1, size, fp) != size)
+		goto out_invalid;
+
+	memcpy(&hdr, buf, sizeof(hdr));
+	lyb_len = ntohl(hdr.lyb_len);
+	if (memcmp(hdr.magic, CONF_LYB_MAGIC, sizeof(hdr.magic))
+	    || lyb_len >= size - sizeof(hdr))
+		goto out_invalid;
+
+	config_file_digest(confp, digest);
+	rewind(confp);
+	if (memcmp(digest, hdr.text_sha256, sizeof(digest))) {
+		zlog_info("%s doesn't match %s, ignoring it", lyb_file,
+			  fullpath);
+		goto out_close;
+	}
+
+	if (lyb_len) {
+		dnode = lyd_parse_mem(ly_native_ctx, buf + sizeof(hdr), LYD_LYB,
+				      LYD_OPT_CONFIG);
+		if (!dnode) {
+			flog_warn(EC_LIB_LIBYANG, "%s: can't parse %s",
+				  __func__, lyb_file);
+			goto out_close;
+		}
+	}
+
+	restp = fmemopen(buf + sizeof(hdr) + lyb_len,
+			 size - sizeof(hdr) - lyb_len, "r");
+	if (!restp) {
+		if (dnode)
+			yang_dnode_free(dnode);
+		goto out_close;
+	}
+	vty_read_file(NULL, nb_config_new(dnode), restp);
+	fclose(restp);
+	ret = true;
+	goto out_close;
+
+out_invalid:
+	flog_warn(EC_LIB_VTY, "%s: %s is not a valid binary configuration",
+		  __func__, lyb_file);
+out_close:
+	fclose(fp);
+out:
+	XFREE(MTYPE_TMP, buf);
+	XFREE(MTYPE_TMP, lyb_file);
+	return ret;
+}
+
 static FILE *vty_use_backup_config(const char *fullpath)
 {
 	char *fullpath_sav, *fullpath_tmp;
@@ -2412,6 +2650,8 @@ bool vty_read_config(struct nb_config *config, const char *config_file,
 	const char *fullpath;
 	char *tmp = NULL;
 	bool read_success = false;
+	struct timeval start;
+	const char *how = "text";
 
 	/* If -f flag specified. */
 	if (config_file != NULL) {
@@ -2503,9 +2743,18 @@ bool vty_read_config(struct nb_config *config, const char *config_file,
 			fullpath = config_default_dir;
 	}
 
-	vty_read_file(config, confp);
+	monotime(&start);
+	if (host.binary_config && !config
+	    && vty_read_config_lyb(fullpath, confp))
+		how = "binary";
+	else
+		vty_read_file(config, NULL, confp);
 	read_success = true;
 
+	if (host.binary_config)
+		zlog_info("Read %s configuration %s in %" PRId64 " ms", how,
+			  fullpath, monotime_since(&start, NULL) / 1000);
+
 	fclose(confp);
 
 	host_config_set(fullpath);
@@ -2677,6 +2926,13 @@ static void vty_event(enum event event, struct vty *vty)
 		thread_add_write(vty_master, vtysh_write, vty, vty->wfd,
 				 &vty->t_write);
 		break;
+	case VTYSH_RESUME:
+		/* a timer rather than an event, so pending I/O goes first;
+		 * back off while the client hasn't drained earlier output */
+		thread_add_timer_msec(vty_master, vty_resume_process, vty,
+				      vty->t_write ? VTY_RESUME_BACKOFF_MSEC : 0,
+				      &vty->t_resume);
+		break;
 #endif /* VTYSH */
 	case VTY_READ:
 		thread_add_read(vty_master, vty_read, vty, vty->fd,
@@ -192,6 +192,16 @@ struct vty {
 	unsigned long v_timeout;
 	struct thread *t_timeout;
 
+	/* Resumable command in progress, see vty_resume_start() */
+	int (*resume_fn)(struct vty *vty, void *arg);
+	void *resume_arg;
+	void (*resume_free)(void *arg);
+	struct thread *t_resume;
+	struct timeval resume_slice;
+	/* Input read along with the command in progress, run after it */
+	unsigned char *resume_input;
+	size_t resume_input_len;
+
 	/* What address is this vty comming from. */
 	char address[SU_ADDRSTRLEN];
 
@@ -320,6 +330,23 @@ extern void vty_frame(struct vty *, const char *, ...) PRINTFRR(2, 3);
 extern void vty_endframe(struct vty *, const char *);
 bool vty_set_include(struct vty *vty, const char *regexp);
 
+/*
+ * Long running show commands can hand a cursor to vty_resume_start() instead
+ * of walking their data in one go.  fn is called with arg until it returns
+ * something other than CMD_YIELD; it should check vty_resume_yield() between
+ * items and return CMD_YIELD when that says its time slice is used up.  On
+ * vtysh sessions the remaining slices run as separate tasks, with the output
+ * produced so far already sent to the client.  Other sessions, or commands
+ * using an output filter, run fn to completion right away.  arg_free, if
+ * given, is called on arg when the command completes or the vty is closed.
+ *
+ * Returns the command's result, or CMD_YIELD if it continues later.
+ */
+extern int vty_resume_start(struct vty *vty,
+			    int (*fn)(struct vty *vty, void *arg), void *arg,
+			    void (*arg_free)(void *arg));
+extern bool vty_resume_yield(struct vty *vty);
+
 extern bool vty_read_config(struct nb_config *config, const char *config_file,
 			    char *config_default_dir);
 extern void vty_time_print(struct vty *, int);
@@ -2344,6 +2344,7 @@ struct connected *zebra_interface_address_read(int type, struct stream *s,
 					ifp->name, ifc->address);
 				UNSET_FLAG(ifc->flags, ZEBRA_IFA_PEER);
 			}
+			connected_index_update(ifc);
 		}
 	} else {
 		assert(type == ZEBRA_INTERFACE_ADDRESS_DELETE);
@@ -3916,6 +3917,11 @@ static int zclient_read(struct thread *thread)
 			(*zclient->zebra_client_close_notify)(command, zclient,
 							      length, vrf_id);
 		break;
+	case ZEBRA_INTERFACE_EVENTS_DONE:
+		if (zclient->interface_events_done)
+			(*zclient->interface_events_done)(command, zclient,
+							  length, vrf_id);
+		break;
 	default:
 		break;
 	}
@@ -221,6 +221,7 @@ typedef enum {
 	ZEBRA_NEIGH_DISCOVER,
 	ZEBRA_ROUTE_NOTIFY_REQUEST,
 	ZEBRA_CLIENT_CLOSE_NOTIFY,
+	ZEBRA_INTERFACE_EVENTS_DONE,
 } zebra_message_types_t;
 
 enum zebra_error_types {
@@ -379,6 +380,7 @@ struct zclient {
 	int (*opaque_unregister_handler)(ZAPI_CALLBACK_ARGS);
 	int (*sr_policy_notify_status)(ZAPI_CALLBACK_ARGS);
 	int (*zebra_client_close_notify)(ZAPI_CALLBACK_ARGS);
+	int (*interface_events_done)(ZAPI_CALLBACK_ARGS);
 };
 
 /* Zebra API message flag. */
@@ -30,6 +30,7 @@
 #include "vty.h"
 #include "filter.h"
 #include "log.h"
+#include "jhash.h"
 
 #include "ospfd/ospfd.h"
 #include "ospfd/ospf_interface.h"
@@ -354,6 +355,141 @@ void ospf_asbr_external_aggregator_init(struct ospf *instance)
 	instance->aggr_delay_interval = OSPF_EXTL_AGGR_DEFAULT_DELAY;
 }
 
+/*
+ * Redistributed routes are not originated as they come in from zebra, but
+ * queued and originated in batches of OSPF_EXTERNAL_BATCH, each flooded in
+ * one pass.  Entries are keyed like the external info; a route that changes
+ * again before it gets its turn is only processed once, and one that is
+ * withdrawn meanwhile not at all.
+ */
+struct ospf_ext_queued {
+	struct ospf_ext_fifo_item fifo_item;
+	struct ospf_ext_pending_item pending_item;
+
+	uint8_t type;
+	unsigned short instance;
+	struct prefix_ipv4 p;
+};
+
+static int ospf_ext_queued_cmp(const struct ospf_ext_queued *a,
+			       const struct ospf_ext_queued *b)
+{
+	if (a->type != b->type)
+		return numcmp(a->type, b->type);
+	if (a->instance != b->instance)
+		return numcmp(a->instance, b->instance);
+	return prefix_cmp((const struct prefix *)&a->p,
+			  (const struct prefix *)&b->p);
+}
+
+static uint32_t ospf_ext_queued_hash(const struct ospf_ext_queued *q)
+{
+	return jhash_2words(prefix_hash_key(&q->p),
+			    ((uint32_t)q->type << 16) | q->instance, 0);
+}
+
+DECLARE_DLIST(ospf_ext_fifo, struct ospf_ext_queued, fifo_item)
+DECLARE_HASH(ospf_ext_pending, struct ospf_ext_queued, pending_item,
+	     ospf_ext_queued_cmp, ospf_ext_queued_hash)
+
+void ospf_external_queue_init(struct ospf *ospf)
+{
+	ospf_ext_fifo_init(&ospf->external_fifo);
+	ospf_ext_pending_init(&ospf->external_pending);
+}
+
+void ospf_external_queue_fini(struct ospf *ospf)
+{
+	struct ospf_ext_queued *q;
+
+	THREAD_OFF(ospf->t_external_queue);
+
+	while ((q = ospf_ext_fifo_pop(&ospf->external_fifo))) {
+		ospf_ext_pending_del(&ospf->external_pending, q);
+		XFREE(MTYPE_OSPF_EXTERNAL_QUEUE, q);
+	}
+	ospf_ext_fifo_fini(&ospf->external_fifo);
+	ospf_ext_pending_fini(&ospf->external_pending);
+}
+
+static int ospf_external_queue_process(struct thread *thread)
+{
+	struct ospf *ospf = THREAD_ARG(thread);
+	struct ospf_ext_queued *q;
+	struct external_info *ei;
+	struct ospf_lsa *current;
+	struct list *flood;
+	unsigned int count = 0;
+
+	flood = list_new();
+
+	while (count < OSPF_EXTERNAL_BATCH
+	       && (q = ospf_ext_fifo_pop(&ospf->external_fifo))) {
+		ospf_ext_pending_del(&ospf->external_pending, q);
+		ei = ospf_external_info_lookup(ospf, q->type, q->instance,
+					       &q->p);
+		XFREE(MTYPE_OSPF_EXTERNAL_QUEUE, q);
+
+		/* Withdrawn meanwhile, or now covered by a summary address
+		 * (which takes care of it).
+		 */
+		if (!ei || ospf_external_aggr_match(ospf, &ei->p))
+			continue;
+
+		count++;
+		current = ospf_external_info_find_lsa(ospf, &ei->p);
+		if (!current) {
+			/* Check the AS-external-LSA should be originated. */
+			if (ospf_redistribute_check(ospf, ei, NULL))
+				ospf_external_lsa_originate_batch(ospf, ei,
+								  flood);
+		} else {
+			if (IS_DEBUG_OSPF(zebra, ZEBRA_REDISTRIBUTE))
+				zlog_debug("%s: %pI4 refreshing LSA", __func__,
+					   &ei->p.prefix);
+			ospf_external_lsa_refresh_batch(ospf, current, ei,
+							LSA_REFRESH_FORCE,
+							flood);
+		}
+	}
+
+	if (IS_DEBUG_OSPF(zebra, ZEBRA_REDISTRIBUTE))
+		zlog_debug("%s: %u routes processed, %u LSAs to flood, %zu left",
+			   __func__, count, listcount(flood),
+			   ospf_ext_fifo_count(&ospf->external_fifo));
+
+	ospf_external_lsa_flood_batch(ospf, flood);
+	list_delete(&flood);
+
+	/* Next batch after whatever else is pending */
+	if (ospf_ext_fifo_count(&ospf->external_fifo))
+		thread_add_event(master, ospf_external_queue_process, ospf, 0,
+				 &ospf->t_external_queue);
+	return 0;
+}
+
+/* Originate or refresh the AS-external-LSA for ei, soon */
+void ospf_external_queue_add(struct ospf *ospf, struct external_info *ei)
+{
+	struct ospf_ext_queued ref = {}, *q;
+
+	ref.type = ei->type;
+	ref.instance = ei->instance;
+	ref.p = ei->p;
+	if (ospf_ext_pending_find(&ospf->external_pending, &ref))
+		return;
+
+	q = XCALLOC(MTYPE_OSPF_EXTERNAL_QUEUE, sizeof(*q));
+	q->type = ei->type;
+	q->instance = ei->instance;
+	q->p = ei->p;
+	ospf_ext_pending_add(&ospf->external_pending, q);
+	ospf_ext_fifo_add_tail(&ospf->external_fifo, q);
+
+	thread_add_event(master, ospf_external_queue_process, ospf, 0,
+			 &ospf->t_external_queue);
+}
+
 static unsigned int ospf_external_rt_hash_key(const void *data)
 {
 	const struct external_info *ei = data;
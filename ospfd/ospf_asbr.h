@@ -64,6 +64,9 @@ struct external_info {
 
 #define OSPF_EXTL_AGGR_DEFAULT_DELAY 5
 
+/* Redistributed routes are originated this many at a time */
+#define OSPF_EXTERNAL_BATCH 1000
+
 #define OSPF_EXTERNAL_RT_COUNT(aggr)                                           \
 	(((struct ospf_external_aggr_rt *)aggr)->match_extnl_hash->count)
 
@@ -132,6 +135,10 @@ extern struct ospf_lsa *ospf_external_info_find_lsa(struct ospf *,
 
 /* External Route Aggregator */
 extern void ospf_asbr_external_aggregator_init(struct ospf *instance);
+extern void ospf_external_queue_init(struct ospf *ospf);
+extern void ospf_external_queue_fini(struct ospf *ospf);
+extern void ospf_external_queue_add(struct ospf *ospf,
+				    struct external_info *ei);
 extern void ospf_external_aggregator_free(struct ospf_external_aggr_rt *aggr);
 extern bool is_valid_summary_addr(struct prefix_ipv4 *p);
 extern struct ospf_external_aggr_rt *
@@ -44,6 +44,36 @@
 #include "ospfd/ospf_ase.h"
 #include "ospfd/ospf_zebra.h"
 #include "ospfd/ospf_dump.h"
+#include "ospfd/ospf_memory.h"
+
+/*
+ * Besides external_lsas (by destination), external LSAs are indexed by ASBR
+ * and by forwarding address.  After SPF, only the external routes depending
+ * on routes that changed are recalculated: those of an ASBR whose route
+ * changed, and those to a destination or through a forwarding address
+ * within a network route that changed.
+ */
+DECLARE_DLIST(ospf_ase_asbr_lsas, struct ospf_lsa, asbr_item)
+DECLARE_DLIST(ospf_ase_fwd_lsas, struct ospf_lsa, fwd_item)
+
+struct ospf_ase_dirty_dest {
+	struct ospf_ase_dirty_item item;
+	struct prefix_ipv4 p;
+};
+
+static int ospf_ase_dirty_cmp(const struct ospf_ase_dirty_dest *a,
+			      const struct ospf_ase_dirty_dest *b)
+{
+	return prefix_cmp(&a->p, &b->p);
+}
+
+static uint32_t ospf_ase_dirty_hash(const struct ospf_ase_dirty_dest *d)
+{
+	return prefix_hash_key(&d->p);
+}
+
+DECLARE_HASH(ospf_ase_dirty, struct ospf_ase_dirty_dest, item,
+	     ospf_ase_dirty_cmp, ospf_ase_dirty_hash)
 
 struct ospf_route *ospf_find_asbr_route(struct ospf *ospf,
 					struct route_table *rtrs,
@@ -551,6 +581,198 @@ static int ospf_ase_compare_tables(struct ospf *ospf,
 	return 0;
 }
 
+static void ospf_ase_lsa_prefix(struct ospf_lsa *lsa, struct prefix_ipv4 *p)
+{
+	struct as_external_lsa *al;
+
+	al = (struct as_external_lsa *)lsa->data;
+	memset(p, 0, sizeof(*p));
+	p->family = AF_INET;
+	p->prefix = lsa->data->id;
+	p->prefixlen = ip_masklen(al->mask);
+	apply_mask_ipv4(p);
+}
+
+static void ospf_ase_dirty_prefix(struct ospf *ospf, struct prefix_ipv4 *p)
+{
+	struct ospf_ase_dirty_dest ref, *dest;
+
+	ref.p = *p;
+	if (ospf_ase_dirty_find(&ospf->ase_dirty, &ref))
+		return;
+
+	dest = XCALLOC(MTYPE_OSPF_ASE_DIRTY, sizeof(*dest));
+	dest->p = *p;
+	ospf_ase_dirty_add(&ospf->ase_dirty, dest);
+}
+
+static void ospf_ase_dirty_lsa(struct ospf *ospf, struct ospf_lsa *lsa)
+{
+	struct prefix_ipv4 p;
+
+	ospf_ase_lsa_prefix(lsa, &p);
+	ospf_ase_dirty_prefix(ospf, &p);
+}
+
+static void ospf_ase_dirty_clear(struct ospf *ospf)
+{
+	struct ospf_ase_dirty_dest *dest;
+
+	while ((dest = ospf_ase_dirty_pop(&ospf->ase_dirty)))
+		XFREE(MTYPE_OSPF_ASE_DIRTY, dest);
+}
+
+/* Whether external routes calculated through or1 and or2 are the same. */
+static bool ospf_ase_route_same(struct ospf_route *or1, struct ospf_route *or2)
+{
+	struct listnode *n1, *n2;
+	struct ospf_path *op1, *op2;
+
+	if (!or1 || !or2)
+		return or1 == or2;
+
+	if (or1->type != or2->type || or1->path_type != or2->path_type
+	    || or1->cost != or2->cost)
+		return false;
+	if (!IPV4_ADDR_SAME(&or1->u.std.area_id, &or2->u.std.area_id)
+	    || or1->u.std.flags != or2->u.std.flags)
+		return false;
+
+	if (listcount(or1->paths) != listcount(or2->paths))
+		return false;
+	for (n1 = listhead(or1->paths), n2 = listhead(or2->paths); n1 && n2;
+	     n1 = listnextnode_unchecked(n1), n2 = listnextnode_unchecked(n2)) {
+		op1 = listgetdata(n1);
+		op2 = listgetdata(n2);
+
+		if (!IPV4_ADDR_SAME(&op1->nexthop, &op2->nexthop))
+			return false;
+		if (op1->ifindex != op2->ifindex)
+			return false;
+	}
+
+	return true;
+}
+
+/* The route to ASBR may have changed, new_rtrs replaces ospf->new_rtrs. */
+static void ospf_ase_check_asbr(struct ospf *ospf,
+				struct route_table *new_rtrs,
+				struct prefix_ipv4 *asbr)
+{
+	struct route_node *rn;
+	struct ospf_lsa *lsa;
+
+	rn = route_node_lookup(ospf->external_asbr, (struct prefix *)asbr);
+	if (!rn)
+		return;
+	route_unlock_node(rn);
+
+	if (ospf_ase_route_same(ospf_find_asbr_route(ospf, ospf->new_rtrs, asbr),
+				ospf_find_asbr_route(ospf, new_rtrs, asbr)))
+		return;
+
+	frr_each (ospf_ase_asbr_lsas,
+		  (struct ospf_ase_asbr_lsas_head *)rn->info, lsa)
+		ospf_ase_dirty_lsa(ospf, lsa);
+}
+
+/* The network route to p changed. */
+static void ospf_ase_check_network(struct ospf *ospf, struct prefix_ipv4 *p)
+{
+	struct route_node *rn, *top;
+	struct ospf_lsa *lsa;
+
+	/* Internal routes take precedence over external ones... */
+	rn = route_node_lookup(ospf->external_lsas, (struct prefix *)p);
+	if (rn) {
+		route_unlock_node(rn);
+		ospf_ase_dirty_prefix(ospf, p);
+	}
+
+	/* ...and forwarding addresses are resolved through them. */
+	top = route_node_get(ospf->external_fwd, (struct prefix *)p);
+	for (rn = route_lock_node(top); rn; rn = route_next_until(rn, top))
+		if (rn->info)
+			frr_each (ospf_ase_fwd_lsas,
+				  (struct ospf_ase_fwd_lsas_head *)rn->info,
+				  lsa)
+				ospf_ase_dirty_lsa(ospf, lsa);
+	route_unlock_node(top);
+}
+
+/* Recalculate the external route to p and install the difference. */
+static void ospf_ase_update_prefix(struct ospf *ospf, struct prefix_ipv4 *p)
+{
+	struct ospf_lsa *lsa;
+	struct listnode *node;
+	struct route_node *rn, *rn2;
+	struct route_table *tmp_old;
+
+	/* if new_table is NULL, there was no spf calculation, thus
+	   incremental update is unneeded */
+	if (!ospf->new_table)
+		return;
+
+	/* If there is already an intra-area or inter-area route
+	   to the destination, no recalculation is necessary
+	   (internal routes take precedence). */
+
+	rn = route_node_lookup(ospf->new_table, (struct prefix *)p);
+	if (rn) {
+		route_unlock_node(rn);
+		if (rn->info)
+			return;
+	}
+
+	rn = route_node_lookup(ospf->external_lsas, (struct prefix *)p);
+	if (rn) {
+		route_unlock_node(rn);
+		for (ALL_LIST_ELEMENTS_RO((struct list *)rn->info, node, lsa))
+			ospf_ase_calculate_route(ospf, lsa);
+	}
+
+	/* prepare temporary old routing table for compare */
+	tmp_old = route_table_init();
+	rn = route_node_lookup(ospf->old_external_route, (struct prefix *)p);
+	if (rn && rn->info) {
+		rn2 = route_node_get(tmp_old, (struct prefix *)p);
+		rn2->info = rn->info;
+		route_unlock_node(rn);
+	}
+
+	/* install changes to zebra */
+	ospf_ase_compare_tables(ospf, ospf->new_external_route, tmp_old);
+
+	/* update ospf->old_external_route table */
+	if (rn && rn->info)
+		ospf_route_free((struct ospf_route *)rn->info);
+
+	rn2 = route_node_lookup(ospf->new_external_route, (struct prefix *)p);
+	/* if new route exists, install it to ospf->old_external_route */
+	if (rn2 && rn2->info) {
+		if (!rn)
+			rn = route_node_get(ospf->old_external_route,
+					    (struct prefix *)p);
+		rn->info = rn2->info;
+	} else {
+		/* remove route node from ospf->old_external_route */
+		if (rn) {
+			rn->info = NULL;
+			route_unlock_node(rn);
+		}
+	}
+
+	if (rn2) {
+		/* rn2->info is stored in route node of ospf->old_external_route
+		 */
+		rn2->info = NULL;
+		route_unlock_node(rn2);
+		route_unlock_node(rn2);
+	}
+
+	route_table_finish(tmp_old);
+}
+
 static int ospf_ase_calculate_timer(struct thread *t)
 {
 	struct ospf *ospf;
@@ -558,13 +780,17 @@ static int ospf_ase_calculate_timer(struct thread *t)
 	struct route_node *rn;
 	struct listnode *node;
 	struct ospf_area *area;
+	struct ospf_ase_dirty_dest *dest;
 	struct timeval start_time, stop_time;
+	unsigned long ase_time;
+	size_t count;
 
 	ospf = THREAD_ARG(t);
 	ospf->t_ase_calc = NULL;
 
 	if (ospf->ase_calc) {
 		ospf->ase_calc = 0;
+		ospf_ase_dirty_clear(ospf);
 
 		monotime(&start_time);
 
@@ -608,6 +834,19 @@ static int ospf_ase_calculate_timer(struct thread *t)
 						* 1000000LL
 					+ (stop_time.tv_usec
 					   - start_time.tv_usec));
+	} else if ((count = ospf_ase_dirty_count(&ospf->ase_dirty))) {
+		monotime(&start_time);
+
+		while ((dest = ospf_ase_dirty_pop(&ospf->ase_dirty))) {
+			ospf_ase_update_prefix(ospf, &dest->p);
+			XFREE(MTYPE_OSPF_ASE_DIRTY, dest);
+		}
+		ase_time = monotime_since(&start_time, NULL);
+
+		if (IS_DEBUG_OSPF_EVENT)
+			zlog_info(
+				"SPF Processing Time(usecs): External Routes: %lu (%zu destinations)",
+				ase_time, count);
 	}
 	return 0;
 }
@@ -620,6 +859,71 @@ void ospf_ase_calculate_schedule(struct ospf *ospf)
 	ospf->ase_calc = 1;
 }
 
+void ospf_ase_calculate_schedule_changes(struct ospf *ospf,
+					 struct route_table *new_table,
+					 struct route_table *new_rtrs)
+{
+	struct route_node *rn, *rn2;
+	struct ospf_route *or;
+
+	if (ospf == NULL || ospf->ase_calc)
+		return;
+
+	if (!ospf->new_table || !ospf->new_rtrs) {
+		ospf_ase_calculate_schedule(ospf);
+		return;
+	}
+
+	/* ASBRs */
+	for (rn = route_top(new_rtrs); rn; rn = route_next(rn))
+		if (rn->info)
+			ospf_ase_check_asbr(ospf, new_rtrs,
+					    (struct prefix_ipv4 *)&rn->p);
+	for (rn = route_top(ospf->new_rtrs); rn; rn = route_next(rn)) {
+		if (!rn->info)
+			continue;
+		rn2 = route_node_lookup(new_rtrs, &rn->p);
+		if (rn2)
+			route_unlock_node(rn2);
+		else
+			ospf_ase_check_asbr(ospf, new_rtrs,
+					    (struct prefix_ipv4 *)&rn->p);
+	}
+
+	/* Networks */
+	for (rn = route_top(new_table); rn; rn = route_next(rn)) {
+		if (!rn->info)
+			continue;
+		or = NULL;
+		rn2 = route_node_lookup(ospf->new_table, &rn->p);
+		if (rn2) {
+			or = rn2->info;
+			route_unlock_node(rn2);
+		}
+		if (!ospf_ase_route_same(or, rn->info))
+			ospf_ase_check_network(ospf,
+					       (struct prefix_ipv4 *)&rn->p);
+	}
+	for (rn = route_top(ospf->new_table); rn; rn = route_next(rn)) {
+		if (!rn->info)
+			continue;
+		rn2 = route_node_lookup(new_table, &rn->p);
+		if (rn2)
+			route_unlock_node(rn2);
+		else
+			ospf_ase_check_network(ospf,
+					       (struct prefix_ipv4 *)&rn->p);
+	}
+
+	/* Recalculating most destinations one by one is slower than a full
+	 * run. */
+	if (ospf_ase_dirty_count(&ospf->ase_dirty)
+	    > route_table_count(ospf->external_lsas) / 2) {
+		ospf_ase_dirty_clear(ospf);
+		ospf_ase_calculate_schedule(ospf);
+	}
+}
+
 void ospf_ase_calculate_timer_add(struct ospf *ospf)
 {
 	if (ospf == NULL)
@@ -629,28 +933,109 @@ void ospf_ase_calculate_timer_add(struct ospf *ospf)
 			 OSPF_ASE_CALC_INTERVAL, &ospf->t_ase_calc);
 }
 
-void ospf_ase_register_external_lsa(struct ospf_lsa *lsa, struct ospf *top)
+static void ospf_ase_index_add(struct ospf *ospf, struct ospf_lsa *lsa)
 {
+	struct as_external_lsa *al;
+	struct ospf_ase_asbr_lsas_head *asbr_lsas;
+	struct ospf_ase_fwd_lsas_head *fwd_lsas;
 	struct route_node *rn;
 	struct prefix_ipv4 p;
-	struct list *lst;
+
+	al = (struct as_external_lsa *)lsa->data;
+	memset(&p, 0, sizeof(p));
+	p.family = AF_INET;
+	p.prefixlen = IPV4_MAX_BITLEN;
+
+	p.prefix = lsa->data->adv_router;
+	rn = route_node_get(ospf->external_asbr, (struct prefix *)&p);
+	if ((asbr_lsas = rn->info) == NULL) {
+		rn->info = asbr_lsas = XCALLOC(MTYPE_OSPF_EXTERNAL_INDEX,
+					       sizeof(*asbr_lsas));
+		ospf_ase_asbr_lsas_init(asbr_lsas);
+	} else
+		route_unlock_node(rn);
+	ospf_ase_asbr_lsas_add_tail(asbr_lsas, lsa);
+
+	if (al->e[0].fwd_addr.s_addr == INADDR_ANY)
+		return;
+
+	p.prefix = al->e[0].fwd_addr;
+	rn = route_node_get(ospf->external_fwd, (struct prefix *)&p);
+	if ((fwd_lsas = rn->info) == NULL) {
+		rn->info = fwd_lsas = XCALLOC(MTYPE_OSPF_EXTERNAL_INDEX,
+					      sizeof(*fwd_lsas));
+		ospf_ase_fwd_lsas_init(fwd_lsas);
+	} else
+		route_unlock_node(rn);
+	ospf_ase_fwd_lsas_add_tail(fwd_lsas, lsa);
+}
+
+static void ospf_ase_index_del(struct ospf *ospf, struct ospf_lsa *lsa)
+{
 	struct as_external_lsa *al;
+	struct ospf_ase_asbr_lsas_head *asbr_lsas;
+	struct ospf_ase_fwd_lsas_head *fwd_lsas;
+	struct route_node *rn;
+	struct prefix_ipv4 p;
 
 	al = (struct as_external_lsa *)lsa->data;
+	memset(&p, 0, sizeof(p));
 	p.family = AF_INET;
-	p.prefix = lsa->data->id;
-	p.prefixlen = ip_masklen(al->mask);
-	apply_mask_ipv4(&p);
+	p.prefixlen = IPV4_MAX_BITLEN;
+
+	p.prefix = lsa->data->adv_router;
+	rn = route_node_lookup(ospf->external_asbr, (struct prefix *)&p);
+	if (rn) {
+		asbr_lsas = rn->info;
+		ospf_ase_asbr_lsas_del(asbr_lsas, lsa);
+		if (ospf_ase_asbr_lsas_count(asbr_lsas) == 0) {
+			ospf_ase_asbr_lsas_fini(asbr_lsas);
+			XFREE(MTYPE_OSPF_EXTERNAL_INDEX, asbr_lsas);
+			rn->info = NULL;
+			route_unlock_node(rn);
+		}
+		route_unlock_node(rn);
+	}
+
+	if (al->e[0].fwd_addr.s_addr == INADDR_ANY)
+		return;
+
+	p.prefix = al->e[0].fwd_addr;
+	rn = route_node_lookup(ospf->external_fwd, (struct prefix *)&p);
+	if (rn) {
+		fwd_lsas = rn->info;
+		ospf_ase_fwd_lsas_del(fwd_lsas, lsa);
+		if (ospf_ase_fwd_lsas_count(fwd_lsas) == 0) {
+			ospf_ase_fwd_lsas_fini(fwd_lsas);
+			XFREE(MTYPE_OSPF_EXTERNAL_INDEX, fwd_lsas);
+			rn->info = NULL;
+			route_unlock_node(rn);
+		}
+		route_unlock_node(rn);
+	}
+}
+
+void ospf_ase_register_external_lsa(struct ospf_lsa *lsa, struct ospf *top)
+{
+	struct route_node *rn;
+	struct prefix_ipv4 p;
+	struct list *lst;
+
+	ospf_ase_lsa_prefix(lsa, &p);
 
 	rn = route_node_get(top->external_lsas, (struct prefix *)&p);
 	if ((lst = rn->info) == NULL)
 		rn->info = lst = list_new();
-	else
+	else {
 		route_unlock_node(rn);
+		if (listnode_lookup(lst, lsa))
+			return;
+	}
 
 	/* We assume that if LSA is deleted from DB
 	   is is also deleted from this RT */
 	listnode_add(lst, ospf_lsa_lock(lsa)); /* external_lsas lst */
+	ospf_ase_index_add(top, lsa);
 }
 
 void ospf_ase_unregister_external_lsa(struct ospf_lsa *lsa, struct ospf *top)
@@ -658,13 +1043,8 @@ void ospf_ase_unregister_external_lsa(struct ospf_lsa *lsa, struct ospf *top)
 	struct route_node *rn;
 	struct prefix_ipv4 p;
 	struct list *lst;
-	struct as_external_lsa *al;
 
-	al = (struct as_external_lsa *)lsa->data;
-	p.family = AF_INET;
-	p.prefix = lsa->data->id;
-	p.prefixlen = ip_masklen(al->mask);
-	apply_mask_ipv4(&p);
+	ospf_ase_lsa_prefix(lsa, &p);
 
 	rn = route_node_lookup(top->external_lsas, (struct prefix *)&p);
 
@@ -674,6 +1054,7 @@ void ospf_ase_unregister_external_lsa(struct ospf_lsa *lsa, struct ospf *top)
 		/* Unlock lsa only if node is present in the list */
 		if (node) {
 			listnode_delete(lst, lsa);
+			ospf_ase_index_del(top, lsa);
 			ospf_lsa_unlock(&lsa); /* external_lsas list */
 		}
 
@@ -681,101 +1062,62 @@ void ospf_ase_unregister_external_lsa(struct ospf_lsa *lsa, struct ospf *top)
 	}
 }
 
-void ospf_ase_external_lsas_finish(struct route_table *rt)
+void ospf_ase_init(struct ospf *ospf)
+{
+	ospf->external_lsas = route_table_init();
+	ospf->external_asbr = route_table_init();
+	ospf->external_fwd = route_table_init();
+	ospf_ase_dirty_init(&ospf->ase_dirty);
+}
+
+void ospf_ase_external_lsas_finish(struct ospf *ospf)
 {
 	struct route_node *rn;
 	struct ospf_lsa *lsa;
 	struct list *lst;
 	struct listnode *node, *nnode;
+	struct ospf_ase_asbr_lsas_head *asbr_lsas;
+	struct ospf_ase_fwd_lsas_head *fwd_lsas;
+
+	/* Indexes first, the LSAs may go away below */
+	for (rn = route_top(ospf->external_asbr); rn; rn = route_next(rn))
+		if ((asbr_lsas = rn->info) != NULL) {
+			while (ospf_ase_asbr_lsas_pop(asbr_lsas))
+				;
+			ospf_ase_asbr_lsas_fini(asbr_lsas);
+			XFREE(MTYPE_OSPF_EXTERNAL_INDEX, asbr_lsas);
+		}
+	route_table_finish(ospf->external_asbr);
+
+	for (rn = route_top(ospf->external_fwd); rn; rn = route_next(rn))
+		if ((fwd_lsas = rn->info) != NULL) {
+			while (ospf_ase_fwd_lsas_pop(fwd_lsas))
+				;
+			ospf_ase_fwd_lsas_fini(fwd_lsas);
+			XFREE(MTYPE_OSPF_EXTERNAL_INDEX, fwd_lsas);
+		}
+	route_table_finish(ospf->external_fwd);
 
-	for (rn = route_top(rt); rn; rn = route_next(rn))
+	ospf_ase_dirty_clear(ospf);
+	ospf_ase_dirty_fini(&ospf->ase_dirty);
+
+	for (rn = route_top(ospf->external_lsas); rn; rn = route_next(rn))
 		if ((lst = rn->info) != NULL) {
 			for (ALL_LIST_ELEMENTS(lst, node, nnode, lsa))
 				ospf_lsa_unlock(&lsa); /* external_lsas lst */
 			list_delete(&lst);
 		}
 
-	route_table_finish(rt);
+	route_table_finish(ospf->external_lsas);
+	ospf->external_lsas = NULL;
+	ospf->external_asbr = NULL;
+	ospf->external_fwd = NULL;
 }
 
 void ospf_ase_incremental_update(struct ospf *ospf, struct ospf_lsa *lsa)
 {
-	struct list *lsas;
-	struct listnode *node;
-	struct route_node *rn, *rn2;
 	struct prefix_ipv4 p;
-	struct route_table *tmp_old;
-	struct as_external_lsa *al;
-
-	al = (struct as_external_lsa *)lsa->data;
-	p.family = AF_INET;
-	p.prefix = lsa->data->id;
-	p.prefixlen = ip_masklen(al->mask);
-	apply_mask_ipv4(&p);
-
-	/* if new_table is NULL, there was no spf calculation, thus
-	   incremental update is unneeded */
-	if (!ospf->new_table)
-		return;
-
-	/* If there is already an intra-area or inter-area route
-	   to the destination, no recalculation is necessary
-	   (internal routes take precedence). */
-
-	rn = route_node_lookup(ospf->new_table, (struct prefix *)&p);
-	if (rn) {
-		route_unlock_node(rn);
-		if (rn->info)
-			return;
-	}
-
-	rn = route_node_lookup(ospf->external_lsas, (struct prefix *)&p);
-	assert(rn);
-	assert(rn->info);
-	lsas = rn->info;
-	route_unlock_node(rn);
-
-	for (ALL_LIST_ELEMENTS_RO(lsas, node, lsa))
-		ospf_ase_calculate_route(ospf, lsa);
-
-	/* prepare temporary old routing table for compare */
-	tmp_old = route_table_init();
-	rn = route_node_lookup(ospf->old_external_route, (struct prefix *)&p);
-	if (rn && rn->info) {
-		rn2 = route_node_get(tmp_old, (struct prefix *)&p);
-		rn2->info = rn->info;
-		route_unlock_node(rn);
-	}
 
-	/* install changes to zebra */
-	ospf_ase_compare_tables(ospf, ospf->new_external_route, tmp_old);
-
-	/* update ospf->old_external_route table */
-	if (rn && rn->info)
-		ospf_route_free((struct ospf_route *)rn->info);
-
-	rn2 = route_node_lookup(ospf->new_external_route, (struct prefix *)&p);
-	/* if new route exists, install it to ospf->old_external_route */
-	if (rn2 && rn2->info) {
-		if (!rn)
-			rn = route_node_get(ospf->old_external_route,
-					    (struct prefix *)&p);
-		rn->info = rn2->info;
-	} else {
-		/* remove route node from ospf->old_external_route */
-		if (rn) {
-			rn->info = NULL;
-			route_unlock_node(rn);
-		}
-	}
-
-	if (rn2) {
-		/* rn2->info is stored in route node of ospf->old_external_route
-		 */
-		rn2->info = NULL;
-		route_unlock_node(rn2);
-		route_unlock_node(rn2);
-	}
-
-	route_table_finish(tmp_old);
+	ospf_ase_lsa_prefix(lsa, &p);
+	ospf_ase_update_prefix(ospf, &p);
 }
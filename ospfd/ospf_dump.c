@@ -226,6 +226,19 @@ const char *ospf_timeval_dump(struct timeval *t, char *buf, size_t size)
 	return buf;
 }
 
+/* msec < 0 means not running */
+const char *ospf_msec_dump(long msec, char *buf, size_t size)
+{
+	struct timeval result;
+
+	if (msec < 0)
+		return "inactive";
+
+	result.tv_sec = msec / 1000;
+	result.tv_usec = (msec % 1000) * 1000;
+	return ospf_timeval_dump(&result, buf, size);
+}
+
 const char *ospf_timer_dump(struct thread *t, char *buf, size_t size)
 {
 	struct timeval result;
@@ -447,26 +447,17 @@ int ospf_flood(struct ospf *ospf, struct ospf_neighbor *nbr,
 }
 
 /* OSPF LSA flooding -- RFC2328 Section 13.3. */
-static int ospf_flood_through_interface(struct ospf_interface *oi,
-					struct ospf_neighbor *inbr,
-					struct ospf_lsa *lsa)
+/*
+ * Add the LSA to the retransmit lists of the neighbors on oi that must
+ * receive it.  Returns whether it was added to any of them.
+ */
+static int ospf_flood_through_interface_nbrs(struct ospf_interface *oi,
+					     struct ospf_neighbor *inbr,
+					     struct ospf_lsa *lsa)
 {
 	struct ospf_neighbor *onbr;
 	struct route_node *rn;
 	int retx_flag;
-	char buf[PREFIX_STRLEN];
-
-	if (IS_DEBUG_OSPF_EVENT)
-		zlog_debug(
-			"%s: considering int %s (%s), INBR(%s), LSA[%s] AGE %u",
-			__func__, IF_NAME(oi), ospf_get_name(oi->ospf),
-			inbr ? inet_ntop(AF_INET, &inbr->router_id, buf,
-					 sizeof(buf))
-			     : "NULL",
-			dump_lsa_key(lsa), ntohs(lsa->data->ls_age));
-
-	if (!ospf_if_is_enable(oi))
-		return 0;
 
 	/* Remember if new LSA is added to a retransmit list. */
 	retx_flag = 0;
@@ -584,6 +575,31 @@ static int ospf_flood_through_interface(struct ospf_interface *oi,
 		retx_flag = 1;
 	}
 
+	return retx_flag;
+}
+
+static int ospf_flood_through_interface(struct ospf_interface *oi,
+					struct ospf_neighbor *inbr,
+					struct ospf_lsa *lsa)
+{
+	struct route_node *rn;
+	int retx_flag;
+	char buf[PREFIX_STRLEN];
+
+	if (IS_DEBUG_OSPF_EVENT)
+		zlog_debug(
+			"%s: considering int %s (%s), INBR(%s), LSA[%s] AGE %u",
+			__func__, IF_NAME(oi), ospf_get_name(oi->ospf),
+			inbr ? inet_ntop(AF_INET, &inbr->router_id, buf,
+					 sizeof(buf))
+			     : "NULL",
+			dump_lsa_key(lsa), ntohs(lsa->data->ls_age));
+
+	if (!ospf_if_is_enable(oi))
+		return 0;
+
+	retx_flag = ospf_flood_through_interface_nbrs(oi, inbr, lsa);
+
 	/* If in the previous step, the LSA was NOT added to any of
 	   the Link state retransmission lists, there is no need to
 	   flood the LSA out the interface. */
@@ -771,6 +787,76 @@ int ospf_flood_through_as(struct ospf *ospf, struct ospf_neighbor *inbr,
 	return (lsa_ack_flag);
 }
 
+/*
+ * Flood a batch of self-originated AS-external-LSAs.  Same as calling
+ * ospf_flood_through_as() for each of them, but areas and interfaces are
+ * walked once, and each interface gets all of its LSAs queued for update
+ * at once.
+ */
+void ospf_flood_through_as_batch(struct ospf *ospf, struct list *lsas)
+{
+	struct listnode *node, *if_node, *lsa_node;
+	struct ospf_area *area;
+	struct ospf_interface *oi;
+	struct ospf_lsa *lsa;
+	struct route_node *rn;
+	struct ospf_neighbor *nbr;
+	struct list *update;
+
+	if (!listcount(lsas))
+		return;
+
+	update = list_new();
+
+	for (ALL_LIST_ELEMENTS_RO(ospf->areas, node, area)) {
+		/* Type-5s only go into normal areas */
+		if (area->external_routing != OSPF_AREA_DEFAULT)
+			continue;
+
+		for (ALL_LIST_ELEMENTS_RO(area->oiflist, if_node, oi)) {
+			if (oi->type == OSPF_IFTYPE_VIRTUALLINK
+			    || !ospf_if_is_enable(oi))
+				continue;
+
+			for (ALL_LIST_ELEMENTS_RO(lsas, lsa_node, lsa)) {
+				/* replaced since, later in the same batch */
+				if (CHECK_FLAG(lsa->flags, OSPF_LSA_DISCARD))
+					continue;
+				if (ospf_flood_through_interface_nbrs(oi, NULL,
+								      lsa))
+					listnode_add(update, lsa);
+			}
+
+			if (!listcount(update))
+				continue;
+
+			if (IS_DEBUG_OSPF(lsa, LSA_FLOODING))
+				zlog_debug("%s: %u LSAs out %s (%s)", __func__,
+					   listcount(update), IF_NAME(oi),
+					   ospf_get_name(ospf));
+
+			/* see ospf_flood_through_interface() */
+			if (oi->type == OSPF_IFTYPE_NBMA) {
+				for (rn = route_top(oi->nbrs); rn;
+				     rn = route_next(rn))
+					if ((nbr = rn->info) != NULL
+					    && nbr != oi->nbr_self
+					    && nbr->state >= NSM_Exchange)
+						ospf_ls_upd_send(
+							nbr, update,
+							OSPF_SEND_PACKET_DIRECT,
+							0);
+			} else
+				ospf_ls_upd_send(oi->nbr_self, update,
+						 OSPF_SEND_PACKET_INDIRECT, 0);
+
+			list_delete_all_node(update);
+		}
+	}
+
+	list_delete(&update);
+}
+
 int ospf_flood_through(struct ospf *ospf, struct ospf_neighbor *inbr,
 		       struct ospf_lsa *lsa)
 {
@@ -30,6 +30,7 @@ extern int ospf_flood_through_area(struct ospf_area *, struct ospf_neighbor *,
 				   struct ospf_lsa *);
 extern int ospf_flood_through_as(struct ospf *, struct ospf_neighbor *,
 				 struct ospf_lsa *);
+extern void ospf_flood_through_as_batch(struct ospf *ospf, struct list *lsas);
 
 extern unsigned long ospf_ls_request_count(struct ospf_neighbor *);
 extern int ospf_ls_request_isempty(struct ospf_neighbor *);
@@ -334,6 +334,7 @@ void ospf_if_cleanup(struct ospf_interface *oi)
 void ospf_if_free(struct ospf_interface *oi)
 {
 	ospf_if_down(oi);
+	ospf_hello_tx_stop(oi);
 
 	ospf_fifo_free(oi->obuf);
 
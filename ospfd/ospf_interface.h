@@ -228,6 +228,7 @@ struct ospf_interface {
 
 	/* Threads. */
 	struct thread *t_hello;		  /* timer */
+	struct hello_tx *hello_tx;	  /* periodic hellos on hello pthread */
 	struct thread *t_wait;		  /* timer */
 	struct thread *t_ls_ack;	  /* timer */
 	struct thread *t_ls_ack_direct;   /* event */
@@ -258,6 +258,10 @@ int ospf_hello_timer(struct thread *thread)
 	if (IS_DEBUG_OSPF(ism, ISM_TIMERS))
 		zlog_debug("ISM[%s]: Timer (Hello timer expire)", IF_NAME(oi));
 
+	/* Periodic hellos from the hello pthread if possible */
+	if (ospf_hello_tx_start(oi, true))
+		return 0;
+
 	/* Sending hello packet. */
 	ospf_hello_send(oi);
 
@@ -295,6 +299,7 @@ static void ism_timer_set(struct ospf_interface *oi)
 		   timers are
 		   reset also. */
 		OSPF_ISM_TIMER_OFF(oi->t_hello);
+		ospf_hello_tx_stop(oi);
 		OSPF_ISM_TIMER_OFF(oi->t_wait);
 		OSPF_ISM_TIMER_OFF(oi->t_ls_ack);
 		break;
@@ -302,6 +307,7 @@ static void ism_timer_set(struct ospf_interface *oi)
 		/* In this state, the interface may be looped back and will be
 		   unavailable for regular data traffic. */
 		OSPF_ISM_TIMER_OFF(oi->t_hello);
+		ospf_hello_tx_stop(oi);
 		OSPF_ISM_TIMER_OFF(oi->t_wait);
 		OSPF_ISM_TIMER_OFF(oi->t_ls_ack);
 		break;
@@ -65,10 +65,13 @@
 	thread_add_timer_msec(master, (F), oi, (V), &(T))
 
 /* convenience macro to set hello timer correctly, according to
- * whether fast-hello is set or not
+ * whether fast-hello is set or not; not needed while the hello pthread
+ * sends them
  */
 #define OSPF_HELLO_TIMER_ON(O)                                                 \
 	do {                                                                   \
+		if ((O)->hello_tx)                                             \
+			break;                                                 \
 		if (OSPF_IF_PARAM((O), fast_hello))                            \
 			OSPF_ISM_TIMER_MSEC_ON(                                \
 				(O)->t_hello, ospf_hello_timer,                \
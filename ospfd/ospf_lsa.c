@@ -201,6 +201,10 @@ struct ospf_lsa *ospf_lsa_dup(struct ospf_lsa *lsa)
 	   XXX: Should we add the LSA to the refresh_list queue? */
 	new->refresh_list = -1;
 
+	/* Nor is it in the external LSA indexes. */
+	memset(&new->asbr_item, 0, sizeof(new->asbr_item));
+	memset(&new->fwd_item, 0, sizeof(new->fwd_item));
+
 	if (IS_DEBUG_OSPF(lsa, LSA))
 		zlog_debug("LSA: duplicated %p (new: %p)", (void *)lsa,
 			   (void *)new);
@@ -1924,9 +1928,13 @@ int is_prefix_default(struct prefix_ipv4 *p)
 	return prefix_same((struct prefix *)p, (struct prefix *)&q);
 }
 
-/* Originate an AS-external-LSA, install and flood. */
-struct ospf_lsa *ospf_external_lsa_originate(struct ospf *ospf,
-					     struct external_info *ei)
+/*
+ * Originate an AS-external-LSA, install and flood.  With a flood list, the
+ * LSA is appended to it (locked) instead of being flooded through the AS.
+ */
+static struct ospf_lsa *
+ospf_external_lsa_originate_flood(struct ospf *ospf, struct external_info *ei,
+				  struct list *flood)
 {
 	struct ospf_lsa *new;
 
@@ -1990,7 +1998,10 @@ struct ospf_lsa *ospf_external_lsa_originate(struct ospf *ospf,
 	ospf->lsa_originate_count++;
 
 	/* Flooding new LSA. only to AS (non-NSSA/STUB) */
-	ospf_flood_through_as(ospf, NULL, new);
+	if (flood)
+		listnode_add(flood, ospf_lsa_lock(new)); /* flood */
+	else
+		ospf_flood_through_as(ospf, NULL, new);
 
 	/* If there is any attached NSSA, do special handling */
 	if (ospf->anyNSSA &&
@@ -2010,6 +2021,24 @@ struct ospf_lsa *ospf_external_lsa_originate(struct ospf *ospf,
 	return new;
 }
 
+struct ospf_lsa *ospf_external_lsa_originate(struct ospf *ospf,
+					     struct external_info *ei)
+{
+	return ospf_external_lsa_originate_flood(ospf, ei, NULL);
+}
+
+/*
+ * Like ospf_external_lsa_originate(), but flooding is left to the caller:
+ * the LSA is appended (locked) to the flood list, to be passed to
+ * ospf_external_lsa_flood_batch() together with others.
+ */
+struct ospf_lsa *ospf_external_lsa_originate_batch(struct ospf *ospf,
+						   struct external_info *ei,
+						   struct list *flood)
+{
+	return ospf_external_lsa_originate_flood(ospf, ei, flood);
+}
+
 static struct external_info *ospf_default_external_info(struct ospf *ospf)
 {
 	int type;
@@ -2212,6 +2241,7 @@ void ospf_external_lsa_refresh_type(struct ospf *ospf, uint8_t type,
 	struct route_node *rn;
 	struct external_info *ei;
 	struct ospf_external *ext;
+	struct list *flood;
 
 	if (type == DEFAULT_ROUTE)
 		return;
@@ -2219,6 +2249,9 @@ void ospf_external_lsa_refresh_type(struct ospf *ospf, uint8_t type,
 	ext = ospf_external_lookup(ospf, type, instance);
 
 	if (ext && EXTERNAL_INFO(ext)) {
+		/* Flooded together at the end */
+		flood = list_new();
+
 		/* Refresh each redistributed AS-external-LSAs. */
 		for (rn = route_top(EXTERNAL_INFO(ext)); rn;
 		     rn = route_next(rn)) {
@@ -2260,27 +2293,30 @@ void ospf_external_lsa_refresh_type(struct ospf *ospf, uint8_t type,
 						if (IS_LSA_MAXAGE(lsa))
 							force = LSA_REFRESH_FORCE;
 
-						ospf_external_lsa_refresh(
+						ospf_external_lsa_refresh_batch(
 							ospf, lsa, ei, force,
-							false);
+							flood);
 					} else {
 						if (!ospf_redistribute_check(
 							    ospf, ei, NULL))
 							continue;
-						ospf_external_lsa_originate(
-							ospf, ei);
+						ospf_external_lsa_originate_batch(
+							ospf, ei, flood);
 					}
 				}
 			}
 		}
+
+		ospf_external_lsa_flood_batch(ospf, flood);
+		list_delete(&flood);
 	}
 }
 
 /* Refresh AS-external-LSA. */
-struct ospf_lsa *ospf_external_lsa_refresh(struct ospf *ospf,
-					   struct ospf_lsa *lsa,
-					   struct external_info *ei, int force,
-					   bool is_aggr)
+static struct ospf_lsa *
+ospf_external_lsa_refresh_flood(struct ospf *ospf, struct ospf_lsa *lsa,
+				struct external_info *ei, int force,
+				bool is_aggr, struct list *flood)
 {
 	struct ospf_lsa *new;
 	int changed = 0;
@@ -2327,7 +2363,10 @@ struct ospf_lsa *ospf_external_lsa_refresh(struct ospf *ospf,
 	ospf_lsa_install(ospf, NULL, new); /* As type-5. */
 
 	/* Flood LSA through AS. */
-	ospf_flood_through_as(ospf, NULL, new);
+	if (flood)
+		listnode_add(flood, ospf_lsa_lock(new)); /* flood */
+	else
+		ospf_flood_through_as(ospf, NULL, new);
 
 	/* If any attached NSSA, install as Type-7, flood to all NSSA Areas */
 	if (ospf->anyNSSA && !(CHECK_FLAG(new->flags, OSPF_LSA_LOCAL_XLT)))
@@ -2351,6 +2390,38 @@ struct ospf_lsa *ospf_external_lsa_refresh(struct ospf *ospf,
 	return new;
 }
 
+struct ospf_lsa *ospf_external_lsa_refresh(struct ospf *ospf,
+					   struct ospf_lsa *lsa,
+					   struct external_info *ei, int force,
+					   bool is_aggr)
+{
+	return ospf_external_lsa_refresh_flood(ospf, lsa, ei, force, is_aggr,
+					       NULL);
+}
+
+/* See ospf_external_lsa_originate_batch() */
+struct ospf_lsa *ospf_external_lsa_refresh_batch(struct ospf *ospf,
+						 struct ospf_lsa *lsa,
+						 struct external_info *ei,
+						 int force, struct list *flood)
+{
+	return ospf_external_lsa_refresh_flood(ospf, lsa, ei, force, false,
+					       flood);
+}
+
+/* Flood and release the LSAs collected by the _batch() functions above */
+void ospf_external_lsa_flood_batch(struct ospf *ospf, struct list *flood)
+{
+	struct listnode *node;
+	struct ospf_lsa *lsa;
+
+	ospf_flood_through_as_batch(ospf, flood);
+
+	for (ALL_LIST_ELEMENTS_RO(flood, node, lsa))
+		ospf_lsa_unlock(&lsa); /* flood */
+	list_delete_all_node(flood);
+}
+
 
 /* LSA installation functions. */
 
@@ -3623,6 +3694,92 @@ void ospf_refresher_unregister_lsa(struct ospf *ospf, struct ospf_lsa *lsa)
 	}
 }
 
+/*
+ * The walker below collects the LSAs that are due; they are refreshed at a
+ * steady rate from a token bucket, so that a large number of LSAs that were
+ * originated together (and hence are due together) is spread out until the
+ * next walk instead of being refreshed in one go.
+ */
+static int ospf_lsa_refresh_pacer(struct thread *t)
+{
+	struct ospf *ospf = THREAD_ARG(t);
+	struct list *pending = ospf->lsa_refresh_pending;
+	struct ospf_lsa *lsa;
+	uint64_t burst;
+	unsigned int count = 0;
+
+	/* Credit is in LSA-milliseconds; up to a second's worth of burst. */
+	burst = (uint64_t)ospf->lsa_refresh_rate * 1000;
+	ospf->lsa_refresh_credit +=
+		(uint64_t)ospf->lsa_refresh_rate
+		* (monotime_since(&ospf->lsa_refresh_last, NULL) / 1000);
+	ospf->lsa_refresh_credit = MIN(ospf->lsa_refresh_credit, burst);
+	monotime(&ospf->lsa_refresh_last);
+
+	while (ospf->lsa_refresh_credit >= 1000 && listcount(pending)) {
+		lsa = listnode_head(pending);
+		list_delete_node(pending, listhead(pending));
+
+		/* Replaced, flushed or rescheduled while waiting */
+		if (!CHECK_FLAG(lsa->flags, OSPF_LSA_DISCARD)
+		    && !IS_LSA_MAXAGE(lsa) && lsa->refresh_list < 0) {
+			ospf_lsa_refresh(ospf, lsa);
+			ospf->lsa_refresh_credit -= 1000;
+			count++;
+		}
+		assert(lsa->lock > 0);
+		ospf_lsa_unlock(&lsa); /* lsa_refresh_pending */
+	}
+
+	if (IS_DEBUG_OSPF(lsa, LSA_REFRESH))
+		zlog_debug("LSA[Refresh]: %s: refreshed %u, %u pending",
+			   __func__, count, listcount(pending));
+
+	if (listcount(pending))
+		thread_add_timer_msec(master, ospf_lsa_refresh_pacer, ospf,
+				      OSPF_LSA_REFRESH_PACER_MSEC,
+				      &ospf->t_lsa_refresh_pacer);
+	return 0;
+}
+
+static void ospf_lsa_refresh_pacer_start(struct ospf *ospf)
+{
+	uint32_t rate;
+
+	if (!listcount(ospf->lsa_refresh_pending))
+		return;
+
+	/* Whatever is pending should be done by the next walk */
+	rate = listcount(ospf->lsa_refresh_pending)
+		       / MAX(ospf->lsa_refresh_interval, 1)
+	       + 1;
+	ospf->lsa_refresh_rate = MAX(rate, OSPF_LSA_REFRESH_RATE_MIN);
+
+	if (ospf->t_lsa_refresh_pacer)
+		return;
+
+	/* start with one tick's worth */
+	ospf->lsa_refresh_credit =
+		(uint64_t)ospf->lsa_refresh_rate * OSPF_LSA_REFRESH_PACER_MSEC;
+	monotime(&ospf->lsa_refresh_last);
+	thread_add_event(master, ospf_lsa_refresh_pacer, ospf, 0,
+			 &ospf->t_lsa_refresh_pacer);
+}
+
+void ospf_lsa_refresh_pacer_stop(struct ospf *ospf)
+{
+	struct listnode *node;
+	struct ospf_lsa *lsa;
+
+	THREAD_OFF(ospf->t_lsa_refresh_pacer);
+	if (!ospf->lsa_refresh_pending)
+		return;
+
+	for (ALL_LIST_ELEMENTS_RO(ospf->lsa_refresh_pending, node, lsa))
+		ospf_lsa_unlock(&lsa); /* lsa_refresh_pending */
+	list_delete(&ospf->lsa_refresh_pending);
+}
+
 int ospf_lsa_refresh_walker(struct thread *t)
 {
 	struct list *refresh_list;
@@ -3630,7 +3787,6 @@ int ospf_lsa_refresh_walker(struct thread *t)
 	struct ospf *ospf = THREAD_ARG(t);
 	struct ospf_lsa *lsa;
 	int i;
-	struct list *lsa_to_refresh = list_new();
 
 	if (IS_DEBUG_OSPF(lsa, LSA_REFRESH))
 		zlog_debug("LSA[Refresh]: ospf_lsa_refresh_walker(): start");
@@ -3680,7 +3836,8 @@ int ospf_lsa_refresh_walker(struct thread *t)
 				assert(lsa->lock > 0);
 				list_delete_node(refresh_list, node);
 				lsa->refresh_list = -1;
-				listnode_add(lsa_to_refresh, lsa);
+				/* lsa_refresh_queue lock moves along */
+				listnode_add(ospf->lsa_refresh_pending, lsa);
 			}
 			list_delete(&refresh_list);
 		}
@@ -3691,14 +3848,7 @@ int ospf_lsa_refresh_walker(struct thread *t)
 			 ospf->lsa_refresh_interval, &ospf->t_lsa_refresher);
 	ospf->lsa_refresher_started = monotime(NULL);
 
-	for (ALL_LIST_ELEMENTS(lsa_to_refresh, node, nnode, lsa)) {
-		ospf_lsa_refresh(ospf, lsa);
-		assert(lsa->lock > 0);
-		ospf_lsa_unlock(
-			&lsa); /* lsa_refresh_queue & temp for lsa_to_refresh*/
-	}
-
-	list_delete(&lsa_to_refresh);
+	ospf_lsa_refresh_pacer_start(ospf);
 
 	if (IS_DEBUG_OSPF(lsa, LSA_REFRESH))
 		zlog_debug("LSA[Refresh]: ospf_lsa_refresh_walker(): end");
@@ -23,6 +23,7 @@
 #define _ZEBRA_OSPF_LSA_H
 
 #include "stream.h"
+#include "typesafe.h"
 
 /* OSPF LSA Default metric values */
 #define DEFAULT_DEFAULT_METRIC 20
@@ -71,6 +72,10 @@ struct lsa_header {
 
 struct vertex;
 
+/* AS-external/NSSA-LSAs by ASBR and by forwarding address, see ospf_ase.c */
+PREDECL_DLIST(ospf_ase_asbr_lsas)
+PREDECL_DLIST(ospf_ase_fwd_lsas)
+
 /* OSPF LSA. */
 struct ospf_lsa {
 	/* LSA origination flag. */
@@ -84,6 +89,12 @@ struct ospf_lsa {
 #define OSPF_LSA_PREMATURE_AGE	  0x40
 #define OSPF_LSA_IN_MAXAGE	  0x80
 
+	/*For topo chg detection in HELPER role*/
+	bool to_be_acknowledged;
+
+	/* VRF Id */
+	vrf_id_t vrf_id;
+
 	/* LSA data. */
 	struct lsa_header *data;
 
@@ -96,12 +107,12 @@ struct ospf_lsa {
 	/* All of reference count, also lock to remove. */
 	int lock;
 
-	/* Flags for the SPF calculation. */
-	struct vertex *stat;
-
 	/* References to this LSA in neighbor retransmission lists*/
 	int retransmit_counter;
 
+	/* Flags for the SPF calculation. */
+	struct vertex *stat;
+
 	/* Area the LSA belongs to, may be NULL if AS-external-LSA. */
 	struct ospf_area *area;
 
@@ -111,17 +122,15 @@ struct ospf_lsa {
 	/* Related Route. */
 	void *route;
 
-	/* Refreshement List or Queue */
-	int refresh_list;
-
 	/* For Type-9 Opaque-LSAs */
 	struct ospf_interface *oi;
 
-	/* VRF Id */
-	vrf_id_t vrf_id;
+	/* Refreshement List or Queue */
+	int refresh_list;
 
-	/*For topo chg detection in HELPER role*/
-	bool to_be_acknowledged;
+	/* AS-external/NSSA-LSA indexes */
+	struct ospf_ase_asbr_lsas_item asbr_item;
+	struct ospf_ase_fwd_lsas_item fwd_item;
 };
 
 /* OSPF LSA Link Type. */
@@ -285,6 +294,9 @@ extern struct in_addr ospf_get_ip_from_ifp(struct ospf_interface *);
 
 extern struct ospf_lsa *ospf_external_lsa_originate(struct ospf *,
 						    struct external_info *);
+extern struct ospf_lsa *
+ospf_external_lsa_originate_batch(struct ospf *ospf, struct external_info *ei,
+				  struct list *flood);
 extern void ospf_external_lsa_rid_change(struct ospf *ospf);
 extern struct ospf_lsa *ospf_lsa_lookup(struct ospf *ospf, struct ospf_area *,
 					uint32_t, struct in_addr,
@@ -308,6 +320,7 @@ extern uint32_t get_metric(uint8_t *);
 
 extern int ospf_lsa_maxage_walker(struct thread *);
 extern struct ospf_lsa *ospf_lsa_refresh(struct ospf *, struct ospf_lsa *);
+extern void ospf_lsa_refresh_pacer_stop(struct ospf *ospf);
 
 extern void ospf_external_lsa_refresh_default(struct ospf *);
 
@@ -317,6 +330,11 @@ extern struct ospf_lsa *ospf_external_lsa_refresh(struct ospf *,
 						  struct ospf_lsa *,
 						  struct external_info *, int,
 						  bool aggr);
+extern struct ospf_lsa *ospf_external_lsa_refresh_batch(
+	struct ospf *ospf, struct ospf_lsa *lsa, struct external_info *ei,
+	int force, struct list *flood);
+extern void ospf_external_lsa_flood_batch(struct ospf *ospf,
+					  struct list *flood);
 extern struct in_addr ospf_lsa_unique_id(struct ospf *, struct ospf_lsdb *,
 					 uint8_t, struct prefix_ipv4 *);
 extern void ospf_schedule_lsa_flood_area(struct ospf_area *, struct ospf_lsa *);
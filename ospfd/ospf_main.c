@@ -41,6 +41,7 @@
 #include "vrf.h"
 #include "libfrr.h"
 #include "routemap.h"
+#include "hello_thread.h"
 
 #include "ospfd/ospfd.h"
 #include "ospfd/ospf_interface.h"
@@ -225,6 +226,8 @@ int main(int argc, char **argv)
 	ospf_error_init();
 
 	frr_config_fork();
+	/* after forking, since pthreads don't survive it */
+	hello_thread_start(master);
 	frr_run(master);
 
 	/* Not reached. */
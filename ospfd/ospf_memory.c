@@ -60,3 +60,6 @@ DEFINE_MTYPE(OSPFD, OSPF_GR_HELPER, "OSPF Graceful Restart Helper")
 DEFINE_MTYPE(OSPFD, OSPF_EXTERNAL_RT_AGGR, "OSPF External Route Summarisation")
 DEFINE_MTYPE(OSPFD, OSPF_P_SPACE, "OSPF TI-LFA P-Space")
 DEFINE_MTYPE(OSPFD, OSPF_Q_SPACE, "OSPF TI-LFA Q-Space")
+DEFINE_MTYPE(OSPFD, OSPF_EXTERNAL_QUEUE, "OSPF queued external route")
+DEFINE_MTYPE(OSPFD, OSPF_EXTERNAL_INDEX, "OSPF external LSA index")
+DEFINE_MTYPE(OSPFD, OSPF_ASE_DIRTY, "OSPF external route recalculation")
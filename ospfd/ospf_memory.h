@@ -59,5 +59,8 @@ DECLARE_MTYPE(OSPF_GR_HELPER)
 DECLARE_MTYPE(OSPF_EXTERNAL_RT_AGGR)
 DECLARE_MTYPE(OSPF_P_SPACE)
 DECLARE_MTYPE(OSPF_Q_SPACE)
+DECLARE_MTYPE(OSPF_EXTERNAL_QUEUE)
+DECLARE_MTYPE(OSPF_EXTERNAL_INDEX)
+DECLARE_MTYPE(OSPF_ASE_DIRTY)
 
 #endif /* _QUAGGA_OSPF_MEMORY_H */
@@ -30,6 +30,7 @@
 #include "table.h"
 #include "log.h"
 #include "json.h"
+#include "hello_thread.h"
 
 #include "ospfd/ospfd.h"
 #include "ospfd/ospf_interface.h"
@@ -141,7 +142,7 @@ void ospf_nbr_free(struct ospf_neighbor *nbr)
 	}
 
 	/* Cancel all timers. */
-	OSPF_NSM_TIMER_OFF(nbr->t_inactivity);
+	hello_hold_free(&nbr->inactivity);
 	OSPF_NSM_TIMER_OFF(nbr->t_db_desc);
 	OSPF_NSM_TIMER_OFF(nbr->t_ls_req);
 	OSPF_NSM_TIMER_OFF(nbr->t_ls_upd);
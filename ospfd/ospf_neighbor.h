@@ -71,8 +71,10 @@ struct ospf_neighbor {
 	uint32_t v_ls_req;
 	uint32_t v_ls_upd;
 
+	/* Inactivity timer, runs on the hello pthread. */
+	struct hello_hold *inactivity;
+
 	/* Threads. */
-	struct thread *t_inactivity;
 	struct thread *t_db_desc;
 	struct thread *t_ls_req;
 	struct thread *t_ls_upd;
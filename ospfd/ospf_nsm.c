@@ -34,6 +34,7 @@
 #include "log.h"
 #include "command.h"
 #include "network.h"
+#include "hello_thread.h"
 
 #include "ospfd/ospfd.h"
 #include "ospfd/ospf_interface.h"
@@ -58,12 +59,9 @@ DEFINE_HOOK(ospf_nsm_change,
 static void nsm_clear_adj(struct ospf_neighbor *);
 
 /* OSPF NSM Timer functions. */
-static int ospf_inactivity_timer(struct thread *thread)
+static void ospf_inactivity_timer(void *arg)
 {
-	struct ospf_neighbor *nbr;
-
-	nbr = THREAD_ARG(thread);
-	nbr->t_inactivity = NULL;
+	struct ospf_neighbor *nbr = arg;
 
 	if (IS_DEBUG_OSPF(nsm, NSM_TIMERS))
 		zlog_debug("NSM[%s:%pI4:%s]: Timer (Inactivity timer expire)",
@@ -79,8 +77,27 @@ static int ospf_inactivity_timer(struct thread *thread)
 		zlog_debug(
 			"%s, Acting as HELPER for this neighbour, So inactivitytimer event will not be fired.",
 			__PRETTY_FUNCTION__);
+}
 
-	return 0;
+/*
+ * The inactivity timer runs on the hello pthread, so that it doesn't expire
+ * just because hellos are stuck behind a long task on the main pthread.
+ */
+static void ospf_inactivity_timer_on(struct ospf_neighbor *nbr)
+{
+	if (!nbr->inactivity)
+		nbr->inactivity = hello_hold_new(ospf_inactivity_timer, nbr);
+
+	hello_hold_refresh(nbr->inactivity, nbr->v_inactivity * 1000);
+}
+
+/* milliseconds until the inactivity timer expires, or -1 if not running */
+long ospf_nbr_inactivity_remain(struct ospf_neighbor *nbr)
+{
+	if (!nbr->inactivity)
+		return -1;
+
+	return hello_hold_remain_msec(nbr->inactivity);
 }
 
 static int ospf_db_desc_timer(struct thread *thread)
@@ -119,7 +136,8 @@ static void nsm_timer_set(struct ospf_neighbor *nbr)
 	switch (nbr->state) {
 	case NSM_Deleted:
 	case NSM_Down:
-		OSPF_NSM_TIMER_OFF(nbr->t_inactivity);
+		if (nbr->inactivity)
+			hello_hold_stop(nbr->inactivity);
 		OSPF_NSM_TIMER_OFF(nbr->t_hello_reply);
 	/* fallthru */
 	case NSM_Attempt:
@@ -175,10 +193,7 @@ int nsm_should_adj(struct ospf_neighbor *nbr)
 static int nsm_packet_received(struct ospf_neighbor *nbr)
 {
 	/* Start or Restart Inactivity Timer. */
-	OSPF_NSM_TIMER_OFF(nbr->t_inactivity);
-
-	OSPF_NSM_TIMER_ON(nbr->t_inactivity, ospf_inactivity_timer,
-			  nbr->v_inactivity);
+	ospf_inactivity_timer_on(nbr);
 
 	if (nbr->oi->type == OSPF_IFTYPE_NBMA && nbr->nbr_nbma)
 		OSPF_POLL_TIMER_OFF(nbr->nbr_nbma->t_poll);
@@ -195,10 +210,7 @@ static int nsm_start(struct ospf_neighbor *nbr)
 	if (nbr->nbr_nbma)
 		OSPF_POLL_TIMER_OFF(nbr->nbr_nbma->t_poll);
 
-	OSPF_NSM_TIMER_OFF(nbr->t_inactivity);
-
-	OSPF_NSM_TIMER_ON(nbr->t_inactivity, ospf_inactivity_timer,
-			  nbr->v_inactivity);
+	ospf_inactivity_timer_on(nbr);
 
 	/* Send proactive ARP requests */
 	ospf_proactively_arp(nbr);
@@ -38,6 +38,7 @@
 #endif
 #include "vrf.h"
 #include "lib_errors.h"
+#include "hello_thread.h"
 
 #include "ospfd/ospfd.h"
 #include "ospfd/ospf_network.h"
@@ -3810,6 +3811,126 @@ void ospf_hello_send(struct ospf_interface *oi)
 	}
 }
 
+/*
+ * Periodic hellos to the multicast address are sent by the hello pthread,
+ * so adjacencies survive long tasks on the main pthread.  NBMA networks and
+ * virtual links keep sending from the main pthread, as do interfaces with
+ * cryptographic authentication: the hello pthread repeats the same packet,
+ * and its sequence number would fall behind that of other packets.  The
+ * hello pthread relies on IP_PKTINFO to pick the interface.
+ */
+static bool ospf_hello_tx_ok(struct ospf_interface *oi)
+{
+#if defined(GNU_LINUX) && defined(IP_PKTINFO)
+	if (oi->type == OSPF_IFTYPE_NBMA || oi->type == OSPF_IFTYPE_VIRTUALLINK)
+		return false;
+	if (OSPF_IF_PASSIVE_STATUS(oi) == OSPF_IF_PASSIVE)
+		return false;
+	if (ospf_auth_type(oi) == OSPF_AUTH_CRYPTOGRAPHIC)
+		return false;
+	return oi->ospf->fd >= 0 && oi->ifp->ifindex != IFINDEX_INTERNAL;
+#else
+	return false;
+#endif
+}
+
+static void ospf_hello_tx_refresh(void *arg)
+{
+	struct ospf_interface *oi = arg;
+
+	if (!ospf_hello_tx_start(oi, false))
+		/* back to sending from the main pthread */
+		OSPF_HELLO_TIMER_ON(oi);
+}
+
+/*
+ * Build the hello, IP header included, and hand it to the hello pthread.
+ * Returns false (and stops the hello pthread's transmissions) if the
+ * interface doesn't qualify.
+ */
+bool ospf_hello_tx_start(struct ospf_interface *oi, bool send_now)
+{
+	struct ospf_packet *op;
+	struct sockaddr_in sa_dst = {};
+	struct ip iph = {};
+	uint8_t *buf;
+	uint16_t length = OSPF_HEADER_SIZE;
+	uint32_t interval;
+	size_t iphlen;
+
+	if (!ospf_hello_tx_ok(oi)) {
+		ospf_hello_tx_stop(oi);
+		return false;
+	}
+
+	if (!oi->hello_tx)
+		oi->hello_tx = hello_tx_new(ospf_hello_tx_refresh, oi);
+	else
+		oi->hello_out += hello_tx_collect(oi->hello_tx);
+
+	op = ospf_packet_new(oi->ifp->mtu);
+	ospf_make_header(OSPF_MSG_HELLO, oi, op->s);
+	length += ospf_make_hello(oi, op->s);
+	if (length == OSPF_HEADER_SIZE) {
+		/* Hello overshooting MTU */
+		ospf_packet_free(op);
+		ospf_hello_tx_stop(oi);
+		return false;
+	}
+	ospf_fill_header(oi, op->s, length);
+
+	/* as in ospf_write() */
+	iphlen = sizeof(struct ip);
+	iph.ip_hl = (iphlen + 3) >> 2;
+	iph.ip_v = IPVERSION;
+	iph.ip_tos = IPTOS_PREC_INTERNETCONTROL;
+	iph.ip_len = (iph.ip_hl << 2) + length;
+#if defined(__DragonFly__)
+	iph.ip_len = htons(iph.ip_len);
+#endif
+	iph.ip_ttl = OSPF_IP_TTL;
+	iph.ip_p = IPPROTO_OSPFIGP;
+	iph.ip_src.s_addr = oi->address->u.prefix4.s_addr;
+	iph.ip_dst.s_addr = htonl(OSPF_ALLSPFROUTERS);
+	sockopt_iphdrincl_swab_htosys(&iph);
+
+	iphlen = iph.ip_hl << 2;
+	buf = XCALLOC(MTYPE_TMP, iphlen + length);
+	memcpy(buf, &iph, sizeof(iph));
+	memcpy(buf + iphlen, STREAM_DATA(op->s), length);
+	ospf_packet_free(op);
+
+	sa_dst.sin_family = AF_INET;
+#ifdef HAVE_STRUCT_SOCKADDR_IN_SIN_LEN
+	sa_dst.sin_len = sizeof(sa_dst);
+#endif /* HAVE_STRUCT_SOCKADDR_IN_SIN_LEN */
+	sa_dst.sin_addr = iph.ip_dst;
+
+	if (OSPF_IF_PARAM(oi, fast_hello) == 0)
+		interval = OSPF_IF_PARAM(oi, v_hello) * 1000;
+	else
+		interval = 1000 / OSPF_IF_PARAM(oi, fast_hello);
+
+	hello_tx_set_interval(oi->hello_tx, interval, 0);
+	hello_tx_update(oi->hello_tx, oi->ospf->fd, (struct sockaddr *)&sa_dst,
+			sizeof(sa_dst), oi->ifp->ifindex, buf, iphlen + length,
+			send_now);
+	XFREE(MTYPE_TMP, buf);
+	if (send_now && IS_DEBUG_OSPF_EVENT)
+		zlog_debug("%s: Hello Tx interface %s via hello pthread",
+			   __func__, IF_NAME(oi));
+	return true;
+}
+
+void ospf_hello_tx_stop(struct ospf_interface *oi)
+{
+	if (!oi->hello_tx)
+		return;
+
+	oi->hello_out += hello_tx_collect(oi->hello_tx);
+	hello_tx_free(&oi->hello_tx);
+}
+
 /* Send OSPF Database Description. */
 void ospf_db_desc_send(struct ospf_neighbor *nbr)
 {
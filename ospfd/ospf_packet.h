@@ -141,6 +141,8 @@ extern void ospf_fifo_free(struct ospf_fifo *);
 
 extern int ospf_read(struct thread *);
 extern void ospf_hello_send(struct ospf_interface *);
+extern bool ospf_hello_tx_start(struct ospf_interface *oi, bool send_now);
+extern void ospf_hello_tx_stop(struct ospf_interface *oi);
 extern void ospf_db_desc_send(struct ospf_neighbor *);
 extern void ospf_db_desc_resend(struct ospf_neighbor *);
 extern void ospf_ls_req_send(struct ospf_neighbor *);
@@ -53,6 +53,13 @@
 
 static unsigned int spf_reason_flags = 0;
 
+/* Reasons after which external routes are only partially recalculated */
+#define SPF_REASONS_TOPOLOGY                                                   \
+	((1 << SPF_FLAG_ROUTER_LSA_INSTALL)                                    \
+	 | (1 << SPF_FLAG_NETWORK_LSA_INSTALL)                                 \
+	 | (1 << SPF_FLAG_SUMMARY_LSA_INSTALL)                                 \
+	 | (1 << SPF_FLAG_ASBR_SUMMARY_LSA_INSTALL) | (1 << SPF_FLAG_MAXAGE))
+
 /* dummy vertex to flag "in spftree" */
 static const struct vertex vertex_in_spftree = {};
 #define LSA_SPF_IN_SPFTREE	(struct vertex *)&vertex_in_spftree
@@ -1845,9 +1852,14 @@ static int ospf_spf_calculate_schedule_worker(struct thread *thread)
 	/*
 	 * Calculate AS external routes, see RFC 2328 16.4.
 	 * There is a dedicated routing table for external routes which is not
-	 * handled here directly
+	 * handled here directly.  Topology changes only affect external
+	 * routes depending on the routes that changed, anything else may
+	 * affect all of them.
 	 */
-	ospf_ase_calculate_schedule(ospf);
+	if (spf_reason_flags & ~SPF_REASONS_TOPOLOGY)
+		ospf_ase_calculate_schedule(ospf);
+	else
+		ospf_ase_calculate_schedule_changes(ospf, new_table, new_rtrs);
 	ospf_ase_calculate_timer_add(ospf);
 
 	if (IS_DEBUG_OSPF_EVENT)
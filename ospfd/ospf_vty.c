@@ -36,6 +36,7 @@
 #include <lib/json.h>
 #include "defaults.h"
 #include "lib/printfrr.h"
+#include "lib/hello_thread.h"
 
 #include "ospfd/ospfd.h"
 #include "ospfd/ospf_asbr.h"
@@ -3741,7 +3742,12 @@ static void show_ip_ospf_interface_sub(struct vty *vty, struct ospf *ospf,
 			char timebuf[OSPF_TIME_DUMP_SIZE];
 			if (use_json) {
 				long time_store = 0;
-				if (oi->t_hello)
+				if (oi->hello_tx)
+					time_store = MAX(
+						hello_tx_remain_msec(
+							oi->hello_tx),
+						0);
+				else if (oi->t_hello)
 					time_store =
 						monotime_until(
 							&oi->t_hello->u.sands,
@@ -3750,7 +3756,13 @@ static void show_ip_ospf_interface_sub(struct vty *vty, struct ospf *ospf,
 				json_object_int_add(json_interface_sub,
 						    "timerHelloInMsecs",
 						    time_store);
-			} else
+			} else if (oi->hello_tx)
+				vty_out(vty, "    Hello due in %s\n",
+					ospf_msec_dump(
+						hello_tx_remain_msec(
+							oi->hello_tx),
+						timebuf, sizeof(timebuf)));
+			else
 				vty_out(vty, "    Hello due in %s\n",
 					ospf_timer_dump(oi->t_hello, timebuf,
 							sizeof(timebuf)));
@@ -4308,11 +4320,7 @@ static void show_ip_ospf_neighbor_sub(struct vty *vty,
 
 				long time_store;
 
-				time_store =
-					monotime_until(
-						&nbr->t_inactivity->u.sands,
-						NULL)
-					/ 1000LL;
+				time_store = ospf_nbr_inactivity_remain(nbr);
 
 				json_object_int_add(json_neighbor, "priority",
 						    nbr->priority);
@@ -4353,9 +4361,9 @@ static void show_ip_ospf_neighbor_sub(struct vty *vty,
 						nbr->priority, msgbuf);
 
 				vty_out(vty, "%9s ",
-					ospf_timer_dump(nbr->t_inactivity,
-							timebuf,
-							sizeof(timebuf)));
+					ospf_msec_dump(
+						ospf_nbr_inactivity_remain(nbr),
+						timebuf, sizeof(timebuf)));
 				vty_out(vty, "%-15pI4 ", &nbr->src);
 				vty_out(vty, "%-32s %5ld %5ld %5d\n",
 					IF_NAME(oi),
@@ -5134,22 +5142,13 @@ static void show_ip_ospf_neighbor_detail_sub(struct vty *vty,
 
 	/* Show Router Dead interval timer. */
 	if (use_json) {
-		if (nbr->t_inactivity) {
-			long time_store;
-			time_store = monotime_until(&nbr->t_inactivity->u.sands,
-						    NULL)
-				     / 1000LL;
-			json_object_int_add(json_neigh,
-					    "routerDeadIntervalTimerDueMsec",
-					    time_store);
-		} else
-			json_object_int_add(
-				json_neigh,
-				"routerDeadIntervalTimerDueMsec", -1);
+		json_object_int_add(json_neigh,
+				    "routerDeadIntervalTimerDueMsec",
+				    ospf_nbr_inactivity_remain(nbr));
 	} else
 		vty_out(vty, "    Dead timer due in %s\n",
-			ospf_timer_dump(nbr->t_inactivity, timebuf,
-					sizeof(timebuf)));
+			ospf_msec_dump(ospf_nbr_inactivity_remain(nbr),
+				       timebuf, sizeof(timebuf)));
 
 	/* Show Database Summary list. */
 	if (use_json)
@@ -5178,12 +5177,12 @@ static void show_ip_ospf_neighbor_detail_sub(struct vty *vty,
 
 	/* Show inactivity timer thread. */
 	if (use_json) {
-		if (nbr->t_inactivity != NULL)
+		if (ospf_nbr_inactivity_remain(nbr) >= 0)
 			json_object_string_add(json_neigh,
 					       "threadInactivityTimer", "on");
 	} else
 		vty_out(vty, "    Thread Inactivity Timer %s\n",
-			nbr->t_inactivity != NULL ? "on" : "off");
+			ospf_nbr_inactivity_remain(nbr) >= 0 ? "on" : "off");
 
 	/* Show Database Description retransmission thread. */
 	if (use_json) {
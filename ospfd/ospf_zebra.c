@@ -1328,38 +1328,11 @@ static int ospf_zebra_read_route(ZAPI_CALLBACK_ARGS)
 								&ei->p, 0);
 						}
 					} else {
-						struct ospf_lsa *current;
-
-						current =
-							ospf_external_info_find_lsa(
-								ospf, &ei->p);
-						if (!current) {
-							/* Check the
-							 * AS-external-LSA
-							 * should be
-							 * originated.
-							 */
-							if (!ospf_redistribute_check(
-								    ospf, ei,
-								    NULL))
-								return 0;
-
-							ospf_external_lsa_originate(
-								ospf, ei);
-						} else {
-							if (IS_DEBUG_OSPF(
-								    zebra,
-								    ZEBRA_REDISTRIBUTE))
-								zlog_debug(
-									"%s: %pI4 refreshing LSA",
-									__func__,
-									&p.prefix);
-							ospf_external_lsa_refresh(
-								ospf, current,
-								ei,
-								LSA_REFRESH_FORCE,
-								false);
-						}
+						/* Originated or refreshed
+						 * in batches.
+						 */
+						ospf_external_queue_add(ospf,
+									ei);
 					}
 				}
 			}
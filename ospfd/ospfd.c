@@ -338,7 +338,7 @@ struct ospf *ospf_new_alloc(unsigned short instance, const char *name)
 
 	new->new_external_route = route_table_init();
 	new->old_external_route = route_table_init();
-	new->external_lsas = route_table_init();
+	ospf_ase_init(new);
 
 	new->stub_router_startup_time = OSPF_STUB_ROUTER_UNCONFIGURED;
 	new->stub_router_shutdown_time = OSPF_STUB_ROUTER_UNCONFIGURED;
@@ -373,6 +373,7 @@ struct ospf *ospf_new_alloc(unsigned short instance, const char *name)
 	new->lsa_refresh_interval = OSPF_LSA_REFRESH_INTERVAL_DEFAULT;
 	new->t_lsa_refresher = NULL;
 	new->lsa_refresher_started = monotime(NULL);
+	new->lsa_refresh_pending = list_new();
 
 	new->ibuf = stream_new(OSPF_MAX_PACKET_SIZE + 1);
 
@@ -385,6 +386,7 @@ struct ospf *ospf_new_alloc(unsigned short instance, const char *name)
 	ospf_gr_helper_init(new);
 
 	ospf_asbr_external_aggregator_init(new);
+	ospf_external_queue_init(new);
 
 	QOBJ_REG(new, ospf);
 
@@ -806,6 +808,7 @@ static void ospf_finish_final(struct ospf *ospf)
 	OSPF_TIMER_OFF(ospf->t_sr_update);
 	OSPF_TIMER_OFF(ospf->t_default_routemap_timer);
 	OSPF_TIMER_OFF(ospf->t_external_aggr);
+	ospf_external_queue_fini(ospf);
 
 	LSDB_LOOP (OPAQUE_AS_LSDB(ospf), rn, lsa)
 		ospf_discard_from_db(ospf, ospf->lsdb, lsa);
@@ -815,6 +818,9 @@ static void ospf_finish_final(struct ospf *ospf)
 	ospf_lsdb_delete_all(ospf->lsdb);
 	ospf_lsdb_free(ospf->lsdb);
 
+	/* everything is discarded by now, so this frees them */
+	ospf_lsa_refresh_pacer_stop(ospf);
+
 	for (rn = route_top(ospf->maxage_lsa); rn; rn = route_next(rn)) {
 		if ((lsa = rn->info) != NULL) {
 			ospf_lsa_unlock(&lsa);
@@ -843,7 +849,7 @@ static void ospf_finish_final(struct ospf *ospf)
 		ospf_route_table_free(ospf->old_external_route);
 	}
 	if (ospf->external_lsas) {
-		ospf_ase_external_lsas_finish(ospf->external_lsas);
+		ospf_ase_external_lsas_finish(ospf);
 	}
 
 	for (i = ZEBRA_ROUTE_SYSTEM; i <= ZEBRA_ROUTE_MAX; i++) {
@@ -2204,6 +2210,8 @@ static int ospf_vrf_enable(struct vrf *vrf)
 static int ospf_vrf_disable(struct vrf *vrf)
 {
 	struct ospf *ospf = NULL;
+	struct ospf_interface *oi;
+	struct listnode *node;
 	vrf_id_t old_vrf_id = VRF_UNKNOWN;
 
 	if (vrf->vrf_id == VRF_DEFAULT)
@@ -2226,6 +2234,15 @@ static int ospf_vrf_disable(struct vrf *vrf)
 			zlog_debug("%s: ospf old_vrf_id %d unlinked", __func__,
 				   old_vrf_id);
 		thread_cancel(&ospf->t_read);
+
+		/* The hello pthread must not use the socket anymore */
+		for (ALL_LIST_ELEMENTS_RO(ospf->oiflist, node, oi)) {
+			if (!oi->hello_tx)
+				continue;
+			ospf_hello_tx_stop(oi);
+			OSPF_HELLO_TIMER_ON(oi);
+		}
+
 		close(ospf->fd);
 		ospf->fd = -1;
 	}
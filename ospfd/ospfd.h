@@ -134,6 +134,13 @@ enum protection_type {
 	OSPF_TI_LFA_NODE_PROTECTION,
 };
 
+/* Redistributed routes waiting for origination, see ospf_asbr.c */
+PREDECL_DLIST(ospf_ext_fifo)
+PREDECL_HASH(ospf_ext_pending)
+
+/* Destinations waiting for external route recalculation, see ospf_ase.c */
+PREDECL_HASH(ospf_ase_dirty)
+
 /* OSPF instance structure. */
 struct ospf {
 	/* OSPF's running state based on the '[no] router ospf [<instance>]'
@@ -215,7 +222,7 @@ struct ospf {
 	struct ospf_lsdb *lsdb;
 
 	/* Flags. */
-	int ase_calc;	/* ASE calculation flag. */
+	int ase_calc;	/* Full ASE calculation flag. */
 
 	struct list *opaque_lsa_self; /* Type-11 Opaque-LSAs */
 
@@ -231,6 +238,12 @@ struct ospf {
 
 	struct route_table *external_lsas; /* Database of external LSAs,
 					      prefix is LSA's adv. network*/
+	struct route_table *external_asbr; /* Same, by adv. router */
+	struct route_table *external_fwd;  /* Same, by forwarding address */
+
+	/* Destinations whose external routes depend on routes changed by
+	 * SPF, recalculated by the next ASE run unless ase_calc is set. */
+	struct ospf_ase_dirty_head ase_dirty;
 
 	/* Time stamps */
 	struct timeval ts_spf;		/* SPF calculation time stamp. */
@@ -298,6 +311,15 @@ struct ospf {
 #define OSPF_LSA_REFRESH_INTERVAL_DEFAULT 10
 	uint16_t lsa_refresh_interval;
 
+	/* Due refreshes, paced out until the next walk */
+	struct list *lsa_refresh_pending;
+	struct thread *t_lsa_refresh_pacer;
+#define OSPF_LSA_REFRESH_PACER_MSEC 100
+#define OSPF_LSA_REFRESH_RATE_MIN 100
+	uint32_t lsa_refresh_rate; /* per second */
+	uint64_t lsa_refresh_credit;
+	struct timeval lsa_refresh_last;
+
 	/* Distance parameter. */
 	uint8_t distance_all;
 	uint8_t distance_intra;
@@ -371,6 +393,13 @@ struct ospf {
 	/* delay interval in seconds */
 	unsigned int aggr_delay_interval;
 
+	/* Redistributed routes whose AS-external-LSA is to be originated
+	 * or refreshed, in batches.
+	 */
+	struct ospf_ext_fifo_head external_fifo;
+	struct ospf_ext_pending_head external_pending;
+	struct thread *t_external_queue;
+
 	/* Table of configured Aggregate addresses */
 	struct route_table *rt_aggr_tbl;
 
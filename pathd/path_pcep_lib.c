@@ -19,6 +19,7 @@
 #include <zebra.h>
 
 #include <debug.h>
+#include "pceplib/pcep_msg_encoding.h"
 #include "pceplib/pcep_utils_counters.h"
 #include "pceplib/pcep_timers.h"
 #include "pathd/path_errors.h"
@@ -318,6 +319,52 @@ struct pcep_message *pcep_lib_format_report(struct pcep_caps *caps,
 	return pcep_msg_create_report(objs);
 }
 
+/* Moves the state reports of an encoded PCRpt message at the end of another
+ * one and frees it, a PCRpt can carry a list of state reports (RFC 8231
+ * section 6.1).  The encoded reports are appended as well, so the result is
+ * sent without being encoded again; it must fit in PCEP_MESSAGE_LENGTH. */
+void pcep_lib_append_report(struct pcep_message *report,
+			    struct pcep_message *other)
+{
+	double_linked_list_node *node;
+	uint16_t length, net_order_length;
+
+	for (node = other->obj_list->head; node != NULL; node = node->next_node)
+		dll_append(report->obj_list, node->data);
+	dll_destroy(other->obj_list);
+	other->obj_list = NULL;
+
+	length = report->encoded_message_length
+		 + other->encoded_message_length - MESSAGE_HEADER_LENGTH;
+	report->encoded_message = pceplib_realloc(
+		PCEPLIB_MESSAGES, report->encoded_message, length);
+	memcpy(report->encoded_message + report->encoded_message_length,
+	       other->encoded_message + MESSAGE_HEADER_LENGTH,
+	       other->encoded_message_length - MESSAGE_HEADER_LENGTH);
+	report->encoded_message_length = length;
+	net_order_length = htons(length);
+	memcpy(report->encoded_message + 2, &net_order_length,
+	       sizeof(net_order_length));
+
+	pcep_msg_free_message(other);
+}
+
+/* Encodes a PCRpt message for the given session, it is then sent as is.
+ * Returns the encoded length, or 0 if it is too large to be encoded */
+uint16_t pcep_lib_encode_report(pcep_session *sess, struct pcep_message *report)
+{
+	pcep_encode_message(report, sess->pcc_config.pcep_msg_versioning);
+	if (report->encoded_message == NULL)
+		return 0;
+
+	return report->encoded_message_length;
+}
+
+void pcep_lib_free_message(struct pcep_message *msg)
+{
+	pcep_msg_free_message(msg);
+}
+
 static struct pcep_object_rp *create_rp(uint32_t reqid)
 {
 	double_linked_list *rp_tlvs;
@@ -54,6 +54,9 @@
 #define OTHER_FAMILY_MAX_RETRIES 4
 #define MAX_ERROR_MSG_SIZE 256
 #define MAX_COMPREQ_TRIES 3
+/* Maximum number of LSP state reports sent in a single PCRpt message during
+ * state synchronization */
+#define MAX_SYNC_REPORTS_PER_MSG 32
 
 pthread_mutex_t g_pcc_info_mtx = PTHREAD_MUTEX_INITIALIZER;
 
@@ -96,6 +99,9 @@ static void send_pcep_error(struct pcc_state *pcc_state,
 			    enum pcep_error_type error_type,
 			    enum pcep_error_value error_value);
 static void send_report(struct pcc_state *pcc_state, struct path *path);
+static void queue_sync_report(struct pcc_state *pcc_state, struct path *path);
+static void flush_sync_reports(struct pcc_state *pcc_state);
+static void discard_sync_reports(struct pcc_state *pcc_state);
 static void send_comp_request(struct ctrl_state *ctrl_state,
 			      struct pcc_state *pcc_state,
 			      struct req_entry *req);
@@ -452,6 +458,7 @@ int pcep_pcc_disable(struct ctrl_state *ctrl_state, struct pcc_state *pcc_state)
 	case PCEP_PCC_OPERATING:
 		PCEP_DEBUG("%s Disconnecting PCC...", pcc_state->tag);
 		cancel_comp_requests(ctrl_state, pcc_state);
+		discard_sync_reports(pcc_state);
 		pcep_lib_disconnect(pcc_state->sess);
 		/* No need to remove if any PCEs is connected */
 		if (get_pce_count_connected(ctrl_state->pcc) == 0) {
@@ -495,7 +502,10 @@ void pcep_pcc_sync_path(struct ctrl_state *ctrl_state,
 		if (filter_path(pcc_state, path)) {
 			PCEP_DEBUG("%s Synchronizing path %s", pcc_state->tag,
 				   path->name);
-			send_report(pcc_state, path);
+			if (pcc_state->status == PCEP_PCC_SYNCHRONIZING)
+				queue_sync_report(pcc_state, path);
+			else
+				send_report(pcc_state, path);
 		} else {
 			PCEP_DEBUG(
 				"%s Skipping %s candidate path %s "
@@ -516,6 +526,8 @@ void pcep_pcc_sync_done(struct ctrl_state *ctrl_state,
 	    && pcc_state->status != PCEP_PCC_OPERATING)
 		return;
 
+	flush_sync_reports(pcc_state);
+
 	if (pcc_state->caps.is_stateful
 	    && pcc_state->status == PCEP_PCC_SYNCHRONIZING) {
 		struct path *path = pcep_new_path();
@@ -1476,6 +1488,9 @@ void send_report(struct pcc_state *pcc_state, struct path *path)
 {
 	struct pcep_message *report;
 
+	/* Keep the reports ordered with any pending synchronization ones */
+	flush_sync_reports(pcc_state);
+
 	path->req_id = 0;
 	specialize_outgoing_path(pcc_state, path);
 	PCEP_DEBUG_PATH("%s Sending path %s: %s", pcc_state->tag, path->name,
@@ -1484,6 +1499,74 @@ void send_report(struct pcc_state *pcc_state, struct path *path)
 	send_pcep_message(pcc_state, report);
 }
 
+/* Accumulates the state report of a path being synchronized, so that multiple
+ * LSPs are reported in a single PCRpt message instead of one message each */
+void queue_sync_report(struct pcc_state *pcc_state, struct path *path)
+{
+	struct pcep_message *report;
+	uint16_t length;
+
+	if (pcc_state->sess == NULL)
+		return;
+
+	path->req_id = 0;
+	specialize_outgoing_path(pcc_state, path);
+	PCEP_DEBUG_PATH("%s Queuing path %s: %s", pcc_state->tag, path->name,
+			format_path(path));
+	report = pcep_lib_format_report(&pcc_state->caps, path);
+
+	/* The reports are encoded as they are queued, the batch is sent
+	 * without being encoded again */
+	length = pcep_lib_encode_report(pcc_state->sess, report);
+	if (length == 0) {
+		/* Too large on its own, it cannot be batched */
+		flush_sync_reports(pcc_state);
+		send_pcep_message(pcc_state, report);
+		return;
+	}
+
+	/* A PCRpt too large to be encoded would be lost with all the reports
+	 * it carries, send what is pending before reaching that size */
+	if (pcc_state->sync_report != NULL
+	    && pcc_state->sync_report->encoded_message_length + length
+			       - MESSAGE_HEADER_LENGTH
+		       > PCEP_MESSAGE_LENGTH)
+		flush_sync_reports(pcc_state);
+
+	if (pcc_state->sync_report == NULL)
+		pcc_state->sync_report = report;
+	else
+		pcep_lib_append_report(pcc_state->sync_report, report);
+
+	if (++pcc_state->sync_report_count >= MAX_SYNC_REPORTS_PER_MSG)
+		flush_sync_reports(pcc_state);
+}
+
+void flush_sync_reports(struct pcc_state *pcc_state)
+{
+	if (pcc_state->sync_report == NULL)
+		return;
+
+	PCEP_DEBUG("%s Sending %u synchronization reports", pcc_state->tag,
+		   pcc_state->sync_report_count);
+	if (pcc_state->sess != NULL)
+		send_pcep_message(pcc_state, pcc_state->sync_report);
+	else
+		pcep_lib_free_message(pcc_state->sync_report);
+	pcc_state->sync_report = NULL;
+	pcc_state->sync_report_count = 0;
+}
+
+void discard_sync_reports(struct pcc_state *pcc_state)
+{
+	if (pcc_state->sync_report == NULL)
+		return;
+
+	pcep_lib_free_message(pcc_state->sync_report);
+	pcc_state->sync_report = NULL;
+	pcc_state->sync_report_count = 0;
+}
+
 /* Updates the path for the PCE, updating the delegation and creation flags */
 void specialize_outgoing_path(struct pcc_state *pcc_state, struct path *path)
 {
@@ -91,6 +91,9 @@ struct pcc_state {
 	struct pcep_caps caps;
 	bool is_best;
 	bool previous_best;
+	/* State reports accumulated during synchronization */
+	struct pcep_message *sync_report;
+	uint32_t sync_report_count;
 };
 
 struct pcc_state *pcep_pcc_initialize(struct ctrl_state *ctrl_state,
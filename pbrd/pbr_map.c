@@ -290,10 +290,12 @@ void pbr_map_policy_interface_update(const struct interface *ifp, bool state_up)
 	/*
 	 * Walk the list and install/remove maps on the interface.
 	 */
+	pbr_send_pbr_map_batch_begin();
 	for (ALL_LIST_ELEMENTS_RO(pbrm->seqnumbers, node, pbrms))
 		for (ALL_LIST_ELEMENTS_RO(pbrm->incoming, inode, pmi))
 			if (pmi->ifp == ifp && pbr_map_interface_is_valid(pmi))
 				pbr_send_pbr_map(pbrms, pmi, state_up, true);
+	pbr_send_pbr_map_batch_end();
 }
 
 static void pbrms_vrf_update(struct pbr_map_sequence *pbrms,
@@ -700,6 +702,7 @@ void pbr_map_policy_install(const char *name)
 	if (!pbrm)
 		return;
 
+	pbr_send_pbr_map_batch_begin();
 	for (ALL_LIST_ELEMENTS_RO(pbrm->seqnumbers, node, pbrms)) {
 		DEBUGD(&pbr_dbg_map,
 		       "%s: Looking at what to install %s(%u) %d %d", __func__,
@@ -715,6 +718,7 @@ void pbr_map_policy_install(const char *name)
 							 false);
 		}
 	}
+	pbr_send_pbr_map_batch_end();
 }
 
 void pbr_map_policy_delete(struct pbr_map *pbrm, struct pbr_map_interface *pmi)
@@ -724,9 +728,11 @@ void pbr_map_policy_delete(struct pbr_map *pbrm, struct pbr_map_interface *pmi)
 	bool sent = false;
 
 
+	pbr_send_pbr_map_batch_begin();
 	for (ALL_LIST_ELEMENTS_RO(pbrm->seqnumbers, node, pbrms))
 		if (pbr_send_pbr_map(pbrms, pmi, false, true))
 			sent = true; /* rule removal sent to zebra */
+	pbr_send_pbr_map_batch_end();
 
 	pmi->delete = true;
 
@@ -548,11 +548,60 @@ static void pbr_encode_pbr_map_sequence(struct stream *s,
 	stream_put(s, ifp->name, INTERFACE_NAMSIZ);
 }
 
+/*
+ * Rules are encoded into their own stream so that several of them can
+ * share one ZEBRA_RULE_ADD/DELETE message while a batch is open; zebra
+ * already reads a count of rules per message.  The message is copied to
+ * the zclient output buffer when it is flushed.
+ */
+#define PBR_RULE_ENCODE_MAX 128
+
+static struct stream *pbr_batch_s;
+static unsigned int pbr_batch_depth;
+static uint16_t pbr_batch_cmd;
+static uint32_t pbr_batch_count;
+
+static void pbr_batch_flush(void)
+{
+	struct stream *s = zclient->obuf;
+
+	if (!pbr_batch_count)
+		return;
+
+	stream_putl_at(pbr_batch_s, ZEBRA_HEADER_SIZE, pbr_batch_count);
+	stream_putw_at(pbr_batch_s, 0, stream_get_endp(pbr_batch_s));
+
+	stream_reset(s);
+	stream_put(s, STREAM_DATA(pbr_batch_s), stream_get_endp(pbr_batch_s));
+	zclient_send_message(zclient);
+
+	stream_reset(pbr_batch_s);
+	pbr_batch_count = 0;
+}
+
+/*
+ * Rules sent between pbr_send_pbr_map_batch_begin() and _end() are
+ * packed into as few messages as possible.  Batches may nest.
+ */
+void pbr_send_pbr_map_batch_begin(void)
+{
+	pbr_batch_depth++;
+}
+
+void pbr_send_pbr_map_batch_end(void)
+{
+	assert(pbr_batch_depth);
+
+	if (--pbr_batch_depth == 0)
+		pbr_batch_flush();
+}
+
 bool pbr_send_pbr_map(struct pbr_map_sequence *pbrms,
 		      struct pbr_map_interface *pmi, bool install, bool changed)
 {
 	struct pbr_map *pbrm = pbrms->parent;
 	struct stream *s;
+	uint16_t cmd;
 	uint64_t is_installed = (uint64_t)1 << pmi->install_bit;
 
 	is_installed &= pbrms->installed;
@@ -573,27 +622,32 @@ bool pbr_send_pbr_map(struct pbr_map_sequence *pbrms,
 	if (!install && !is_installed)
 		return false;
 
-	s = zclient->obuf;
-	stream_reset(s);
-
-	zclient_create_header(s,
-			      install ? ZEBRA_RULE_ADD : ZEBRA_RULE_DELETE,
-			      VRF_DEFAULT);
-
-	/*
-	 * We are sending one item at a time at the moment
-	 */
-	stream_putl(s, 1);
+	if (!pbr_batch_s)
+		pbr_batch_s = stream_new(ZEBRA_MAX_PACKET_SIZ);
+	s = pbr_batch_s;
+
+	cmd = install ? ZEBRA_RULE_ADD : ZEBRA_RULE_DELETE;
+	if (pbr_batch_count
+	    && (cmd != pbr_batch_cmd
+		|| STREAM_WRITEABLE(s) < PBR_RULE_ENCODE_MAX))
+		pbr_batch_flush();
+
+	if (!pbr_batch_count) {
+		zclient_create_header(s, cmd, VRF_DEFAULT);
+		/* Number of rules, filled in on flush */
+		stream_putl(s, 0);
+		pbr_batch_cmd = cmd;
+	}
 
 	DEBUGD(&pbr_dbg_zebra, "%s:    %s %s seq %u %d %s %u", __func__,
 	       install ? "Installing" : "Deleting", pbrm->name, pbrms->seqno,
 	       install, pmi->ifp->name, pmi->delete);
 
 	pbr_encode_pbr_map_sequence(s, pbrms, pmi->ifp);
+	pbr_batch_count++;
 
-	stream_putw_at(s, 0, stream_get_endp(s));
-
-	zclient_send_message(zclient);
+	if (!pbr_batch_depth)
+		pbr_batch_flush();
 
 	return true;
 }
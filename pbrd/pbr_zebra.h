@@ -38,6 +38,8 @@ extern void pbr_send_rnh(struct nexthop *nhop, bool reg);
 extern bool pbr_send_pbr_map(struct pbr_map_sequence *pbrms,
 			     struct pbr_map_interface *pmi, bool install,
 			     bool changed);
+extern void pbr_send_pbr_map_batch_begin(void);
+extern void pbr_send_pbr_map_batch_end(void);
 
 extern struct pbr_interface *pbr_if_new(struct interface *ifp);
 
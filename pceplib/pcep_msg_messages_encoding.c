@@ -90,6 +90,14 @@ static const enum pcep_object_classes MANDATORY_MESSAGE_OBJECT_CLASSES[13][4] =
 void pcep_encode_message(struct pcep_message *message,
 			 struct pcep_versioning *versioning)
 {
+	/* Internal buffer used for the entire message. Later, once the entire
+	 * length is known, memory will be allocated and this buffer will be
+	 * copied. The encoders expect the buffer to be zeroed, so instead of
+	 * clearing PCEP_MESSAGE_LENGTH bytes for every message, the buffer is
+	 * reused and only the bytes written by the previous message are
+	 * cleared. Each thread encoding messages gets its own buffer. */
+	static __thread uint8_t message_buffer[PCEP_MESSAGE_LENGTH];
+
 	if (message == NULL) {
 		return;
 	}
@@ -98,11 +106,6 @@ void pcep_encode_message(struct pcep_message *message,
 		return;
 	}
 
-	/* Internal buffer used for the entire message. Later, once the entire
-	 * length is known, memory will be allocated and this buffer will be
-	 * copied. */
-	uint8_t message_buffer[PCEP_MESSAGE_LENGTH] = {0};
-
 	/* Write the message header. The message header length will be
 	 * written when the entire length is known. */
 	uint32_t message_length = MESSAGE_HEADER_LENGTH;
@@ -110,21 +113,9 @@ void pcep_encode_message(struct pcep_message *message,
 	message_buffer[0] = (message->msg_header->pcep_version << 5) & 0xf0;
 	message_buffer[1] = message->msg_header->type;
 
-	if (message->obj_list == NULL) {
-		net_order_length = htons(message_length);
-		memcpy(message_buffer + 2, &net_order_length,
-		       sizeof(net_order_length));
-		message->encoded_message =
-			pceplib_malloc(PCEPLIB_MESSAGES, message_length);
-		memcpy(message->encoded_message, message_buffer,
-		       message_length);
-		message->encoded_message_length = message_length;
-
-		return;
-	}
-
 	/* Encode each of the objects */
-	double_linked_list_node *node = message->obj_list->head;
+	double_linked_list_node *node =
+		message->obj_list == NULL ? NULL : message->obj_list->head;
 	for (; node != NULL; node = node->next_node) {
 		message_length +=
 			pcep_encode_object(node->data, versioning,
@@ -132,6 +123,7 @@ void pcep_encode_message(struct pcep_message *message,
 		if (message_length > PCEP_MESSAGE_LENGTH) {
 			message->encoded_message = NULL;
 			message->encoded_message_length = 0;
+			memset(message_buffer, 0, sizeof(message_buffer));
 			return;
 		}
 	}
@@ -142,6 +134,8 @@ void pcep_encode_message(struct pcep_message *message,
 		pceplib_malloc(PCEPLIB_MESSAGES, message_length);
 	memcpy(message->encoded_message, message_buffer, message_length);
 	message->encoded_message_length = message_length;
+
+	memset(message_buffer, 0, message_length);
 }
 
 /*
@@ -210,7 +210,11 @@ void send_message(pcep_session *session, struct pcep_message *msg,
 		return;
 	}
 
-	pcep_encode_message(msg, session->pcc_config.pcep_msg_versioning);
+	/* Messages the caller already encoded, e.g. batched reports, are sent
+	 * as they are */
+	if (msg->encoded_message == NULL)
+		pcep_encode_message(msg,
+				    session->pcc_config.pcep_msg_versioning);
 	socket_comm_session_send_message(
 		session->socket_comm_session, (char *)msg->encoded_message,
 		msg->encoded_message_length, free_after_send);
@@ -33,6 +33,10 @@
 #include "pcep_socket_comm_mock.h"
 #include "pcep_utils_memory.h"
 
+#define REPORT_BENCH_NUM_LSPS 10000
+#define REPORT_BENCH_BATCH_SIZE 32
+#define REPORT_BENCH_NUM_HOPS 4
+
 extern pcep_event_queue *session_logic_event_queue_;
 extern const char MESSAGE_RECEIVED_STR[];
 extern const char UNKNOWN_EVENT_STR[];
@@ -247,6 +251,125 @@ void test_send_message()
 	destroy_pcc();
 }
 
+static void append_lsp_report(double_linked_list *obj_list, uint32_t plsp_id)
+{
+	struct in_addr node_id = {.s_addr = htonl(0x0a000001)};
+	double_linked_list *ero_list = dll_initialize();
+	int i;
+
+	for (i = 0; i < REPORT_BENCH_NUM_HOPS; i++)
+		dll_append(ero_list,
+			   pcep_obj_create_ro_subobj_sr_ipv4_node(
+				   false, false, false, true, (16000 + i) << 12,
+				   &node_id));
+
+	dll_append(obj_list, pcep_obj_create_srp(false, 0, NULL));
+	dll_append(obj_list,
+		   pcep_obj_create_lsp(plsp_id, PCEP_LSP_OPERATIONAL_UP, false,
+				       true, false, true, true, NULL));
+	dll_append(obj_list, pcep_obj_create_ero(ero_list));
+}
+
+/* Sends REPORT_BENCH_NUM_LSPS state reports, batch_size per PCRpt message */
+static void send_lsp_reports(pcep_session *session, int batch_size)
+{
+	uint32_t plsp_id = 1;
+	int i;
+
+	while (plsp_id <= REPORT_BENCH_NUM_LSPS) {
+		double_linked_list *obj_list = dll_initialize();
+
+		for (i = 0; i < batch_size && plsp_id <= REPORT_BENCH_NUM_LSPS;
+		     i++, plsp_id++)
+			append_lsp_report(obj_list, plsp_id);
+		send_message(session, pcep_msg_create_report(obj_list), true);
+	}
+}
+
+void test_send_report_batch()
+{
+	pcep_configuration *config = create_default_pcep_configuration();
+	struct hostent *host_info = gethostbyname("localhost");
+	struct in_addr dest_address;
+	memcpy(&dest_address, host_info->h_addr, host_info->h_length);
+	mock_socket_comm_info *mock_info = get_mock_socket_comm_info();
+	mock_info->send_message_save_message = true;
+	int i;
+
+	initialize_pcc();
+
+	pcep_session *session = connect_pce(config, &dest_address);
+	uint8_t *encoded_msg =
+		dll_delete_first_node(mock_info->sent_message_list);
+	pceplib_free(PCEPLIB_MESSAGES, encoded_msg);
+
+	double_linked_list *obj_list = dll_initialize();
+	for (i = 1; i <= REPORT_BENCH_BATCH_SIZE; i++)
+		append_lsp_report(obj_list, i);
+	send_message(session, pcep_msg_create_report(obj_list), true);
+
+	/* All the state reports should be in a single PCRpt message */
+	CU_ASSERT_EQUAL(mock_info->sent_message_list->num_entries, 1);
+	encoded_msg = dll_delete_first_node(mock_info->sent_message_list);
+	CU_ASSERT_PTR_NOT_NULL(encoded_msg);
+	struct pcep_message *msg = pcep_decode_message(encoded_msg);
+	CU_ASSERT_PTR_NOT_NULL(msg);
+	CU_ASSERT_EQUAL(msg->msg_header->type, PCEP_TYPE_REPORT);
+
+	int num_lsps = 0;
+	uint32_t expected_plsp_id = 1;
+	double_linked_list_node *node = msg->obj_list->head;
+	for (; node != NULL; node = node->next_node) {
+		struct pcep_object_header *obj = node->data;
+		if (obj->object_class != PCEP_OBJ_CLASS_LSP)
+			continue;
+		CU_ASSERT_EQUAL(((struct pcep_object_lsp *)obj)->plsp_id,
+				expected_plsp_id);
+		expected_plsp_id++;
+		num_lsps++;
+	}
+	CU_ASSERT_EQUAL(num_lsps, REPORT_BENCH_BATCH_SIZE);
+
+	pcep_msg_free_message(msg);
+	pceplib_free(PCEPLIB_MESSAGES, encoded_msg);
+	destroy_pcep_session(session);
+	destroy_pcep_configuration(config);
+
+	destroy_pcc();
+}
+
+void test_send_report_throughput()
+{
+	pcep_configuration *config = create_default_pcep_configuration();
+	struct hostent *host_info = gethostbyname("localhost");
+	struct in_addr dest_address;
+	memcpy(&dest_address, host_info->h_addr, host_info->h_length);
+	mock_socket_comm_info *mock_info = get_mock_socket_comm_info();
+	int times_called;
+
+	initialize_pcc();
+
+	pcep_session *session = connect_pce(config, &dest_address);
+
+	times_called = mock_info->socket_comm_session_send_message_times_called;
+	send_lsp_reports(session, 1);
+	CU_ASSERT_EQUAL(mock_info->socket_comm_session_send_message_times_called
+				- times_called,
+			REPORT_BENCH_NUM_LSPS);
+
+	times_called = mock_info->socket_comm_session_send_message_times_called;
+	send_lsp_reports(session, REPORT_BENCH_BATCH_SIZE);
+	CU_ASSERT_EQUAL(mock_info->socket_comm_session_send_message_times_called
+				- times_called,
+			(REPORT_BENCH_NUM_LSPS + REPORT_BENCH_BATCH_SIZE - 1)
+				/ REPORT_BENCH_BATCH_SIZE);
+
+	destroy_pcep_session(session);
+	destroy_pcep_configuration(config);
+
+	destroy_pcc();
+}
+
 void test_event_queue()
 {
 	/* This initializes the event_queue */
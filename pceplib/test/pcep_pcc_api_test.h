@@ -37,6 +37,8 @@ void test_connect_pce_ipv6(void);
 void test_connect_pce_with_src_ip(void);
 void test_disconnect_pce(void);
 void test_send_message(void);
+void test_send_report_batch(void);
+void test_send_report_throughput(void);
 void test_event_queue(void);
 void test_get_event_type_str(void);
 
@@ -57,6 +57,10 @@ int main(int argc, char **argv)
 	CU_add_test(test_pcc_api_suite, "test_disconnect_pce",
 		    test_disconnect_pce);
 	CU_add_test(test_pcc_api_suite, "test_send_message", test_send_message);
+	CU_add_test(test_pcc_api_suite, "test_send_report_batch",
+		    test_send_report_batch);
+	CU_add_test(test_pcc_api_suite, "test_send_report_throughput",
+		    test_send_report_throughput);
 	CU_add_test(test_pcc_api_suite, "test_event_queue", test_event_queue);
 	CU_add_test(test_pcc_api_suite, "test_get_event_type_str",
 		    test_get_event_type_str);
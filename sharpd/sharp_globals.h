@@ -24,6 +24,28 @@
 
 DECLARE_MGROUP(SHARPD)
 
+/*
+ * Install/removal latency, as seen between handing a route to the
+ * zapi stream and zebra notifying us about it.  Bucket i counts
+ * samples in [2^i, 2^(i+1)) microseconds.
+ */
+#define SHARP_LATENCY_BUCKETS 24
+
+struct sharp_latency {
+	uint64_t buckets[SHARP_LATENCY_BUCKETS];
+	uint64_t count;
+	uint64_t sum_usec;
+	uint64_t min_usec;
+	uint64_t max_usec;
+};
+
+enum sharp_churn {
+	SHARP_CHURN_NONE,
+	SHARP_CHURN_FLAP,
+	SHARP_CHURN_NEXTHOP,
+	SHARP_CHURN_ECMP,
+};
+
 struct sharp_routes {
 	/* The original prefix for route installation */
 	struct prefix orig_prefix;
@@ -47,6 +69,27 @@ struct sharp_routes {
 	struct timeval t_end;
 
 	char opaque[ZAPI_MESSAGE_OPAQUE_LENGTH];
+
+	/* Routes per second to send, 0 means as fast as possible */
+	uint32_t rate;
+	struct thread *t_rate;
+
+	/*
+	 * When each route of the current batch was sent, indexed by
+	 * offset from sent_prefix.
+	 */
+	struct prefix sent_prefix;
+	struct timeval *t_sent;
+	uint32_t t_sent_size;
+
+	struct sharp_latency install_latency;
+	struct sharp_latency remove_latency;
+
+	/* Churn pattern applied to the installed routes */
+	enum sharp_churn churn;
+	uint32_t churn_iterations;
+	uint32_t churn_step;
+	struct nexthop_group churn_nhg;
 };
 
 struct sharp_global {
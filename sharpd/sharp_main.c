@@ -44,9 +44,9 @@
 #include "routemap.h"
 #include "nexthop_group.h"
 
+#include "sharp_globals.h"
 #include "sharp_zebra.h"
 #include "sharp_vty.h"
-#include "sharp_globals.h"
 #include "sharp_nht.h"
 
 DEFINE_MGROUP(SHARPD, "sharpd")
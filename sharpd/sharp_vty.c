@@ -29,6 +29,7 @@
 #include "vrf.h"
 #include "zclient.h"
 #include "nexthop_group.h"
+#include "json.h"
 
 #include "sharpd/sharp_globals.h"
 #include "sharpd/sharp_zebra.h"
@@ -139,19 +140,114 @@ DEFPY(sharp_nht_data_dump,
 	return CMD_SUCCESS;
 }
 
+static const char *const sharp_churn_names[] = {
+	[SHARP_CHURN_NONE] = "none",
+	[SHARP_CHURN_FLAP] = "flap",
+	[SHARP_CHURN_NEXTHOP] = "nexthop-change",
+	[SHARP_CHURN_ECMP] = "ecmp-width",
+};
+
+static void sharp_latency_dump(struct vty *vty, const char *name,
+			       const struct sharp_latency *lat,
+			       json_object *json)
+{
+	json_object *json_lat = NULL, *json_hist = NULL, *json_bucket;
+	uint64_t avg = lat->count ? lat->sum_usec / lat->count : 0;
+	char buf[32];
+	int i;
+
+	if (json) {
+		json_lat = json_object_new_object();
+		json_object_int_add(json_lat, "count", lat->count);
+		json_object_int_add(json_lat, "minUsec", lat->min_usec);
+		json_object_int_add(json_lat, "avgUsec", avg);
+		json_object_int_add(json_lat, "maxUsec", lat->max_usec);
+		json_hist = json_object_new_array();
+		json_object_object_add(json_lat, "histogram", json_hist);
+		json_object_object_add(json, name, json_lat);
+	} else
+		vty_out(vty,
+			"%s latency: %" PRIu64 " samples, min %" PRIu64
+			" avg %" PRIu64 " max %" PRIu64 " usec\n",
+			name, lat->count, lat->min_usec, avg, lat->max_usec);
+
+	for (i = 0; i < SHARP_LATENCY_BUCKETS; i++) {
+		uint64_t lo = i ? (1ULL << i) : 0;
+
+		if (!lat->buckets[i])
+			continue;
+
+		if (json) {
+			json_bucket = json_object_new_object();
+			json_object_int_add(json_bucket, "fromUsec", lo);
+			json_object_int_add(json_bucket, "toUsec",
+					    (1ULL << (i + 1)) - 1);
+			json_object_int_add(json_bucket, "count",
+					    lat->buckets[i]);
+			json_object_array_add(json_hist, json_bucket);
+			continue;
+		}
+
+		snprintf(buf, sizeof(buf), "%" PRIu64 "-%llu", lo,
+			 (1ULL << (i + 1)) - 1);
+		vty_out(vty, "  %20s usec: %" PRIu64 "\n", buf,
+			lat->buckets[i]);
+	}
+}
+
 DEFPY (install_routes_data_dump,
        install_routes_data_dump_cmd,
-       "sharp data route",
+       "sharp data route [json$json]",
        "Sharp routing Protocol\n"
        "Data about what is going on\n"
-       "Route Install/Removal Information\n")
+       "Route Install/Removal Information\n"
+       JSON_STR)
 {
 	struct timeval r;
+	json_object *jo = NULL;
 
 	timersub(&sg.r.t_end, &sg.r.t_start, &r);
-	vty_out(vty, "Prefix: %pFX Total: %u %u %u Time: %jd.%ld\n",
-		&sg.r.orig_prefix, sg.r.total_routes, sg.r.installed_routes,
-		sg.r.removed_routes, (intmax_t)r.tv_sec, (long)r.tv_usec);
+
+	if (json) {
+		char buf[PREFIX_STRLEN];
+
+		jo = json_object_new_object();
+		json_object_string_add(jo, "prefix",
+				       prefix2str(&sg.r.orig_prefix, buf,
+						  sizeof(buf)));
+		json_object_int_add(jo, "totalRoutes", sg.r.total_routes);
+		json_object_int_add(jo, "installedRoutes",
+				    sg.r.installed_routes);
+		json_object_int_add(jo, "removedRoutes", sg.r.removed_routes);
+		json_object_int_add(jo, "timeUsec",
+				    (int64_t)r.tv_sec * 1000000 + r.tv_usec);
+		json_object_int_add(jo, "rate", sg.r.rate);
+		json_object_string_add(jo, "churn",
+				       sharp_churn_names[sg.r.churn]);
+		json_object_int_add(jo, "churnStep", sg.r.churn_step);
+	} else {
+		vty_out(vty, "Prefix: %pFX Total: %u %u %u Time: %jd.%ld\n",
+			&sg.r.orig_prefix, sg.r.total_routes,
+			sg.r.installed_routes, sg.r.removed_routes,
+			(intmax_t)r.tv_sec, (long)r.tv_usec);
+		if (sg.r.rate)
+			vty_out(vty, "Rate: %u routes/sec\n", sg.r.rate);
+		if (sg.r.churn != SHARP_CHURN_NONE)
+			vty_out(vty, "Churn: %s step %u\n",
+				sharp_churn_names[sg.r.churn], sg.r.churn_step);
+	}
+
+	sharp_latency_dump(vty, json ? "installLatency" : "Install",
+			   &sg.r.install_latency, jo);
+	sharp_latency_dump(vty, json ? "removeLatency" : "Remove",
+			   &sg.r.remove_latency, jo);
+
+	if (json) {
+		vty_out(vty, "%s\n",
+			json_object_to_json_string_ext(
+				jo, JSON_C_TO_STRING_PRETTY));
+		json_object_free(jo);
+	}
 
 	return CMD_SUCCESS;
 }
@@ -163,7 +259,7 @@ DEFPY (install_routes,
 	  <nexthop <A.B.C.D$nexthop4|X:X::X:X$nexthop6>|\
 	   nexthop-group NHGNAME$nexthop_group>\
 	  [backup$backup <A.B.C.D$backup_nexthop4|X:X::X:X$backup_nexthop6>] \
-	  (1-1000000)$routes [instance (0-255)$instance] [repeat (2-1000)$rpt] [opaque WORD]",
+	  (1-1000000)$routes [instance (0-255)$instance] [repeat (2-1000)$rpt] [rate (1-10000000)$rate] [opaque WORD]",
        "Sharp routing Protocol\n"
        "install some routes\n"
        "Routes to install\n"
@@ -184,6 +280,8 @@ DEFPY (install_routes,
        "Instance\n"
        "Should we repeat this command\n"
        "How many times to repeat this command\n"
+       "Limit how fast routes are sent to zebra\n"
+       "Routes per second\n"
        "What opaque data to send down\n"
        "The opaque data\n")
 {
@@ -192,8 +290,15 @@ DEFPY (install_routes,
 	uint32_t rts;
 	uint32_t nhgid = 0;
 
+	if (sg.r.churn != SHARP_CHURN_NONE) {
+		vty_out(vty, "%% Route churn in progress\n");
+		return CMD_WARNING;
+	}
+
 	sg.r.total_routes = routes;
 	sg.r.installed_routes = 0;
+	sg.r.rate = rate;
+	sharp_route_timing_reset(routes, true);
 
 	if (rpt >= 2)
 		sg.r.repeat = rpt * 2;
@@ -341,7 +446,7 @@ DEFPY(vrf_label, vrf_label_cmd,
 
 DEFPY (remove_routes,
        remove_routes_cmd,
-       "sharp remove routes [vrf NAME$vrf_name] <A.B.C.D$start4|X:X::X:X$start6> (1-1000000)$routes [instance (0-255)$instance]",
+       "sharp remove routes [vrf NAME$vrf_name] <A.B.C.D$start4|X:X::X:X$start6> (1-1000000)$routes [instance (0-255)$instance] [rate (1-10000000)$rate]",
        "Sharp Routing Protocol\n"
        "Remove some routes\n"
        "Routes to remove\n"
@@ -351,13 +456,22 @@ DEFPY (remove_routes,
        "v6 Starting spot\n"
        "Routes to uninstall\n"
        "instance to use\n"
-       "Value of instance\n")
+       "Value of instance\n"
+       "Limit how fast routes are sent to zebra\n"
+       "Routes per second\n")
 {
 	struct vrf *vrf;
 	struct prefix prefix;
 
+	if (sg.r.churn != SHARP_CHURN_NONE) {
+		vty_out(vty, "%% Route churn in progress\n");
+		return CMD_WARNING;
+	}
+
 	sg.r.total_routes = routes;
 	sg.r.removed_routes = 0;
+	sg.r.rate = rate;
+	sharp_route_timing_reset(routes, false);
 	uint32_t rts;
 
 	memset(&prefix, 0, sizeof(prefix));
@@ -388,6 +502,45 @@ DEFPY (remove_routes,
 	return CMD_SUCCESS;
 }
 
+DEFPY (churn_routes,
+       churn_routes_cmd,
+       "sharp churn routes <flap$flap|nexthop-change$nh_change|ecmp-width$ecmp> (1-1000)$iterations",
+       "Sharp Routing Protocol\n"
+       "Churn the routes installed by the last install command\n"
+       "Routes to churn\n"
+       "Remove and reinstall the routes\n"
+       "Move the routes through each nexthop of their nexthop-group\n"
+       "Move the routes through ECMP widths 1..N of their nexthop-group\n"
+       "How many times to churn\n")
+{
+	enum sharp_churn churn = SHARP_CHURN_FLAP;
+
+	if (sg.r.churn != SHARP_CHURN_NONE) {
+		vty_out(vty, "%% Route churn already in progress\n");
+		return CMD_WARNING;
+	}
+
+	if (!sg.r.total_routes
+	    || sg.r.installed_routes != sg.r.total_routes) {
+		vty_out(vty, "%% Routes must be fully installed first\n");
+		return CMD_WARNING;
+	}
+
+	if (nh_change)
+		churn = SHARP_CHURN_NEXTHOP;
+	else if (ecmp)
+		churn = SHARP_CHURN_ECMP;
+
+	if (churn != SHARP_CHURN_FLAP && !sg.r.nhop_group.nexthop) {
+		vty_out(vty, "%% Routes have no nexthops to churn\n");
+		return CMD_WARNING;
+	}
+
+	sharp_churn_start(churn, iterations);
+
+	return CMD_SUCCESS;
+}
+
 DEFUN_NOSH (show_debugging_sharpd,
 	    show_debugging_sharpd_cmd,
 	    "show debugging [sharp]",
@@ -705,6 +858,7 @@ void sharp_vty_init(void)
 	install_element(ENABLE_NODE, &install_routes_data_dump_cmd);
 	install_element(ENABLE_NODE, &install_routes_cmd);
 	install_element(ENABLE_NODE, &remove_routes_cmd);
+	install_element(ENABLE_NODE, &churn_routes_cmd);
 	install_element(ENABLE_NODE, &vrf_label_cmd);
 	install_element(ENABLE_NODE, &sharp_nht_data_dump_cmd);
 	install_element(ENABLE_NODE, &watch_nexthop_v6_cmd);
@@ -45,6 +45,7 @@ extern struct thread_master *master;
 extern struct zebra_privs_t sharp_privs;
 
 DEFINE_MTYPE_STATIC(SHARPD, ZC, "Test zclients");
+DEFINE_MTYPE_STATIC(SHARPD, ROUTE_TIMES, "Route send timestamps");
 
 /* Struct to hold list of test zclients */
 struct sharp_zclient {
@@ -329,6 +330,113 @@ static bool route_delete(struct prefix *p, vrf_id_t vrf_id, uint8_t instance)
 		return false;
 }
 
+/*
+ * Rate control: when sg.r.rate is set we send at most a tick's worth of
+ * routes and then come back from a timer, the same way we come back
+ * when the zapi stream is buffered.
+ */
+#define SHARP_RATE_TICK_MSEC 10
+
+static void sharp_zclient_buffer_ready(void);
+
+static int sharp_rate_timer(struct thread *thread)
+{
+	sharp_zclient_buffer_ready();
+
+	return 0;
+}
+
+static uint32_t sharp_rate_budget(long *interval)
+{
+	uint32_t budget;
+
+	*interval = SHARP_RATE_TICK_MSEC;
+	if (!sg.r.rate)
+		return 0;
+
+	budget = (uint64_t)sg.r.rate * SHARP_RATE_TICK_MSEC / 1000;
+	if (!budget) {
+		budget = 1;
+		*interval = 1000 / sg.r.rate;
+	}
+
+	return budget;
+}
+
+/* Returns true when this tick's budget is used up and routes remain */
+static bool sharp_rate_exhausted(uint32_t *budget, uint32_t sent,
+				 uint32_t routes)
+{
+	if (!*budget)
+		return false;
+
+	return --(*budget) == 0 && sent < routes;
+}
+
+void sharp_route_timing_reset(uint32_t routes, bool install)
+{
+	if (routes > sg.r.t_sent_size) {
+		sg.r.t_sent = XREALLOC(MTYPE_ROUTE_TIMES, sg.r.t_sent,
+				       routes * sizeof(*sg.r.t_sent));
+		sg.r.t_sent_size = routes;
+	}
+	memset(sg.r.t_sent, 0, sg.r.t_sent_size * sizeof(*sg.r.t_sent));
+
+	if (install)
+		memset(&sg.r.install_latency, 0, sizeof(sg.r.install_latency));
+	memset(&sg.r.remove_latency, 0, sizeof(sg.r.remove_latency));
+}
+
+static bool sharp_route_index(const struct prefix *p, uint32_t *idx)
+{
+	const struct prefix *start = &sg.r.sent_prefix;
+
+	if (p->family != start->family)
+		return false;
+
+	if (p->family == AF_INET)
+		*idx = ntohl(p->u.prefix4.s_addr)
+		       - ntohl(start->u.prefix4.s_addr);
+	else
+		*idx = ntohl(p->u.val32[3]) - ntohl(start->u.val32[3]);
+
+	return *idx < sg.r.t_sent_size;
+}
+
+static void sharp_route_stamp(uint32_t idx)
+{
+	if (idx < sg.r.t_sent_size)
+		monotime(&sg.r.t_sent[idx]);
+}
+
+static void sharp_latency_record(struct sharp_latency *lat,
+				 const struct prefix *p)
+{
+	struct timeval now, diff;
+	uint64_t usec;
+	uint32_t idx;
+	int b = 0;
+
+	if (!sharp_route_index(p, &idx) || !timerisset(&sg.r.t_sent[idx]))
+		return;
+
+	monotime(&now);
+	timersub(&now, &sg.r.t_sent[idx], &diff);
+	timerclear(&sg.r.t_sent[idx]);
+
+	usec = (uint64_t)diff.tv_sec * 1000000 + diff.tv_usec;
+	while (b < SHARP_LATENCY_BUCKETS - 1 && (usec >> (b + 1)))
+		b++;
+
+	lat->buckets[b]++;
+	if (!lat->count || usec < lat->min_usec)
+		lat->min_usec = usec;
+	if (usec > lat->max_usec)
+		lat->max_usec = usec;
+	lat->count++;
+	lat->sum_usec += usec;
+}
+
 static void sharp_install_routes_restart(struct prefix *p, uint32_t count,
 					 vrf_id_t vrf_id, uint8_t instance,
 					 uint32_t nhgid,
@@ -336,8 +444,9 @@ static void sharp_install_routes_restart(struct prefix *p, uint32_t count,
 					 const struct nexthop_group *backup_nhg,
 					 uint32_t routes, char *opaque)
 {
-	uint32_t temp, i;
+	uint32_t temp, i, budget;
 	bool v4 = false;
+	long interval;
 
 	if (p->family == AF_INET) {
 		v4 = true;
@@ -345,15 +454,20 @@ static void sharp_install_routes_restart(struct prefix *p, uint32_t count,
 	} else
 		temp = ntohl(p->u.val32[3]);
 
+	budget = sharp_rate_budget(&interval);
+
 	for (i = count; i < routes; i++) {
-		bool buffered = route_add(p, vrf_id, (uint8_t)instance, nhgid,
-					  nhg, backup_nhg, opaque);
+		bool buffered;
+
+		sharp_route_stamp(i);
+		buffered = route_add(p, vrf_id, (uint8_t)instance, nhgid, nhg,
+				     backup_nhg, opaque);
 		if (v4)
 			p->u.prefix4.s_addr = htonl(++temp);
 		else
 			p->u.val32[3] = htonl(++temp);
 
-		if (buffered) {
+		if (buffered || sharp_rate_exhausted(&budget, i + 1, routes)) {
 			wb.p = *p;
 			wb.count = i+1;
 			wb.routes = routes;
@@ -365,6 +479,10 @@ static void sharp_install_routes_restart(struct prefix *p, uint32_t count,
 			wb.opaque = opaque;
 			wb.restart = SHARP_INSTALL_ROUTES_RESTART;
 
+			if (!buffered)
+				thread_add_timer_msec(master, sharp_rate_timer,
+						      NULL, interval,
+						      &sg.r.t_rate);
 			return;
 		}
 	}
@@ -382,6 +500,8 @@ void sharp_install_routes_helper(struct prefix *p, vrf_id_t vrf_id,
 	if (backup_nhg && (backup_nhg->nexthop == NULL))
 		backup_nhg = NULL;
 
+	THREAD_OFF(sg.r.t_rate);
+	sg.r.sent_prefix = *p;
 	monotime(&sg.r.t_start);
 	sharp_install_routes_restart(p, 0, vrf_id, instance, nhgid, nhg,
 				     backup_nhg, routes, opaque);
@@ -391,8 +511,9 @@ static void sharp_remove_routes_restart(struct prefix *p, uint32_t count,
 					vrf_id_t vrf_id, uint8_t instance,
 					uint32_t routes)
 {
-	uint32_t temp, i;
+	uint32_t temp, i, budget;
 	bool v4 = false;
+	long interval;
 
 	if (p->family == AF_INET) {
 		v4 = true;
@@ -400,15 +521,20 @@ static void sharp_remove_routes_restart(struct prefix *p, uint32_t count,
 	} else
 		temp = ntohl(p->u.val32[3]);
 
+	budget = sharp_rate_budget(&interval);
+
 	for (i = count; i < routes; i++) {
-		bool buffered = route_delete(p, vrf_id, (uint8_t)instance);
+		bool buffered;
+
+		sharp_route_stamp(i);
+		buffered = route_delete(p, vrf_id, (uint8_t)instance);
 
 		if (v4)
 			p->u.prefix4.s_addr = htonl(++temp);
 		else
 			p->u.val32[3] = htonl(++temp);
 
-		if (buffered) {
+		if (buffered || sharp_rate_exhausted(&budget, i + 1, routes)) {
 			wb.p = *p;
 			wb.count = i + 1;
 			wb.vrf_id = vrf_id;
@@ -416,6 +542,10 @@ static void sharp_remove_routes_restart(struct prefix *p, uint32_t count,
 			wb.routes = routes;
 			wb.restart = SHARP_DELETE_ROUTES_RESTART;
 
+			if (!buffered)
+				thread_add_timer_msec(master, sharp_rate_timer,
+						      NULL, interval,
+						      &sg.r.t_rate);
 			return;
 		}
 	}
@@ -426,6 +556,8 @@ void sharp_remove_routes_helper(struct prefix *p, vrf_id_t vrf_id,
 {
 	zlog_debug("Removing %u routes", routes);
 
+	THREAD_OFF(sg.r.t_rate);
+	sg.r.sent_prefix = *p;
 	monotime(&sg.r.t_start);
 
 	sharp_remove_routes_restart(p, 0, vrf_id, instance, routes);
@@ -436,8 +568,11 @@ static void handle_repeated(bool installed)
 	struct prefix p = sg.r.orig_prefix;
 	sg.r.repeat--;
 
-	if (sg.r.repeat <= 0)
+	if (sg.r.repeat <= 0) {
+		if (sg.r.churn == SHARP_CHURN_FLAP)
+			sg.r.churn = SHARP_CHURN_NONE;
 		return;
+	}
 
 	if (installed) {
 		sg.r.removed_routes = 0;
@@ -454,8 +589,84 @@ static void handle_repeated(bool installed)
 	}
 }
 
+/*
+ * Reinstall the routes with the next nexthop set of the churn pattern:
+ * either one nexthop of the group at a time, or the first 1..N nexthops
+ * of the group.
+ */
+static void sharp_churn_step(void)
+{
+	struct prefix p = sg.r.orig_prefix;
+	const struct nexthop *nh;
+	uint32_t num = 0, sel, i;
+
+	for (nh = sg.r.nhop_group.nexthop; nh; nh = nh->next)
+		num++;
+
+	nexthops_free(sg.r.churn_nhg.nexthop);
+	sg.r.churn_nhg.nexthop = NULL;
+
+	sel = sg.r.churn_step++ % num;
+	for (nh = sg.r.nhop_group.nexthop, i = 0; nh; nh = nh->next, i++) {
+		if (sg.r.churn == SHARP_CHURN_NEXTHOP && i != sel)
+			continue;
+		if (sg.r.churn == SHARP_CHURN_ECMP && i > sel)
+			break;
+
+		nexthop_group_add_sorted(&sg.r.churn_nhg,
+					 nexthop_dup(nh, NULL));
+	}
+
+	sg.r.installed_routes = 0;
+	sharp_install_routes_helper(&p, sg.r.vrf_id, sg.r.inst, 0,
+				    &sg.r.churn_nhg, NULL, sg.r.total_routes,
+				    sg.r.opaque);
+}
+
+void sharp_churn_start(enum sharp_churn churn, uint32_t iterations)
+{
+	struct prefix p = sg.r.orig_prefix;
+
+	sg.r.churn = churn;
+	sg.r.churn_iterations = iterations;
+	sg.r.churn_step = 0;
+
+	switch (churn) {
+	case SHARP_CHURN_NONE:
+		break;
+	case SHARP_CHURN_FLAP:
+		/* Remove and reinstall, ending with the routes installed */
+		sg.r.repeat = iterations * 2;
+		sg.r.removed_routes = 0;
+		sharp_remove_routes_helper(&p, sg.r.vrf_id, sg.r.inst,
+					   sg.r.total_routes);
+		break;
+	case SHARP_CHURN_NEXTHOP:
+	case SHARP_CHURN_ECMP:
+		sg.r.repeat = 0;
+		sharp_churn_step();
+		break;
+	}
+}
+
+static void sharp_churn_done(void)
+{
+	if (--sg.r.churn_iterations) {
+		sharp_churn_step();
+		return;
+	}
+
+	sg.r.churn = SHARP_CHURN_NONE;
+	nexthops_free(sg.r.churn_nhg.nexthop);
+	sg.r.churn_nhg.nexthop = NULL;
+}
+
 static void sharp_zclient_buffer_ready(void)
 {
+	/* Rate control will pick up where we left off */
+	if (sg.r.t_rate)
+		return;
+
 	switch (wb.restart) {
 	case SHARP_INSTALL_ROUTES_RESTART:
 		sharp_install_routes_restart(
@@ -483,12 +694,17 @@ static int route_notify_owner(ZAPI_CALLBACK_ARGS)
 	switch (note) {
 	case ZAPI_ROUTE_INSTALLED:
 		sg.r.installed_routes++;
+		sharp_latency_record(&sg.r.install_latency, &p);
 		if (sg.r.total_routes == sg.r.installed_routes) {
 			monotime(&sg.r.t_end);
 			timersub(&sg.r.t_end, &sg.r.t_start, &r);
 			zlog_debug("Installed All Items %jd.%ld",
 				   (intmax_t)r.tv_sec, (long)r.tv_usec);
-			handle_repeated(true);
+			if (sg.r.churn == SHARP_CHURN_NEXTHOP
+			    || sg.r.churn == SHARP_CHURN_ECMP)
+				sharp_churn_done();
+			else
+				handle_repeated(true);
 		}
 		break;
 	case ZAPI_ROUTE_FAIL_INSTALL:
@@ -499,6 +715,7 @@ static int route_notify_owner(ZAPI_CALLBACK_ARGS)
 		break;
 	case ZAPI_ROUTE_REMOVED:
 		sg.r.removed_routes++;
+		sharp_latency_record(&sg.r.remove_latency, &p);
 		if (sg.r.total_routes == sg.r.removed_routes) {
 			monotime(&sg.r.t_end);
 			timersub(&sg.r.t_end, &sg.r.t_start, &r);
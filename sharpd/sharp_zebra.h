@@ -22,6 +22,8 @@
 #ifndef __SHARP_ZEBRA_H__
 #define __SHARP_ZEBRA_H__
 
+#include "sharpd/sharp_globals.h"
+
 extern void sharp_zebra_init(void);
 
 /* Add and delete extra zapi client sessions, for testing */
@@ -43,6 +45,10 @@ extern void sharp_install_routes_helper(struct prefix *p, vrf_id_t vrf_id,
 extern void sharp_remove_routes_helper(struct prefix *p, vrf_id_t vrf_id,
 				       uint8_t instance, uint32_t routes);
 
+/* Size the per route send timestamps and clear latency statistics */
+extern void sharp_route_timing_reset(uint32_t routes, bool install);
+extern void sharp_churn_start(enum sharp_churn churn, uint32_t iterations);
+
 int sharp_install_lsps_helper(bool install_p, bool update_p,
 			      const struct prefix *p, uint8_t type,
 			      int instance, uint32_t in_label,
@@ -79,6 +79,7 @@ static void sigint(void)
 	zlog_notice("Terminating on signal");
 
 	static_vrf_terminate();
+	static_install_queue_fini();
 
 	frr_fini();
 
@@ -157,6 +158,7 @@ int main(int argc, char **argv, char **envp)
 
 	static_debug_init();
 	static_vrf_init();
+	static_install_queue_init();
 
 	static_zebra_init();
 	static_vty_init();
@@ -30,155 +30,6 @@
 #include "static_zebra.h"
 #include "static_nht.h"
 
-static void static_nht_update_path(struct route_node *rn,
-				   struct static_path *pn, struct prefix *nhp,
-				   uint32_t nh_num, vrf_id_t nh_vrf_id,
-				   struct vrf *vrf, safi_t safi)
-{
-	struct static_nexthop *nh;
-
-	frr_each(static_nexthop_list, &pn->nexthop_list, nh) {
-		if (nh->nh_vrf_id != nh_vrf_id)
-			continue;
-
-		if (nh->type != STATIC_IPV4_GATEWAY
-		    && nh->type != STATIC_IPV4_GATEWAY_IFNAME
-		    && nh->type != STATIC_IPV6_GATEWAY
-		    && nh->type != STATIC_IPV6_GATEWAY_IFNAME)
-			continue;
-
-		if (nhp->family == AF_INET
-		    && nhp->u.prefix4.s_addr == nh->addr.ipv4.s_addr)
-			nh->nh_valid = !!nh_num;
-
-		if (nhp->family == AF_INET6
-		    && memcmp(&nhp->u.prefix6, &nh->addr.ipv6, 16) == 0)
-			nh->nh_valid = !!nh_num;
-
-		if (nh->state == STATIC_START)
-			static_zebra_route_add(rn, pn, safi, true);
-	}
-}
-
-static void static_nht_update_safi(struct prefix *sp, struct prefix *nhp,
-				   uint32_t nh_num, afi_t afi, safi_t safi,
-				   struct vrf *vrf, vrf_id_t nh_vrf_id)
-{
-	struct route_table *stable;
-	struct static_vrf *svrf;
-	struct route_node *rn;
-	struct static_path *pn;
-	struct static_route_info *si;
-
-	svrf = vrf->info;
-	if (!svrf)
-		return;
-
-	stable = static_vrf_static_table(afi, safi, svrf);
-	if (!stable)
-		return;
-
-	if (sp) {
-		rn = srcdest_rnode_lookup(stable, sp, NULL);
-		if (rn && rn->info) {
-			si = static_route_info_from_rnode(rn);
-			frr_each(static_path_list, &si->path_list, pn) {
-				static_nht_update_path(rn, pn, nhp, nh_num,
-						       nh_vrf_id, vrf, safi);
-			}
-			route_unlock_node(rn);
-		}
-		return;
-	}
-
-	for (rn = route_top(stable); rn; rn = route_next(rn)) {
-		si = static_route_info_from_rnode(rn);
-		if (!si)
-			continue;
-		frr_each(static_path_list, &si->path_list, pn) {
-			static_nht_update_path(rn, pn, nhp, nh_num, nh_vrf_id,
-					       vrf, safi);
-		}
-	}
-}
-
-void static_nht_update(struct prefix *sp, struct prefix *nhp,
-		       uint32_t nh_num, afi_t afi, vrf_id_t nh_vrf_id)
-{
-
-	struct vrf *vrf;
-
-	RB_FOREACH (vrf, vrf_name_head, &vrfs_by_name) {
-		static_nht_update_safi(sp, nhp, nh_num, afi, SAFI_UNICAST,
-				       vrf, nh_vrf_id);
-		static_nht_update_safi(sp, nhp, nh_num, afi, SAFI_MULTICAST,
-				       vrf, nh_vrf_id);
-	}
-}
-
-static void static_nht_reset_start_safi(struct prefix *nhp, afi_t afi,
-					safi_t safi, struct vrf *vrf,
-					vrf_id_t nh_vrf_id)
-{
-	struct static_vrf *svrf;
-	struct route_table *stable;
-	struct static_nexthop *nh;
-	struct static_path *pn;
-	struct route_node *rn;
-	struct static_route_info *si;
-
-	svrf = vrf->info;
-	if (!svrf)
-		return;
-
-	stable = static_vrf_static_table(afi, safi, svrf);
-	if (!stable)
-		return;
-
-	for (rn = route_top(stable); rn; rn = route_next(rn)) {
-		si = static_route_info_from_rnode(rn);
-		if (!si)
-			continue;
-		frr_each(static_path_list, &si->path_list, pn) {
-			frr_each(static_nexthop_list, &pn->nexthop_list, nh) {
-				if (nh->nh_vrf_id != nh_vrf_id)
-					continue;
-
-				if (nhp->family == AF_INET
-				    && nhp->u.prefix4.s_addr
-					       != nh->addr.ipv4.s_addr)
-					continue;
-
-				if (nhp->family == AF_INET6
-				    && memcmp(&nhp->u.prefix6, &nh->addr.ipv6,
-					      16)
-					       != 0)
-					continue;
-
-				/*
-				 * We've been told that a nexthop we
-				 * depend on has changed in some manner,
-				 * so reset the state machine to allow
-				 * us to start over.
-				 */
-				nh->state = STATIC_START;
-			}
-		}
-	}
-}
-
-void static_nht_reset_start(struct prefix *nhp, afi_t afi, vrf_id_t nh_vrf_id)
-{
-	struct vrf *vrf;
-
-	RB_FOREACH (vrf, vrf_name_head, &vrfs_by_name) {
-		static_nht_reset_start_safi(nhp, afi, SAFI_UNICAST,
-					    vrf, nh_vrf_id);
-		static_nht_reset_start_safi(nhp, afi, SAFI_MULTICAST,
-					    vrf, nh_vrf_id);
-	}
-}
-
 static void static_nht_mark_state_safi(struct prefix *sp, afi_t afi,
 				       safi_t safi, struct vrf *vrf,
 				       enum static_install_states state)
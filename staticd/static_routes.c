@@ -38,6 +38,76 @@
 DEFINE_MTYPE(STATIC, STATIC_ROUTE, "Static Route Info");
 DEFINE_MTYPE(STATIC, STATIC_PATH, "Static Path");
 
+/*
+ * Paths waiting to be sent to zebra.  A configuration commit or a vrf
+ * coming up calls static_install_path() once per nexthop, so sending
+ * right away would announce a path with N nexthops N times.  Queue the
+ * path instead and send it once from an event after the current batch
+ * of work is done.
+ */
+static struct static_install_list_head static_install_queue;
+static struct thread *t_static_install_queue;
+
+static int static_install_queue_run(struct thread *thread)
+{
+	struct static_path *pn;
+
+	while ((pn = static_install_list_pop(&static_install_queue))) {
+		pn->install_queued = false;
+
+		if (static_nexthop_list_count(&pn->nexthop_list))
+			static_zebra_route_add(pn->install_rn, pn,
+					       pn->install_safi, true);
+	}
+
+	return 0;
+}
+
+void static_install_queue_init(void)
+{
+	static_install_list_init(&static_install_queue);
+}
+
+void static_install_queue_fini(void)
+{
+	struct static_path *pn;
+
+	THREAD_OFF(t_static_install_queue);
+	while ((pn = static_install_list_pop(&static_install_queue)))
+		pn->install_queued = false;
+	static_install_list_fini(&static_install_queue);
+}
+
+/* Drop a path from the install queue, e.g. because it is being freed. */
+void static_install_path_cancel(struct static_path *pn)
+{
+	if (!pn->install_queued)
+		return;
+
+	static_install_list_del(&static_install_queue, pn);
+	pn->install_queued = false;
+}
+
+/*
+ * Announce a path to zebra from the install queue.  Everything that sends
+ * a path because it was configured or one of its nexthops resolved goes
+ * through here, so the path is only sent once per batch.
+ */
+void static_install_path_queue(struct route_node *rn, struct static_path *pn,
+			       safi_t safi)
+{
+	if (!static_nexthop_list_count(&pn->nexthop_list) || pn->install_queued)
+		return;
+
+	pn->install_rn = rn;
+	pn->install_safi = safi;
+	pn->install_queued = true;
+	static_install_list_add_tail(&static_install_queue, pn);
+
+	thread_add_event(master, static_install_queue_run, NULL, 0,
+			 &t_static_install_queue);
+}
+
 /* Install static path into rib. */
 void static_install_path(struct route_node *rn, struct static_path *pn,
 			 safi_t safi, struct static_vrf *svrf)
@@ -47,8 +117,10 @@ void static_install_path(struct route_node *rn, struct static_path *pn,
 	frr_each(static_nexthop_list, &pn->nexthop_list, nh)
 		static_zebra_nht_register(rn, nh, true);
 
-	if (static_nexthop_list_count(&pn->nexthop_list) && svrf && svrf->vrf)
-		static_zebra_route_add(rn, pn, safi, true);
+	if (!svrf || !svrf->vrf)
+		return;
+
+	static_install_path_queue(rn, pn, safi);
 }
 
 /* Uninstall static path from RIB. */
@@ -197,6 +269,7 @@ void static_del_path(struct route_node *rn, struct static_path *pn, safi_t safi,
 	si = rn->info;
 
 	static_path_list_del(&si->path_list, pn);
+	static_install_path_cancel(pn);
 
 	frr_each_safe(static_nexthop_list, &pn->nexthop_list, nh) {
 		static_delete_nexthop(rn, pn, safi, svrf, nh);
@@ -227,6 +300,9 @@ static_add_nexthop(struct route_node *rn, struct static_path *pn, safi_t safi,
 
 	nh->type = type;
 	nh->color = color;
+	nh->rn = rn;
+	nh->pn = pn;
+	nh->safi = safi;
 
 	nh->nh_vrf_id = nh_svrf ? nh_svrf->vrf->vrf_id : VRF_UNKNOWN;
 	strlcpy(nh->nh_vrfname, nh_vrf, sizeof(nh->nh_vrfname));
@@ -71,6 +71,10 @@ enum static_install_states {
 
 PREDECL_DLIST(static_path_list);
 PREDECL_DLIST(static_nexthop_list);
+PREDECL_DLIST(static_install_list);
+PREDECL_DLIST(static_nht_dep_list);
+
+struct static_nht_data;
 
 /* Static route information */
 struct static_route_info {
@@ -90,9 +94,19 @@ struct static_path {
 	uint32_t table_id;
 	/* Nexthop list */
 	struct static_nexthop_list_head nexthop_list;
+
+	/*
+	 * Pending announcement to zebra, see static_install_path().
+	 * rn and safi are only valid while install_queued is set.
+	 */
+	struct static_install_list_item install_item;
+	bool install_queued;
+	struct route_node *install_rn;
+	safi_t install_safi;
 };
 
 DECLARE_DLIST(static_path_list, struct static_path, list);
+DECLARE_DLIST(static_install_list, struct static_path, install_item);
 
 /* Static route information. */
 struct static_nexthop {
@@ -135,9 +149,19 @@ struct static_nexthop {
 
 	/* SR-TE color */
 	uint32_t color;
+
+	/* Owning route and path, used when a tracked nexthop changes */
+	struct route_node *rn;
+	struct static_path *pn;
+	safi_t safi;
+
+	/* Tracked nexthop we are registered against, if any */
+	struct static_nht_data *nhtd;
+	struct static_nht_dep_list_item nht_item;
 };
 
 DECLARE_DLIST(static_nexthop_list, struct static_nexthop, list);
+DECLARE_DLIST(static_nht_dep_list, struct static_nexthop, nht_item);
 
 
 /*
@@ -178,6 +202,11 @@ extern void static_ifindex_update(struct interface *ifp, bool up);
 
 extern void static_install_path(struct route_node *rn, struct static_path *pn,
 				safi_t safi, struct static_vrf *svrf);
+extern void static_install_path_queue(struct route_node *rn,
+				      struct static_path *pn, safi_t safi);
+extern void static_install_path_cancel(struct static_path *pn);
+extern void static_install_queue_init(void);
+extern void static_install_queue_fini(void);
 
 extern struct route_node *static_add_route(afi_t afi, safi_t safi,
 					   struct prefix *p,
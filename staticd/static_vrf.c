@@ -50,9 +50,11 @@ static void zebra_stable_node_cleanup(struct route_table *table,
 			frr_each_safe(static_nexthop_list, &pn->nexthop_list,
 				       nh) {
 				static_nexthop_list_del(&pn->nexthop_list, nh);
+				static_zebra_nht_detach(nh);
 				XFREE(MTYPE_STATIC_NEXTHOP, nh);
 			}
 			static_path_list_del(&si->path_list, pn);
+			static_install_path_cancel(pn);
 			XFREE(MTYPE_STATIC_PATH, pn);
 		}
 
@@ -74,10 +76,12 @@ static void zebra_stable_node_cleanup(struct route_table *table,
 						static_nexthop_list_del(
 							&src_pn->nexthop_list,
 							nh);
+						static_zebra_nht_detach(nh);
 						XFREE(MTYPE_STATIC_NEXTHOP, nh);
 					}
 					static_path_list_del(&src_si->path_list,
 							     src_pn);
+					static_install_path_cancel(src_pn);
 					XFREE(MTYPE_STATIC_PATH, src_pn);
 				}
 
@@ -153,6 +153,9 @@ struct static_nht_data {
 
 	uint32_t refcount;
 	uint8_t nh_num;
+
+	/* Static nexthops registered against this tracked nexthop */
+	struct static_nht_dep_list_head deps;
 };
 
 /* API to check whether the configured nexthop address is
@@ -174,20 +177,44 @@ static_nexthop_is_local(vrf_id_t vrfid, struct prefix *addr, int family)
 	}
 	return false;
 }
+
+/*
+ * Reevaluate only the static nexthops that depend on this tracked
+ * nexthop instead of walking every static route in every vrf.
+ */
+static void static_nht_deps_update(struct static_nht_data *nhtd)
+{
+	struct static_nexthop *nh;
+
+	/*
+	 * We've been told that a nexthop we depend on has changed in
+	 * some manner, so reset the state machine to allow us to
+	 * start over.
+	 */
+	frr_each(static_nht_dep_list, &nhtd->deps, nh) {
+		nh->state = STATIC_START;
+		nh->nh_valid = !!nhtd->nh_num;
+	}
+
+	/*
+	 * The install queue sends each path once, even with several
+	 * nexthops on this gateway or when it is already queued, e.g. by a
+	 * configuration commit.
+	 */
+	frr_each(static_nht_dep_list, &nhtd->deps, nh)
+		static_install_path_queue(nh->rn, nh->pn, nh->safi);
+}
+
 static int static_zebra_nexthop_update(ZAPI_CALLBACK_ARGS)
 {
 	struct static_nht_data *nhtd, lookup;
 	struct zapi_route nhr;
-	afi_t afi = AFI_IP;
 
 	if (!zapi_nexthop_update_decode(zclient->ibuf, &nhr)) {
 		zlog_err("Failure to decode nexthop update message");
 		return 1;
 	}
 
-	if (nhr.prefix.family == AF_INET6)
-		afi = AFI_IP6;
-
 	if (nhr.type == ZEBRA_ROUTE_CONNECT) {
 		if (static_nexthop_is_local(vrf_id, &nhr.prefix,
 					nhr.prefix.family))
@@ -203,9 +230,7 @@ static int static_zebra_nexthop_update(ZAPI_CALLBACK_ARGS)
 	if (nhtd) {
 		nhtd->nh_num = nhr.nexthop_num;
 
-		static_nht_reset_start(&nhr.prefix, afi, nhtd->nh_vrf_id);
-		static_nht_update(NULL, &nhr.prefix, nhr.nexthop_num, afi,
-				  nhtd->nh_vrf_id);
+		static_nht_deps_update(nhtd);
 	} else
 		zlog_err("No nhtd?");
 
@@ -249,6 +274,7 @@ static void *static_nht_hash_alloc(void *data)
 	new->refcount = 0;
 	new->nh_num = 0;
 	new->nh_vrf_id = copy->nh_vrf_id;
+	static_nht_dep_list_init(&new->deps);
 
 	return new;
 }
@@ -256,18 +282,36 @@ static void *static_nht_hash_alloc(void *data)
 static void static_nht_hash_free(void *data)
 {
 	struct static_nht_data *nhtd = data;
+	struct static_nexthop *nh;
+
+	while ((nh = static_nht_dep_list_pop(&nhtd->deps)))
+		nh->nhtd = NULL;
+	static_nht_dep_list_fini(&nhtd->deps);
 
 	prefix_free(&nhtd->nh);
 	XFREE(MTYPE_TMP, nhtd);
 }
 
+/*
+ * Forget which tracked nexthop this static nexthop depends on, without
+ * touching the registration with zebra.  Used before a nexthop is freed
+ * or registered again.
+ */
+void static_zebra_nht_detach(struct static_nexthop *nh)
+{
+	if (!nh->nhtd)
+		return;
+
+	static_nht_dep_list_del(&nh->nhtd->deps, nh);
+	nh->nhtd = NULL;
+}
+
 void static_zebra_nht_register(struct route_node *rn, struct static_nexthop *nh,
 			       bool reg)
 {
 	struct static_nht_data *nhtd, lookup;
 	uint32_t cmd;
 	struct prefix p;
-	afi_t afi = AFI_IP;
 
 	cmd = (reg) ?
 		ZEBRA_NEXTHOP_REGISTER : ZEBRA_NEXTHOP_UNREGISTER;
@@ -288,14 +332,12 @@ void static_zebra_nht_register(struct route_node *rn, struct static_nexthop *nh,
 		p.family = AF_INET;
 		p.prefixlen = IPV4_MAX_BITLEN;
 		p.u.prefix4 = nh->addr.ipv4;
-		afi = AFI_IP;
 		break;
 	case STATIC_IPV6_GATEWAY:
 	case STATIC_IPV6_GATEWAY_IFNAME:
 		p.family = AF_INET6;
 		p.prefixlen = IPV6_MAX_BITLEN;
 		p.u.prefix6 = nh->addr.ipv6;
-		afi = AFI_IP6;
 		break;
 	}
 
@@ -304,18 +346,22 @@ void static_zebra_nht_register(struct route_node *rn, struct static_nexthop *nh,
 	lookup.nh_vrf_id = nh->nh_vrf_id;
 
 	nh->nh_registered = reg;
+	static_zebra_nht_detach(nh);
 
 	if (reg) {
 		nhtd = hash_get(static_nht_hash, &lookup,
 				static_nht_hash_alloc);
 		nhtd->refcount++;
+		nh->nhtd = nhtd;
+		static_nht_dep_list_add_tail(&nhtd->deps, nh);
 
 		DEBUGD(&static_dbg_route,
 		       "Registered nexthop(%pFX) for %pRN %d", &p, rn,
 		       nhtd->nh_num);
 		if (nhtd->refcount > 1 && nhtd->nh_num) {
-			static_nht_update(&rn->p, nhtd->nh, nhtd->nh_num, afi,
-					  nh->nh_vrf_id);
+			/* Already resolved, no need to wait for zebra */
+			nh->nh_valid = true;
+			static_install_path_queue(rn, nh->pn, nh->safi);
 			return;
 		}
 	} else {
@@ -343,7 +389,6 @@ int static_zebra_nh_update(struct route_node *rn, struct static_nexthop *nh)
 {
 	struct static_nht_data *nhtd, lookup = {};
 	struct prefix p = {};
-	afi_t afi = AFI_IP;
 
 	if (!nh->nh_registered)
 		return 0;
@@ -357,14 +402,12 @@ int static_zebra_nh_update(struct route_node *rn, struct static_nexthop *nh)
 		p.family = AF_INET;
 		p.prefixlen = IPV4_MAX_BITLEN;
 		p.u.prefix4 = nh->addr.ipv4;
-		afi = AFI_IP;
 		break;
 	case STATIC_IPV6_GATEWAY:
 	case STATIC_IPV6_GATEWAY_IFNAME:
 		p.family = AF_INET6;
 		p.prefixlen = IPV6_MAX_BITLEN;
 		p.u.prefix6 = nh->addr.ipv6;
-		afi = AFI_IP6;
 		break;
 	}
 
@@ -374,8 +417,8 @@ int static_zebra_nh_update(struct route_node *rn, struct static_nexthop *nh)
 	nhtd = hash_lookup(static_nht_hash, &lookup);
 	if (nhtd && nhtd->nh_num) {
 		nh->state = STATIC_START;
-		static_nht_update(&rn->p, nhtd->nh, nhtd->nh_num, afi,
-				  nh->nh_vrf_id);
+		nh->nh_valid = true;
+		static_install_path_queue(rn, nh->pn, nh->safi);
 		return 1;
 	}
 	return 0;
@@ -299,6 +299,9 @@ static int topology_load_node_level(const struct isis_topology *topology,
 				      AF_INET6, &next_label);
 	}
 
+	/* SPF reads reachability from the PDU */
+	lsp_pack_pdu(lsp);
+
 	return 0;
 }
 
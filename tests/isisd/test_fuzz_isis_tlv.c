@@ -12,6 +12,7 @@
 #include "thread.h"
 
 #include "isisd/isis_circuit.h"
+#include "isisd/isis_mt.h"
 #include "isisd/isis_tlvs.h"
 
 #include "test_common.h"
@@ -71,6 +72,160 @@ static char *sortlines(char *in)
 	return rv;
 }
 
+/*
+ * The reachability view of the packed TLVs has to yield the same items as
+ * the unpacked TLVs.
+ */
+static void check_view_prefix_sids(const struct isis_reach_view *r,
+				   struct isis_subtlvs *subtlvs)
+{
+	struct isis_prefix_sid sid;
+	bool seen[256] = {};
+
+	for (struct isis_item *i = subtlvs ? subtlvs->prefix_sids.head : NULL;
+	     i; i = i->next) {
+		struct isis_prefix_sid *psid = (struct isis_prefix_sid *)i;
+
+		if (seen[psid->algorithm])
+			continue;
+		seen[psid->algorithm] = true;
+
+		assert(isis_reach_view_prefix_sid(r, psid->algorithm, &sid));
+		assert(sid.flags == psid->flags);
+		assert(sid.value == psid->value);
+	}
+
+	for (unsigned int algorithm = 0; algorithm < 256; algorithm++) {
+		if (!seen[algorithm])
+			assert(!isis_reach_view_prefix_sid(r, algorithm, &sid));
+	}
+}
+
+static void check_view_item(const struct isis_reach_view *r,
+			    struct isis_item *i)
+{
+	struct prefix_ipv6 src;
+
+	switch (r->kind) {
+	case ISIS_REACH_OLDSTYLE_IS: {
+		struct isis_oldstyle_reach *reach =
+			(struct isis_oldstyle_reach *)i;
+
+		assert(r->metric == reach->metric);
+		assert(!memcmp(r->id, reach->id, sizeof(reach->id)));
+		break;
+	}
+	case ISIS_REACH_EXTENDED_IS: {
+		struct isis_extended_reach *reach =
+			(struct isis_extended_reach *)i;
+
+		assert(r->metric == reach->metric);
+		assert(!memcmp(r->id, reach->id, sizeof(reach->id)));
+		break;
+	}
+	case ISIS_REACH_OLDSTYLE_IP:
+	case ISIS_REACH_OLDSTYLE_IP_EXT: {
+		struct isis_oldstyle_ip_reach *reach =
+			(struct isis_oldstyle_ip_reach *)i;
+
+		assert(r->metric == reach->metric);
+		assert(r->prefix.family == AF_INET);
+		assert(r->prefix.prefixlen == reach->prefix.prefixlen);
+		assert(r->prefix.u.prefix4.s_addr
+		       == reach->prefix.prefix.s_addr);
+		break;
+	}
+	case ISIS_REACH_EXTENDED_IP: {
+		struct isis_extended_ip_reach *reach =
+			(struct isis_extended_ip_reach *)i;
+
+		assert(r->metric == reach->metric);
+		assert(r->down == reach->down);
+		assert(prefix_same(&r->prefix,
+				   (struct prefix *)&reach->prefix));
+		check_view_prefix_sids(r, reach->subtlvs);
+		break;
+	}
+	case ISIS_REACH_IPV6: {
+		struct isis_ipv6_reach *reach = (struct isis_ipv6_reach *)i;
+
+		assert(r->metric == reach->metric);
+		assert(r->down == reach->down);
+		assert(r->external == reach->external);
+		assert(prefix_same(&r->prefix,
+				   (struct prefix *)&reach->prefix));
+		check_view_prefix_sids(r, reach->subtlvs);
+		if (reach->subtlvs && reach->subtlvs->source_prefix) {
+			assert(isis_reach_view_source_prefix(r, &src));
+			assert(prefix_same((struct prefix *)&src,
+					   (struct prefix *)reach->subtlvs
+						   ->source_prefix));
+		} else {
+			assert(!isis_reach_view_source_prefix(r, &src));
+		}
+		break;
+	}
+	}
+}
+
+static void check_view_items(const struct isis_tlvs_view *view,
+			     enum isis_reach_kind kind, uint16_t mtid,
+			     struct isis_item_list *items)
+{
+	struct isis_reach_iter it;
+	struct isis_reach_view r;
+	struct isis_item *i = items ? items->head : NULL;
+
+	isis_reach_iter_init(&it, view, kind, mtid);
+	while (isis_reach_iter_next(&it, &r)) {
+		assert(i);
+		check_view_item(&r, i);
+		i = i->next;
+	}
+	assert(!i);
+}
+
+static void check_view(const struct isis_tlvs_view *view,
+		       struct isis_tlvs *tlvs)
+{
+	check_view_items(view, ISIS_REACH_OLDSTYLE_IS, ISIS_MT_IPV4_UNICAST,
+			 &tlvs->oldstyle_reach);
+	check_view_items(view, ISIS_REACH_EXTENDED_IS, ISIS_MT_IPV4_UNICAST,
+			 &tlvs->extended_reach);
+	check_view_items(view, ISIS_REACH_OLDSTYLE_IP, ISIS_MT_IPV4_UNICAST,
+			 &tlvs->oldstyle_ip_reach);
+	check_view_items(view, ISIS_REACH_OLDSTYLE_IP_EXT,
+			 ISIS_MT_IPV4_UNICAST, &tlvs->oldstyle_ip_reach_ext);
+	check_view_items(view, ISIS_REACH_EXTENDED_IP, ISIS_MT_IPV4_UNICAST,
+			 &tlvs->extended_ip_reach);
+	check_view_items(view, ISIS_REACH_IPV6, ISIS_MT_IPV4_UNICAST,
+			 &tlvs->ipv6_reach);
+
+	/* other topologies, as found in the MT TLVs */
+	for (size_t pos = 0; pos < view->len;
+	     pos += 2 + view->data[pos + 1]) {
+		uint8_t type = view->data[pos];
+		uint16_t mtid;
+
+		if (!IS_COMPAT_MT_TLV(type))
+			continue;
+		mtid = ((view->data[pos + 2] << 8) | view->data[pos + 3])
+		       & ISIS_MT_MASK;
+		if (mtid == ISIS_MT_IPV4_UNICAST)
+			continue;
+
+		check_view_items(view, ISIS_REACH_EXTENDED_IS, mtid,
+				 isis_lookup_mt_items(&tlvs->mt_reach, mtid));
+		check_view_items(view, ISIS_REACH_EXTENDED_IP, mtid,
+				 isis_lookup_mt_items(&tlvs->mt_ip_reach,
+						      mtid));
+		check_view_items(view, ISIS_REACH_IPV6, mtid,
+				 isis_lookup_mt_items(&tlvs->mt_ipv6_reach,
+						      mtid));
+		check_view_items(view, ISIS_REACH_OLDSTYLE_IS, mtid, NULL);
+	}
+}
+
 static int test(FILE *input, FILE *output)
 {
 	struct stream *s = stream_new(TEST_STREAM_SIZE);
@@ -96,6 +251,9 @@ static int test(FILE *input, FILE *output)
 	}
 
 	stream_set_getp(s, 0);
+	struct isis_tlvs_view view;
+	bool view_valid = !isis_tlvs_view_init(&view, STREAM_DATA(s),
+					       STREAM_READABLE(s));
 	struct isis_tlvs *tlvs;
 	const char *log;
 	int rv = isis_unpack_tlvs(STREAM_READABLE(s), s, &tlvs, &log);
@@ -111,6 +269,9 @@ static int test(FILE *input, FILE *output)
 	const char *s_tlvs = isis_format_tlvs(tlvs);
 	fprintf(output, "Unpacked TLVs:\n%s", s_tlvs);
 
+	assert(view_valid);
+	check_view(&view, tlvs);
+
 	struct isis_item *orig_auth = tlvs->isis_auth.head;
 	tlvs->isis_auth.head = NULL;
 	s_tlvs = isis_format_tlvs(tlvs);
@@ -0,0 +1,197 @@
+/*
+ * Regeneration of a large own LSP.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <zebra.h>
+
+#include "isisd/isis_lsp.c"
+
+#include "test_common.h"
+
+/* Enough redistributed prefixes to fill more than ten fragments */
+#define NB_PREFIXES 2000
+
+static const uint8_t sysid[ISIS_SYS_ID_LEN] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x01
+};
+
+/*
+ * Redistributed IPv4 prefixes of the area at level 2, set up like
+ * isis_redist_set() does, without subscribing to zebra.
+ */
+static struct route_table *ext_reach(struct isis_area *area)
+{
+	/* IPv4 is redistribution protocol 0, see redist_protocol() */
+	if (!area->ext_reach[0][IS_LEVEL_2 - 1])
+		area->ext_reach[0][IS_LEVEL_2 - 1] = srcdest_table_init();
+
+	return get_ext_reach(area, AF_INET, IS_LEVEL_2);
+}
+
+static void prefix_nth(struct prefix *p, unsigned int n)
+{
+	memset(p, 0, sizeof(*p));
+	p->family = AF_INET;
+	p->prefixlen = IPV4_MAX_BITLEN;
+	p->u.prefix4.s_addr = htonl(0x0a000000 + n);
+}
+
+static void redist_set(struct isis_area *area, unsigned int n, uint32_t metric)
+{
+	struct isis_ext_info *info;
+	struct route_node *rn;
+	struct prefix p;
+
+	prefix_nth(&p, n);
+	rn = srcdest_rnode_get(ext_reach(area), &p, NULL);
+	if (rn->info)
+		route_unlock_node(rn);
+	else
+		rn->info = XCALLOC(MTYPE_TMP, sizeof(*info));
+
+	info = rn->info;
+	info->origin = ZEBRA_ROUTE_STATIC;
+	info->distance = 1;
+	info->metric = metric;
+}
+
+static void redist_unset(struct isis_area *area, unsigned int n)
+{
+	struct route_node *rn;
+	struct prefix p;
+
+	prefix_nth(&p, n);
+	rn = srcdest_rnode_lookup(ext_reach(area), &p, NULL);
+	assert(rn && rn->info);
+	route_unlock_node(rn);
+
+	XFREE(MTYPE_TMP, rn->info);
+	route_unlock_node(rn);
+}
+
+/* Sequence numbers of our level-2 LSP fragments, 0 for those not in use */
+static void lsp_seqnos(struct isis_area *area, uint32_t seqnos[256])
+{
+	uint8_t lspid[ISIS_SYS_ID_LEN + 2] = {};
+	struct isis_lsp *lsp;
+
+	memcpy(lspid, sysid, ISIS_SYS_ID_LEN);
+	for (int i = 0; i < 256; i++) {
+		LSP_FRAGMENT(lspid) = i;
+		lsp = lsp_search(&area->lspdb[IS_LEVEL_2 - 1], lspid);
+		seqnos[i] = (lsp && lsp->tlvs) ? lsp->hdr.seqno : 0;
+	}
+}
+
+/* Regenerates our LSP, returns how many fragments got a new seqno */
+static unsigned int regenerate(struct isis_area *area, uint32_t seqnos[256])
+{
+	uint32_t old[256];
+	unsigned int changed = 0;
+
+	memcpy(old, seqnos, sizeof(old));
+	assert(lsp_regenerate(area, IS_LEVEL_2) == ISIS_OK);
+	lsp_seqnos(area, seqnos);
+
+	for (int i = 0; i < 256; i++) {
+		if (seqnos[i] != old[i])
+			changed++;
+	}
+
+	return changed;
+}
+
+static void test_lsp_regenerate(struct isis_area *area)
+{
+	uint32_t seqnos[256];
+	unsigned int frags = 0;
+
+	for (unsigned int i = 0; i < NB_PREFIXES; i++)
+		redist_set(area, i, 10);
+
+	assert(lsp_generate(area, IS_LEVEL_2) == ISIS_OK);
+	lsp_seqnos(area, seqnos);
+	for (int i = 0; i < 256; i++) {
+		if (seqnos[i])
+			frags++;
+	}
+	assert(frags > 10);
+
+	/* Nothing changed, nothing is reoriginated */
+	assert(regenerate(area, seqnos) == 0);
+
+	/* Only the fragment carrying a changed prefix is reoriginated */
+	redist_set(area, NB_PREFIXES / 2, 20);
+	assert(regenerate(area, seqnos) == 1);
+
+	redist_unset(area, 0);
+	assert(regenerate(area, seqnos) == 1);
+
+	/* A new prefix goes into one fragment with room, the rest stay put */
+	redist_set(area, NB_PREFIXES, 10);
+	assert(regenerate(area, seqnos) == 1);
+
+	/* Changes far apart land in two different fragments */
+	redist_set(area, NB_PREFIXES - 1, 30);
+	redist_unset(area, NB_PREFIXES / 2);
+	assert(regenerate(area, seqnos) == 2);
+
+	assert(regenerate(area, seqnos) == 0);
+}
+
+static void redist_finish(struct isis_area *area)
+{
+	struct route_table *table = ext_reach(area);
+	struct route_node *rn;
+
+	for (rn = route_top(table); rn; rn = srcdest_route_next(rn))
+		XFREE(MTYPE_TMP, rn->info);
+
+	route_table_finish(table);
+	area->ext_reach[0][IS_LEVEL_2 - 1] = NULL;
+}
+
+int main(int argc, char **argv)
+{
+	struct isis *isis;
+	struct isis_area *area;
+
+	/* master init. */
+	master = thread_master_create(NULL);
+	isis_master_init(master);
+
+	/* Library inits. */
+	cmd_init(1);
+	cmd_hostname_set("test");
+	yang_init(true);
+	zlog_aux_init("NONE: ", ZLOG_DISABLED);
+
+	/* IS-IS inits. */
+	yang_module_load("frr-isisd");
+	isis = isis_new(VRF_DEFAULT_NAME);
+	listnode_add(im->isis, isis);
+	SET_FLAG(im->options, F_ISIS_UNIT_TEST);
+
+	area = isis_area_create("1", NULL);
+	memcpy(area->isis->sysid, sysid, ISIS_SYS_ID_LEN);
+	area->isis->sysid_set = 1;
+	test_lsp_regenerate(area);
+
+	redist_finish(area);
+	isis_area_destroy(area);
+	return 0;
+}
@@ -0,0 +1,8 @@
+import frrtest
+
+
+class TestIsisLSPRegen(frrtest.TestMultiOut):
+    program = "./test_isis_lsp_regen"
+
+
+TestIsisLSPRegen.exit_cleanly()
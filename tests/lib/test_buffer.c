@@ -51,6 +51,22 @@ int main(int argc, char **argv)
 		buffer_reset(b1);
 		buffer_reset(b2);
 	}
+
+	/* formatted output larger than the room left in the tail chunk */
+	char big[3000], *str;
+
+	memset(big, 'x', sizeof(big) - 1);
+	big[sizeof(big) - 1] = '\0';
+	buffer_put(b2, "abc", 3);
+	buffer_printf(b2, "%s-%d", big, 42);
+	buffer_printf(b2, "%s", "");
+	str = buffer_getstr(b2);
+	assert(strlen(str) == 3 + strlen(big) + 3);
+	assert(!strncmp(str, "abcxxx", 6));
+	assert(!strcmp(str + strlen(str) - 3, "-42"));
+	XFREE(MTYPE_TMP, str);
+	buffer_reset(b2);
+
 	buffer_free(b1);
 	buffer_free(b2);
 	return 0;
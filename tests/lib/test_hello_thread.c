@@ -0,0 +1,247 @@
+/*
+ * Hello pthread tests.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <zebra.h>
+
+#include "frr_pthread.h"
+#include "hello_thread.h"
+#include "log.h"
+#include "thread.h"
+
+#define NB_TXS 32
+
+static struct thread_master *master;
+
+/* hellos go from tx_fd to rx_fd over loopback */
+static int tx_fd, rx_fd;
+static struct sockaddr_in rx_addr;
+
+struct tx_state {
+	struct hello_tx *tx;
+	bool alive;
+	unsigned int refreshed;
+};
+
+static int event_done(struct thread *t)
+{
+	bool *done = THREAD_ARG(t);
+
+	*done = true;
+	return 0;
+}
+
+/* Run the event loop for msec */
+static void run_event_loop(long msec)
+{
+	struct thread thread;
+	bool done = false;
+
+	thread_add_timer_msec(master, event_done, &done, msec, NULL);
+	while (!done && thread_fetch(master, &thread))
+		thread_call(&thread);
+}
+
+static unsigned int rx_count(void)
+{
+	char buf[64];
+	unsigned int count = 0;
+
+	while (recv(rx_fd, buf, sizeof(buf), MSG_DONTWAIT) > 0)
+		count++;
+	return count;
+}
+
+static void tx_refresh(void *arg)
+{
+	struct tx_state *state = arg;
+
+	/* never called once the transmitter is freed */
+	assert(state->alive);
+	state->refreshed++;
+}
+
+static void tx_start(struct tx_state *state, uint32_t interval_msec,
+		     bool send_now)
+{
+	state->alive = true;
+	state->tx = hello_tx_new(tx_refresh, state);
+	hello_tx_set_interval(state->tx, interval_msec, 0);
+	hello_tx_update(state->tx, tx_fd, (struct sockaddr *)&rx_addr,
+			sizeof(rx_addr), 0, "hello", 5, send_now);
+}
+
+static void tx_stop(struct tx_state *state)
+{
+	hello_tx_free(&state->tx);
+	assert(!state->tx);
+	state->alive = false;
+}
+
+/* Hellos keep going out, and the main pthread gets to refresh them */
+static void test_tx(void)
+{
+	struct tx_state state = {};
+	unsigned int sent, received;
+
+	tx_start(&state, 50, true);
+	assert(hello_tx_collect(state.tx) == 1);
+	assert(rx_count() == 1);
+	assert(hello_tx_remain_msec(state.tx) >= 0);
+	assert(hello_tx_remain_msec(state.tx) <= 50);
+
+	run_event_loop(320);
+	sent = hello_tx_collect(state.tx);
+	received = rx_count();
+	assert(sent >= 3 && sent <= 10);
+	assert(received == sent);
+	assert(state.refreshed >= 2);
+
+	/* A zero interval stops transmission */
+	hello_tx_set_interval(state.tx, 0, 0);
+	assert(hello_tx_remain_msec(state.tx) == -1);
+	run_event_loop(120);
+	assert(hello_tx_collect(state.tx) == 0);
+	assert(rx_count() == 0);
+
+	tx_stop(&state);
+}
+
+/*
+ * Transmitters come and go while the hello pthread is busy sending; those
+ * that are gone neither send nor get refresh callbacks anymore.
+ */
+static void test_tx_churn(void)
+{
+	struct tx_state states[NB_TXS] = {};
+	unsigned int sent = 0;
+
+	for (int i = 0; i < NB_TXS; i++)
+		tx_start(&states[i], 5, false);
+
+	for (int round = 0; round < 20; round++) {
+		for (int i = round % 2; i < NB_TXS; i += 2) {
+			sent += hello_tx_collect(states[i].tx);
+			tx_stop(&states[i]);
+		}
+		run_event_loop(5);
+		for (int i = round % 2; i < NB_TXS; i += 2)
+			tx_start(&states[i], 5, false);
+		run_event_loop(5);
+	}
+
+	for (int i = 0; i < NB_TXS; i++) {
+		sent += hello_tx_collect(states[i].tx);
+		tx_stop(&states[i]);
+	}
+	assert(sent > 0);
+
+	/* Nothing is left to send or refresh */
+	run_event_loop(50);
+	rx_count();
+	run_event_loop(50);
+	assert(rx_count() == 0);
+}
+
+static void hold_expire(void *arg)
+{
+	unsigned int *expired = arg;
+
+	(*expired)++;
+}
+
+static void test_hold(void)
+{
+	struct hello_hold *hold;
+	unsigned int expired = 0;
+
+	hold = hello_hold_new(hold_expire, &expired);
+	assert(hello_hold_remain_msec(hold) == -1);
+
+	/* Expiry */
+	hello_hold_refresh(hold, 50);
+	assert(hello_hold_remain_msec(hold) > 0);
+	run_event_loop(20);
+	assert(expired == 0);
+	run_event_loop(100);
+	assert(expired == 1);
+	assert(hello_hold_remain_msec(hold) == -1);
+
+	/*
+	 * The main pthread is busy past the deadline, but a hello arrived in
+	 * the meantime: the expiry the hello pthread posted is not confirmed.
+	 */
+	hello_hold_refresh(hold, 50);
+	usleep(100 * 1000);
+	hello_hold_refresh(hold, 200);
+	run_event_loop(50);
+	assert(expired == 1);
+	assert(hello_hold_remain_msec(hold) > 0);
+
+	/* Without a hello, the posted expiry is confirmed */
+	hello_hold_refresh(hold, 50);
+	usleep(100 * 1000);
+	run_event_loop(50);
+	assert(expired == 2);
+
+	/* A stopped hold timer doesn't expire */
+	hello_hold_refresh(hold, 50);
+	usleep(100 * 1000);
+	hello_hold_stop(hold);
+	run_event_loop(100);
+	assert(expired == 2);
+
+	/* Nor does a freed one with an expiry posted */
+	hello_hold_refresh(hold, 20);
+	usleep(50 * 1000);
+	hello_hold_free(&hold);
+	assert(!hold);
+	run_event_loop(50);
+	assert(expired == 2);
+}
+
+int main(int argc, char **argv)
+{
+	socklen_t len = sizeof(rx_addr);
+	int ret;
+
+	master = thread_master_create(NULL);
+	zlog_aux_init("NONE: ", ZLOG_DISABLED);
+
+	rx_fd = socket(AF_INET, SOCK_DGRAM, 0);
+	tx_fd = socket(AF_INET, SOCK_DGRAM, 0);
+	assert(rx_fd >= 0 && tx_fd >= 0);
+	rx_addr.sin_family = AF_INET;
+	rx_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	ret = bind(rx_fd, (struct sockaddr *)&rx_addr, sizeof(rx_addr));
+	assert(ret == 0);
+	ret = getsockname(rx_fd, (struct sockaddr *)&rx_addr, &len);
+	assert(ret == 0);
+
+	frr_pthread_init();
+	hello_thread_start(master);
+
+	test_tx();
+	test_tx_churn();
+	test_hold();
+
+	frr_pthread_finish();
+	close(tx_fd);
+	close(rx_fd);
+	thread_master_free(master);
+	return 0;
+}
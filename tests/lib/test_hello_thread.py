@@ -0,0 +1,8 @@
+import frrtest
+
+
+class TestHelloThread(frrtest.TestMultiOut):
+    program = "./test_hello_thread"
+
+
+TestHelloThread.exit_cleanly()
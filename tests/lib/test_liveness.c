@@ -0,0 +1,151 @@
+/*
+ * Event loop liveness tests.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <zebra.h>
+
+#include "liveness.h"
+#include "log.h"
+#include "thread.h"
+
+static struct thread_master *master;
+static char path[MAXPATHLEN];
+
+static int event_done(struct thread *t)
+{
+	bool *done = THREAD_ARG(t);
+
+	*done = true;
+	return 0;
+}
+
+/* Run the event loop until a task scheduled now has run */
+static void run_event_loop(void)
+{
+	struct thread thread;
+	bool done = false;
+
+	thread_add_event(master, event_done, &done, 0, NULL);
+	while (!done && thread_fetch(master, &thread))
+		thread_call(&thread);
+}
+
+static enum frr_liveness_phase mapped_phase(struct frr_liveness *live)
+{
+	return atomic_load_explicit(&live->phase, memory_order_relaxed);
+}
+
+static uint64_t mapped_heartbeat(struct frr_liveness *live)
+{
+	return atomic_load_explicit(&live->heartbeat, memory_order_relaxed);
+}
+
+/* The page watchfrr maps follows the daemon's event loop and phase */
+static void test_phases(void)
+{
+	struct frr_liveness *live;
+	uint64_t heartbeat;
+
+	/* Without a page, daemons count as running */
+	assert(frr_liveness_get_phase() == FRR_LIVENESS_RUNNING);
+	assert(frr_liveness_map(path) == NULL);
+
+	frr_liveness_start(master, path);
+	live = frr_liveness_map(path);
+	assert(live);
+	assert(live->pid == getpid());
+
+	/* Configuration has not been read yet */
+	assert(frr_liveness_get_phase() == FRR_LIVENESS_STARTUP);
+	assert(mapped_phase(live) == FRR_LIVENESS_STARTUP);
+
+	frr_liveness_set_phase(FRR_LIVENESS_CONVERGING);
+	assert(mapped_phase(live) == FRR_LIVENESS_CONVERGING);
+
+	frr_liveness_set_phase(FRR_LIVENESS_RUNNING);
+	assert(frr_liveness_get_phase() == FRR_LIVENESS_RUNNING);
+	assert(mapped_phase(live) == FRR_LIVENESS_RUNNING);
+
+	/* Each pass through the event loop is a heartbeat */
+	heartbeat = mapped_heartbeat(live);
+	run_event_loop();
+	assert(mapped_heartbeat(live) > heartbeat);
+	assert(frr_liveness_lag(live) >= 0);
+	assert(frr_liveness_lag(live) < 100 * 1000);
+
+	/* A task that doesn't return shows up as lag */
+	usleep(200 * 1000);
+	assert(frr_liveness_lag(live) >= 200 * 1000);
+	run_event_loop();
+	assert(frr_liveness_lag(live) < 100 * 1000);
+
+	frr_liveness_unmap(live);
+	frr_liveness_stop();
+}
+
+/* A restarted daemon replaces the page; old mappings stay valid but stale */
+static void test_restart(void)
+{
+	struct frr_liveness *old, *live;
+
+	frr_liveness_start(master, path);
+	frr_liveness_set_phase(FRR_LIVENESS_CONVERGING);
+	old = frr_liveness_map(path);
+	assert(old);
+	frr_liveness_stop();
+
+	/* The file is gone, the daemon no longer publishes a phase */
+	assert(frr_liveness_map(path) == NULL);
+	assert(frr_liveness_get_phase() == FRR_LIVENESS_RUNNING);
+
+	frr_liveness_start(master, path);
+	live = frr_liveness_map(path);
+	assert(live && live != old);
+	assert(mapped_phase(live) == FRR_LIVENESS_STARTUP);
+
+	/* The old page is left as the previous instance last wrote it */
+	assert(mapped_phase(old) == FRR_LIVENESS_CONVERGING);
+	usleep(50 * 1000);
+	run_event_loop();
+	assert(frr_liveness_lag(old) >= 50 * 1000);
+	assert(frr_liveness_lag(live) < 50 * 1000);
+
+	frr_liveness_unmap(old);
+	frr_liveness_unmap(live);
+	frr_liveness_stop();
+}
+
+int main(int argc, char **argv)
+{
+	char dir[] = "/tmp/test_liveness.XXXXXX";
+
+	if (!mkdtemp(dir)) {
+		perror("mkdtemp");
+		return 1;
+	}
+	snprintf(path, sizeof(path), "%s/test.live", dir);
+
+	master = thread_master_create(NULL);
+	zlog_aux_init("NONE: ", ZLOG_DISABLED);
+
+	test_phases();
+	test_restart();
+
+	rmdir(dir);
+	thread_master_free(master);
+	return 0;
+}
@@ -0,0 +1,8 @@
+import frrtest
+
+
+class TestLiveness(frrtest.TestMultiOut):
+    program = "./test_liveness"
+
+
+TestLiveness.exit_cleanly()
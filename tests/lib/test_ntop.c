@@ -22,6 +22,7 @@
 #endif
 
 #include <assert.h>
+#include <time.h>
 
 #include "tests/helpers/c/prng.h"
 
@@ -30,14 +31,53 @@
 #define INET_NTOP_NO_OVERRIDE
 #include "lib/ntop.c"
 
+#define BENCH_ITER 2000000
+
+static double bench_time(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* not run by default; "test_ntop bench" prints ns per call */
+static void bench(int af, const void *addrs, size_t addrsize, size_t count)
+{
+	const uint8_t *a = addrs;
+	char buf[64];
+	size_t i, sum = 0;
+	double t0, t1, t2, t3;
+
+	t0 = bench_time();
+	for (i = 0; i < BENCH_ITER; i++)
+		sum += !!inet_ntop(af, a + (i % count) * addrsize, buf,
+				   sizeof(buf));
+	t1 = bench_time();
+	for (i = 0; i < BENCH_ITER; i++)
+		sum += !!frr_inet_ntop(af, a + (i % count) * addrsize, buf,
+				       sizeof(buf));
+	t2 = bench_time();
+	for (i = 0; i < BENCH_ITER; i++)
+		sum += frr_inet_ntop_fast(af, a + (i % count) * addrsize, buf);
+	t3 = bench_time();
+
+	printf("%s: libc %.1fns, frr_inet_ntop %.1fns, frr_inet_ntop_fast %.1fns (%zu)\n",
+	       af == AF_INET ? "IPv4" : "IPv6",
+	       (t1 - t0) * 1e9 / BENCH_ITER, (t2 - t1) * 1e9 / BENCH_ITER,
+	       (t3 - t2) * 1e9 / BENCH_ITER, sum);
+}
+
 int main(int argc, char **argv)
 {
 	size_t i, j, k, l;
 	struct in_addr i4;
 	struct in6_addr i6, i6check;
-	char buf1[64], buf2[64];
+	char buf1[64], buf2[64], buf3[64];
 	const char *rv;
 	struct prng *prng;
+	static struct in_addr bench4[1024];
+	static struct in6_addr bench6[1024];
 
 	prng = prng_new(0);
 	/* IPv4 */
@@ -46,6 +86,17 @@ int main(int argc, char **argv)
 		assert(frr_inet_ntop(AF_INET, &i4, buf1, sizeof(buf1)));
 		assert(inet_ntop(AF_INET, &i4, buf2, sizeof(buf2)));
 		assert(!strcmp(buf1, buf2));
+		assert(frr_inet_ntop_fast(AF_INET, &i4, buf3) == strlen(buf1));
+		assert(!strcmp(buf1, buf3));
+		bench4[i % array_size(bench4)] = i4;
+	}
+
+	/* every octet value in every position */
+	for (i = 0; i < 256; i++) {
+		i4.s_addr = htonl(i * 0x01010101U);
+		assert(frr_inet_ntop(AF_INET, &i4, buf1, sizeof(buf1)));
+		assert(inet_ntop(AF_INET, &i4, buf2, sizeof(buf2)));
+		assert(!strcmp(buf1, buf2));
 	}
 
 	/* check size limit */
@@ -81,6 +132,19 @@ int main(int argc, char **argv)
 
 		assert(inet_pton(AF_INET6, buf1, &i6check));
 		assert(!memcmp(&i6, &i6check, sizeof(i6)));
+
+		assert(frr_inet_ntop_fast(AF_INET6, &i6, buf3) == strlen(buf1));
+		assert(!strcmp(buf1, buf3));
+		bench6[i % array_size(bench6)] = i6;
+	}
+
+	assert(!frr_inet_ntop(AF_UNSPEC, &i6, buf1, sizeof(buf1)));
+	assert(frr_inet_ntop_fast(AF_UNSPEC, &i6, buf1) == 0 && !*buf1);
+
+	if (argc > 1 && !strcmp(argv[1], "bench")) {
+		bench(AF_INET, bench4, sizeof(bench4[0]), array_size(bench4));
+		bench(AF_INET6, bench6, sizeof(bench6[0]), array_size(bench6));
 	}
+	prng_free(prng);
 	return 0;
 }
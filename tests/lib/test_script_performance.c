@@ -0,0 +1,135 @@
+/*
+ * Test program which measures scripted route-map style policy throughput,
+ * with a script loaded for every call and with a cached script.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <zebra.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include "prefix.h"
+#include "memory.h"
+#include "monotime.h"
+#include "frrscript.h"
+
+#ifdef HAVE_SCRIPTING
+
+#define CALLS_LOAD   10000
+#define CALLS_CACHED 1000000
+
+static const char script[] =
+	"if prefix.length > 24 then\n"
+	"  action = RM_NOMATCH\n"
+	"else\n"
+	"  action = RM_MATCH\n"
+	"end\n";
+
+static long long status_nomatch = 1, status_match = 2;
+
+static void run(struct frrscript *fs, uint32_t i)
+{
+	struct prefix p = {.family = AF_INET};
+	long long action = 0;
+	long long *result;
+
+	p.u.prefix4.s_addr = htonl(0x0a000000 | (i << 8));
+	p.prefixlen = 16 + i % 16;
+
+	struct frrscript_env env[] = {
+		{"integer", "RM_NOMATCH", &status_nomatch},
+		{"integer", "RM_MATCH", &status_match},
+		{"integer", "action", &action},
+		{"prefix", "prefix", &p},
+		{}};
+	struct frrscript_env res = {"integer", "action"};
+
+	if (frrscript_call(fs, env)) {
+		fprintf(stderr, "script call failed\n");
+		exit(1);
+	}
+
+	result = frrscript_get_result(fs, &res);
+	if (*result != (p.prefixlen > 24 ? status_nomatch : status_match)) {
+		fprintf(stderr, "wrong script result\n");
+		exit(1);
+	}
+	XFREE(MTYPE_TMP, result);
+}
+
+static void report(const char *what, uint32_t calls, int64_t us)
+{
+	printf("%-8s %8u calls in %8.3f s, %10.0f calls/s\n", what, calls,
+	       us / 1e6, calls * 1e6 / (us ? us : 1));
+}
+
+int main(int argc, char **argv)
+{
+	char dir[] = "/tmp/frrscript_perf.XXXXXX";
+	char path[sizeof(dir) + 32];
+	struct frrscript *fs;
+	struct timeval start;
+	FILE *fp;
+	uint32_t i;
+
+	if (!mkdtemp(dir)) {
+		perror("mkdtemp");
+		return 1;
+	}
+	snprintf(path, sizeof(path), "%s/policy.lua", dir);
+	fp = fopen(path, "w");
+	if (!fp) {
+		perror(path);
+		return 1;
+	}
+	fputs(script, fp);
+	fclose(fp);
+
+	frrscript_init(dir);
+
+	monotime(&start);
+	for (i = 0; i < CALLS_LOAD; i++) {
+		fs = frrscript_load("policy", NULL);
+		assert(fs);
+		run(fs, i);
+		frrscript_unload(fs);
+	}
+	report("load", CALLS_LOAD, monotime_since(&start, NULL));
+
+	monotime(&start);
+	for (i = 0; i < CALLS_CACHED; i++) {
+		fs = frrscript_get("policy");
+		assert(fs);
+		run(fs, i);
+	}
+	report("cached", CALLS_CACHED, monotime_since(&start, NULL));
+	fflush(stdout);
+
+	unlink(path);
+	rmdir(dir);
+	return 0;
+}
+
+#else /* !HAVE_SCRIPTING */
+
+int main(int argc, char **argv)
+{
+	printf("scripting support not enabled, nothing to measure\n");
+	return 0;
+}
+
+#endif /* HAVE_SCRIPTING */
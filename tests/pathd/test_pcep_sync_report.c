@@ -0,0 +1,210 @@
+/*
+ * pathd PCEP state synchronization tests.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <zebra.h>
+
+#include "pathd/path_pcep_pcc.c"
+
+#include "pceplib/pcep_msg_encoding.h"
+#include "pceplib/pcep_msg_tools.h"
+#include "pceplib/pcep_socket_comm_mock.h"
+
+/* shim out what path_main.c would provide */
+struct thread_master *master;
+struct zebra_privs_t pathd_privs;
+
+static pcep_configuration *config;
+
+/* What the mock PCE received: the state reports carried by each message */
+struct sync_messages {
+	unsigned int count;
+	unsigned int reports[64];
+	uint16_t length[64];
+};
+
+static struct path *new_path(uint32_t color, int num_hops)
+{
+	struct path *path = pcep_new_path();
+	struct path_hop *hop;
+	int i;
+
+	path->nbkey.color = color;
+	path->nbkey.endpoint.ipa_type = IPADDR_V4;
+	inet_pton(AF_INET, "192.0.2.2", &path->nbkey.endpoint.ipaddr_v4);
+	path->nbkey.preference = 100;
+	path->name = XSTRDUP(MTYPE_PCEP, "test");
+	path->type = SRTE_CANDIDATE_TYPE_EXPLICIT;
+	path->status = PCEP_LSP_OPERATIONAL_UP;
+
+	for (i = 0; i < num_hops; i++) {
+		hop = pcep_new_hop();
+		hop->is_mpls = true;
+		hop->has_sid = true;
+		hop->sid.mpls.label = 16000 + i;
+		hop->has_nai = true;
+		hop->nai.type = PCEP_SR_SUBOBJ_NAI_IPV4_NODE;
+		hop->nai.local_addr.ipa_type = IPADDR_V4;
+		hop->nai.local_addr.ipaddr_v4.s_addr = htonl(0x0a000001 + i);
+		hop->next = path->first_hop;
+		path->first_hop = hop;
+	}
+
+	return path;
+}
+
+static struct pcc_state *connect_pcc(void)
+{
+	mock_socket_comm_info *mock_info;
+	struct pcc_state *pcc_state;
+	struct in_addr pce_addr;
+
+	setup_mock_socket_comm_info();
+	mock_info = get_mock_socket_comm_info();
+	mock_info->send_message_save_message = true;
+	initialize_pcc();
+
+	config = create_default_pcep_configuration();
+	pcc_state = pcep_pcc_initialize(NULL, 1);
+	inet_pton(AF_INET, "127.0.0.1", &pce_addr);
+	pcc_state->sess = connect_pce(config, &pce_addr);
+	assert(pcc_state->sess != NULL);
+	pcc_state->status = PCEP_PCC_SYNCHRONIZING;
+	pcc_state->caps.is_stateful = true;
+	inet_pton(AF_INET, "192.0.2.1", &pcc_state->pcc_addr_v4);
+	SET_FLAG(pcc_state->flags, F_PCC_STATE_HAS_IPV4);
+
+	/* Drop the OPEN message */
+	pceplib_free(PCEPLIB_MESSAGES,
+		     dll_delete_first_node(mock_info->sent_message_list));
+
+	return pcc_state;
+}
+
+static void disconnect_pcc(struct pcc_state *pcc_state)
+{
+	destroy_pcep_session(pcc_state->sess);
+	destroy_pcep_configuration(config);
+	destroy_pcc();
+	teardown_mock_socket_comm_info();
+
+	pcc_state->sess = NULL;
+	pcc_state->status = PCEP_PCC_DISCONNECTED;
+	pcep_pcc_finalize(NULL, pcc_state);
+}
+
+/* Synchronize num_paths paths, then decode what the PCE received */
+static void sync_paths(int num_paths, int num_hops,
+		       struct sync_messages *msgs)
+{
+	struct pcc_state *pcc_state = connect_pcc();
+	mock_socket_comm_info *mock_info = get_mock_socket_comm_info();
+	uint32_t expected_plsp_id = 1, plsp_id;
+	struct pcep_object_header *obj;
+	uint16_t length, offset, obj_length;
+	uint8_t *encoded;
+	int i;
+
+	for (i = 1; i <= num_paths; i++) {
+		struct path *path = new_path(i, num_hops);
+
+		pcep_pcc_sync_path(NULL, pcc_state, path);
+		pcep_free_path(path);
+	}
+	pcep_pcc_sync_done(NULL, pcc_state);
+
+	/*
+	 * Walk the objects rather than decoding the messages, the end of
+	 * synchronization marker has no SRP and pceplib rejects it.
+	 */
+	memset(msgs, 0, sizeof(*msgs));
+	while ((encoded = dll_delete_first_node(mock_info->sent_message_list))
+	       != NULL) {
+		assert(msgs->count < array_size(msgs->reports));
+		assert(encoded[1] == PCEP_TYPE_REPORT);
+		length = (encoded[2] << 8) | encoded[3];
+		msgs->length[msgs->count] = length;
+
+		for (offset = MESSAGE_HEADER_LENGTH; offset < length;
+		     offset += obj_length) {
+			obj = pcep_decode_object(encoded + offset);
+			assert(obj != NULL);
+			obj_length = obj->encoded_object_length;
+
+			/* the end-of-sync marker comes after all paths */
+			if (obj->object_class == PCEP_OBJ_CLASS_LSP) {
+				plsp_id = ((struct pcep_object_lsp *)obj)->plsp_id;
+				if (expected_plsp_id > (uint32_t)num_paths)
+					assert(plsp_id == 0);
+				else
+					assert(plsp_id == expected_plsp_id);
+				expected_plsp_id++;
+				msgs->reports[msgs->count]++;
+			}
+			pcep_obj_free_object(obj);
+		}
+		msgs->count++;
+
+		pceplib_free(PCEPLIB_MESSAGES, encoded);
+	}
+	assert(expected_plsp_id == (uint32_t)num_paths + 2);
+
+	disconnect_pcc(pcc_state);
+}
+
+/* Reports are sent MAX_SYNC_REPORTS_PER_MSG per PCRpt */
+static void test_sync_batch(void)
+{
+	struct sync_messages msgs;
+
+	sync_paths(70, 2, &msgs);
+
+	assert(msgs.count == 4);
+	assert(msgs.reports[0] == MAX_SYNC_REPORTS_PER_MSG);
+	assert(msgs.reports[1] == MAX_SYNC_REPORTS_PER_MSG);
+	assert(msgs.reports[2] == 70 - 2 * MAX_SYNC_REPORTS_PER_MSG);
+	assert(msgs.reports[3] == 1);
+}
+
+/* Long paths are split before a PCRpt gets too large to be encoded */
+static void test_sync_batch_split(void)
+{
+	struct sync_messages msgs;
+	unsigned int i, report_length;
+
+	sync_paths(40, 400, &msgs);
+
+	/* all paths have the same size */
+	report_length = (msgs.length[0] - MESSAGE_HEADER_LENGTH)
+			/ msgs.reports[0];
+	assert(report_length * MAX_SYNC_REPORTS_PER_MSG > PCEP_MESSAGE_LENGTH);
+
+	for (i = 0; i < msgs.count - 2; i++) {
+		assert(msgs.length[i] <= PCEP_MESSAGE_LENGTH);
+		assert(msgs.length[i] + report_length > PCEP_MESSAGE_LENGTH);
+		assert(msgs.reports[i] < MAX_SYNC_REPORTS_PER_MSG);
+	}
+	assert(msgs.reports[msgs.count - 1] == 1);
+}
+
+int main(int argc, char **argv)
+{
+	test_sync_batch();
+	test_sync_batch_split();
+
+	return 0;
+}
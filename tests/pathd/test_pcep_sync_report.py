@@ -0,0 +1,8 @@
+import frrtest
+
+
+class TestPcepSyncReport(frrtest.TestMultiOut):
+    program = "./test_pcep_sync_report"
+
+
+TestPcepSyncReport.exit_cleanly()
@@ -0,0 +1,252 @@
+/*
+ * staticd nexthop tracking tests.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <zebra.h>
+
+#include "command.h"
+#include "log.h"
+#include "network.h"
+#include "privs.h"
+#include "stream.h"
+#include "thread.h"
+#include "vrf.h"
+#include "vty.h"
+#include "zclient.h"
+
+#include "staticd/static_vrf.h"
+#include "staticd/static_routes.h"
+#include "staticd/static_zebra.h"
+
+/* shim out what static_main.c would provide */
+struct thread_master *master;
+struct zebra_privs_t static_privs;
+bool mpls_enabled;
+
+extern struct zclient *zclient;
+
+/* Our end of the zclient socket, standing in for zebra */
+static int zebra_sock = -1;
+
+/* ZEBRA_ROUTE_ADDs zebra has received, per prefix */
+static struct {
+	struct prefix p;
+	unsigned int count;
+} route_adds_seen[8];
+
+static void route_adds_count(const struct prefix *p)
+{
+	size_t i;
+
+	for (i = 0; i < array_size(route_adds_seen); i++) {
+		if (!route_adds_seen[i].p.family)
+			prefix_copy(&route_adds_seen[i].p, p);
+		if (prefix_same(&route_adds_seen[i].p, p)) {
+			route_adds_seen[i].count++;
+			return;
+		}
+	}
+	assert(!"too many prefixes");
+}
+
+/* Number of ZEBRA_ROUTE_ADDs for prefix sent since the previous call */
+static unsigned int route_adds(const char *prefix)
+{
+	static uint8_t buf[65536];
+	struct zapi_route api;
+	struct prefix p;
+	struct stream *s;
+	ssize_t nbytes;
+	size_t len = 0, i;
+	unsigned int count = 0;
+
+	while ((nbytes = read(zebra_sock, buf + len, sizeof(buf) - len)) > 0)
+		len += nbytes;
+
+	s = stream_new(sizeof(buf));
+	stream_put(s, buf, len);
+	while (STREAM_READABLE(s) >= ZEBRA_HEADER_SIZE) {
+		size_t start = stream_get_getp(s);
+		uint16_t size, command;
+
+		size = stream_getw(s);
+		stream_forward_getp(s, 6); /* marker, version, vrf_id */
+		command = stream_getw(s);
+
+		if (command == ZEBRA_ROUTE_ADD && !zapi_route_decode(s, &api))
+			route_adds_count(&api.prefix);
+
+		stream_set_getp(s, start + size);
+	}
+	stream_free(s);
+
+	str2prefix(prefix, &p);
+	for (i = 0; i < array_size(route_adds_seen); i++) {
+		if (prefix_same(&route_adds_seen[i].p, &p)) {
+			count = route_adds_seen[i].count;
+			route_adds_seen[i].count = 0;
+		}
+	}
+
+	return count;
+}
+
+/* Have zebra report addr as resolved */
+static void nexthop_resolved(const char *addr)
+{
+	struct stream *s = zclient->ibuf;
+	struct in_addr gate;
+
+	inet_pton(AF_INET, addr, &gate);
+
+	stream_reset(s);
+	stream_putl(s, 0); /* message */
+	stream_putw(s, AF_INET);
+	stream_putc(s, IPV4_MAX_BITLEN);
+	stream_put_in_addr(s, &gate);
+	stream_putc(s, ZEBRA_ROUTE_OSPF);
+	stream_putw(s, 0); /* instance */
+	stream_putc(s, 110); /* distance */
+	stream_putl(s, 20); /* metric */
+	stream_putc(s, 1); /* nexthop_num */
+	stream_putl(s, VRF_DEFAULT);
+	stream_putc(s, NEXTHOP_TYPE_IPV4_IFINDEX);
+	stream_putc(s, 0); /* flags */
+	stream_put_in_addr(s, &gate);
+	stream_putl(s, 1); /* ifindex */
+
+	zclient->nexthop_update(ZEBRA_NEXTHOP_UPDATE, zclient,
+				stream_get_endp(s), VRF_DEFAULT);
+}
+
+/* Configure prefix via gate the way the northbound callbacks do */
+static struct static_path *add_route(const char *prefix, const char *gate,
+				     struct route_node **rnp)
+{
+	struct static_vrf *svrf = vrf_info_lookup(VRF_DEFAULT);
+	struct ipaddr ipaddr = { .ipa_type = IPADDR_V4 };
+	struct static_nexthop *nh;
+	struct static_path *pn;
+	struct route_node *rn;
+	struct prefix p;
+
+	str2prefix(prefix, &p);
+	inet_pton(AF_INET, gate, &ipaddr.ipaddr_v4);
+
+	rn = static_add_route(AFI_IP, SAFI_UNICAST, &p, NULL, svrf);
+	pn = static_add_path(rn, 0, 1);
+	nh = static_add_nexthop(rn, pn, SAFI_UNICAST, svrf,
+				STATIC_IPV4_GATEWAY, &ipaddr, NULL,
+				VRF_DEFAULT_NAME, 0);
+	static_install_nexthop(rn, pn, nh, SAFI_UNICAST, svrf, NULL,
+			       STATIC_IPV4_GATEWAY, VRF_DEFAULT_NAME);
+
+	*rnp = rn;
+	return pn;
+}
+
+static bool events_done;
+
+static int events_done_cb(struct thread *thread)
+{
+	events_done = true;
+	return 0;
+}
+
+/* Run the events scheduled so far, e.g. the install queue */
+static void run_events(void)
+{
+	struct thread thread;
+
+	events_done = false;
+	thread_add_event(master, events_done_cb, NULL, 0, NULL);
+	while (!events_done && thread_fetch(master, &thread))
+		thread_call(&thread);
+}
+
+static void test_shared_nexthop(void)
+{
+	struct static_vrf *svrf = vrf_info_lookup(VRF_DEFAULT);
+	struct static_path *pn;
+	struct route_node *rn;
+
+	/* Nothing to send until zebra resolves the gateway */
+	add_route("10.1.0.0/16", "192.0.2.1", &rn);
+	run_events();
+	assert(route_adds("10.1.0.0/16") == 0);
+
+	nexthop_resolved("192.0.2.1");
+	run_events();
+	assert(route_adds("10.1.0.0/16") == 1);
+
+	/*
+	 * A second route on the same, already resolved gateway is queued
+	 * like any other, even when the path is installed again in the same
+	 * batch, and sent once.
+	 */
+	pn = add_route("10.2.0.0/16", "192.0.2.1", &rn);
+	static_install_path(rn, pn, SAFI_UNICAST, svrf);
+	assert(route_adds("10.2.0.0/16") == 0);
+	run_events();
+	assert(route_adds("10.2.0.0/16") == 1);
+
+	/* A nexthop update resends each route once */
+	nexthop_resolved("192.0.2.1");
+	assert(route_adds("10.1.0.0/16") == 0);
+	run_events();
+	assert(route_adds("10.1.0.0/16") == 1);
+	assert(route_adds("10.2.0.0/16") == 1);
+
+	/*
+	 * A nexthop update for a path that is still queued, e.g. because
+	 * it was just configured, doesn't send it a second time.
+	 */
+	add_route("10.3.0.0/16", "192.0.2.1", &rn);
+	nexthop_resolved("192.0.2.1");
+	run_events();
+	assert(route_adds("10.1.0.0/16") == 1);
+	assert(route_adds("10.2.0.0/16") == 1);
+	assert(route_adds("10.3.0.0/16") == 1);
+}
+
+int main(int argc, char **argv)
+{
+	int sv[2];
+
+	master = thread_master_create(NULL);
+
+	cmd_init(1);
+	cmd_hostname_set("test");
+	vty_init(master, false);
+	zlog_aux_init("NONE: ", ZLOG_DISABLED);
+
+	static_vrf_init();
+	static_install_queue_init();
+	static_zebra_init();
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+		perror("socketpair");
+		exit(1);
+	}
+	zclient->sock = sv[0];
+	zebra_sock = sv[1];
+	set_nonblocking(zebra_sock);
+
+	test_shared_nexthop();
+
+	return 0;
+}
@@ -0,0 +1,8 @@
+import frrtest
+
+
+class TestStaticNHT(frrtest.TestMultiOut):
+    program = "./test_static_nht"
+
+
+TestStaticNHT.exit_cleanly()
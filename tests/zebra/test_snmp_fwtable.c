@@ -0,0 +1,131 @@
+/*
+ * ipForwardTable walk tests.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; see the file COPYING; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <zebra.h>
+
+#include "zebra/zebra_snmp.c"
+
+static struct route_table *rib;
+
+/* shim out the RIB lookup */
+struct route_table *zebra_vrf_table(afi_t afi, safi_t safi, vrf_id_t vrf_id)
+{
+	return rib;
+}
+
+static void add_route(const char *prefix, int type, const char *gate)
+{
+	struct route_node *rn;
+	struct route_entry *re;
+	struct nexthop *nexthop;
+	struct prefix p;
+	rib_dest_t *dest;
+
+	str2prefix(prefix, &p);
+	rn = route_node_get(rib, &p);
+	dest = rn->info;
+	if (!dest) {
+		dest = XCALLOC(MTYPE_TMP, sizeof(*dest));
+		re_list_init(&dest->routes);
+		rn->info = dest;
+	}
+
+	nexthop = nexthop_new();
+	nexthop->type = NEXTHOP_TYPE_IPV4;
+	inet_pton(AF_INET, gate, &nexthop->gate.ipv4);
+
+	re = XCALLOC(MTYPE_TMP, sizeof(*re));
+	re->type = type;
+	re->nhe = XCALLOC(MTYPE_TMP, sizeof(*re->nhe));
+	re->nhe->nhg.nexthop = nexthop;
+	re_list_add_tail(&dest->routes, re);
+}
+
+struct fwtable_row {
+	const char *dest;
+	int proto;
+	const char *nexthop;
+};
+
+/* Walk ipForwardTable with GETNEXTs and compare against rows */
+static void check_walk(const struct fwtable_row *rows, size_t count)
+{
+	struct variable v = { .namelen = 0 };
+	struct route_node *np;
+	struct route_entry *re;
+	oid objid[10] = {};
+	size_t objid_len = 0;
+	struct in_addr addr;
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		get_fwtable_route_node(&v, objid, &objid_len, 0, &np, &re);
+		assert(np && re);
+		assert(objid_len == 10);
+
+		oid2in_addr(objid, 4, &addr);
+		assert(inet_addr(rows[i].dest) == addr.s_addr);
+		assert(objid[4] == (oid)rows[i].proto);
+		assert(objid[5] == 0);
+		oid2in_addr(objid + 6, 4, &addr);
+		assert(inet_addr(rows[i].nexthop) == addr.s_addr);
+
+		/* exact lookups find the same entry */
+		get_fwtable_route_node(&v, objid, &objid_len, 1, &np, &re);
+		assert(np && re);
+		assert(proto_trans(re->type) == rows[i].proto);
+	}
+
+	get_fwtable_route_node(&v, objid, &objid_len, 0, &np, &re);
+	assert(!np);
+}
+
+/*
+ * Rows for the same destination come from different prefix lengths, and
+ * are ordered by proto first.  After answering from 10.0.0.0/16, the walk
+ * has to go back to 10.0.0.0/8 for the next row.
+ */
+static void test_same_dest(void)
+{
+	static const struct fwtable_row rows[] = {
+		{ "10.0.0.0", 2, "192.0.2.2" },
+		{ "10.0.0.0", 3, "192.0.2.1" },
+		{ "10.0.0.0", 8, "192.0.2.3" },
+		{ "10.0.0.0", 13, "192.0.2.4" },
+		{ "10.0.1.0", 3, "192.0.2.1" },
+		{ "10.1.0.0", 14, "192.0.2.5" },
+	};
+
+	rib = route_table_init();
+
+	add_route("10.0.0.0/8", ZEBRA_ROUTE_STATIC, "192.0.2.1");
+	add_route("10.0.0.0/8", ZEBRA_ROUTE_OSPF, "192.0.2.4");
+	add_route("10.0.0.0/16", ZEBRA_ROUTE_CONNECT, "192.0.2.2");
+	add_route("10.0.0.0/16", ZEBRA_ROUTE_RIP, "192.0.2.3");
+	add_route("10.0.1.0/24", ZEBRA_ROUTE_STATIC, "192.0.2.1");
+	add_route("10.1.0.0/16", ZEBRA_ROUTE_BGP, "192.0.2.5");
+
+	check_walk(rows, array_size(rows));
+}
+
+int main(int argc, char **argv)
+{
+	test_same_dest();
+
+	return 0;
+}
@@ -0,0 +1,14 @@
+import frrtest
+import pytest
+
+pytestmark = pytest.mark.skipif(
+    'S["SNMP_TRUE"]=""\n' not in open("../config.status").readlines(),
+    reason="SNMP not enabled",
+)
+
+
+class TestSNMPFwtable(frrtest.TestMultiOut):
+    program = "./test_snmp_fwtable"
+
+
+TestSNMPFwtable.exit_cleanly()
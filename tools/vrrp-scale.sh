@@ -0,0 +1,129 @@
+#!/bin/bash
+#
+# Measure vrrpd CPU use with many virtual routers in Master state.
+#
+# Creates a network namespace with veth pairs, puts up to 250 virtual routers
+# (each with its macvlan device) on one end of each pair, starts zebra and
+# vrrpd there and reports vrrpd CPU time and advertisements received on the
+# other ends over a measurement period.  Needs root, iproute2 and an FRR
+# build.
+#
+# Usage: vrrp-scale.sh [-n VRS] [-i INTERVAL_MS] [-t SECONDS] [-s SBINDIR]
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the Free
+# Software Foundation; either version 2 of the License, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+# more details.
+#
+# You should have received a copy of the GNU General Public License along
+# with this program; see the file COPYING; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+VRS=1000
+INTERVAL=100
+DURATION=30
+SBINDIR=/usr/lib/frr
+USER_GROUP="-u root -g root"
+NS=vrrpscale
+PER_PAIR=250
+
+while getopts "n:i:t:s:" opt; do
+	case $opt in
+	n) VRS=$OPTARG ;;
+	i) INTERVAL=$OPTARG ;;
+	t) DURATION=$OPTARG ;;
+	s) SBINDIR=$OPTARG ;;
+	*) sed -n 's/^# Usage: //p' "$0"; exit 1 ;;
+	esac
+done
+
+RUNDIR=/var/run/frr/${NS}
+CONF=$(mktemp -d /tmp/vrrp-scale.XXXXXX)
+nsexec() { ip netns exec ${NS} "$@"; }
+
+cleanup() {
+	for D in vrrpd zebra; do
+		[ -f "${RUNDIR}/${D}.pid" ] && kill "$(cat "${RUNDIR}/${D}.pid")"
+	done
+	sleep 1
+	ip netns del ${NS} 2>/dev/null
+	rm -rf "${CONF}"
+}
+trap cleanup EXIT
+
+set -e
+ip netns add ${NS}
+nsexec ip link set lo up
+
+PAIRS=$(( (VRS + PER_PAIR - 1) / PER_PAIR ))
+VR=0
+: > "${CONF}/vrrpd.conf"
+for P in $(seq 1 ${PAIRS}); do
+	nsexec ip link add vsa${P} type veth peer name vsb${P}
+	nsexec ip addr add 10.${P}.0.1/16 dev vsa${P}
+	nsexec ip link set vsa${P} up
+	nsexec ip link set vsb${P} up
+	echo "interface vsa${P}" >> "${CONF}/vrrpd.conf"
+
+	for VRID in $(seq 1 ${PER_PAIR}); do
+		[ ${VR} -ge ${VRS} ] && break
+		VR=$((VR + 1))
+		MVL=vs${P}v${VRID}
+		nsexec ip link add ${MVL} link vsa${P} addrgenmode random \
+			type macvlan mode bridge
+		nsexec ip link set dev ${MVL} \
+			address $(printf "00:00:5e:00:01:%02x" ${VRID})
+		nsexec ip addr add 10.${P}.1.${VRID}/16 dev ${MVL}
+		nsexec ip link set dev ${MVL} up
+		cat >> "${CONF}/vrrpd.conf" <<- EOF
+			 vrrp ${VRID} version 3
+			 vrrp ${VRID} priority 254
+			 vrrp ${VRID} advertisement-interval ${INTERVAL}
+			 vrrp ${VRID} ip 10.${P}.1.${VRID}
+		EOF
+	done
+done
+set +e
+
+: > "${CONF}/zebra.conf"
+for D in zebra vrrpd; do
+	nsexec "${SBINDIR}/${D}" -d -N ${NS} ${USER_GROUP} \
+		-f "${CONF}/${D}.conf" || exit 1
+done
+
+rx_packets() {
+	local sum=0 n
+	for P in $(seq 1 ${PAIRS}); do
+		n=$(nsexec cat /sys/class/net/vsb${P}/statistics/rx_packets)
+		sum=$((sum + n))
+	done
+	echo ${sum}
+}
+
+cpu_ticks() {
+	awk '{ print $14 + $15 }' "/proc/$(cat "${RUNDIR}/vrrpd.pid")/stat"
+}
+
+echo "${VRS} virtual routers on ${PAIRS} interfaces," \
+	"advertisement interval ${INTERVAL} ms"
+# Backups become Master after Master_Down_Interval (3 intervals plus skew)
+sleep $(( (4 * INTERVAL + 999) / 1000 + 2 ))
+
+PKT0=$(rx_packets)
+CPU0=$(cpu_ticks)
+sleep ${DURATION}
+PKT1=$(rx_packets)
+CPU1=$(cpu_ticks)
+
+HZ=$(getconf CLK_TCK)
+awk -v pkts=$((PKT1 - PKT0)) -v ticks=$((CPU1 - CPU0)) -v hz=${HZ} \
+	-v secs=${DURATION} -v vrs=${VRS} -v int=${INTERVAL} 'BEGIN {
+	printf "advertisements: %.0f/s (expected %.0f/s)\n",
+		pkts / secs, vrs * 1000 / int;
+	printf "vrrpd CPU:      %.1f%%\n", ticks * 100 / hz / secs;
+}'
@@ -22,8 +22,10 @@
 #include "lib/hash.h"
 #include "lib/hook.h"
 #include "lib/if.h"
+#include "lib/jhash.h"
 #include "lib/linklist.h"
 #include "lib/memory.h"
+#include "lib/monotime.h"
 #include "lib/network.h"
 #include "lib/prefix.h"
 #include "lib/sockopt.h"
@@ -42,6 +44,7 @@
 
 DEFINE_MTYPE_STATIC(VRRPD, VRRP_IP, "VRRP IP address")
 DEFINE_MTYPE_STATIC(VRRPD, VRRP_RTR, "VRRP Router")
+DEFINE_MTYPE_STATIC(VRRPD, VRRP_ADVER_GROUP, "VRRP advertisement group")
 
 /* statics */
 struct hash *vrrp_vrouters_hash;
@@ -380,6 +383,9 @@ void vrrp_check_start(struct vrrp_vrouter *vr)
 			  vr->vrid, family2str(r->family), whynot);
 }
 
+static void vrrp_adver_start(struct vrrp_router *r);
+static void vrrp_adver_stop(struct vrrp_router *r);
+
 void vrrp_set_priority(struct vrrp_vrouter *vr, uint8_t priority)
 {
 	vr->priority = priority;
@@ -396,6 +402,16 @@ void vrrp_set_advertisement_interval(struct vrrp_vrouter *vr,
 	vr->advertisement_interval = advertisement_interval;
 	vrrp_recalculate_timers(vr->v4);
 	vrrp_recalculate_timers(vr->v6);
+
+	/* Masters move to the group sending at the new interval */
+	if (vr->v4->adver_group) {
+		vrrp_adver_stop(vr->v4);
+		vrrp_adver_start(vr->v4);
+	}
+	if (vr->v6->adver_group) {
+		vrrp_adver_stop(vr->v6);
+		vrrp_adver_start(vr->v6);
+	}
 }
 
 static bool vrrp_has_ip(struct vrrp_vrouter *vr, struct ipaddr *ip)
@@ -437,6 +453,7 @@ int vrrp_add_ip(struct vrrp_vrouter *vr, struct ipaddr *ip)
 
 	*new = *ip;
 	listnode_add(r->addrs, new);
+	r->adver_stale = true;
 
 	if (r->fsm.state == VRRP_STATE_MASTER) {
 		switch (r->family) {
@@ -486,6 +503,7 @@ int vrrp_del_ip(struct vrrp_vrouter *vr, struct ipaddr *ip)
 	for (ALL_LIST_ELEMENTS(r->addrs, ln, nn, iter))
 		if (!memcmp(&iter->ip, &ip->ip, IPADDRSZ(ip)))
 			list_delete_node(r->addrs, ln);
+	r->adver_stale = true;
 
 	/*
 	 * NB: Deleting the last address and then issuing a shutdown will cause
@@ -623,6 +641,9 @@ static void vrrp_router_destroy(struct vrrp_router *r)
 	if (r->sock_tx >= 0)
 		close(r->sock_tx);
 
+	if (r->adver_pkt)
+		vrrp_pkt_free(r->adver_pkt);
+
 	/* FIXME: also delete list elements */
 	list_delete(&r->addrs);
 	XFREE(MTYPE_VRRP_RTR, r);
@@ -681,7 +702,6 @@ struct vrrp_vrouter *vrrp_lookup(const struct interface *ifp, uint8_t vrid)
 
 /* Forward decls */
 static void vrrp_change_state(struct vrrp_router *r, int to);
-static int vrrp_adver_timer_expire(struct thread *thread);
 static int vrrp_master_down_timer_expire(struct thread *thread);
 
 /*
@@ -769,39 +789,80 @@ static int vrrp_bind_to_primary_connected(struct vrrp_router *r)
 
 
 /*
- * Create and multicast a VRRP ADVERTISEMENT message.
+ * Get the ADVERTISEMENT to send for a VRRP router, building it if it does not
+ * exist yet or anything it is built from has changed since.
+ *
+ * r
+ *    VRRP Router for which to get ADVERTISEMENT
+ *
+ * Returns:
+ *    the packet; its size is in r->adver_pktsz
+ */
+static struct vrrp_pkt *vrrp_adver_pkt(struct vrrp_router *r)
+{
+	struct ipaddr *addrs[r->addrs->count];
+	ssize_t pktsz;
+
+	if (r->adver_pkt && !r->adver_stale
+	    && r->adver_version == r->vr->version
+	    && r->adver_priority == r->priority
+	    && r->adver_interval == r->vr->advertisement_interval
+	    && !memcmp(&r->adver_src, &r->src, sizeof(r->src)))
+		return r->adver_pkt;
+
+	if (r->adver_pkt)
+		vrrp_pkt_free(r->adver_pkt);
+
+	list_to_array(r->addrs, (void **)addrs, r->addrs->count);
+
+	pktsz = vrrp_pkt_adver_build(&r->adver_pkt, &r->src, r->vr->version,
+				     r->vr->vrid, r->priority,
+				     r->vr->advertisement_interval,
+				     r->addrs->count, (struct ipaddr **)&addrs);
+
+	r->adver_pktsz = (size_t)pktsz;
+	r->adver_src = r->src;
+	r->adver_version = r->vr->version;
+	r->adver_priority = r->priority;
+	r->adver_interval = r->vr->advertisement_interval;
+	r->adver_stale = false;
+
+	return r->adver_pkt;
+}
+
+/*
+ * Multicast a VRRP ADVERTISEMENT message.
  *
  * r
  *    VRRP Router for which to send ADVERTISEMENT
  */
 static void vrrp_send_advertisement(struct vrrp_router *r)
 {
+	static union sockunion dest4, dest6;
+	union sockunion *dest;
 	struct vrrp_pkt *pkt;
-	ssize_t pktsz;
-	struct ipaddr *addrs[r->addrs->count];
-	union sockunion dest;
 
 	if (r->src.ipa_type == IPADDR_NONE
 	    && vrrp_bind_to_primary_connected(r) < 0)
 		return;
 
-	list_to_array(r->addrs, (void **)addrs, r->addrs->count);
-
-	pktsz = vrrp_pkt_adver_build(&pkt, &r->src, r->vr->version, r->vr->vrid,
-				     r->priority, r->vr->advertisement_interval,
-				     r->addrs->count, (struct ipaddr **)&addrs);
+	pkt = vrrp_adver_pkt(r);
 
 	if (DEBUG_MODE_CHECK(&vrrp_dbg_pkt, DEBUG_MODE_ALL))
-		zlog_hexdump(pkt, (size_t)pktsz);
-
-	const char *group = r->family == AF_INET ? VRRP_MCASTV4_GROUP_STR
-						 : VRRP_MCASTV6_GROUP_STR;
-	(void)str2sockunion(group, &dest);
+		zlog_hexdump(pkt, r->adver_pktsz);
 
-	ssize_t sent = sendto(r->sock_tx, pkt, (size_t)pktsz, 0, &dest.sa,
-			      sockunion_sizeof(&dest));
+	if (r->family == AF_INET) {
+		if (dest4.sa.sa_family == AF_UNSPEC)
+			(void)str2sockunion(VRRP_MCASTV4_GROUP_STR, &dest4);
+		dest = &dest4;
+	} else {
+		if (dest6.sa.sa_family == AF_UNSPEC)
+			(void)str2sockunion(VRRP_MCASTV6_GROUP_STR, &dest6);
+		dest = &dest6;
+	}
 
-	vrrp_pkt_free(pkt);
+	ssize_t sent = sendto(r->sock_tx, pkt, r->adver_pktsz, 0, &dest->sa,
+			      sockunion_sizeof(dest));
 
 	if (sent < 0) {
 		zlog_warn(VRRP_LOGPFX VRRP_LOGPFX_VRID VRRP_LOGPFX_FAM
@@ -813,6 +874,176 @@ static void vrrp_send_advertisement(struct vrrp_router *r)
 	}
 }
 
+/* Advertisement groups ---------------------------------------------------- */
+
+/*
+ * All VRRP routers in Master state on the same interface with the same
+ * advertisement interval send their ADVERTISEMENTs from one timer, rather
+ * than each arming its own Adver_Timer.  A router joining a group sends on
+ * the group's next tick, which is never more than one interval away.
+ */
+struct vrrp_adver_group {
+	struct interface *ifp;
+	/* Advertisement interval (centiseconds) */
+	uint16_t interval;
+
+	struct vrrp_adver_members_head members;
+	struct thread *t_adver;
+};
+
+DECLARE_DLIST(vrrp_adver_members, struct vrrp_router, adver_item);
+
+static struct hash *vrrp_adver_groups;
+
+static unsigned int vrrp_adver_group_hash_key(const void *arg)
+{
+	const struct vrrp_adver_group *g = arg;
+
+	return jhash_2words((uint32_t)(uintptr_t)g->ifp, g->interval, 0);
+}
+
+static bool vrrp_adver_group_hash_cmp(const void *arg1, const void *arg2)
+{
+	const struct vrrp_adver_group *g1 = arg1;
+	const struct vrrp_adver_group *g2 = arg2;
+
+	return g1->ifp == g2->ifp && g1->interval == g2->interval;
+}
+
+static void *vrrp_adver_group_alloc(void *arg)
+{
+	const struct vrrp_adver_group *ref = arg;
+	struct vrrp_adver_group *g;
+
+	g = XCALLOC(MTYPE_VRRP_ADVER_GROUP, sizeof(*g));
+	g->ifp = ref->ifp;
+	g->interval = ref->interval;
+	vrrp_adver_members_init(&g->members);
+
+	return g;
+}
+
+/*
+ * Called when a group's Adver_Timer expires; sends an ADVERTISEMENT for each
+ * member.
+ */
+static int vrrp_adver_group_expire(struct thread *thread)
+{
+	struct vrrp_adver_group *g = thread->arg;
+	struct vrrp_router *r;
+
+	DEBUGD(&vrrp_dbg_proto,
+	       VRRP_LOGPFX "Adver_Timer expired for %zu routers on %s",
+	       vrrp_adver_members_count(&g->members), g->ifp->name);
+
+	/* Reset the Adver_Timer to Advertisement_Interval */
+	thread_add_timer_msec(master, vrrp_adver_group_expire, g,
+			      g->interval * CS2MS, &g->t_adver);
+
+	frr_each (vrrp_adver_members, &g->members, r) {
+		if (r->fsm.state != VRRP_STATE_MASTER) {
+			zlog_err(VRRP_LOGPFX VRRP_LOGPFX_VRID VRRP_LOGPFX_FAM
+				 "Adver_Timer expired in state '%s'; this is a bug",
+				 r->vr->vrid, family2str(r->family),
+				 vrrp_state_names[r->fsm.state]);
+			continue;
+		}
+
+		/* Send an ADVERTISEMENT */
+		vrrp_send_advertisement(r);
+	}
+
+	return 0;
+}
+
+/*
+ * Start sending periodic ADVERTISEMENTs for a VRRP router.
+ *
+ * r
+ *    VRRP Router to operate on
+ */
+static void vrrp_adver_start(struct vrrp_router *r)
+{
+	struct vrrp_adver_group ref, *g;
+
+	if (r->adver_group)
+		return;
+
+	ref.ifp = r->vr->ifp;
+	ref.interval = r->vr->advertisement_interval;
+	g = hash_get(vrrp_adver_groups, &ref, vrrp_adver_group_alloc);
+
+	if (vrrp_adver_members_count(&g->members) == 0)
+		thread_add_timer_msec(master, vrrp_adver_group_expire, g,
+				      g->interval * CS2MS, &g->t_adver);
+
+	vrrp_adver_members_add_tail(&g->members, r);
+	r->adver_group = g;
+}
+
+/*
+ * Stop sending periodic ADVERTISEMENTs for a VRRP router.
+ *
+ * r
+ *    VRRP Router to operate on
+ */
+static void vrrp_adver_stop(struct vrrp_router *r)
+{
+	struct vrrp_adver_group *g = r->adver_group;
+
+	if (!g)
+		return;
+
+	vrrp_adver_members_del(&g->members, r);
+	r->adver_group = NULL;
+
+	if (vrrp_adver_members_count(&g->members))
+		return;
+
+	THREAD_OFF(g->t_adver);
+	hash_release(vrrp_adver_groups, g);
+	vrrp_adver_members_fini(&g->members);
+	XFREE(MTYPE_VRRP_ADVER_GROUP, g);
+}
+
+/* Master_Down_Timer ------------------------------------------------------- */
+
+/*
+ * (Re)start the Master_Down_Timer of a VRRP router.
+ *
+ * Backups restart it on every ADVERTISEMENT they receive.  Doing so only
+ * moves the deadline; the timer thread stays armed and, if it fires before
+ * the deadline, is armed again for the remaining time.
+ *
+ * r
+ *    VRRP Router to operate on
+ *
+ * interval
+ *    Time until the timer expires (centiseconds)
+ */
+static void vrrp_master_down_timer_set(struct vrrp_router *r,
+				       uint16_t interval)
+{
+	struct timeval deadline, tv;
+
+	monotime(&deadline);
+	tv.tv_sec = interval / 100;
+	tv.tv_usec = (interval % 100) * 10000;
+	timeradd(&deadline, &tv, &deadline);
+
+	/* can't fire early enough for the new deadline; rearm */
+	if (r->t_master_down_timer
+	    && timercmp(&deadline, &r->master_down_deadline, <))
+		THREAD_OFF(r->t_master_down_timer);
+
+	r->master_down_deadline = deadline;
+
+	if (!r->t_master_down_timer)
+		thread_add_timer_msec(master, vrrp_master_down_timer_expire, r,
+				      interval * CS2MS,
+				      &r->t_master_down_timer);
+}
+
 /*
  * Receive and parse VRRP advertisement.
  *
@@ -907,11 +1138,6 @@ static int vrrp_recv_advertisement(struct vrrp_router *r, struct ipaddr *src,
 
 		if (pkt->hdr.priority == 0) {
 			vrrp_send_advertisement(r);
-			THREAD_OFF(r->t_adver_timer);
-			thread_add_timer_msec(
-				master, vrrp_adver_timer_expire, r,
-				r->vr->advertisement_interval * CS2MS,
-				&r->t_adver_timer);
 		} else if (pkt->hdr.priority > r->priority
 			   || ((pkt->hdr.priority == r->priority)
 			       && addrcmp > 0)) {
@@ -920,17 +1146,13 @@ static int vrrp_recv_advertisement(struct vrrp_router *r, struct ipaddr *src,
 				"Received advertisement from %s w/ priority %hhu; switching to Backup",
 				r->vr->vrid, family2str(r->family), sipstr,
 				pkt->hdr.priority);
-			THREAD_OFF(r->t_adver_timer);
+			vrrp_adver_stop(r);
 			if (r->vr->version == 3) {
 				r->master_adver_interval =
 					htons(pkt->hdr.v3.adver_int);
 			}
 			vrrp_recalculate_timers(r);
-			THREAD_OFF(r->t_master_down_timer);
-			thread_add_timer_msec(master,
-					      vrrp_master_down_timer_expire, r,
-					      r->master_down_interval * CS2MS,
-					      &r->t_master_down_timer);
+			vrrp_master_down_timer_set(r, r->master_down_interval);
 			vrrp_change_state(r, VRRP_STATE_BACKUP);
 		} else {
 			/* Discard advertisement */
@@ -943,10 +1165,7 @@ static int vrrp_recv_advertisement(struct vrrp_router *r, struct ipaddr *src,
 		break;
 	case VRRP_STATE_BACKUP:
 		if (pkt->hdr.priority == 0) {
-			THREAD_OFF(r->t_master_down_timer);
-			thread_add_timer_msec(
-				master, vrrp_master_down_timer_expire, r,
-				r->skew_time * CS2MS, &r->t_master_down_timer);
+			vrrp_master_down_timer_set(r, r->skew_time);
 		} else if (!r->vr->preempt_mode
 			   || pkt->hdr.priority >= r->priority) {
 			if (r->vr->version == 3) {
@@ -954,11 +1173,7 @@ static int vrrp_recv_advertisement(struct vrrp_router *r, struct ipaddr *src,
 					ntohs(pkt->hdr.v3.adver_int);
 			}
 			vrrp_recalculate_timers(r);
-			THREAD_OFF(r->t_master_down_timer);
-			thread_add_timer_msec(master,
-					      vrrp_master_down_timer_expire, r,
-					      r->master_down_interval * CS2MS,
-					      &r->t_master_down_timer);
+			vrrp_master_down_timer_set(r, r->master_down_interval);
 		} else if (r->vr->preempt_mode
 			   && pkt->hdr.priority < r->priority) {
 			/* Discard advertisement */
@@ -1412,7 +1627,7 @@ static void vrrp_change_state_backup(struct vrrp_router *r)
 		vrrp_zebra_radv_set(r, false);
 
 	/* Disable Adver_Timer */
-	THREAD_OFF(r->t_adver_timer);
+	vrrp_adver_stop(r);
 
 	r->advert_pending = false;
 	r->garp_pending = false;
@@ -1477,50 +1692,27 @@ static void vrrp_change_state(struct vrrp_router *r, int to)
 	++r->stats.trans_cnt;
 }
 
-/*
- * Called when Adver_Timer expires.
- */
-static int vrrp_adver_timer_expire(struct thread *thread)
-{
-	struct vrrp_router *r = thread->arg;
-
-	DEBUGD(&vrrp_dbg_proto,
-	       VRRP_LOGPFX VRRP_LOGPFX_VRID VRRP_LOGPFX_FAM
-	       "Adver_Timer expired",
-	       r->vr->vrid, family2str(r->family));
-
-	if (r->fsm.state == VRRP_STATE_MASTER) {
-		/* Send an ADVERTISEMENT */
-		vrrp_send_advertisement(r);
-
-		/* Reset the Adver_Timer to Advertisement_Interval */
-		thread_add_timer_msec(master, vrrp_adver_timer_expire, r,
-				      r->vr->advertisement_interval * CS2MS,
-				      &r->t_adver_timer);
-	} else {
-		zlog_err(VRRP_LOGPFX VRRP_LOGPFX_VRID VRRP_LOGPFX_FAM
-			 "Adver_Timer expired in state '%s'; this is a bug",
-			 r->vr->vrid, family2str(r->family),
-			 vrrp_state_names[r->fsm.state]);
-	}
-
-	return 0;
-}
-
 /*
  * Called when Master_Down_Timer expires.
  */
 static int vrrp_master_down_timer_expire(struct thread *thread)
 {
 	struct vrrp_router *r = thread->arg;
+	int64_t remain = monotime_until(&r->master_down_deadline, NULL);
+
+	/* an ADVERTISEMENT moved the deadline since the timer was armed */
+	if (remain > 0) {
+		thread_add_timer_msec(master, vrrp_master_down_timer_expire, r,
+				      (remain + 999) / 1000,
+				      &r->t_master_down_timer);
+		return 0;
+	}
 
 	zlog_info(VRRP_LOGPFX VRRP_LOGPFX_VRID VRRP_LOGPFX_FAM
 		  "Master_Down_Timer expired",
 		  r->vr->vrid, family2str(r->family));
 
-	thread_add_timer_msec(master, vrrp_adver_timer_expire, r,
-			      r->vr->advertisement_interval * CS2MS,
-			      &r->t_adver_timer);
+	vrrp_adver_start(r);
 	vrrp_change_state(r, VRRP_STATE_MASTER);
 
 	return 0;
@@ -1594,16 +1786,12 @@ static int vrrp_startup(struct vrrp_router *r)
 	}
 
 	if (r->priority == VRRP_PRIO_MASTER) {
-		thread_add_timer_msec(master, vrrp_adver_timer_expire, r,
-				      r->vr->advertisement_interval * CS2MS,
-				      &r->t_adver_timer);
+		vrrp_adver_start(r);
 		vrrp_change_state(r, VRRP_STATE_MASTER);
 	} else {
 		r->master_adver_interval = r->vr->advertisement_interval;
 		vrrp_recalculate_timers(r);
-		thread_add_timer_msec(master, vrrp_master_down_timer_expire, r,
-				      r->master_down_interval * CS2MS,
-				      &r->t_master_down_timer);
+		vrrp_master_down_timer_set(r, r->master_down_interval);
 		vrrp_change_state(r, VRRP_STATE_BACKUP);
 	}
 
@@ -1643,7 +1831,7 @@ static int vrrp_shutdown(struct vrrp_router *r)
 	}
 
 	/* Cancel all timers */
-	THREAD_OFF(r->t_adver_timer);
+	vrrp_adver_stop(r);
 	THREAD_OFF(r->t_master_down_timer);
 	THREAD_OFF(r->t_read);
 	THREAD_OFF(r->t_write);
@@ -2398,6 +2586,10 @@ void vrrp_init(void)
 	vrrp_autoconfig_version = 3;
 	vrrp_vrouters_hash = hash_create(&vrrp_hash_key, vrrp_hash_cmp,
 					 "VRRP virtual router hash");
+	vrrp_adver_groups =
+		hash_create(vrrp_adver_group_hash_key,
+			    vrrp_adver_group_hash_cmp,
+			    "VRRP advertisement group hash");
 	vrf_init(NULL, NULL, NULL, NULL, NULL);
 }
 
@@ -2416,4 +2608,7 @@ void vrrp_fini(void)
 
 	hash_clean(vrrp_vrouters_hash, NULL);
 	hash_free(vrrp_vrouters_hash);
+
+	/* groups go away with their last member */
+	hash_free(vrrp_adver_groups);
 }
@@ -32,6 +32,7 @@
 #include "lib/privs.h"
 #include "lib/stream.h"
 #include "lib/thread.h"
+#include "lib/typesafe.h"
 #include "lib/vty.h"
 
 /* Global definitions */
@@ -84,6 +85,10 @@ extern struct zebra_privs_t vrrp_privs;
 /* Global hash of all Virtual Routers */
 extern struct hash *vrrp_vrouters_hash;
 
+struct vrrp_adver_group;
+
+PREDECL_DLIST(vrrp_adver_members);
+
 /*
  * VRRP Router.
  *
@@ -204,8 +209,32 @@ struct vrrp_router {
 		uint32_t trans_cnt;
 	} stats;
 
+	/*
+	 * While Master, advertisements are sent by the group of all VRRP
+	 * routers on the same interface with the same advertisement interval.
+	 */
+	struct vrrp_adver_group *adver_group;
+	struct vrrp_adver_members_item adver_item;
+
+	/*
+	 * Prebuilt ADVERTISEMENT, and the values it was built from. It is
+	 * rebuilt when any of these change, or when adver_stale is set.
+	 */
+	struct vrrp_pkt *adver_pkt;
+	size_t adver_pktsz;
+	struct ipaddr adver_src;
+	uint8_t adver_version;
+	uint8_t adver_priority;
+	uint16_t adver_interval;
+	bool adver_stale;
+
+	/*
+	 * Master_Down_Timer expiry. Receiving an ADVERTISEMENT only moves this
+	 * forward; t_master_down_timer is rearmed when it fires too early.
+	 */
+	struct timeval master_down_deadline;
+
 	struct thread *t_master_down_timer;
-	struct thread *t_adver_timer;
 	struct thread *t_read;
 	struct thread *t_write;
 };
@@ -63,6 +63,8 @@ struct vtysh_client {
 	int flag;
 	char path[MAXPATHLEN];
 	struct vtysh_client *next;
+	/* commands sent whose response has not been read yet */
+	unsigned int pending;
 };
 
 /* Some utility functions for working on vtysh-specific vty tasks */
@@ -173,39 +175,26 @@ static void vclient_close(struct vtysh_client *vclient)
 		/* indicate as candidate for reconnect */
 		vclient->fd = VTYSH_WAS_ACTIVE;
 	}
+	vclient->pending = 0;
 }
 
+/* Read size used when command output is not parsed line by line */
+#define VTYSH_CLIENT_READ_BUFSIZ 65536
+
 /*
- * Send a CLI command to a client and read the response.
- *
- * Output will be printed to vty->of. If you want to suppress output, set that
- * to NULL.
- *
- * vclient
- *    the client to send the command to
- *
- * line
- *    the command to send
- *
- * callback
- *    if non-null, this will be called with each line of output received from
- *    the client passed in the second parameter
+ * Send a CLI command to a client without waiting for the response.
  *
- * cbarg
- *    optional first argument to pass to callback
+ * Daemons execute commands as they arrive and buffer their output, so
+ * sending a command to several daemons before reading any response lets them
+ * work on it concurrently.  Responses come back in the order the commands
+ * were sent; each one must be collected with vtysh_client_recv().
  *
  * Returns:
- *    a status code
+ *    1 if the command was sent, 0 if the client is not connected, -1 on error
  */
-static int vtysh_client_run(struct vtysh_client *vclient, const char *line,
-			    void (*callback)(void *, const char *), void *cbarg)
+static int vtysh_client_send(struct vtysh_client *vclient, const char *line)
 {
 	int ret;
-	char stackbuf[4096];
-	char *buf = stackbuf;
-	size_t bufsz = sizeof(stackbuf);
-	char *bufvalid, *end = NULL;
-	char terminator[3] = {0, 0, 0};
 
 	/* vclinet was previously active, try to reconnect */
 	if (vclient->fd == VTYSH_WAS_ACTIVE) {
@@ -215,10 +204,14 @@ static int vtysh_client_run(struct vtysh_client *vclient, const char *line,
 	}
 
 	if (vclient->fd < 0)
-		return CMD_SUCCESS;
+		return 0;
 
 	ret = write(vclient->fd, line, strlen(line) + 1);
 	if (ret <= 0) {
+		/* reconnecting would lose the outstanding responses */
+		if (vclient->pending)
+			goto out_err;
+
 		/* close connection and try to reconnect */
 		vclient_close(vclient);
 		ret = vtysh_reconnect(vclient);
@@ -230,6 +223,53 @@ static int vtysh_client_run(struct vtysh_client *vclient, const char *line,
 			goto out_err;
 	}
 
+	vclient->pending++;
+	return 1;
+
+out_err:
+	vclient_close(vclient);
+	return -1;
+}
+
+/*
+ * Read the response to the oldest command sent to a client.
+ *
+ * Output will be printed to vty->of. If you want to suppress output, set that
+ * to NULL.
+ *
+ * vclient
+ *    the client to read the response from
+ *
+ * callback
+ *    if non-null, this will be called with each line of output received from
+ *    the client passed in the second parameter
+ *
+ * cbarg
+ *    optional first argument to pass to callback
+ *
+ * Returns:
+ *    a status code
+ */
+static int vtysh_client_recv(struct vtysh_client *vclient,
+			     void (*callback)(void *, const char *),
+			     void *cbarg)
+{
+	int ret;
+	char stackbuf[4096];
+	char *buf = stackbuf;
+	size_t bufsz = sizeof(stackbuf);
+	char *bufvalid, *end = NULL;
+	char terminator[3] = {0, 0, 0};
+
+	if (vclient->fd < 0 || !vclient->pending)
+		return CMD_SUCCESS;
+
+	/* raw output is passed straight through; read it in large pieces */
+	if (!callback) {
+		bufsz = VTYSH_CLIENT_READ_BUFSIZ;
+		buf = XMALLOC(MTYPE_TMP, bufsz);
+	}
+
 	bufvalid = buf;
 	do {
 		ssize_t nread =
@@ -328,8 +368,13 @@ static int vtysh_client_run(struct vtysh_client *vclient, const char *line,
 
 		/* else if no callback, dump raw */
 		if (!callback) {
-			if (vty->of)
+			/* pass text through as-is, unless it must be filtered */
+			if (vty->of && vty->filter)
 				vty_out(vty, "%s", buf);
+			else if (vty->of && textlen) {
+				fwrite(buf, 1, textlen, vty->of);
+				fflush(vty->of);
+			}
 			memmove(buf, buf + textlen, bufvalid - buf - textlen);
 			bufvalid -= textlen;
 			if (end)
@@ -350,6 +395,7 @@ static int vtysh_client_run(struct vtysh_client *vclient, const char *line,
 		if (end && bufvalid - buf == 4) {
 			assert(!memcmp(buf, terminator, 3));
 			ret = buf[3];
+			vclient->pending--;
 			break;
 		}
 
@@ -365,17 +411,33 @@ out:
 	return ret;
 }
 
-static int vtysh_client_run_all(struct vtysh_client *head_client,
-				const char *line, int continue_on_err,
-				void (*callback)(void *, const char *),
-				void *cbarg)
+/* Send a CLI command to all instances of a daemon */
+static void vtysh_client_send_all(struct vtysh_client *head_client,
+				  const char *line)
 {
 	struct vtysh_client *client;
-	int rc, rc_all = CMD_SUCCESS;
+
+	for (client = head_client; client; client = client->next)
+		vtysh_client_send(client, line);
+}
+
+/* Collect the responses to a command sent with vtysh_client_send_all() */
+static int vtysh_client_recv_all(struct vtysh_client *head_client,
+				 int continue_on_err,
+				 void (*callback)(void *, const char *),
+				 void *cbarg)
+{
+	struct vtysh_client *client;
+	int rc, rc_all = CMD_SUCCESS, rc_err = CMD_SUCCESS;
 	int correct_instance = 0, wrong_instance = 0;
 
+	/* the command went to all instances, so collect all responses even
+	 * when stopping at the first error
+	 */
 	for (client = head_client; client; client = client->next) {
-		rc = vtysh_client_run(client, line, callback, cbarg);
+		rc = vtysh_client_recv(client, callback, cbarg);
+		if (rc_err != CMD_SUCCESS)
+			continue;
 		if (rc == CMD_NOT_MY_INSTANCE) {
 			wrong_instance++;
 			continue;
@@ -384,10 +446,12 @@ static int vtysh_client_run_all(struct vtysh_client *head_client,
 			correct_instance++;
 		if (rc != CMD_SUCCESS) {
 			if (!continue_on_err)
-				return rc;
+				rc_err = rc;
 			rc_all = rc;
 		}
 	}
+	if (rc_err != CMD_SUCCESS)
+		return rc_err;
 	if (wrong_instance && !correct_instance && vty->of) {
 		vty_out(vty,
 			"%% [%s]: command ignored as it targets an instance that is not running\n",
@@ -397,6 +461,16 @@ static int vtysh_client_run_all(struct vtysh_client *head_client,
 	return rc_all;
 }
 
+static int vtysh_client_run_all(struct vtysh_client *head_client,
+				const char *line, int continue_on_err,
+				void (*callback)(void *, const char *),
+				void *cbarg)
+{
+	vtysh_client_send_all(head_client, line);
+	return vtysh_client_recv_all(head_client, continue_on_err, callback,
+				     cbarg);
+}
+
 /*
  * Execute command against all daemons.
  *
@@ -436,26 +510,39 @@ static int vtysh_client_execute_name(const char *name, const char *line)
  * Retrieve all running config from daemons and parse it with the vtysh config
  * parser. Returned output is not displayed to the user.
  *
- * head_client
- *    where to start walking in the daemon list
+ * The command goes out to all daemons first, so they render their config
+ * concurrently; it is then parsed in daemon order.
+ *
+ * name
+ *    only retrieve config from this daemon, or NULL for all of them
  *
  * line
  *    the specific command to execute
  */
-static void vtysh_client_config(struct vtysh_client *head_client, char *line)
+static void vtysh_client_config(const char *name, const char *line)
 {
-	/* watchfrr currently doesn't load any config, and has some hardcoded
-	 * settings that show up in "show run".  skip it here (for now at
-	 * least) so we don't get that mangled up in config-write.
-	 */
-	if (head_client->flag == VTYSH_WATCHFRR)
-		return;
+	unsigned int i;
+	bool selected[array_size(vtysh_client)];
+
+	for (i = 0; i < array_size(vtysh_client); i++) {
+		/* watchfrr currently doesn't load any config, and has some
+		 * hardcoded settings that show up in "show run".  skip it
+		 * here (for now at least) so we don't get that mangled up in
+		 * config-write.
+		 */
+		selected[i] = vtysh_client[i].flag != VTYSH_WATCHFRR
+			      && (!name || strmatch(vtysh_client[i].name, name));
+		if (selected[i])
+			vtysh_client_send_all(&vtysh_client[i], line);
+	}
 
 	/* suppress output to user */
 	vty->of_saved = vty->of;
 	vty->of = NULL;
-	vtysh_client_run_all(head_client, line, 1, vtysh_config_parse_line,
-			     NULL);
+	for (i = 0; i < array_size(vtysh_client); i++)
+		if (selected[i])
+			vtysh_client_recv_all(&vtysh_client[i], 1,
+					      vtysh_config_parse_line, NULL);
 	vty->of = vty->of_saved;
 }
 
@@ -619,7 +706,11 @@ static int vtysh_execute_func(const char *line, int pager)
 
 		cmd_stat = CMD_SUCCESS;
 		struct vtysh_client *vc;
+		bool selected[array_size(vtysh_client)];
+
+		/* dispatch to all daemons, then collect in daemon order */
 		for (i = 0; i < array_size(vtysh_client); i++) {
+			selected[i] = false;
 			if (cmd->daemon & vtysh_client[i].flag) {
 				if (vtysh_client[i].fd < 0
 				    && (cmd->daemon == vtysh_client[i].flag)) {
@@ -642,12 +733,19 @@ static int vtysh_execute_func(const char *line, int pager)
 						continue;
 					}
 				}
-				cmd_stat = vtysh_client_execute(
-					&vtysh_client[i], line);
-				if (cmd_stat != CMD_SUCCESS)
-					break;
+				vtysh_client_send_all(&vtysh_client[i], line);
+				selected[i] = true;
 			}
 		}
+		for (i = 0; i < array_size(vtysh_client); i++) {
+			if (!selected[i])
+				continue;
+
+			ret = vtysh_client_recv_all(&vtysh_client[i], 0, NULL,
+						    NULL);
+			if (cmd_stat == CMD_SUCCESS)
+				cmd_stat = ret;
+		}
 		if (cmd_stat != CMD_SUCCESS)
 			break;
 
@@ -931,6 +1029,97 @@ int vtysh_mark_file(const char *filename)
 	return 0;
 }
 
+/*
+ * Config lines are sent to the daemons without waiting for each response;
+ * up to this many are in flight before the responses are collected.  Lines
+ * that also do something in vtysh itself (e.g. enter a node) wait for the
+ * daemons first, since that only happens if they succeeded.
+ *
+ * The daemons answer one response per line, in order.  A line that yields
+ * in the daemon, e.g. "do show ip route", answers once it completes, and
+ * the lines read after it only run then.
+ */
+#define VTYSH_CONFIG_PIPELINE_DEPTH 64
+
+struct vtysh_config_pipeline {
+	unsigned int count;
+	struct {
+		int lineno;
+		int daemons;
+		char *line;
+	} lines[VTYSH_CONFIG_PIPELINE_DEPTH];
+};
+
+/* Send a config line to its daemons, collecting responses when full */
+static void vtysh_config_pipeline_send(struct vtysh_config_pipeline *pl,
+				       const struct cmd_element *cmd,
+				       int lineno, const char *line)
+{
+	unsigned int i;
+
+	pl->lines[pl->count].lineno = lineno;
+	pl->lines[pl->count].daemons = cmd->daemon;
+	pl->lines[pl->count].line = XSTRDUP(MTYPE_VTYSH_CMD, line);
+	pl->count++;
+
+	for (i = 0; i < array_size(vtysh_client); i++)
+		if (cmd->daemon & vtysh_client[i].flag)
+			vtysh_client_send_all(&vtysh_client[i], line);
+}
+
+/*
+ * Collect the responses to all lines in flight.  Errors are reported for
+ * each line as before; the first one is stored in *retcode.
+ *
+ * Returns the result of the last line: the first failure from any daemon,
+ * else what the last daemon returned.
+ */
+static int vtysh_config_pipeline_flush(struct vtysh_config_pipeline *pl,
+				       int *retcode)
+{
+	unsigned int n, i;
+	int cmd_stat = CMD_SUCCESS, line_stat;
+	bool failed;
+
+	for (n = 0; n < pl->count; n++) {
+		line_stat = CMD_SUCCESS;
+		failed = false;
+
+		for (i = 0; i < array_size(vtysh_client); i++) {
+			if (!(pl->lines[n].daemons & vtysh_client[i].flag))
+				continue;
+
+			cmd_stat = vtysh_client_recv_all(&vtysh_client[i], 0,
+							 NULL, NULL);
+			if (failed)
+				continue;
+
+			/*
+			 * CMD_WARNING - Can mean that the command was parsed
+			 * successfully but it was already entered in a few
+			 * spots. As such if we receive a CMD_WARNING from a
+			 * daemon we shouldn't complain about it.
+			 */
+			if (cmd_stat != CMD_SUCCESS && cmd_stat != CMD_WARNING) {
+				fprintf(stderr,
+					"line %d: Failure to communicate[%d] to %s, line: %s\n",
+					pl->lines[n].lineno, cmd_stat,
+					vtysh_client[i].name,
+					pl->lines[n].line);
+				*retcode = cmd_stat;
+				failed = true;
+			}
+			line_stat = cmd_stat;
+		}
+
+		XFREE(MTYPE_VTYSH_CMD, pl->lines[n].line);
+		cmd_stat = line_stat;
+	}
+	pl->count = 0;
+
+	return cmd_stat;
+}
+
 /* Configration make from file. */
 int vtysh_config_from_file(struct vty *vty, FILE *fp)
 {
@@ -939,12 +1128,17 @@ int vtysh_config_from_file(struct vty *vty, FILE *fp)
 	int lineno = 0;
 	/* once we have an error, we remember & return that */
 	int retcode = CMD_SUCCESS;
+	struct vtysh_config_pipeline pl = {};
 
 	while (fgets(vty->buf, VTY_BUFSIZ, fp)) {
 		lineno++;
 
 		ret = command_config_read_one_line(vty, &cmd, lineno, 1);
 
+		/* keep errors in line order */
+		if (ret != CMD_SUCCESS && ret != CMD_SUCCESS_DAEMON)
+			vtysh_config_pipeline_flush(&pl, &retcode);
+
 		switch (ret) {
 		case CMD_WARNING:
 		case CMD_WARNING_CONFIG_FAILED:
@@ -972,34 +1166,14 @@ int vtysh_config_from_file(struct vty *vty, FILE *fp)
 			retcode = CMD_ERR_INCOMPLETE;
 			break;
 		case CMD_SUCCESS_DAEMON: {
-			unsigned int i;
-			int cmd_stat = CMD_SUCCESS;
+			int cmd_stat;
 
-			for (i = 0; i < array_size(vtysh_client); i++) {
-				if (cmd->daemon & vtysh_client[i].flag) {
-					cmd_stat = vtysh_client_execute(
-						&vtysh_client[i], vty->buf);
-					/*
-					 * CMD_WARNING - Can mean that the
-					 * command was parsed successfully but
-					 * it was already entered in a few
-					 * spots. As such if we receive a
-					 * CMD_WARNING from a daemon we
-					 * shouldn't stop talking to the other
-					 * daemons for the particular command.
-					 */
-					if (cmd_stat != CMD_SUCCESS
-					    && cmd_stat != CMD_WARNING) {
-						fprintf(stderr,
-							"line %d: Failure to communicate[%d] to %s, line: %s\n",
-							lineno, cmd_stat,
-							vtysh_client[i].name,
-							vty->buf);
-						retcode = cmd_stat;
-						break;
-					}
-				}
-			}
+			vtysh_config_pipeline_send(&pl, cmd, lineno, vty->buf);
+			if (!cmd->func
+			    && pl.count < VTYSH_CONFIG_PIPELINE_DEPTH)
+				break;
+
+			cmd_stat = vtysh_config_pipeline_flush(&pl, &retcode);
 			if (cmd_stat != CMD_SUCCESS)
 				break;
 
@@ -1008,6 +1182,7 @@ int vtysh_config_from_file(struct vty *vty, FILE *fp)
 		}
 		}
 	}
+	vtysh_config_pipeline_flush(&pl, &retcode);
 
 	return (retcode);
 }
@@ -3171,7 +3346,6 @@ DEFUN (vtysh_write_terminal,
        DAEMONS_STR
        "Skip \"Building configuration...\" header\n")
 {
-	unsigned int i;
 	char line[] = "do write terminal\n";
 
 	if (!strcmp(argv[argc - 1]->arg, "no-header"))
@@ -3182,10 +3356,7 @@ DEFUN (vtysh_write_terminal,
 		vty_out(vty, "!\n");
 	}
 
-	for (i = 0; i < array_size(vtysh_client); i++)
-		if ((argc < 3)
-		    || (strmatch(vtysh_client[i].name, argv[2]->text)))
-			vtysh_client_config(&vtysh_client[i], line);
+	vtysh_client_config(argc < 3 ? NULL : argv[2]->text, line);
 
 	/* Integrate vtysh specific configuration. */
 	vty_open_pager(vty);
@@ -3250,7 +3421,6 @@ static void backup_config_file(const char *fbackup)
 
 int vtysh_write_config_integrated(void)
 {
-	unsigned int i;
 	char line[] = "do write terminal\n";
 	FILE *fp;
 	int fd;
@@ -3277,8 +3447,7 @@ int vtysh_write_config_integrated(void)
 	}
 	fd = fileno(fp);
 
-	for (i = 0; i < array_size(vtysh_client); i++)
-		vtysh_client_config(&vtysh_client[i], line);
+	vtysh_client_config(NULL, line);
 
 	vtysh_config_write();
 	vty->of_saved = vty->of;
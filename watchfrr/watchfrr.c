@@ -30,6 +30,7 @@
 #include "zlog_targets.h"
 #include "network.h"
 #include "printfrr.h"
+#include "liveness.h"
 
 #include <getopt.h>
 #include <sys/un.h>
@@ -50,6 +51,7 @@
 
 #define DEFAULT_PERIOD		5
 #define DEFAULT_TIMEOUT		90
+#define DEFAULT_CONVERGE_TIMEOUT	300
 #define DEFAULT_RESTART_TIMEOUT	20
 #define DEFAULT_LOGLEVEL	LOG_INFO
 #define DEFAULT_MIN_RESTART	60
@@ -108,6 +110,7 @@ static struct global_state {
 	const char *vtydir;
 	long period;
 	long timeout;
+	long converge_timeout;
 	long restart_timeout;
 	long min_restart_interval;
 	long max_restart_interval;
@@ -126,6 +129,7 @@ static struct global_state {
 	.vtydir = frr_vtydir,
 	.period = 1000 * DEFAULT_PERIOD,
 	.timeout = DEFAULT_TIMEOUT,
+	.converge_timeout = DEFAULT_CONVERGE_TIMEOUT,
 	.restart_timeout = DEFAULT_RESTART_TIMEOUT,
 	.loglevel = DEFAULT_LOGLEVEL,
 	.min_restart_interval = DEFAULT_MIN_RESTART,
@@ -155,6 +159,8 @@ struct daemon {
 	daemon_state_t state;
 	int fd;
 	struct timeval echo_sent;
+	/* event loop liveness page, if the daemon publishes one */
+	struct frr_liveness *live;
 	unsigned int connect_tries;
 	struct thread *t_wakeup;
 	struct thread *t_read;
@@ -176,6 +182,7 @@ struct daemon {
 #define OPTION_MAXRESTART 2001
 #define OPTION_DRY        2002
 #define OPTION_NETNS      2003
+#define OPTION_CONVERGE   2004
 
 static const struct option longopts[] = {
 	{"daemon", no_argument, NULL, 'd'},
@@ -184,6 +191,7 @@ static const struct option longopts[] = {
 	{"interval", required_argument, NULL, 'i'},
 	{"timeout", required_argument, NULL, 't'},
 	{"restart-timeout", required_argument, NULL, 'T'},
+	{"converge-timeout", required_argument, NULL, OPTION_CONVERGE},
 	{"restart", required_argument, NULL, 'r'},
 	{"start-command", required_argument, NULL, 's'},
 	{"kill-command", required_argument, NULL, 'k'},
@@ -232,9 +240,12 @@ static void printhelp(FILE *target)
 Watchdog program to monitor status of frr daemons and try to restart\n\
 them if they are down or unresponsive.  It determines whether a daemon is\n\
 up based on whether it can connect to the daemon's vty unix stream socket.\n\
-It then repeatedly sends echo commands over that socket to determine whether\n\
-the daemon is responsive.  If the daemon crashes, we will receive an EOF\n\
-on the socket connection and know immediately that the daemon is down.\n\n\
+It then repeatedly checks how long ago the daemon's event loop last got\n\
+control, which the daemon publishes in a shared memory page, to determine\n\
+whether the daemon is responsive (daemons without that page are sent echo\n\
+commands over the socket instead).  If the daemon crashes, we will receive\n\
+an EOF on the socket connection and know immediately that the daemon is\n\
+down.\n\n\
 The daemons to be monitored should be listed on the command line.\n\n\
 In order to avoid attempting to restart the daemons in a fast loop,\n\
 the -m and -M options allow you to control the minimum delay between\n\
@@ -266,6 +277,9 @@ Otherwise, the interval is doubled (but capped at the -M value).\n\n",
 		restart commands (default is %d).\n\
 -i, --interval	Set the status polling interval in seconds (default is %d)\n\
 -t, --timeout	Set the unresponsiveness timeout in seconds (default is %d)\n\
+    --converge-timeout\n\
+		Set the unresponsiveness timeout in seconds for daemons that\n\
+		are still starting up or converging (default is %d)\n\
 -T, --restart-timeout\n\
 		Set the restart (kill) timeout in seconds (default is %d).\n\
 		If any background jobs are still running after this much\n\
@@ -296,9 +310,9 @@ Otherwise, the interval is doubled (but capped at the -M value).\n\n",
 -h, --help	Display this help and exit\n",
 		frr_vtydir, DEFAULT_LOGLEVEL, LOG_EMERG, LOG_DEBUG, LOG_DEBUG,
 		DEFAULT_MIN_RESTART, DEFAULT_MAX_RESTART, DEFAULT_PERIOD,
-		DEFAULT_TIMEOUT, DEFAULT_RESTART_TIMEOUT,
-		DEFAULT_RESTART_CMD, DEFAULT_START_CMD, DEFAULT_STOP_CMD,
-		frr_vtydir);
+		DEFAULT_TIMEOUT, DEFAULT_CONVERGE_TIMEOUT,
+		DEFAULT_RESTART_TIMEOUT, DEFAULT_RESTART_CMD,
+		DEFAULT_START_CMD, DEFAULT_STOP_CMD, frr_vtydir);
 }
 
 static pid_t run_background(char *shell_cmd)
@@ -605,6 +619,8 @@ static void daemon_down(struct daemon *dmn, const char *why)
 		close(dmn->fd);
 		dmn->fd = -1;
 	}
+	frr_liveness_unmap(dmn->live);
+	dmn->live = NULL;
 	THREAD_OFF(dmn->t_read);
 	THREAD_OFF(dmn->t_write);
 	THREAD_OFF(dmn->t_wakeup);
@@ -727,10 +743,20 @@ static void daemon_send_ready(int exitcode)
 
 static void daemon_up(struct daemon *dmn, const char *why)
 {
+	char path[sizeof(((struct sockaddr_un *)NULL)->sun_path)];
+
 	dmn->state = DAEMON_UP;
 	gs.numdown--;
 	dmn->connect_tries = 0;
 	zlog_notice("%s state -> up : %s", dmn->name, why);
+
+	/* daemons create this before their vty socket, so it's there now */
+	snprintf(path, sizeof(path), "%s/%s.live", gs.vtydir, dmn->name);
+	frr_liveness_unmap(dmn->live);
+	dmn->live = frr_liveness_map(path);
+	if (!dmn->live && gs.loglevel > LOG_DEBUG)
+		zlog_debug("%s: no liveness page, using echo commands",
+			   dmn->name);
 	if (gs.numdown == 0)
 		daemon_send_ready(0);
 	SET_WAKEUP_ECHO(dmn);
@@ -1010,6 +1036,52 @@ static int wakeup_no_answer(struct thread *t_wakeup)
 	return 0;
 }
 
+/*
+ * Check how long ago the daemon's event loop last got control.  A daemon
+ * that is merely busy keeps doing that between tasks (unlike answering an
+ * echo command, which has to wait for everything queued before it), so only
+ * a single task hogging the loop, or a stopped process, count against it.
+ * Daemons that are still starting up or converging get a longer limit.
+ */
+static void check_liveness(struct daemon *dmn)
+{
+	int64_t lag = frr_liveness_lag(dmn->live);
+	uint32_t phase;
+	long limit;
+
+	phase = atomic_load_explicit(&dmn->live->phase, memory_order_relaxed);
+	if (phase > FRR_LIVENESS_RUNNING)
+		phase = FRR_LIVENESS_RUNNING;
+	limit = phase == FRR_LIVENESS_RUNNING ? gs.timeout
+					      : gs.converge_timeout;
+
+	if (lag < limit * 1000000LL) {
+		if (dmn->state == DAEMON_UNRESPONSIVE) {
+			dmn->state = DAEMON_UP;
+			zlog_warn("%s state -> up : event loop lag %lld.%06lld seconds",
+				  dmn->name, (long long)lag / 1000000,
+				  (long long)lag % 1000000);
+		} else if (gs.loglevel > LOG_DEBUG + 1)
+			zlog_debug("%s: event loop lag %lld.%06lld seconds",
+				   dmn->name, (long long)lag / 1000000,
+				   (long long)lag % 1000000);
+		SET_WAKEUP_ECHO(dmn);
+		return;
+	}
+
+	if (dmn->state != DAEMON_UNRESPONSIVE) {
+		dmn->state = DAEMON_UNRESPONSIVE;
+		if (!dmn->ignore_timeout)
+			flog_err(EC_WATCHFRR_CONNECTION,
+				 "%s state -> unresponsive : event loop stuck for %lld seconds (%s, limit %ld)",
+				 dmn->name, (long long)lag / 1000000,
+				 frr_liveness_phase_names[phase], limit);
+	}
+	SET_WAKEUP_ECHO(dmn);
+	if (!dmn->ignore_timeout)
+		try_restart(dmn);
+}
+
 static int wakeup_send_echo(struct thread *t_wakeup)
 {
 	static const char echocmd[] = "echo " PING_TOKEN;
@@ -1017,6 +1089,17 @@ static int wakeup_send_echo(struct thread *t_wakeup)
 	struct daemon *dmn = THREAD_ARG(t_wakeup);
 
 	dmn->t_wakeup = NULL;
+
+	if (dmn->live && frr_liveness_lag(dmn->live) < 0) {
+		/* replaced by something we don't understand */
+		frr_liveness_unmap(dmn->live);
+		dmn->live = NULL;
+	}
+	if (dmn->live) {
+		check_liveness(dmn);
+		return 0;
+	}
+
 	if (((rc = write(dmn->fd, echocmd, sizeof(echocmd))) < 0)
 	    || ((size_t)rc != sizeof(echocmd))) {
 		char why[100 + sizeof(echocmd)];
@@ -1056,6 +1139,18 @@ void watchfrr_status(struct vty *vty)
 	for (dmn = gs.daemons; dmn; dmn = dmn->next) {
 		vty_out(vty, "  %-20s %s%s", dmn->name, state_str[dmn->state],
 			dmn->ignore_timeout ? "/Ignoring Timeout\n" : "\n");
+		if (dmn->live && IS_UP(dmn)) {
+			int64_t lag = frr_liveness_lag(dmn->live);
+			uint32_t phase = atomic_load_explicit(
+				&dmn->live->phase, memory_order_relaxed);
+
+			if (lag >= 0 && phase <= FRR_LIVENESS_RUNNING)
+				vty_out(vty,
+					"      %s, event loop lag %lld.%03lld seconds\n",
+					frr_liveness_phase_names[phase],
+					(long long)lag / 1000000,
+					(long long)(lag % 1000000) / 1000);
+		}
 		if (dmn->restart.pid)
 			vty_out(vty, "      restart running, pid %ld\n",
 				(long)dmn->restart.pid);
@@ -1472,6 +1567,18 @@ int main(int argc, char **argv)
 				frr_help_exit(1);
 			}
 		} break;
+		case OPTION_CONVERGE: {
+			char garbage[3];
+			if ((sscanf(optarg, "%ld%1s", &gs.converge_timeout,
+				    garbage)
+			     != 1)
+			    || (gs.converge_timeout < 1)) {
+				fprintf(stderr,
+					"Invalid converge timeout argument: %s\n",
+					optarg);
+				frr_help_exit(1);
+			}
+		} break;
 		case 'T': {
 			char garbage[3];
 			if ((sscanf(optarg, "%ld%1s", &gs.restart_timeout,
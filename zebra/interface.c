@@ -250,6 +250,8 @@ static int if_zebra_delete_hook(struct interface *ifp)
 
 		THREAD_OFF(zebra_if->speed_update);
 
+		zebra_interface_events_cancel(ifp);
+
 		XFREE(MTYPE_ZINFO, zebra_if);
 	}
 
@@ -2967,7 +2969,7 @@ int if_ip_address_install(struct interface *ifp, struct prefix *prefix,
 			ifc->label = XSTRDUP(MTYPE_CONNECTED_LABEL, label);
 
 		/* Add to linked list. */
-		listnode_add(ifp->connected, ifc);
+		connected_add(ifp, ifc);
 	}
 
 	/* This address is configured from zebra. */
@@ -3062,7 +3064,7 @@ static int ip_address_install(struct vty *vty, struct interface *ifp,
 			ifc->label = XSTRDUP(MTYPE_CONNECTED_LABEL, label);
 
 		/* Add to linked list. */
-		listnode_add(ifp->connected, ifc);
+		connected_add(ifp, ifc);
 	}
 
 	/* This address is configured from zebra. */
@@ -3325,7 +3327,7 @@ int if_ipv6_address_install(struct interface *ifp, struct prefix *prefix,
 			ifc->label = XSTRDUP(MTYPE_CONNECTED_LABEL, label);
 
 		/* Add to linked list. */
-		listnode_add(ifp->connected, ifc);
+		connected_add(ifp, ifc);
 	}
 
 	/* This address is configured from zebra. */
@@ -3398,7 +3400,7 @@ static int ipv6_address_install(struct vty *vty, struct interface *ifp,
 			ifc->label = XSTRDUP(MTYPE_CONNECTED_LABEL, label);
 
 		/* Add to linked list. */
-		listnode_add(ifp->connected, ifc);
+		connected_add(ifp, ifc);
 	}
 
 	/* This address is configured from zebra. */
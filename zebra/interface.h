@@ -26,6 +26,7 @@
 #include "vrf.h"
 #include "hook.h"
 #include "bitfield.h"
+#include "typesafe.h"
 
 #include "zebra/zebra_l2.h"
 #include "zebra/zebra_nhg_private.h"
@@ -310,6 +311,8 @@ enum zebra_if_flags {
 };
 
 /* `zebra' daemon local interface structure. */
+PREDECL_DLIST(zebra_if_events);
+
 struct zebra_if {
 	/* back pointer to the interface */
 	struct interface *ifp;
@@ -404,6 +407,10 @@ struct zebra_if {
 
 	struct thread *speed_update;
 
+	/* Coalesced up/down notification not yet sent to clients */
+	uint16_t ev_cmd;
+	struct zebra_if_events_item ev_item;
+
 	/*
 	 * Does this interface have a v6 to v4 ll neighbor entry
 	 * for bgp unnumbered?
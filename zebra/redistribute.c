@@ -38,6 +38,7 @@
 #include "zebra/zebra_vrf.h"
 #include "zebra/zebra_routemap.h"
 #include "zebra/redistribute.h"
+#include "zebra/interface.h"
 #include "zebra/debug.h"
 #include "zebra/router-id.h"
 #include "zebra/zapi_msg.h"
@@ -74,6 +75,8 @@ static void zebra_redistribute_default(struct zserv *client, vrf_id_t vrf_id)
 	struct route_node *rn;
 	struct route_entry *newre;
 
+	zebra_interface_events_flush();
+
 	for (afi = AFI_IP; afi <= AFI_IP6; afi++) {
 
 		if (!vrf_bitmap_check(client->redist_default[afi], vrf_id))
@@ -116,6 +119,8 @@ static void zebra_redistribute(struct zserv *client, int type,
 	if (!table)
 		return;
 
+	zebra_interface_events_flush();
+
 	for (rn = route_top(table); rn; rn = srcdest_route_next(rn))
 		RNODE_FOREACH_RE (rn, newre) {
 			const struct prefix *dst_p, *src_p;
@@ -215,6 +220,7 @@ void redistribute_update(const struct prefix *p, const struct prefix *src_p,
 		return;
 	}
 
+	zebra_interface_events_flush();
 
 	for (ALL_LIST_ELEMENTS(zrouter.client_list, node, nnode, client)) {
 		if (zebra_redistribute_check(re, client, p, afi)) {
@@ -291,6 +297,8 @@ void redistribute_delete(const struct prefix *p, const struct prefix *src_p,
 		return;
 	}
 
+	zebra_interface_events_flush();
+
 	for (ALL_LIST_ELEMENTS(zrouter.client_list, node, nnode, client)) {
 		/* Do not send unsolicited messages to synchronous clients. */
 		if (client->synchronous)
@@ -439,16 +447,30 @@ stream_failure:
 	return;
 }
 
-/* Interface up information. */
-void zebra_interface_up_update(struct interface *ifp)
+/*
+ * Interface up/down notifications are held back for a short window and
+ * merged per interface: each message already carries the full interface
+ * state, so only the last one of a burst needs to reach the clients.
+ *
+ * Anything else zebra tells a client may depend on that state, so the
+ * pending notifications are flushed before any other interface,
+ * redistribution or nexthop tracking message goes out.  Each flush ends
+ * with a ZEBRA_INTERFACE_EVENTS_DONE, letting clients react once per batch
+ * rather than once per interface.
+ */
+#define ZEBRA_IF_EVENT_COALESCE_MSEC 10
+
+DECLARE_DLIST(zebra_if_events, struct zebra_if, ev_item);
+
+static struct zebra_if_events_head zebra_if_events_pending =
+	INIT_DLIST(zebra_if_events_pending);
+static struct thread *t_zebra_if_events;
+
+static void zebra_interface_up_send(struct interface *ifp)
 {
 	struct listnode *node, *nnode;
 	struct zserv *client;
 
-	if (IS_ZEBRA_DEBUG_EVENT)
-		zlog_debug("MESSAGE: ZEBRA_INTERFACE_UP %s(%u)",
-			   ifp->name, ifp->vrf_id);
-
 	if (ifp->ptm_status || !ifp->ptm_enable) {
 		for (ALL_LIST_ELEMENTS(zrouter.client_list, node, nnode,
 				       client)) {
@@ -465,16 +487,11 @@ void zebra_interface_up_update(struct interface *ifp)
 	}
 }
 
-/* Interface down information. */
-void zebra_interface_down_update(struct interface *ifp)
+static void zebra_interface_down_send(struct interface *ifp)
 {
 	struct listnode *node, *nnode;
 	struct zserv *client;
 
-	if (IS_ZEBRA_DEBUG_EVENT)
-		zlog_debug("MESSAGE: ZEBRA_INTERFACE_DOWN %s(%u)",
-			   ifp->name, ifp->vrf_id);
-
 	for (ALL_LIST_ELEMENTS(zrouter.client_list, node, nnode, client)) {
 		/* Do not send unsolicited messages to synchronous clients. */
 		if (client->synchronous)
@@ -484,6 +501,117 @@ void zebra_interface_down_update(struct interface *ifp)
 	}
 }
 
+static void zebra_interface_event_send(struct interface *ifp, uint16_t cmd)
+{
+	if (cmd == ZEBRA_INTERFACE_UP)
+		zebra_interface_up_send(ifp);
+	else
+		zebra_interface_down_send(ifp);
+}
+
+/* Tell clients that a batch of up/down notifications is complete */
+static void zebra_interface_events_done(void)
+{
+	struct listnode *node, *nnode;
+	struct zserv *client;
+
+	for (ALL_LIST_ELEMENTS(zrouter.client_list, node, nnode, client)) {
+		/* Do not send unsolicited messages to synchronous clients. */
+		if (client->synchronous)
+			continue;
+
+		zsend_interface_events_done(client);
+	}
+}
+
+/* Send all pending up/down notifications, in the order they were queued */
+void zebra_interface_events_flush(void)
+{
+	struct zebra_if *zif;
+	uint16_t cmd;
+
+	if (!zebra_if_events_count(&zebra_if_events_pending))
+		return;
+
+	THREAD_OFF(t_zebra_if_events);
+
+	while ((zif = zebra_if_events_pop(&zebra_if_events_pending))) {
+		cmd = zif->ev_cmd;
+		zif->ev_cmd = 0;
+		zebra_interface_event_send(zif->ifp, cmd);
+	}
+
+	zebra_interface_events_done();
+}
+
+static int zebra_interface_events_process(struct thread *thread)
+{
+	zebra_interface_events_flush();
+
+	return 0;
+}
+
+static void zebra_interface_event_queue(struct interface *ifp, uint16_t cmd)
+{
+	struct zebra_if *zif = ifp->info;
+
+	if (!zif) {
+		zebra_interface_events_flush();
+		zebra_interface_event_send(ifp, cmd);
+		zebra_interface_events_done();
+		return;
+	}
+
+	if (!zif->ev_cmd)
+		zebra_if_events_add_tail(&zebra_if_events_pending, zif);
+	zif->ev_cmd = cmd;
+
+	thread_add_timer_msec(zrouter.master, zebra_interface_events_process,
+			      NULL, ZEBRA_IF_EVENT_COALESCE_MSEC,
+			      &t_zebra_if_events);
+}
+
+/* Drop the pending notification of an interface that is being freed. */
+void zebra_interface_events_cancel(struct interface *ifp)
+{
+	struct zebra_if *zif = ifp->info;
+
+	if (!zif || !zif->ev_cmd)
+		return;
+
+	zebra_if_events_del(&zebra_if_events_pending, zif);
+	zif->ev_cmd = 0;
+}
+
+void zebra_interface_events_finish(void)
+{
+	struct zebra_if *zif;
+
+	THREAD_OFF(t_zebra_if_events);
+	while ((zif = zebra_if_events_pop(&zebra_if_events_pending)))
+		zif->ev_cmd = 0;
+}
+
+/* Interface up information. */
+void zebra_interface_up_update(struct interface *ifp)
+{
+	if (IS_ZEBRA_DEBUG_EVENT)
+		zlog_debug("MESSAGE: ZEBRA_INTERFACE_UP %s(%u)",
+			   ifp->name, ifp->vrf_id);
+
+	zebra_interface_event_queue(ifp, ZEBRA_INTERFACE_UP);
+}
+
+/* Interface down information. */
+void zebra_interface_down_update(struct interface *ifp)
+{
+	if (IS_ZEBRA_DEBUG_EVENT)
+		zlog_debug("MESSAGE: ZEBRA_INTERFACE_DOWN %s(%u)",
+			   ifp->name, ifp->vrf_id);
+
+	zebra_interface_event_queue(ifp, ZEBRA_INTERFACE_DOWN);
+}
+
 /* Interface information update. */
 void zebra_interface_add_update(struct interface *ifp)
 {
@@ -494,6 +622,8 @@ void zebra_interface_add_update(struct interface *ifp)
 		zlog_debug("MESSAGE: ZEBRA_INTERFACE_ADD %s(%u)", ifp->name,
 			   ifp->vrf_id);
 
+	zebra_interface_events_flush();
+
 	for (ALL_LIST_ELEMENTS(zrouter.client_list, node, nnode, client)) {
 		/* Do not send unsolicited messages to synchronous clients. */
 		if (client->synchronous)
@@ -514,6 +644,8 @@ void zebra_interface_delete_update(struct interface *ifp)
 		zlog_debug("MESSAGE: ZEBRA_INTERFACE_DELETE %s(%u)",
 			   ifp->name, ifp->vrf_id);
 
+	zebra_interface_events_flush();
+
 	for (ALL_LIST_ELEMENTS(zrouter.client_list, node, nnode, client)) {
 		/* Do not send unsolicited messages to synchronous clients. */
 		if (client->synchronous)
@@ -539,6 +671,8 @@ void zebra_interface_address_add_update(struct interface *ifp,
 			p, ifp->name, ifp->vrf_id);
 	}
 
+	zebra_interface_events_flush();
+
 	if (!CHECK_FLAG(ifc->conf, ZEBRA_IFC_REAL))
 		flog_warn(
 			EC_ZEBRA_ADVERTISING_UNUSABLE_ADDR,
@@ -576,6 +710,8 @@ void zebra_interface_address_delete_update(struct interface *ifp,
 			p, ifp->name, ifp->vrf_id);
 	}
 
+	zebra_interface_events_flush();
+
 	zebra_vxlan_add_del_gw_macip(ifp, ifc->address, 0);
 
 	router_id_del_address(ifc);
@@ -606,6 +742,8 @@ void zebra_interface_vrf_update_del(struct interface *ifp, vrf_id_t new_vrf_id)
 			"MESSAGE: ZEBRA_INTERFACE_VRF_UPDATE/DEL %s VRF Id %u -> %u",
 			ifp->name, ifp->vrf_id, new_vrf_id);
 
+	zebra_interface_events_flush();
+
 	for (ALL_LIST_ELEMENTS(zrouter.client_list, node, nnode, client)) {
 		/* Do not send unsolicited messages to synchronous clients. */
 		if (client->synchronous)
@@ -925,6 +1063,8 @@ void zebra_interface_parameters_update(struct interface *ifp)
 		zlog_debug("MESSAGE: ZEBRA_INTERFACE_LINK_PARAMS %s(%u)",
 			   ifp->name, ifp->vrf_id);
 
+	zebra_interface_events_flush();
+
 	for (ALL_LIST_ELEMENTS(zrouter.client_list, node, nnode, client)) {
 		/* Do not send unsolicited messages to synchronous clients. */
 		if (client->synchronous)
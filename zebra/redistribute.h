@@ -67,6 +67,9 @@ extern void zebra_interface_address_add_update(struct interface *,
 extern void zebra_interface_address_delete_update(struct interface *,
 						  struct connected *c);
 extern void zebra_interface_parameters_update(struct interface *);
+extern void zebra_interface_events_flush(void);
+extern void zebra_interface_events_cancel(struct interface *ifp);
+extern void zebra_interface_events_finish(void);
 extern void zebra_interface_vrf_update_del(struct interface *,
 					   vrf_id_t new_vrf_id);
 extern void zebra_interface_vrf_update_add(struct interface *,
@@ -63,7 +63,8 @@ struct rnh {
 	uint32_t seqno;
 
 	struct route_entry *state;
-	struct prefix resolved_route;
+	/* compact, there is one of these per tracked nexthop */
+	struct prefix_key resolved_route;
 	struct list *client_list;
 
 	/* pseudowires dependent on this nh */
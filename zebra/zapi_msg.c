@@ -2552,6 +2552,17 @@ int zsend_sr_policy_notify_status(uint32_t color, struct ipaddr *endpoint,
 	return zserv_send_message(client, s);
 }
 
+/* Mark the end of a batch of coalesced interface notifications */
+int zsend_interface_events_done(struct zserv *client)
+{
+	struct stream *s = stream_new(ZEBRA_MAX_PACKET_SIZ);
+
+	zclient_create_header(s, ZEBRA_INTERFACE_EVENTS_DONE, VRF_DEFAULT);
+	stream_putw_at(s, 0, stream_get_endp(s));
+
+	return zserv_send_message(client, s);
+}
+
 /* Send client close notify to client */
 int zsend_client_close_notify(struct zserv *client, struct zserv *closed_client)
 {
@@ -223,40 +223,45 @@ bool zebra_pbr_rules_hash_equal(const void *arg1, const void *arg2)
 	return true;
 }
 
-struct pbr_rule_unique_lookup {
-	struct zebra_pbr_rule *rule;
-	uint32_t unique;
-	char ifname[INTERFACE_NAMSIZ + 1];
-	vrf_id_t vrf_id;
-};
+/*
+ * Secondary index over the rules, keyed the way clients identify a rule
+ * they want to update: by unique id, interface and vrf.
+ */
+uint32_t zebra_pbr_rules_unique_hash_key(const void *arg)
+{
+	const struct zebra_pbr_rule *rule = arg;
+	uint32_t key;
 
-static int pbr_rule_lookup_unique_walker(struct hash_bucket *b, void *data)
+	key = jhash_2words(rule->rule.unique, rule->vrf_id, 0x5b3fa1c9);
+
+	return jhash(rule->rule.ifname, strlen(rule->rule.ifname), key);
+}
+
+bool zebra_pbr_rules_unique_hash_equal(const void *arg1, const void *arg2)
 {
-	struct pbr_rule_unique_lookup *pul = data;
-	struct zebra_pbr_rule *rule = b->data;
+	const struct zebra_pbr_rule *r1 = arg1;
+	const struct zebra_pbr_rule *r2 = arg2;
 
-	if (pul->unique == rule->rule.unique
-	    && strncmp(pul->ifname, rule->rule.ifname, INTERFACE_NAMSIZ) == 0
-	    && pul->vrf_id == rule->vrf_id) {
-		pul->rule = rule;
-		return HASHWALK_ABORT;
-	}
+	if (r1->rule.unique != r2->rule.unique)
+		return false;
 
-	return HASHWALK_CONTINUE;
+	if (r1->vrf_id != r2->vrf_id)
+		return false;
+
+	return strncmp(r1->rule.ifname, r2->rule.ifname, INTERFACE_NAMSIZ)
+	       == 0;
 }
 
 static struct zebra_pbr_rule *
 pbr_rule_lookup_unique(struct zebra_pbr_rule *zrule)
 {
-	struct pbr_rule_unique_lookup pul;
-
-	pul.unique = zrule->rule.unique;
-	strlcpy(pul.ifname, zrule->rule.ifname, INTERFACE_NAMSIZ);
-	pul.rule = NULL;
-	pul.vrf_id = zrule->vrf_id;
-	hash_walk(zrouter.rules_hash, &pbr_rule_lookup_unique_walker, &pul);
+	return hash_lookup(zrouter.rules_unique_hash, zrule);
+}
 
-	return pul.rule;
+static void pbr_rule_unique_release(struct zebra_pbr_rule *rule)
+{
+	if (hash_lookup(zrouter.rules_unique_hash, rule) == rule)
+		hash_release(zrouter.rules_unique_hash, rule);
 }
 
 void zebra_pbr_ipset_free(void *arg)
@@ -485,6 +490,7 @@ static int pbr_rule_release(struct zebra_pbr_rule *rule)
 		return -ENOENT;
 
 	hash_release(zrouter.rules_hash, lookup);
+	pbr_rule_unique_release(lookup);
 	XFREE(MTYPE_TMP, lookup);
 
 	return 0;
@@ -494,10 +500,7 @@ void zebra_pbr_add_rule(struct zebra_pbr_rule *rule)
 {
 	struct zebra_pbr_rule *found;
 
-	/**
-	 * Check if we already have it (this checks via a unique ID, walking
-	 * over the hash table, not via a hash operation).
-	 */
+	/* Check if we already have it, by unique ID */
 	found = pbr_rule_lookup_unique(rule);
 
 	/* If found, this is an update */
@@ -525,7 +528,8 @@ void zebra_pbr_add_rule(struct zebra_pbr_rule *rule)
 		(void)dplane_pbr_rule_add(rule);
 	}
 
-	(void)hash_get(zrouter.rules_hash, rule, pbr_rule_alloc_intern);
+	found = hash_get(zrouter.rules_hash, rule, pbr_rule_alloc_intern);
+	(void)hash_get(zrouter.rules_unique_hash, found, hash_alloc_intern);
 }
 
 void zebra_pbr_del_rule(struct zebra_pbr_rule *rule)
@@ -612,9 +616,10 @@ static void zebra_pbr_cleanup_rules(struct hash_bucket *b, void *data)
 
 	if (rule->sock == *sock) {
 		(void)dplane_pbr_rule_delete(rule);
-		if (hash_release(zrouter.rules_hash, rule))
+		if (hash_release(zrouter.rules_hash, rule)) {
+			pbr_rule_unique_release(rule);
 			XFREE(MTYPE_TMP, rule);
-		else
+		} else
 			zlog_debug(
 				"%s: Rule seq: %u is being cleaned but we can't find it in our tables",
 				__func__, rule->rule.seq);
@@ -219,6 +219,9 @@ extern int kernel_pbr_rule_del(struct zebra_pbr_rule *rule);
 extern void zebra_pbr_rules_free(void *arg);
 extern uint32_t zebra_pbr_rules_hash_key(const void *arg);
 extern bool zebra_pbr_rules_hash_equal(const void *arg1, const void *arg2);
+extern uint32_t zebra_pbr_rules_unique_hash_key(const void *arg);
+extern bool zebra_pbr_rules_unique_hash_equal(const void *arg1,
+					      const void *arg2);
 
 /* has operates on 32bit pointer
  * and field is a string of 8bit
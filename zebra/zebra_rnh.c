@@ -91,12 +91,14 @@ static void zebra_rnh_remove_from_routing_table(struct rnh *rnh)
 	struct zebra_vrf *zvrf = zebra_vrf_lookup_by_id(rnh->vrf_id);
 	struct route_table *table = zvrf->table[rnh->afi][SAFI_UNICAST];
 	struct route_node *rn;
+	struct prefix resolved;
 	rib_dest_t *dest;
 
 	if (!table)
 		return;
 
-	rn = route_node_match(table, &rnh->resolved_route);
+	prefix_key_get(&rnh->resolved_route, &resolved);
+	rn = route_node_match(table, &resolved);
 	if (!rn)
 		return;
 
@@ -115,9 +117,11 @@ static void zebra_rnh_store_in_routing_table(struct rnh *rnh)
 	struct zebra_vrf *zvrf = zebra_vrf_lookup_by_id(rnh->vrf_id);
 	struct route_table *table = zvrf->table[rnh->afi][SAFI_UNICAST];
 	struct route_node *rn;
+	struct prefix resolved;
 	rib_dest_t *dest;
 
-	rn = route_node_match(table, &rnh->resolved_route);
+	prefix_key_get(&rnh->resolved_route, &resolved);
+	rn = route_node_match(table, &resolved);
 	if (!rn)
 		return;
 
@@ -228,8 +232,10 @@ void zebra_free_rnh(struct rnh *rnh)
 
 	if (table) {
 		struct route_node *rern;
+		struct prefix resolved;
 
-		rern = route_node_match(table, &rnh->resolved_route);
+		prefix_key_get(&rnh->resolved_route, &resolved);
+		rern = route_node_match(table, &resolved);
 		if (rern) {
 			rib_dest_t *dest;
 
@@ -483,14 +489,10 @@ static void zebra_rnh_eval_import_check_entry(struct zebra_vrf *zvrf, afi_t afi,
 	struct listnode *node;
 
 	zebra_rnh_remove_from_routing_table(rnh);
-	if (prn) {
-		prefix_copy(&rnh->resolved_route, &prn->p);
-	} else {
-		int family = rnh->resolved_route.family;
-
-		memset(&rnh->resolved_route.family, 0, sizeof(struct prefix));
-		rnh->resolved_route.family = family;
-	}
+	if (prn)
+		prefix_key_set(&rnh->resolved_route, &prn->p);
+	else
+		prefix_key_reset(&rnh->resolved_route);
 	zebra_rnh_store_in_routing_table(rnh);
 
 	if (re && (rnh->state == NULL)) {
@@ -753,19 +755,11 @@ static void zebra_rnh_eval_nexthop_entry(struct zebra_vrf *zvrf, afi_t afi,
 	 * change.
 	 */
 	zebra_rnh_remove_from_routing_table(rnh);
-	if (!prefix_same(&rnh->resolved_route, prn ? &prn->p : NULL)) {
+	if (!prn || !prefix_key_same(&rnh->resolved_route, &prn->p)) {
 		if (prn)
-			prefix_copy(&rnh->resolved_route, &prn->p);
-		else {
-			/*
-			 * Just quickly store the family of the resolved
-			 * route so that we can reset it in a second here
-			 */
-			int family = rnh->resolved_route.family;
-
-			memset(&rnh->resolved_route, 0, sizeof(struct prefix));
-			rnh->resolved_route.family = family;
-		}
+			prefix_key_set(&rnh->resolved_route, &prn->p);
+		else
+			prefix_key_reset(&rnh->resolved_route);
 
 		copy_state(rnh, re, nrn);
 		state_changed = 1;
@@ -1102,6 +1096,9 @@ int zebra_send_rnh_update(struct rnh *rnh, struct zserv *client,
 	rn = rnh->node;
 	re = rnh->state;
 
+	/* Clients must see interface state before nexthops resolved over it */
+	zebra_interface_events_flush();
+
 	/* Get output stream. */
 	s = stream_new(ZEBRA_MAX_PACKET_SIZ);
 
@@ -30,6 +30,7 @@
 #include "zebra_vxlan.h"
 #include "zebra_mlag.h"
 #include "zebra_nhg.h"
+#include "redistribute.h"
 #include "debug.h"
 
 DEFINE_MTYPE_STATIC(ZEBRA, RIB_TABLE_INFO, "RIB table info")
@@ -239,6 +240,7 @@ void zebra_router_terminate(void)
 
 	zebra_vxlan_disable();
 	zebra_mlag_terminate();
+	zebra_interface_events_finish();
 
 	/* Free NHE in ID table only since it has unhashable entries as well */
 	hash_clean(zrouter.nhgs_id, zebra_nhg_hash_free);
@@ -246,6 +248,8 @@ void zebra_router_terminate(void)
 	hash_clean(zrouter.nhgs, NULL);
 	hash_free(zrouter.nhgs);
 
+	hash_clean(zrouter.rules_unique_hash, NULL);
+	hash_free(zrouter.rules_unique_hash);
 	hash_clean(zrouter.rules_hash, zebra_pbr_rules_free);
 	hash_free(zrouter.rules_hash);
 
@@ -276,6 +280,10 @@ void zebra_router_init(bool asic_offload, bool notify_on_ack)
 	zrouter.rules_hash = hash_create_size(8, zebra_pbr_rules_hash_key,
 					      zebra_pbr_rules_hash_equal,
 					      "Rules Hash");
+	zrouter.rules_unique_hash =
+		hash_create_size(8, zebra_pbr_rules_unique_hash_key,
+				 zebra_pbr_rules_unique_hash_equal,
+				 "Rules Unique Hash");
 
 	zrouter.ipset_hash =
 		hash_create_size(8, zebra_pbr_ipset_hash_key,
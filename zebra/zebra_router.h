@@ -156,6 +156,9 @@ struct zebra_router {
 
 	struct hash *rules_hash;
 
+	/* Same rules, indexed by (unique, ifname, vrf_id) */
+	struct hash *rules_unique_hash;
+
 	struct hash *ipset_hash;
 
 	struct hash *ipset_entry_hash;
@@ -255,44 +255,98 @@ static int proto_trans(int type)
 	}
 }
 
-static void check_replace(struct route_node *np2, struct route_entry *re2,
-			  struct route_node **np, struct route_entry **re)
+/* ipForwardTable index: ipForwardDest, ipForwardProto, ipForwardPolicy,
+ * ipForwardNextHop
+ */
+struct fwtable_index {
+	struct in_addr dest;
+	int proto;
+	int policy;
+	struct in_addr nexthop;
+};
+
+static int fwtable_index_cmp(const struct fwtable_index *a,
+			     const struct fwtable_index *b)
 {
-	int proto, proto2;
+	int ret;
+
+	ret = in_addr_cmp((uint8_t *)&a->dest, (uint8_t *)&b->dest);
+	if (ret)
+		return ret;
+	if (a->proto != b->proto)
+		return a->proto < b->proto ? -1 : 1;
+	if (a->policy != b->policy)
+		return a->policy < b->policy ? -1 : 1;
+	return in_addr_cmp((uint8_t *)&a->nexthop, (uint8_t *)&b->nexthop);
+}
 
-	if (!*np) {
-		*np = np2;
-		*re = re2;
-		return;
-	}
+static bool fwtable_entry_index(const struct route_node *np,
+				const struct route_entry *re,
+				struct fwtable_index *idx)
+{
+	const struct nexthop *nexthop = re->nhe->nhg.nexthop;
 
-	if (prefix_cmp(&(*np)->p, &np2->p) < 0)
-		return;
-	if (prefix_cmp(&(*np)->p, &np2->p) > 0) {
-		*np = np2;
-		*re = re2;
-		return;
-	}
+	if (!nexthop)
+		return false;
 
-	proto = proto_trans((*re)->type);
-	proto2 = proto_trans(re2->type);
+	idx->dest = np->p.u.prefix4;
+	idx->proto = proto_trans(re->type);
+	idx->policy = 0;
+	idx->nexthop = nexthop->gate.ipv4;
+	return true;
+}
 
-	if (proto2 > proto)
-		return;
-	if (proto2 < proto) {
-		*np = np2;
-		*re = re2;
-		return;
-	}
+/*
+ * Table iteration order never decreases in network address, and puts all
+ * nodes with the same address (e.g. 10.0.0.0/8 and 10.0.0.0/16) next to
+ * each other.  So the entries for a destination, and those following it,
+ * can be found without scanning the table from the top: start at the
+ * shortest prefix that can have that network address.
+ *
+ * Returns a locked node, or NULL.
+ */
+static struct route_node *fwtable_node_ge(struct route_table *table,
+					  struct in_addr dest)
+{
+	struct prefix p = {};
+	struct route_node *np;
+	uint32_t addr = ntohl(dest.s_addr);
 
-	if (in_addr_cmp((uint8_t *)&(*re)->nhe->nhg.nexthop->gate.ipv4,
-			(uint8_t *)&re2->nhe->nhg.nexthop->gate.ipv4)
-	    <= 0)
-		return;
+	p.family = AF_INET;
+	p.prefixlen = addr ? IPV4_MAX_BITLEN - __builtin_ctz(addr) : 0;
+	p.u.prefix4 = dest;
+
+	np = route_node_lookup_maynull(table, &p);
+	if (!np)
+		np = route_table_get_next(table, &p);
+	return np;
+}
 
-	*np = np2;
-	*re = re2;
-	return;
+/*
+ * A walk (including a GETBULK, which is answered as a series of GETNEXTs)
+ * asks for the entry after the one returned last.  Remember where that was,
+ * so the next request continues from there.  The next entry for the same
+ * destination may sit on an earlier node with a shorter prefix (proto
+ * sorts before prefix length), so this is the first node with that
+ * destination rather than the one the entry came from.
+ */
+static struct {
+	struct route_table *table;
+	struct route_node *np;
+	struct fwtable_index idx;
+} fwtable_cursor;
+
+static void fwtable_cursor_set(struct route_table *table,
+			       struct route_node *np,
+			       const struct fwtable_index *idx)
+{
+	if (fwtable_cursor.np)
+		route_unlock_node(fwtable_cursor.np);
+
+	fwtable_cursor.table = table;
+	fwtable_cursor.np = np ? route_lock_node(np) : NULL;
+	if (idx)
+		fwtable_cursor.idx = *idx;
 }
 
 static void get_fwtable_route_node(struct variable *v, oid objid[],
@@ -300,29 +354,13 @@ static void get_fwtable_route_node(struct variable *v, oid objid[],
 				   struct route_node **np,
 				   struct route_entry **re)
 {
-	struct in_addr dest;
+	struct fwtable_index key = {}, idx, best_idx;
 	struct route_table *table;
-	struct route_node *np2;
+	struct route_node *np2, *first = NULL, *best_first = NULL;
 	struct route_entry *re2;
-	int proto;
-	int policy;
-	struct in_addr nexthop;
 	uint8_t *pnt;
 	int i;
 
-	/* Init index variables */
-
-	pnt = (uint8_t *)&dest;
-	for (i = 0; i < 4; i++)
-		*pnt++ = 0;
-
-	pnt = (uint8_t *)&nexthop;
-	for (i = 0; i < 4; i++)
-		*pnt++ = 0;
-
-	proto = 0;
-	policy = 0;
-
 	/* Init return variables */
 
 	*np = NULL;
@@ -343,104 +381,103 @@ static void get_fwtable_route_node(struct variable *v, oid objid[],
 
 	if (*objid_len > (unsigned)v->namelen)
 		oid2in_addr(objid + v->namelen,
-			    MIN(4U, *objid_len - v->namelen), &dest);
+			    MIN(4U, *objid_len - v->namelen), &key.dest);
 
 	if (*objid_len > (unsigned)v->namelen + 4)
-		proto = objid[v->namelen + 4];
+		key.proto = objid[v->namelen + 4];
 
 	if (*objid_len > (unsigned)v->namelen + 5)
-		policy = objid[v->namelen + 5];
+		key.policy = objid[v->namelen + 5];
 
 	if (*objid_len > (unsigned)v->namelen + 6)
 		oid2in_addr(objid + v->namelen + 6,
-			    MIN(4U, *objid_len - v->namelen - 6), &nexthop);
-
-	/* Apply GETNEXT on not exact search */
-
-	if (!exact && (*objid_len >= (unsigned)v->namelen + 10)) {
-		if (!in_addr_add((uint8_t *)&nexthop, 1))
-			return;
-	}
+			    MIN(4U, *objid_len - v->namelen - 6), &key.nexthop);
 
 	/* For exact: search matching entry in rib table. */
 
 	if (exact) {
-		if (policy) /* Not supported (yet?) */
-			return;
-		for (*np = route_top(table); *np; *np = route_next(*np)) {
-			if (!in_addr_cmp(&(*np)->p.u.prefix,
-					 (uint8_t *)&dest)) {
-				RNODE_FOREACH_RE (*np, *re) {
-					if (!in_addr_cmp((uint8_t *)&(*re)->nhe
-							 ->nhg.nexthop
-							 ->gate.ipv4,
-							 (uint8_t *)&nexthop))
-						if (proto
-						    == proto_trans((*re)->type))
-							return;
+		for (np2 = fwtable_node_ge(table, key.dest); np2;
+		     np2 = route_next(np2)) {
+			if (!IPV4_ADDR_SAME(&np2->p.u.prefix4, &key.dest)) {
+				route_unlock_node(np2);
+				break;
+			}
+			RNODE_FOREACH_RE (np2, re2) {
+				if (fwtable_entry_index(np2, re2, &idx)
+				    && !fwtable_index_cmp(&idx, &key)) {
+					route_unlock_node(np2);
+					*np = np2;
+					*re = re2;
+					return;
 				}
 			}
 		}
 		return;
 	}
 
-	/* Search next best entry */
+	/* Search next entry, i.e. the lowest one >= key */
 
-	for (np2 = route_top(table); np2; np2 = route_next(np2)) {
+	if (*objid_len >= (unsigned)v->namelen + 10) {
+		if (fwtable_cursor.np && fwtable_cursor.table == table
+		    && !fwtable_index_cmp(&fwtable_cursor.idx, &key))
+			np2 = route_lock_node(fwtable_cursor.np);
+		else
+			np2 = fwtable_node_ge(table, key.dest);
 
-		/* Check destination first */
-		if (in_addr_cmp(&np2->p.u.prefix, (uint8_t *)&dest) > 0)
-			RNODE_FOREACH_RE (np2, re2) {
-				check_replace(np2, re2, np, re);
-			}
+		/* Apply GETNEXT on not exact search */
+		if (!in_addr_add((uint8_t *)&key.nexthop, 1)) {
+			if (np2)
+				route_unlock_node(np2);
+			return;
+		}
+	} else
+		np2 = fwtable_node_ge(table, key.dest);
+
+	for (; np2; np2 = route_next(np2)) {
+		/* entries for the next destination can't be any better */
+		if (*np && !IPV4_ADDR_SAME(&np2->p.u.prefix4,
+					   &(*np)->p.u.prefix4)) {
+			route_unlock_node(np2);
+			break;
+		}
 
-		if (in_addr_cmp(&np2->p.u.prefix, (uint8_t *)&dest)
-		    == 0) { /* have to look at each re individually */
-			RNODE_FOREACH_RE (np2, re2) {
-				int proto2, policy2;
-
-				proto2 = proto_trans(re2->type);
-				policy2 = 0;
-
-				if ((policy < policy2)
-				    || ((policy == policy2) && (proto < proto2))
-				    || ((policy == policy2) && (proto == proto2)
-					&& (in_addr_cmp(
-						    (uint8_t *)&re2->nhe
-						    ->nhg.nexthop->gate.ipv4,
-						    (uint8_t *)&nexthop)
-					    >= 0)))
-					check_replace(np2, re2, np, re);
-			}
+		if (!first || !IPV4_ADDR_SAME(&np2->p.u.prefix4,
+					      &first->p.u.prefix4))
+			first = np2;
+
+		RNODE_FOREACH_RE (np2, re2) {
+			if (!fwtable_entry_index(np2, re2, &idx)
+			    || fwtable_index_cmp(&idx, &key) < 0)
+				continue;
+
+			if (*re && fwtable_index_cmp(&idx, &best_idx) >= 0)
+				continue;
+
+			*np = np2;
+			*re = re2;
+			best_first = first;
+			best_idx = idx;
 		}
 	}
 
-	if (!*re)
+	if (!*re) {
+		fwtable_cursor_set(NULL, NULL, NULL);
 		return;
+	}
 
-	policy = 0;
-	proto = proto_trans((*re)->type);
+	fwtable_cursor_set(table, best_first, &best_idx);
 
 	*objid_len = v->namelen + 10;
-	pnt = (uint8_t *)&(*np)->p.u.prefix;
+	pnt = (uint8_t *)&best_idx.dest;
 	for (i = 0; i < 4; i++)
 		objid[v->namelen + i] = *pnt++;
 
-	objid[v->namelen + 4] = proto;
-	objid[v->namelen + 5] = policy;
+	objid[v->namelen + 4] = best_idx.proto;
+	objid[v->namelen + 5] = best_idx.policy;
 
-	{
-		struct nexthop *nexthop;
-
-		nexthop = (*re)->nhe->nhg.nexthop;
-		if (nexthop) {
-			pnt = (uint8_t *)&nexthop->gate.ipv4;
-			for (i = 0; i < 4; i++)
-				objid[i + v->namelen + 6] = *pnt++;
-		}
-	}
-
-	return;
+	pnt = (uint8_t *)&best_idx.nexthop;
+	for (i = 0; i < 4; i++)
+		objid[i + v->namelen + 6] = *pnt++;
 }
 
 static uint8_t *ipFwTable(struct variable *v, oid objid[], size_t *objid_len,
@@ -558,9 +595,16 @@ static int zebra_snmp_init(struct thread_master *tm)
 	return 0;
 }
 
+static int zebra_snmp_fini(void)
+{
+	fwtable_cursor_set(NULL, NULL, NULL);
+	return 0;
+}
+
 static int zebra_snmp_module_init(void)
 {
 	hook_register(frr_late_init, zebra_snmp_init);
+	hook_register(frr_early_fini, zebra_snmp_fini);
 	return 0;
 }
 
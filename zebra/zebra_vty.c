@@ -59,6 +59,7 @@
 #include "northbound_cli.h"
 #include "zebra/zebra_nb.h"
 #include "zebra/kernel_netlink.h"
+#include "snapshot.h"
 
 extern int allow_delete;
 
@@ -66,6 +67,13 @@ extern int allow_delete;
 struct route_show_ctx {
 	bool multi;       /* dump multiple tables or vrf */
 	bool header_done; /* common header already displayed */
+
+	/* single table dump that yielded, see show_route_resume() */
+	bool paused;
+	bool first;
+	struct prefix resume_p; /* first destination not displayed yet */
+	uint32_t snapshot;	/* routes added after the start are skipped */
+	json_object *json;
 };
 
 static int do_show_ip_route(struct vty *vty, const char *vrf_name, afi_t afi,
@@ -667,10 +675,8 @@ static void show_nexthop_json_helper(json_object *json_nexthop,
 	switch (nexthop->type) {
 	case NEXTHOP_TYPE_IPV4:
 	case NEXTHOP_TYPE_IPV4_IFINDEX:
-		json_object_string_add(
-			json_nexthop, "ip",
-			inet_ntop(AF_INET, &nexthop->gate.ipv4,
-				  buf, sizeof(buf)));
+		json_object_addr_add(json_nexthop, "ip", AF_INET,
+				     &nexthop->gate.ipv4);
 		json_object_string_add(json_nexthop, "afi",
 				       "ipv4");
 
@@ -687,10 +693,8 @@ static void show_nexthop_json_helper(json_object *json_nexthop,
 		break;
 	case NEXTHOP_TYPE_IPV6:
 	case NEXTHOP_TYPE_IPV6_IFINDEX:
-		json_object_string_add(
-			json_nexthop, "ip",
-			inet_ntop(AF_INET6, &nexthop->gate.ipv6,
-				  buf, sizeof(buf)));
+		json_object_addr_add(json_nexthop, "ip", AF_INET6,
+				     &nexthop->gate.ipv6);
 		json_object_string_add(json_nexthop, "afi",
 				       "ipv6");
 
@@ -1077,13 +1081,13 @@ static void vty_show_ip_route_detail_json(struct vty *vty,
 	json_object_free(json);
 }
 
-static void do_show_route_helper(struct vty *vty, struct zebra_vrf *zvrf,
-				 struct route_table *table, afi_t afi,
-				 bool use_fib, route_tag_t tag,
-				 const struct prefix *longer_prefix_p,
-				 bool supernets_only, int type,
-				 unsigned short ospf_instance_id, bool use_json,
-				 uint32_t tableid, struct route_show_ctx *ctx)
+static int do_show_route_helper(struct vty *vty, struct zebra_vrf *zvrf,
+				struct route_table *table, afi_t afi,
+				bool use_fib, route_tag_t tag,
+				const struct prefix *longer_prefix_p,
+				bool supernets_only, int type,
+				unsigned short ospf_instance_id, bool use_json,
+				uint32_t tableid, struct route_show_ctx *ctx)
 {
 	struct route_node *rn;
 	struct route_entry *re;
@@ -1105,11 +1109,38 @@ static void do_show_route_helper(struct vty *vty, struct zebra_vrf *zvrf,
 	 *   => display the VRF and table if specific
 	 */
 
-	if (use_json)
-		json = json_object_new_object();
+	if (ctx->paused) {
+		/* pick up where the previous time slice stopped */
+		json = ctx->json;
+		first = ctx->first;
+		rn = route_node_lookup_maynull(table, &ctx->resume_p);
+		if (!rn)
+			rn = route_table_get_next(table, &ctx->resume_p);
+		ctx->paused = false;
+	} else {
+		if (use_json)
+			json = json_object_new_object();
+		ctx->snapshot = route_table_snapshot(table);
+		rn = route_top(table);
+	}
 
 	/* Show all routes. */
-	for (rn = route_top(table); rn; rn = srcdest_route_next(rn)) {
+	for (; rn; rn = srcdest_route_next(rn)) {
+		/* Pause only between destinations; source-specific routes
+		 * are walked together with their destination. */
+		if (rn->table == table && vty_resume_yield(vty)) {
+			prefix_copy(&ctx->resume_p, &rn->p);
+			route_unlock_node(rn);
+			ctx->json = json;
+			ctx->first = first;
+			ctx->paused = true;
+			return CMD_YIELD;
+		}
+
+		if (rn->table == table
+		    && !route_node_in_snapshot(rn, ctx->snapshot))
+			continue;
+
 		dest = rib_dest_from_rnode(rn);
 
 		RNODE_FOREACH_RE (rn, re) {
@@ -1188,7 +1219,10 @@ static void do_show_route_helper(struct vty *vty, struct zebra_vrf *zvrf,
 		vty_out(vty, "%s\n", json_object_to_json_string_ext(json,
 						JSON_C_TO_STRING_PRETTY));
 		json_object_free(json);
+		ctx->json = NULL;
 	}
+
+	return CMD_SUCCESS;
 }
 
 static void do_show_ip_route_all(struct vty *vty, struct zebra_vrf *zvrf,
@@ -1230,6 +1264,24 @@ static int do_show_ip_route(struct vty *vty, const char *vrf_name, afi_t afi,
 	struct route_table *table;
 	struct zebra_vrf *zvrf = NULL;
 
+	/* the VRF or table went away while a yielded dump was paused */
+	if (ctx->paused
+	    && (!(zvrf = zebra_vrf_lookup_by_name(vrf_name))
+		|| zvrf_id(zvrf) == VRF_UNKNOWN
+		|| !(tableid ? zebra_router_find_table(zvrf, tableid, afi,
+						       SAFI_UNICAST)
+			     : zebra_vrf_table(afi, safi, zvrf_id(zvrf))))) {
+		if (ctx->json) {
+			vty_out(vty, "%s\n",
+				json_object_to_json_string_ext(
+					ctx->json, JSON_C_TO_STRING_PRETTY));
+			json_object_free(ctx->json);
+			ctx->json = NULL;
+		}
+		ctx->paused = false;
+		return CMD_SUCCESS;
+	}
+
 	if (!(zvrf = zebra_vrf_lookup_by_name(vrf_name))) {
 		if (use_json)
 			vty_out(vty, "{}\n");
@@ -1256,11 +1308,46 @@ static int do_show_ip_route(struct vty *vty, const char *vrf_name, afi_t afi,
 		return CMD_SUCCESS;
 	}
 
-	do_show_route_helper(vty, zvrf, table, afi, use_fib, tag,
-			     longer_prefix_p, supernets_only, type,
-			     ospf_instance_id, use_json, tableid, ctx);
+	return do_show_route_helper(vty, zvrf, table, afi, use_fib, tag,
+				    longer_prefix_p, supernets_only, type,
+				    ospf_instance_id, use_json, tableid, ctx);
+}
+
+/* "show ip route" on a single table, run as a resumable vty command */
+struct route_show_walk {
+	char vrf_name[VRF_NAMSIZ];
+	afi_t afi;
+	bool use_fib;
+	bool use_json;
+	route_tag_t tag;
+	bool has_longer_prefix;
+	struct prefix longer_prefix;
+	bool supernets_only;
+	int type;
+	unsigned short ospf_instance_id;
+	uint32_t tableid;
+	struct route_show_ctx ctx;
+};
 
-	return CMD_SUCCESS;
+static int show_route_resume(struct vty *vty, void *arg)
+{
+	struct route_show_walk *walk = arg;
+
+	return do_show_ip_route(
+		vty, walk->vrf_name, walk->afi, SAFI_UNICAST, walk->use_fib,
+		walk->use_json, walk->tag,
+		walk->has_longer_prefix ? &walk->longer_prefix : NULL,
+		walk->supernets_only, walk->type, walk->ospf_instance_id,
+		walk->tableid, &walk->ctx);
+}
+
+static void show_route_walk_free(void *arg)
+{
+	struct route_show_walk *walk = arg;
+
+	if (walk->ctx.json)
+		json_object_free(walk->ctx.json);
+	XFREE(MTYPE_TMP, walk);
 }
 
 DEFPY (show_ip_nht,
@@ -1818,12 +1905,29 @@ DEFPY (show_route,
 					     prefix_str ? prefix : NULL,
 					     !!supernets_only, type,
 					     ospf_instance_id, &ctx);
-		else
-			do_show_ip_route(vty, vrf->name, afi, SAFI_UNICAST,
-					 !!fib, !!json, tag,
-					 prefix_str ? prefix : NULL,
-					 !!supernets_only, type,
-					 ospf_instance_id, table, &ctx);
+		else {
+			struct route_show_walk *walk;
+
+			walk = XCALLOC(MTYPE_TMP, sizeof(*walk));
+			strlcpy(walk->vrf_name, vrf->name,
+				sizeof(walk->vrf_name));
+			walk->afi = afi;
+			walk->use_fib = !!fib;
+			walk->use_json = !!json;
+			walk->tag = tag;
+			if (prefix_str) {
+				walk->has_longer_prefix = true;
+				prefix_copy(&walk->longer_prefix, prefix);
+			}
+			walk->supernets_only = !!supernets_only;
+			walk->type = type;
+			walk->ospf_instance_id = ospf_instance_id;
+			walk->tableid = table;
+			walk->ctx = ctx;
+
+			return vty_resume_start(vty, show_route_resume, walk,
+						show_route_walk_free);
+		}
 	}
 
 	return CMD_SUCCESS;
@@ -4137,4 +4241,11 @@ void zebra_vty_init(void)
 #endif /* HAVE_NETLINK */
 
 	install_element(VIEW_NODE, &zebra_show_routing_tables_summary_cmd);
+
+	/* polled by monitoring, answered by --query-thread */
+	snapshot_register("show ip route summary", 1000);
+	snapshot_register("show ipv6 route summary", 1000);
+	snapshot_register("show interface brief", 1000);
+	snapshot_register("show ip route", 5000);
+	snapshot_register("show ipv6 route", 5000);
 }